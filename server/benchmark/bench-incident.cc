@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A benchmark of the incident path against RedmineAPIEmulator.
+ * It measures the throughput and the tail latency of
+ *   - registering incidents through IncidentSenderManager and
+ *   - synchronizing updated issues by ArmRedmine.
+ *
+ * It uses the same DB as the unit tests (see test/DBTablesTest.cc),
+ * which is recreated on startup.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <glib.h>
+#include <StringUtils.h>
+#include "Hatohol.h"
+#include "ConfigManager.h"
+#include "IncidentSenderManager.h"
+#include "ArmRedmine.h"
+#include "ThreadLocalDBCache.h"
+#include "LatencyHistogram.h"
+#include "DBTablesTest.h"
+#include "RedmineAPIEmulator.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace mlpl;
+
+struct Options {
+	gint    numEvents;
+	gint    numIssues;
+	gint    numRounds;
+	gint    numIssuesPerRound;
+	gint    numSenderJobs;
+	gint    latencyMSec;
+	gint    latencyJitterMSec;
+	gdouble errorRate;
+
+	Options(void)
+	: numEvents(1000),
+	  numIssues(10000),
+	  numRounds(20),
+	  numIssuesPerRound(500),
+	  numSenderJobs(IncidentSender::DEFAULT_MAX_IN_FLIGHT_JOBS),
+	  latencyMSec(20),
+	  latencyJitterMSec(20),
+	  errorRate(0.0)
+	{
+	}
+};
+
+static bool parseCommandLine(gint *argc, gchar ***argv, Options &options)
+{
+	GOptionEntry entries[] = {
+		{"events",
+		 'e', 0, G_OPTION_ARG_INT, &options.numEvents,
+		 "Number of events sent as incidents", NULL},
+		{"issues",
+		 'n', 0, G_OPTION_ARG_INT, &options.numIssues,
+		 "Number of issues tracked by ArmRedmine", NULL},
+		{"rounds",
+		 'r', 0, G_OPTION_ARG_INT, &options.numRounds,
+		 "Number of ArmRedmine polls", NULL},
+		{"issues-per-round",
+		 'u', 0, G_OPTION_ARG_INT, &options.numIssuesPerRound,
+		 "Number of issues updated before each poll", NULL},
+		{"jobs",
+		 'J', 0, G_OPTION_ARG_INT, &options.numSenderJobs,
+		 "Number of incidents sent concurrently", NULL},
+		{"latency",
+		 'l', 0, G_OPTION_ARG_INT, &options.latencyMSec,
+		 "Latency of the emulator in milliseconds", NULL},
+		{"jitter",
+		 'j', 0, G_OPTION_ARG_INT, &options.latencyJitterMSec,
+		 "Maximum random latency added to --latency", NULL},
+		{"error-rate",
+		 'E', 0, G_OPTION_ARG_DOUBLE, &options.errorRate,
+		 "Ratio of requests answered with an error (0.0 - 1.0)", NULL},
+		{ NULL }
+	};
+
+	GOptionContext *optCtx = g_option_context_new(NULL);
+	g_option_context_add_main_entries(optCtx, entries, NULL);
+	GError *error = NULL;
+	bool succeeded = g_option_context_parse(optCtx, argc, argv, &error);
+	if (!succeeded) {
+		fprintf(stderr, "Failed to parse command line argment. (%s)\n",
+		        error ? error->message : "Unknown reason");
+		g_error_free(error);
+	}
+	g_option_context_free(optCtx);
+	return succeeded;
+}
+
+static void reportHeader(void)
+{
+	printf("%-22s %8s %12s %9s %9s %9s %9s %8s\n",
+	       "Label", "Count", "Throughput",
+	       "p50", "p95", "p99", "Max", "Failed");
+}
+
+static void report(const string &label, const size_t &count,
+                   const double &elapsedSec,
+                   const LatencyHistogram &histogram,
+                   const size_t &numFailed)
+{
+	LatencyHistogram::Snapshot snapshot;
+	histogram.getSnapshot(snapshot);
+	auto msec = [&](const double &percentile) {
+		return StringUtils::sprintf(
+		  "%.1fms", snapshot.getValueAtPercentile(percentile) / 1000.0);
+	};
+	printf("%-22s %8zd %10.1f/s %9s %9s %9s %9s %8zd\n",
+	       label.c_str(), count, count / elapsedSec,
+	       msec(50).c_str(), msec(95).c_str(), msec(99).c_str(),
+	       StringUtils::sprintf("%.1fms", snapshot.max / 1000.0).c_str(),
+	       numFailed);
+}
+
+struct SenderBenchmark {
+	struct Job {
+		SenderBenchmark       *benchmark;
+		steady_clock::time_point queuedTime;
+	};
+
+	mutex              lock;
+	condition_variable finished;
+	size_t             numFinished;
+	size_t             numFailed;
+	LatencyHistogram   histogram;
+	vector<Job>        jobs;
+
+	SenderBenchmark(void)
+	: numFinished(0),
+	  numFailed(0)
+	{
+	}
+
+	static void callback(const IncidentSender &sender,
+	                     const EventInfo &info,
+	                     const IncidentSender::JobStatus &status,
+	                     void *userData)
+	{
+		if (status != IncidentSender::JOB_SUCCEEDED &&
+		    status != IncidentSender::JOB_FAILED) {
+			return;
+		}
+		Job *job = static_cast<Job *>(userData);
+		SenderBenchmark *benchmark = job->benchmark;
+		benchmark->histogram.recordSince(job->queuedTime);
+
+		lock_guard<mutex> lock(benchmark->lock);
+		benchmark->numFinished++;
+		if (status == IncidentSender::JOB_FAILED)
+			benchmark->numFailed++;
+		benchmark->finished.notify_all();
+	}
+
+	void run(const IncidentTrackerInfo &tracker, const size_t &numEvents)
+	{
+		IncidentSenderManager &manager
+		  = IncidentSenderManager::getInstance();
+		jobs.resize(numEvents);
+
+		const steady_clock::time_point startTime = steady_clock::now();
+		for (size_t i = 0; i < numEvents; i++) {
+			// Use different triggers not to coalesce events
+			EventInfo event = testEventInfo[0];
+			event.id = StringUtils::sprintf("bench-%zd", i);
+			event.triggerId = StringUtils::sprintf("bench-%zd", i);
+			Job &job = jobs[i];
+			job.benchmark = this;
+			job.queuedTime = steady_clock::now();
+			manager.queue(tracker.id, event, callback, &job);
+		}
+
+		unique_lock<mutex> lock(this->lock);
+		finished.wait(lock, [&] { return numFinished >= numEvents; });
+		const double elapsedSec = duration_cast<duration<double>>(
+		  steady_clock::now() - startTime).count();
+		report("IncidentSenderManager", numEvents, elapsedSec,
+		       histogram, numFailed);
+	}
+};
+
+struct ArmRedmineBenchmark : public ArmRedmine {
+	ArmRedmineBenchmark(const IncidentTrackerInfo &tracker)
+	: ArmRedmine(tracker)
+	{
+	}
+
+	static void addIncidents(const IncidentTrackerInfo &tracker,
+	                         const size_t &numIssues,
+	                         const time_t &updatedOn)
+	{
+		ThreadLocalDBCache cache;
+		DBTablesMonitoring &dbMonitoring = cache.getMonitoring();
+		for (size_t i = 0; i < numIssues; i++) {
+			IncidentInfo incident;
+			incident.trackerId = tracker.id;
+			incident.serverId = testEventInfo[0].serverId;
+			incident.eventId = StringUtils::sprintf("issue-%zd", i);
+			incident.triggerId = testEventInfo[0].triggerId;
+			incident.identifier = StringUtils::toString(
+			  static_cast<uint64_t>(i + 1));
+			incident.status = "New";
+			incident.createdAt.tv_sec = updatedOn;
+			incident.createdAt.tv_nsec = 0;
+			incident.updatedAt = incident.createdAt;
+			incident.doneRatio = 0;
+			incident.unifiedEventId = 0;
+			incident.commentCount = 0;
+			dbMonitoring.addIncidentInfo(&incident);
+		}
+	}
+
+	void run(const Options &options)
+	{
+		// Issues have to be newer than the incidents registered by
+		// SenderBenchmark to be picked up.
+		const time_t updatedOn = time(NULL) + 1;
+		LatencyHistogram histogram;
+		size_t numFailed = 0;
+		duration<double> elapsed(0);
+		for (int round = 1; round <= options.numRounds; round++) {
+			g_redmineEmulator.touchIssues(options.numIssuesPerRound,
+			                              updatedOn + round);
+			const steady_clock::time_point startTime
+			  = steady_clock::now();
+			if (mainThreadOneProc() != COLLECT_OK)
+				numFailed++;
+			elapsed += steady_clock::now() - startTime;
+			histogram.recordSince(startTime);
+		}
+		const size_t numUpdated =
+		  options.numRounds * options.numIssuesPerRound;
+		report("ArmRedmine", numUpdated, elapsed.count(),
+		       histogram, numFailed);
+	}
+};
+
+int main(int argc, char *argv[])
+{
+	Options options;
+	if (!parseCommandLine(&argc, &argv, options))
+		return EXIT_FAILURE;
+
+	hatoholInit();
+	setupTestDB();
+	loadTestDBTablesConfig();
+	ConfigManager::getInstance()->setNumberOfIncidentSenderJobs(
+	  options.numSenderJobs);
+
+	// The tracker for RedmineAPIEmulator
+	const IncidentTrackerInfo &tracker = testIncidentTrackerInfo[2];
+	RedmineAPIEmulator &emulator = g_redmineEmulator;
+	emulator.addUser(tracker.userName, tracker.password);
+	RedmineAPIEmulator::LoadProfile profile;
+	profile.latencyMSec = options.latencyMSec;
+	profile.latencyJitterMSec = options.latencyJitterMSec;
+	profile.errorRate = options.errorRate;
+	emulator.setLoadProfile(profile);
+	const time_t updatedOn = time(NULL) - 3600;
+	emulator.generateIssues(options.numIssues, updatedOn);
+	emulator.start(EMULATOR_PORT);
+
+	reportHeader();
+
+	SenderBenchmark senderBenchmark;
+	senderBenchmark.run(tracker, options.numEvents);
+
+	ArmRedmineBenchmark::addIncidents(tracker, options.numIssues,
+	                                  updatedOn);
+	ArmRedmineBenchmark armBenchmark(tracker);
+	armBenchmark.run(options);
+
+	printf("Requests: %zd, Injected errors: %zd\n",
+	       emulator.getNumberOfRequests(),
+	       emulator.getNumberOfInjectedErrors());
+	emulator.stop();
+	return EXIT_SUCCESS;
+}
@@ -533,6 +533,33 @@ bool AMQPConnection::openChannel(void)
 	return m_impl->openChannel();
 }
 
+bool AMQPConnection::setQoS(void)
+{
+	const uint16_t prefetchCount =
+	  getConnectionInfo().getPrefetchCount();
+	if (prefetchCount == 0)
+		return true;
+
+	const uint32_t prefetchSize = 0;
+	const amqp_boolean_t global = false;
+	const amqp_basic_qos_ok_t *response;
+	response = amqp_basic_qos(getConnection(),
+				  getChannel(),
+				  prefetchSize,
+				  prefetchCount,
+				  global);
+	if (!response) {
+		const amqp_rpc_reply_t reply =
+			amqp_get_rpc_reply(getConnection());
+		if (reply.reply_type != AMQP_RESPONSE_NORMAL) {
+			logErrorResponse("set QoS", reply);
+			disposeConnection();
+			return false;
+		}
+	}
+	return true;
+}
+
 bool AMQPConnection::declareQueue(const string queueName)
 {
 	return m_impl->declareQueue(queueName);
@@ -575,12 +602,15 @@ bool AMQPConnection::startConsuming(void)
 		return false;
 	if (!m_impl->declareConsumerQueue())
 		return false;
+	if (!setQoS())
+		return false;
 
 	const amqp_bytes_t queue =
 		amqp_cstring_bytes(getConsumerQueueName().c_str());
 	const amqp_bytes_t consumer_tag = amqp_empty_bytes;
 	const amqp_boolean_t no_local = false;
-	const amqp_boolean_t no_ack = true;
+	const amqp_boolean_t no_ack =
+		!getConnectionInfo().isManualAckEnabled();
 	const amqp_boolean_t exclusive = false;
 	const amqp_table_t arguments = amqp_empty_table;
 	const amqp_basic_consume_ok_t *response;
@@ -605,6 +635,21 @@ bool AMQPConnection::startConsuming(void)
 }
 
 bool AMQPConnection::consume(AMQPMessage &message)
+{
+	struct timeval timeout = {
+		getTimeout(),
+		0
+	};
+	return consume(message, &timeout);
+}
+
+bool AMQPConnection::consumeIfReady(AMQPMessage &message)
+{
+	struct timeval timeout = {0, 0};
+	return consume(message, &timeout);
+}
+
+bool AMQPConnection::consume(AMQPMessage &message, struct timeval *timeout)
 {
 	if (!isConnected())
 		return false;
@@ -613,15 +658,11 @@ bool AMQPConnection::consume(AMQPMessage &message)
 
 	amqp_maybe_release_buffers(getConnection());
 
-	struct timeval timeout = {
-		getTimeout(),
-		0
-	};
 	const int flags = 0;
 	amqp_envelope_t envelope;
 	amqp_rpc_reply_t reply = amqp_consume_message(getConnection(),
 						      &envelope,
-						      &timeout,
+						      timeout,
 						      flags);
 	switch (reply.reply_type) {
 	case AMQP_RESPONSE_NORMAL:
@@ -634,6 +675,7 @@ bool AMQPConnection::consume(AMQPMessage &message)
 		  static_cast<int>(contentType->len));
 		message.body.assign(static_cast<char*>(body->bytes),
 				    static_cast<int>(body->len));
+		message.deliveryTag = envelope.delivery_tag;
 		amqp_destroy_envelope(&envelope);
 		break;
 	}
@@ -652,6 +694,42 @@ bool AMQPConnection::consume(AMQPMessage &message)
 	return true;
 }
 
+bool AMQPConnection::ack(const uint64_t &deliveryTag, const bool &multiple)
+{
+	if (!isConnected())
+		return false;
+
+	const int status = amqp_basic_ack(getConnection(),
+					  getChannel(),
+					  deliveryTag,
+					  multiple);
+	if (status != AMQP_STATUS_OK) {
+		m_impl->logErrorResponse("ack messages", status);
+		m_impl->disposeConnection();
+		return false;
+	}
+	return true;
+}
+
+bool AMQPConnection::nack(const uint64_t &deliveryTag, const bool &multiple,
+			  const bool &requeue)
+{
+	if (!isConnected())
+		return false;
+
+	const int status = amqp_basic_nack(getConnection(),
+					   getChannel(),
+					   deliveryTag,
+					   multiple,
+					   requeue);
+	if (status != AMQP_STATUS_OK) {
+		m_impl->logErrorResponse("nack messages", status);
+		m_impl->disposeConnection();
+		return false;
+	}
+	return true;
+}
+
 bool AMQPConnection::publish(const AMQPMessage &message)
 {
 	if (!isConnected())
@@ -693,6 +771,77 @@ bool AMQPConnection::publish(const AMQPMessage &message)
 	return true;
 }
 
+bool AMQPConnection::enableConfirm(void)
+{
+	if (!isConnected())
+		return false;
+
+	const amqp_confirm_select_ok_t *response;
+	response = amqp_confirm_select(getConnection(), getChannel());
+	if (!response) {
+		const amqp_rpc_reply_t reply =
+			amqp_get_rpc_reply(getConnection());
+		if (reply.reply_type != AMQP_RESPONSE_NORMAL) {
+			logErrorResponse("enable confirm", reply);
+			disposeConnection();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool AMQPConnection::waitConfirmation(AMQPConfirmation &confirmation,
+				      struct timeval *timeout)
+{
+	if (!isConnected())
+		return false;
+
+	amqp_maybe_release_buffers(getConnection());
+
+	amqp_frame_t frame;
+	const int status =
+	  amqp_simple_wait_frame_noblock(getConnection(), &frame, timeout);
+	if (status == AMQP_STATUS_TIMEOUT)
+		return false;
+	if (status != AMQP_STATUS_OK) {
+		m_impl->logErrorResponse("wait confirmation", status);
+		m_impl->disposeConnection();
+		return false;
+	}
+	if (frame.frame_type != AMQP_FRAME_METHOD)
+		return false;
+
+	switch (frame.payload.method.id) {
+	case AMQP_BASIC_ACK_METHOD:
+	{
+		const amqp_basic_ack_t *ack =
+		  static_cast<amqp_basic_ack_t *>(frame.payload.method.decoded);
+		confirmation.deliveryTag = ack->delivery_tag;
+		confirmation.multiple = ack->multiple;
+		confirmation.acked = true;
+		return true;
+	}
+	case AMQP_BASIC_NACK_METHOD:
+	{
+		const amqp_basic_nack_t *nack =
+		  static_cast<amqp_basic_nack_t *>(frame.payload.method.decoded);
+		confirmation.deliveryTag = nack->delivery_tag;
+		confirmation.multiple = nack->multiple;
+		confirmation.acked = false;
+		return true;
+	}
+	case AMQP_CHANNEL_CLOSE_METHOD:
+	case AMQP_CONNECTION_CLOSE_METHOD:
+		MLPL_ERR("The broker closed the connection "
+			 "while waiting confirmation.\n");
+		m_impl->disposeConnection();
+		return false;
+	default:
+		break;
+	}
+	return false;
+}
+
 bool AMQPConnection::purgeAllQueues(void)
 {
 	bool succeeded = true;
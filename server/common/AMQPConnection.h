@@ -20,6 +20,7 @@
 #define AMQPConnection_h
 
 #include "AMQPConnectionInfo.h"
+#include <vector>
 #include <glib.h>
 #include <unistd.h>
 #include <Logger.h>
@@ -35,6 +36,20 @@ typedef UsedCountablePtr<AMQPConnection> AMQPConnectionPtr;
 struct AMQPMessage {
 	std::string contentType;
 	std::string body;
+	uint64_t    deliveryTag;
+
+	AMQPMessage()
+	: deliveryTag(0)
+	{
+	}
+};
+
+typedef std::vector<AMQPMessage> AMQPMessageVect;
+
+struct AMQPConfirmation {
+	uint64_t deliveryTag;
+	bool     multiple;
+	bool     acked;
 };
 
 struct AMQPJSONMessage : public AMQPMessage {
@@ -58,7 +73,60 @@ public:
 	bool isConnected(void);
 	bool startConsuming(void);
 	bool consume(AMQPMessage &message);
+
+	/**
+	 * Consume a message only when it has already been delivered.
+	 *
+	 * @param message A message that receives the content.
+	 * @return true if a message is consumed. Otherwise false.
+	 */
+	bool consumeIfReady(AMQPMessage &message);
+
+	/**
+	 * Acknowledge consumed messages. This is meaningful only when
+	 * the manual ack is enabled in AMQPConnectionInfo.
+	 *
+	 * @param deliveryTag A delivery tag of the message.
+	 * @param multiple
+	 * If this is true, all messages up to deliveryTag are acknowledged.
+	 * @return true if the acknowledgement is sent. Otherwise false.
+	 */
+	bool ack(const uint64_t &deliveryTag, const bool &multiple = false);
+
+	/**
+	 * Negatively acknowledge consumed messages. The messages are
+	 * redelivered if requeue is true.
+	 *
+	 * @param deliveryTag A delivery tag of the message.
+	 * @param multiple
+	 * If this is true, all messages up to deliveryTag are rejected.
+	 * @param requeue If this is true, the messages are requeued.
+	 * @return true if the acknowledgement is sent. Otherwise false.
+	 */
+	bool nack(const uint64_t &deliveryTag, const bool &multiple = false,
+		  const bool &requeue = true);
 	bool publish(const AMQPMessage &message);
+
+	/**
+	 * Put the channel into the confirm mode. After this call,
+	 * the broker confirms each published message with a sequence
+	 * number starting from 1.
+	 *
+	 * @return true on success. Otherwise false.
+	 */
+	bool enableConfirm(void);
+
+	/**
+	 * Wait for a confirmation of published messages.
+	 *
+	 * @param confirmation A confirmation is stored in this.
+	 * @param timeout A timeout. NULL means no timeout.
+	 * @return
+	 * true if a confirmation is received. Otherwise false.
+	 * The connection is disposed if an error occurs.
+	 */
+	bool waitConfirmation(AMQPConfirmation &confirmation,
+			      struct timeval *timeout);
 	bool purgeAllQueues(void);
 	bool deleteAllQueues(void);
 
@@ -68,6 +136,8 @@ protected:
 	bool openSocket(void);
 	bool login(void);
 	bool openChannel(void);
+	bool setQoS(void);
+	bool consume(AMQPMessage &message, struct timeval *timeout);
 	bool declareQueue(const std::string queueName);
 	bool purgeQueue(const std::string queueName);
 	bool deleteQueue(const std::string queueName);
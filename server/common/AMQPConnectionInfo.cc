@@ -35,7 +35,9 @@ struct AMQPConnectionInfo::Impl {
 	Impl()
 	: m_URLBuf(NULL),
 	  m_parsedURL(),
-	  m_timeout(DEFAULT_TIMEOUT)
+	  m_timeout(DEFAULT_TIMEOUT),
+	  m_prefetchCount(0),
+	  m_manualAckEnabled(false)
 	{
 		amqp_default_connection_info(&m_parsedURL);
 		setURL(DEFAULT_URL);
@@ -54,6 +56,8 @@ struct AMQPConnectionInfo::Impl {
 		m_consumerQueueName = rhs.m_consumerQueueName;
 		m_publisherQueueName = rhs.m_publisherQueueName;
 		m_timeout = rhs.m_timeout;
+		m_prefetchCount = rhs.m_prefetchCount;
+		m_manualAckEnabled = rhs.m_manualAckEnabled;
 		m_tlsCertificatePath = rhs.m_tlsCertificatePath;
 		m_tlsKeyPath = rhs.m_tlsKeyPath;
 		m_tlsCACertificatePath = rhs.m_tlsCACertificatePath;
@@ -69,6 +73,8 @@ struct AMQPConnectionInfo::Impl {
 		m_consumerQueueName = rhs.m_consumerQueueName;
 		m_publisherQueueName = rhs.m_publisherQueueName;
 		m_timeout = rhs.m_timeout;
+		m_prefetchCount = rhs.m_prefetchCount;
+		m_manualAckEnabled = rhs.m_manualAckEnabled;
 		m_tlsCertificatePath = rhs.m_tlsCertificatePath;
 		m_tlsKeyPath = rhs.m_tlsKeyPath;
 		m_tlsCACertificatePath = rhs.m_tlsCACertificatePath;
@@ -98,6 +104,8 @@ struct AMQPConnectionInfo::Impl {
 	string m_consumerQueueName;
 	string m_publisherQueueName;
 	time_t m_timeout;
+	uint16_t m_prefetchCount;
+	bool m_manualAckEnabled;
 	string m_tlsCertificatePath;
 	string m_tlsKeyPath;
 	string m_tlsCACertificatePath;
@@ -206,6 +214,26 @@ void AMQPConnectionInfo::setTimeout(const time_t &timeout)
 	m_impl->m_timeout = timeout;
 }
 
+uint16_t AMQPConnectionInfo::getPrefetchCount(void) const
+{
+	return m_impl->m_prefetchCount;
+}
+
+void AMQPConnectionInfo::setPrefetchCount(const uint16_t &prefetchCount)
+{
+	m_impl->m_prefetchCount = prefetchCount;
+}
+
+bool AMQPConnectionInfo::isManualAckEnabled(void) const
+{
+	return m_impl->m_manualAckEnabled;
+}
+
+void AMQPConnectionInfo::setManualAckEnabled(const bool &enabled)
+{
+	m_impl->m_manualAckEnabled = enabled;
+}
+
 const string &AMQPConnectionInfo::getTLSCertificatePath(void) const
 {
 	return m_impl->m_tlsCertificatePath;
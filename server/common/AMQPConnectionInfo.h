@@ -22,6 +22,7 @@
 
 #include <string>
 #include <memory>
+#include <stdint.h>
 #include "Params.h"
 
 class AMQPConnectionInfo {
@@ -49,6 +50,21 @@ public:
 	time_t getTimeout(void) const;
 	void setTimeout(const time_t &timeout);
 
+	/**
+	 * The maximum number of unacknowledged messages that the broker
+	 * delivers to a consumer (basic.qos). 0 means no limit.
+	 */
+	uint16_t getPrefetchCount(void) const;
+	void setPrefetchCount(const uint16_t &prefetchCount);
+
+	/**
+	 * If this is enabled, a consumer acknowledges each message
+	 * explicitly after the message is handled. Otherwise the broker
+	 * regards a message as acknowledged when it is delivered.
+	 */
+	bool isManualAckEnabled(void) const;
+	void setManualAckEnabled(const bool &enabled);
+
 	const std::string &getTLSCertificatePath(void) const;
 	void setTLSCertificatePath(const std::string &path);
 
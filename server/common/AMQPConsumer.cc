@@ -22,6 +22,7 @@
 #include "AMQPConnectionInfo.h"
 #include "AMQPMessageHandler.h"
 #include <unistd.h>
+#include <algorithm>
 #include <Logger.h>
 #include <Reaper.h>
 #include <SimpleSemaphore.h>
@@ -39,7 +40,8 @@ struct AMQPConsumer::Impl {
 	: m_connection(NULL),
 	  m_handler(NULL),
 	  m_waitSem(0),
-	  m_connChangeCallback([](...){})
+	  m_connChangeCallback([](...){}),
+	  m_maxBatchSize(1)
 	{
 	}
 
@@ -51,6 +53,43 @@ struct AMQPConsumer::Impl {
 	AMQPMessageHandler *m_handler;
 	SimpleSemaphore m_waitSem;
 	ConnectionChangeCallback m_connChangeCallback;
+	size_t m_maxBatchSize;
+
+	void drain(AMQPMessageVect &messages)
+	{
+		while (messages.size() < m_maxBatchSize) {
+			AMQPMessage message;
+			if (!m_connection->consumeIfReady(message))
+				break;
+			messages.push_back(message);
+		}
+	}
+
+	void acknowledge(const AMQPMessageVect &messages,
+			 const vector<bool> &handled)
+	{
+		if (!m_connection->getConnectionInfo().isManualAckEnabled())
+			return;
+		if (!m_connection->isConnected())
+			return; // The messages will be redelivered.
+
+		if (find(handled.begin(), handled.end(), false) ==
+		    handled.end()) {
+			const bool multiple = true;
+			m_connection->ack(messages.back().deliveryTag,
+					  multiple);
+			return;
+		}
+
+		// Only the messages that aren't handled are redelivered.
+		for (size_t i = 0; i < messages.size(); i++) {
+			const uint64_t &tag = messages[i].deliveryTag;
+			if (handled[i])
+				m_connection->ack(tag);
+			else
+				m_connection->nack(tag);
+		}
+	}
 
 };
 
@@ -81,6 +120,11 @@ AMQPConnectionPtr AMQPConsumer::getConnection(void)
 	return m_impl->m_connection;
 }
 
+void AMQPConsumer::setMaxBatchSize(const size_t &maxBatchSize)
+{
+	m_impl->m_maxBatchSize = maxBatchSize;
+}
+
 void AMQPConsumer::setConnectionChangeCallback(ConnectionChangeCallback cb)
 {
 	m_impl->m_connChangeCallback = cb;
@@ -126,12 +170,16 @@ gpointer AMQPConsumer::mainThread(HatoholThreadArg *arg)
 		}
 
 		i = 0; // reset wait counter
-		AMQPMessage message;
-		const bool consumed = m_impl->m_connection->consume(message);
+		AMQPMessageVect messages(1);
+		const bool consumed =
+		  m_impl->m_connection->consume(messages.front());
 		if (!consumed)
 			continue;
+		m_impl->drain(messages);
 
-		m_impl->m_handler->handle(*this, message);
+		vector<bool> handled(messages.size(), true);
+		m_impl->m_handler->handleMessages(*this, messages, handled);
+		m_impl->acknowledge(messages, handled);
 	}
 	return NULL;
 }
@@ -45,6 +45,16 @@ public:
 	AMQPConnectionPtr getConnection(void);
 	void setConnectionChangeCallback(ConnectionChangeCallback cb);
 
+	/**
+	 * Set the maximum number of messages that are passed to
+	 * AMQPMessageHandler::handleMessages() at once. After a message
+	 * arrives, messages that have already been delivered are drained
+	 * up to this number. The default is 1.
+	 *
+	 * @param maxBatchSize The maximum number of messages.
+	 */
+	void setMaxBatchSize(const size_t &maxBatchSize);
+
 protected:
 	virtual gpointer mainThread(HatoholThreadArg *arg) override;
 
@@ -26,3 +26,11 @@ AMQPMessageHandler::AMQPMessageHandler()
 AMQPMessageHandler::~AMQPMessageHandler()
 {
 }
+
+void AMQPMessageHandler::handleMessages(AMQPConsumer &consumer,
+					const AMQPMessageVect &messages,
+					std::vector<bool> &handled)
+{
+	for (size_t i = 0; i < messages.size(); i++)
+		handled[i] = handle(consumer, messages[i]);
+}
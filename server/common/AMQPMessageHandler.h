@@ -33,6 +33,23 @@ public:
 
 	virtual bool handle(AMQPConsumer &consumer,
 			    const AMQPMessage &message) = 0;
+
+	/**
+	 * Handle messages that are consumed at once.
+	 * The default implementation calls handle() for each message.
+	 *
+	 * @param consumer An AMQPConsumer that consumed the messages.
+	 * @param messages Consumed messages in the order of delivery.
+	 * @param handled
+	 * The result of each message. It has the same size as messages and
+	 * all elements are true on the call. An element should be set to
+	 * false if the message isn't handled. When the manual ack is
+	 * enabled, such messages are redelivered and the others are
+	 * acknowledged.
+	 */
+	virtual void handleMessages(AMQPConsumer &consumer,
+				    const AMQPMessageVect &messages,
+				    std::vector<bool> &handled);
 };
 
 #endif // AMQPMessageHandler_h
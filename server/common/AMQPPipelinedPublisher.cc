@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <inttypes.h>
+#include <Logger.h>
+#include <SimpleSemaphore.h>
+#include "AMQPPipelinedPublisher.h"
+
+using namespace std;
+using namespace mlpl;
+
+const size_t AMQPPipelinedPublisher::DEFAULT_MAX_UNCONFIRMED = 64;
+const size_t AMQPPipelinedPublisher::DEFAULT_FLUSH_TIMEOUT_MSEC = 5000;
+
+static const size_t IDLE_WAIT_MSEC = 1000;
+static const size_t RETRY_INTERVAL_MSEC = 5000;
+
+struct AMQPPipelinedPublisher::Impl {
+	typedef pair<uint64_t, AMQPMessage> InFlightMessage;
+
+	AMQPConnectionPtr m_connection;
+	SimpleSemaphore m_waitSem;
+	// m_queueMutex protects m_queue and modifications of m_inFlight.
+	// m_inFlight is modified only in the publisher thread.
+	mutex m_queueMutex;
+	deque<AMQPMessage> m_queue;
+	deque<InFlightMessage> m_inFlight;
+	uint64_t m_nextSequenceNumber;
+	size_t m_maxUnconfirmed;
+	size_t m_flushTimeoutMSec;
+
+	Impl(const AMQPConnectionInfo &connectionInfo)
+	: m_connection(AMQPConnection::create(connectionInfo)),
+	  m_waitSem(0),
+	  m_nextSequenceNumber(1),
+	  m_maxUnconfirmed(DEFAULT_MAX_UNCONFIRMED),
+	  m_flushTimeoutMSec(DEFAULT_FLUSH_TIMEOUT_MSEC)
+	{
+	}
+
+	bool connect(void)
+	{
+		if (m_connection->isConnected())
+			return true;
+		if (!m_connection->connect())
+			return false;
+		if (!m_connection->enableConfirm())
+			return false;
+		m_nextSequenceNumber = 1;
+		return true;
+	}
+
+	bool popQueue(AMQPMessage &message)
+	{
+		lock_guard<mutex> lock(m_queueMutex);
+		if (m_queue.empty())
+			return false;
+		message = move(m_queue.front());
+		m_queue.pop_front();
+		return true;
+	}
+
+	bool hasQueuedMessages(void)
+	{
+		lock_guard<mutex> lock(m_queueMutex);
+		return !m_queue.empty();
+	}
+
+	// Move messages in flight back to the head of the queue to
+	// publish them again in the same order.
+	void requeue(deque<InFlightMessage>::iterator begin,
+	             deque<InFlightMessage>::iterator end)
+	{
+		lock_guard<mutex> lock(m_queueMutex);
+		auto it = end;
+		while (it != begin) {
+			--it;
+			m_queue.push_front(move(it->second));
+		}
+		m_inFlight.erase(begin, end);
+	}
+
+	void requeueAll(void)
+	{
+		requeue(m_inFlight.begin(), m_inFlight.end());
+	}
+
+	void publishQueuedMessages(void)
+	{
+		while (m_inFlight.size() < m_maxUnconfirmed) {
+			AMQPMessage message;
+			if (!popQueue(message))
+				return;
+			if (!m_connection->publish(message)) {
+				{
+					lock_guard<mutex> lock(m_queueMutex);
+					m_queue.push_front(move(message));
+				}
+				requeueAll();
+				return;
+			}
+			lock_guard<mutex> lock(m_queueMutex);
+			m_inFlight.push_back(
+			  InFlightMessage(m_nextSequenceNumber++,
+			                  move(message)));
+		}
+	}
+
+	void processConfirmation(const AMQPConfirmation &confirmation)
+	{
+		const uint64_t &tag = confirmation.deliveryTag;
+		auto begin = m_inFlight.begin();
+		auto end = begin;
+		if (confirmation.multiple) {
+			// All messages up to the tag are settled.
+			while (end != m_inFlight.end() && end->first <= tag)
+				++end;
+		} else {
+			// Only the message with the tag is settled. The
+			// confirmations of the earlier ones may come later.
+			begin = find_if(m_inFlight.begin(), m_inFlight.end(),
+			  [&](const InFlightMessage &inFlight) {
+				return inFlight.first == tag;
+			  });
+			if (begin == m_inFlight.end()) {
+				MLPL_WARN("Unknown confirmation: %" PRIu64 "\n",
+				          tag);
+				return;
+			}
+			end = begin + 1;
+		}
+		if (confirmation.acked) {
+			lock_guard<mutex> lock(m_queueMutex);
+			m_inFlight.erase(begin, end);
+		} else {
+			MLPL_WARN("Messages are rejected by the broker: "
+			          "%" PRIu64 "%s\n", tag,
+			          confirmation.multiple ? " (multiple)" : "");
+			requeue(begin, end);
+		}
+	}
+
+	void waitConfirmations(const size_t &timeoutMSec)
+	{
+		struct timeval timeout = {
+			static_cast<time_t>(timeoutMSec / 1000),
+			static_cast<suseconds_t>((timeoutMSec % 1000) * 1000)
+		};
+		AMQPConfirmation confirmation;
+		if (m_connection->waitConfirmation(confirmation, &timeout))
+			processConfirmation(confirmation);
+
+		// Process confirmations that have already arrived.
+		struct timeval noWait = {0, 0};
+		while (!m_inFlight.empty() &&
+		       m_connection->waitConfirmation(confirmation, &noWait)) {
+			processConfirmation(confirmation);
+		}
+		if (!m_connection->isConnected())
+			requeueAll();
+	}
+
+	void flush(void)
+	{
+		typedef chrono::steady_clock Clock;
+		const Clock::time_point deadline =
+		  Clock::now() + chrono::milliseconds(m_flushTimeoutMSec);
+		while (Clock::now() < deadline) {
+			if (!connect())
+				break;
+			publishQueuedMessages();
+			if (m_inFlight.empty() && !hasQueuedMessages())
+				return;
+			const size_t remainingMSec =
+			  chrono::duration_cast<chrono::milliseconds>(
+			    deadline - Clock::now()).count();
+			waitConfirmations(min(remainingMSec, IDLE_WAIT_MSEC));
+		}
+		size_t numLost = m_inFlight.size();
+		{
+			lock_guard<mutex> lock(m_queueMutex);
+			numLost += m_queue.size();
+		}
+		if (numLost > 0)
+			MLPL_ERR("Failed to publish %zd messages.\n", numLost);
+	}
+};
+
+AMQPPipelinedPublisher::AMQPPipelinedPublisher(
+  const AMQPConnectionInfo &connectionInfo)
+: m_impl(new Impl(connectionInfo))
+{
+}
+
+AMQPPipelinedPublisher::~AMQPPipelinedPublisher()
+{
+	requestExit();
+	m_impl->m_waitSem.post();
+	exitSync();
+}
+
+void AMQPPipelinedPublisher::push(const AMQPMessage &message)
+{
+	{
+		lock_guard<mutex> lock(m_impl->m_queueMutex);
+		m_impl->m_queue.push_back(message);
+	}
+	m_impl->m_waitSem.post();
+}
+
+size_t AMQPPipelinedPublisher::getNumberOfPendingMessages(void)
+{
+	lock_guard<mutex> lock(m_impl->m_queueMutex);
+	return m_impl->m_queue.size() + m_impl->m_inFlight.size();
+}
+
+void AMQPPipelinedPublisher::setMaxUnconfirmed(const size_t &maxUnconfirmed)
+{
+	m_impl->m_maxUnconfirmed = maxUnconfirmed;
+}
+
+void AMQPPipelinedPublisher::setFlushTimeout(const size_t &timeoutMSec)
+{
+	m_impl->m_flushTimeoutMSec = timeoutMSec;
+}
+
+gpointer AMQPPipelinedPublisher::mainThread(HatoholThreadArg *arg)
+{
+	while (!isExitRequested()) {
+		if (!m_impl->connect()) {
+			MLPL_ERR("Failed to connect. Try again after %zd ms.\n",
+			         RETRY_INTERVAL_MSEC);
+			m_impl->m_waitSem.timedWait(RETRY_INTERVAL_MSEC);
+			continue;
+		}
+
+		m_impl->publishQueuedMessages();
+		if (!m_impl->m_inFlight.empty()) {
+			// Wait shortly so that newly queued messages are
+			// published without waiting all confirmations.
+			const size_t timeoutMSec = 10;
+			m_impl->waitConfirmations(timeoutMSec);
+			continue;
+		}
+		if (m_impl->hasQueuedMessages())
+			continue;
+
+		m_impl->m_waitSem.timedWait(IDLE_WAIT_MSEC);
+		// Process frames such as heartbeats while idle.
+		m_impl->waitConfirmations(0);
+	}
+	m_impl->flush();
+	return NULL;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AMQPPipelinedPublisher_h
+#define AMQPPipelinedPublisher_h
+
+#include "HatoholThreadBase.h"
+#include "AMQPConnection.h"
+
+/**
+ * A publisher that sends queued messages on its own thread and
+ * connection.
+ *
+ * push() doesn't block. Messages are published back-to-back without
+ * waiting for each confirmation of the broker (publisher confirms).
+ * Unconfirmed messages are kept and published again when the broker
+ * rejects them or the connection is lost.
+ */
+class AMQPPipelinedPublisher : public HatoholThreadBase {
+public:
+	static const size_t DEFAULT_MAX_UNCONFIRMED;
+	static const size_t DEFAULT_FLUSH_TIMEOUT_MSEC;
+
+	AMQPPipelinedPublisher(const AMQPConnectionInfo &connectionInfo);
+	virtual ~AMQPPipelinedPublisher();
+
+	/**
+	 * Queue a message to be published. This method is MT-safe.
+	 *
+	 * @param message A message to be published.
+	 */
+	void push(const AMQPMessage &message);
+
+	/**
+	 * Get the number of messages that haven't been confirmed yet.
+	 *
+	 * @return The number of queued and unconfirmed messages.
+	 */
+	size_t getNumberOfPendingMessages(void);
+
+	/**
+	 * Set the maximum number of messages that are published before
+	 * their confirmations arrive. It should be called before start().
+	 *
+	 * @param maxUnconfirmed The maximum number of messages.
+	 */
+	void setMaxUnconfirmed(const size_t &maxUnconfirmed);
+
+	/**
+	 * Set how long the remaining messages are tried to be published
+	 * when the publisher stops. The messages that aren't confirmed by
+	 * then are dropped. It should be called before start().
+	 *
+	 * @param timeoutMSec The timeout in milliseconds.
+	 */
+	void setFlushTimeout(const size_t &timeoutMSec);
+
+protected:
+	virtual gpointer mainThread(HatoholThreadArg *arg) override;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // AMQPPipelinedPublisher_h
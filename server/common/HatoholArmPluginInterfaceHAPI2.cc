@@ -21,6 +21,7 @@
 #include "AMQPConnectionInfo.h"
 #include "AMQPConsumer.h"
 #include "AMQPPublisher.h"
+#include "AMQPPipelinedPublisher.h"
 #include "HatoholArmPluginInterfaceHAPI2.h"
 #include "JSONBuilder.h"
 #include <mutex>
@@ -28,6 +29,11 @@
 using namespace std;
 using namespace mlpl;
 
+// The server receives messages from a plugin in bursts. These allow the
+// messages to be handled together, e.g. in a single DB transaction.
+static const uint16_t AMQP_PREFETCH_COUNT = 100;
+static const size_t   AMQP_MAX_BATCH_SIZE = 50;
+
 std::list<HAPI2ProcedureDef> defaultValidProcedureList = {
 	{BOTH,   PROCEDURE,    HAPI2_EXCHANGE_PROFILE,          MANDATORY},
 	{SERVER, PROCEDURE,    HAPI2_MONITORING_SERVER_INFO,    MANDATORY},
@@ -63,7 +69,7 @@ struct JSONRPCObject {
 	string m_errorMessage;
 
 	JSONRPCObject(const string &json)
-	: m_parser(json), m_type(Type::INVALID)
+	: m_parser(json, JSONParser::BACKEND_IN_SITU), m_type(Type::INVALID)
 	{
 		parse(m_parser);
 	}
@@ -210,18 +216,63 @@ class HatoholArmPluginInterfaceHAPI2::AMQPHAPI2MessageHandler
 {
 public:
 	AMQPHAPI2MessageHandler(HatoholArmPluginInterfaceHAPI2 &hapi2)
-	: m_hapi2(hapi2)
+	: m_hapi2(hapi2),
+	  m_messageDeferred(false),
+	  m_deferredTicket(0)
 	{
 	}
 
 	bool handle(AMQPConsumer &consumer, const AMQPMessage &message)
+	{
+		AMQPMessageVect messages;
+		messages.push_back(message);
+		vector<bool> handled(messages.size(), true);
+		handleMessages(consumer, messages, handled);
+		return handled.front();
+	}
+
+	void handleMessages(AMQPConsumer &consumer,
+			    const AMQPMessageVect &messages,
+			    vector<bool> &handled) override
+	{
+		// The deferred data of the messages are stored while the
+		// following messages are handled. The responses are sent
+		// and the messages are acknowledged only after the data
+		// are stored.
+		const size_t numMessages = messages.size();
+		vector<AMQPJSONMessage> responses(numMessages);
+		vector<bool> hasResponse(numMessages, false);
+		vector<bool> deferred(numMessages, false);
+		vector<uint64_t> tickets(numMessages, 0);
+		for (size_t i = 0; i < numMessages; i++) {
+			m_messageDeferred = false;
+			hasResponse[i] = handleMessage(messages[i],
+						       responses[i]);
+			deferred[i] = m_messageDeferred;
+			tickets[i] = m_deferredTicket;
+		}
+		m_messageDeferred = false;
+		for (size_t i = 0; i < numMessages; i++) {
+			if (deferred[i] &&
+			    !m_hapi2.waitDeferredMessage(tickets[i])) {
+				// Only the messages whose data haven't been
+				// stored are redelivered and responded then.
+				handled[i] = false;
+				continue;
+			}
+			if (hasResponse[i])
+				sendResponse(consumer, responses[i]);
+		}
+	}
+
+	bool handleMessage(const AMQPMessage &message,
+			   AMQPJSONMessage &response)
 	{
 		MLPL_DBG("message: <%s>/<%s>\n",
 			 message.contentType.c_str(),
 			 message.body.c_str());
 
 		JSONRPCObject object(message.body);
-		AMQPJSONMessage response;
 
 		if (object.m_parser.hasError()) {
 			response.body =
@@ -230,7 +281,6 @@ public:
 						     NULL);
 			MLPL_WARN("Invalid JSON: %s\n",
 				  object.m_errorMessage.c_str());
-			sendResponse(consumer, response);
 			return true;
 		}
 
@@ -239,8 +289,7 @@ public:
 			response.body = m_hapi2.interpretHandler(
 					  object.m_methodName,
 					  object.m_parser);
-			sendResponse(consumer, response);
-			break;
+			return true;
 		case JSONRPCObject::Type::NOTIFICATION:
 			m_hapi2.interpretHandler(object.m_methodName,
 						 object.m_parser);
@@ -257,29 +306,28 @@ public:
 						     &object.m_parser);
 			MLPL_WARN("Invalid JSON-RPC object: %s\n",
 				  object.m_errorMessage.c_str());
-			sendResponse(consumer, response);
-			break;
+			return true;
 		}
 
-		return true;
+		return false;
 	}
 
 	void sendResponse(AMQPConsumer &consumer,
 			  const AMQPJSONMessage &response)
 	{
-		AMQPConnectionPtr connectionPtr = consumer.getConnection();
-		AMQPPublisher publisher(connectionPtr);
-		publisher.setMessage(response);
-		bool succeeded = false;
-		do {
-			succeeded = publisher.publish();
-			if (!succeeded)
-				sleep(1);
-		} while (!succeeded && !consumer.isExitRequested());
+		m_hapi2.send(response.body);
+	}
+
+	void markMessageDeferred(const uint64_t &ticket)
+	{
+		m_messageDeferred = true;
+		m_deferredTicket = ticket;
 	}
 
 private:
 	HatoholArmPluginInterfaceHAPI2 &m_hapi2;
+	bool m_messageDeferred;
+	uint64_t m_deferredTicket;
 };
 
 struct HatoholArmPluginInterfaceHAPI2::Impl
@@ -302,6 +350,7 @@ struct HatoholArmPluginInterfaceHAPI2::Impl
 	map<string, ProcedureCallContextPtr> m_procedureCallContextMap;
 	AMQPConnectionInfo m_connectionInfo;
 	AMQPConsumer *m_consumer;
+	AMQPPipelinedPublisher *m_publisher;
 	AMQPHAPI2MessageHandler m_handler;
 
 	Impl(HatoholArmPluginInterfaceHAPI2 &hapi2,
@@ -310,6 +359,7 @@ struct HatoholArmPluginInterfaceHAPI2::Impl
 	  m_hapi2(hapi2),
 	  m_established(false),
 	  m_consumer(NULL),
+	  m_publisher(NULL),
 	  m_handler(m_hapi2)
 	{
 	}
@@ -356,6 +406,10 @@ struct HatoholArmPluginInterfaceHAPI2::Impl
 		info.setTLSKeyPath(m_pluginInfo.tlsKeyPath);
 		info.setTLSCACertificatePath(m_pluginInfo.tlsCACertificatePath);
 		info.setTLSVerifyEnabled(m_pluginInfo.isTLSVerifyEnabled());
+		if (m_communicationMode == MODE_SERVER) {
+			info.setPrefetchCount(AMQP_PREFETCH_COUNT);
+			info.setManualAckEnabled(true);
+		}
 	}
 
 	void setupAMQPConnection(void)
@@ -363,6 +417,9 @@ struct HatoholArmPluginInterfaceHAPI2::Impl
 		setupAMQPConnectionInfo();
 
 		m_consumer = new AMQPConsumer(m_connectionInfo, &m_handler);
+		m_publisher = new AMQPPipelinedPublisher(m_connectionInfo);
+		if (m_communicationMode == MODE_SERVER)
+			m_consumer->setMaxBatchSize(AMQP_MAX_BATCH_SIZE);
 
 		auto connCb = [&](const AMQPConsumer::ConnectionStatus &stat) {
 			if (stat == AMQPConsumer::CONN_ESTABLISHED)
@@ -388,6 +445,7 @@ struct HatoholArmPluginInterfaceHAPI2::Impl
 			onConnectFailure();
 			return;
 		}
+		m_publisher->start();
 		m_consumer->start();
 	}
 
@@ -454,6 +512,11 @@ struct HatoholArmPluginInterfaceHAPI2::Impl
 			delete m_consumer;
 			m_consumer = nullptr;
 		}
+		if (m_publisher) {
+			// The destructor publishes the rest of the messages.
+			delete m_publisher;
+			m_publisher = nullptr;
+		}
 	}
 
 	void onConnect(void)
@@ -552,10 +615,15 @@ void HatoholArmPluginInterfaceHAPI2::stop(void)
 
 void HatoholArmPluginInterfaceHAPI2::send(const std::string &message)
 {
-	// TODO: Should use only one conection per one thread
-	AMQPPublisher publisher(m_impl->m_connectionInfo);
 	AMQPJSONMessage amqpMessage;
 	amqpMessage.body = message;
+	if (m_impl->m_publisher) {
+		m_impl->m_publisher->push(amqpMessage);
+		return;
+	}
+
+	// Not started yet
+	AMQPPublisher publisher(m_impl->m_connectionInfo);
 	publisher.setMessage(amqpMessage);
 	publisher.publish();
 }
@@ -656,6 +724,18 @@ void HatoholArmPluginInterfaceHAPI2::onConnect(void)
 {
 }
 
+bool HatoholArmPluginInterfaceHAPI2::waitDeferredMessage(
+  const uint64_t &ticket)
+{
+	return true;
+}
+
+void HatoholArmPluginInterfaceHAPI2::markMessageDeferred(
+  const uint64_t &ticket)
+{
+	m_impl->m_handler.markMessageDeferred(ticket);
+}
+
 void HatoholArmPluginInterfaceHAPI2::onConnectFailure(void)
 {
 }
@@ -22,6 +22,7 @@
 
 #include <string>
 #include <random>
+#include <stdint.h>
 #include "HatoholThreadBase.h"
 #include "HatoholException.h"
 #include "JSONParser.h"
@@ -197,6 +198,29 @@ protected:
 	virtual void onConnect(void);
 	virtual void onConnectFailure(void);
 
+	/**
+	 * Wait for the data of a message marked by markMessageDeferred()
+	 * to be stored. It's called after all messages consumed at once
+	 * are handled, and the response to the message is sent after
+	 * this method returns.
+	 *
+	 * @param ticket The ticket passed to markMessageDeferred().
+	 *
+	 * @return
+	 * true if the data are stored successfully. Otherwise the message
+	 * isn't acknowledged nor responded, so that it is redelivered when
+	 * the manual ack is enabled.
+	 */
+	virtual bool waitDeferredMessage(const uint64_t &ticket);
+
+	/**
+	 * Mark the message being handled as one whose data are stored
+	 * asynchronously. A handler that defers storing has to call this.
+	 *
+	 * @param ticket A value to identify the data on waitDeferredMessage().
+	 */
+	void markMessageDeferred(const uint64_t &ticket);
+
 private:
 	class AMQPHAPI2MessageHandler;
 	struct Impl;
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2013 Project Hatohol
+ * Copyright (C) 2013-2016 Project Hatohol
  *
  * This file is part of Hatohol.
  *
@@ -17,103 +17,213 @@
  * <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+#include <inttypes.h>
 #include "JSONBuilder.h"
+#include "HatoholException.h"
 using namespace std;
 
+const size_t JSONBuilder::DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+// The escaped strings of characters. NULL means no escape is needed.
+struct JSONEscapeTable {
+	const char *escaped[256];
+	char        buf[0x20][7];
+
+	JSONEscapeTable(void)
+	{
+		memset(escaped, 0, sizeof(escaped));
+		for (int i = 0; i < 0x20; i++) {
+			snprintf(buf[i], sizeof(buf[i]), "\\u%04x", i);
+			escaped[i] = buf[i];
+		}
+		escaped[(unsigned char)'"']  = "\\\"";
+		escaped[(unsigned char)'\\'] = "\\\\";
+		escaped[(unsigned char)'\b'] = "\\b";
+		escaped[(unsigned char)'\f'] = "\\f";
+		escaped[(unsigned char)'\n'] = "\\n";
+		escaped[(unsigned char)'\r'] = "\\r";
+		escaped[(unsigned char)'\t'] = "\\t";
+	}
+};
+
+static const JSONEscapeTable escapeTable;
+
 // ---------------------------------------------------------------------------
 // Public methods
 // ---------------------------------------------------------------------------
 JSONBuilder::JSONBuilder(void)
+: m_chunkSize(0)
+{
+}
+
+JSONBuilder::JSONBuilder(const ChunkSink &sink, const size_t &chunkSize)
+: m_sink(sink),
+  m_chunkSize(chunkSize)
 {
-	m_builder = json_builder_new();
+	m_buffer.reserve(chunkSize);
 }
 
 JSONBuilder::~JSONBuilder()
 {
-	if (m_builder)
-		g_object_unref(m_builder);
 }
 
 string JSONBuilder::generate(void)
 {
-	JsonGenerator *generator = json_generator_new();
-	JsonNode *root = json_builder_get_root(m_builder);
-	json_generator_set_root(generator, root);
-
-	gchar *str = json_generator_to_data(generator, NULL);
-	string json_str = str;
-
-	g_free(str);
-	json_node_free(root);
-	g_object_unref(generator);
+	if (!m_sink)
+		return m_buffer;
+	if (!m_buffer.empty()) {
+		m_sink(m_buffer.data(), m_buffer.size());
+		m_buffer.clear();
+	}
+	return string();
+}
 
-	return json_str;
+void JSONBuilder::moveTo(string &dest)
+{
+	dest.clear();
+	dest.swap(m_buffer);
 }
 
 void JSONBuilder::startObject(const char *member)
 {
-	if (member)
-		json_builder_set_member_name(m_builder, member);
-	json_builder_begin_object(m_builder);
+	startValue(member);
+	m_buffer += '{';
+	Container container = {CONTAINER_OBJECT, true};
+	m_containerStack.push_back(container);
 }
 
 void JSONBuilder::startObject(const string &member)
 {
-        startObject(member.c_str());
+	startObject(member.c_str());
 }
 
 void JSONBuilder::endObject(void)
 {
-	json_builder_end_object(m_builder);
+	HATOHOL_ASSERT(!m_containerStack.empty() &&
+	               m_containerStack.back().type == CONTAINER_OBJECT,
+	               "No object to be closed.");
+	m_containerStack.pop_back();
+	m_buffer += '}';
+	flushIfNeeded();
 }
 
 void JSONBuilder::startArray(const string &member)
 {
-	json_builder_set_member_name(m_builder, member.c_str());
-	json_builder_begin_array(m_builder);
+	startValue(member.c_str());
+	m_buffer += '[';
+	Container container = {CONTAINER_ARRAY, true};
+	m_containerStack.push_back(container);
 }
 
 void JSONBuilder::endArray(void)
 {
-	json_builder_end_array(m_builder);
+	HATOHOL_ASSERT(!m_containerStack.empty() &&
+	               m_containerStack.back().type == CONTAINER_ARRAY,
+	               "No array to be closed.");
+	m_containerStack.pop_back();
+	m_buffer += ']';
+	flushIfNeeded();
 }
 
 void JSONBuilder::addNull(const string &member)
 {
-	json_builder_set_member_name(m_builder, member.c_str());
-	json_builder_add_null_value(m_builder);
+	startValue(member.c_str());
+	m_buffer += "null";
+	flushIfNeeded();
 }
 
 void JSONBuilder::add(const string &member, const string &value)
 {
-	json_builder_set_member_name(m_builder, member.c_str());
-	json_builder_add_string_value(m_builder, value.c_str());
+	startValue(member.c_str());
+	appendString(value.c_str(), value.size());
+	flushIfNeeded();
 }
 
 void JSONBuilder::add(const string &member, gint64 value)
 {
-	json_builder_set_member_name(m_builder, member.c_str());
-	json_builder_add_int_value(m_builder, value);
+	startValue(member.c_str());
+	appendInteger(value);
+	flushIfNeeded();
 }
 
 void JSONBuilder::add(const gint64 value)
 {
-	json_builder_add_int_value(m_builder, value);
+	startValue(NULL);
+	appendInteger(value);
+	flushIfNeeded();
 }
 
 void JSONBuilder::add(const string &value)
 {
-	json_builder_add_string_value(m_builder, value.c_str());
+	startValue(NULL);
+	appendString(value.c_str(), value.size());
+	flushIfNeeded();
 }
 
 void JSONBuilder::addTrue(const string &member)
 {
-	json_builder_set_member_name(m_builder, member.c_str());
-	json_builder_add_boolean_value(m_builder, TRUE);
+	startValue(member.c_str());
+	m_buffer += "true";
+	flushIfNeeded();
 }
 
 void JSONBuilder::addFalse(const string &member)
 {
-	json_builder_set_member_name(m_builder, member.c_str());
-	json_builder_add_boolean_value(m_builder, FALSE);
+	startValue(member.c_str());
+	m_buffer += "false";
+	flushIfNeeded();
+}
+
+// ---------------------------------------------------------------------------
+// Protected methods
+// ---------------------------------------------------------------------------
+void JSONBuilder::startValue(const char *member)
+{
+	if (m_containerStack.empty())
+		return;
+	Container &container = m_containerStack.back();
+	if (!container.empty)
+		m_buffer += ',';
+	container.empty = false;
+	// A member name is meaningful only in an object.
+	if (container.type == CONTAINER_OBJECT && member) {
+		appendString(member, strlen(member));
+		m_buffer += ':';
+	}
+}
+
+void JSONBuilder::appendString(const char *str, const size_t &length)
+{
+	m_buffer += '"';
+	// Characters that don't have to be escaped (i.e. most of ASCII and
+	// all multibyte UTF-8 sequences) are copied in a block.
+	const char *head = str;
+	const char *end = str + length;
+	for (const char *p = str; p < end; p++) {
+		const char *escaped = escapeTable.escaped[(unsigned char)*p];
+		if (!escaped)
+			continue;
+		m_buffer.append(head, p - head);
+		m_buffer += escaped;
+		head = p + 1;
+	}
+	m_buffer.append(head, end - head);
+	m_buffer += '"';
+}
+
+void JSONBuilder::appendInteger(const gint64 &value)
+{
+	char buf[32];
+	const int length = snprintf(buf, sizeof(buf), "%" PRId64,
+	                            (int64_t)value);
+	m_buffer.append(buf, length);
+}
+
+void JSONBuilder::flushIfNeeded(void)
+{
+	if (!m_sink || m_buffer.size() < m_chunkSize)
+		return;
+	m_sink(m_buffer.data(), m_buffer.size());
+	m_buffer.clear();
 }
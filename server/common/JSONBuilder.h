@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2013 Project Hatohol
+ * Copyright (C) 2013-2016 Project Hatohol
  *
  * This file is part of Hatohol.
  *
@@ -21,14 +21,59 @@
 #define JSONBuilder_h
 
 #include <string>
-#include <json-glib/json-glib.h>
+#include <vector>
+#include <functional>
+#include <glib.h>
 
+/**
+ * An append-only JSON writer.
+ *
+ * The output is directly written into a buffer without building a tree.
+ * Member names and values are output in the order they are added.
+ */
 class JSONBuilder
 {
 public:
+	/**
+	 * A function that receives the output in chunks.
+	 */
+	typedef std::function<void (const char *data, const size_t &size)>
+	  ChunkSink;
+
+	static const size_t DEFAULT_CHUNK_SIZE;
+
 	JSONBuilder(void);
+
+	/**
+	 * Create an instance that passes the output to the sink every time
+	 * the buffered output exceeds chunkSize. The rest is passed in
+	 * generate().
+	 *
+	 * @param sink A function that receives the output.
+	 * @param chunkSize A threshold size to call the sink.
+	 */
+	JSONBuilder(const ChunkSink &sink,
+	            const size_t &chunkSize = DEFAULT_CHUNK_SIZE);
 	~JSONBuilder();
+
+	/**
+	 * Get the output.
+	 *
+	 * If the instance is created with a ChunkSink, the rest of the output
+	 * is passed to the sink and an empty string is returned.
+	 *
+	 * @return A JSON string.
+	 */
 	std::string generate(void);
+
+	/**
+	 * Move the output to the given string without copy.
+	 * The buffer of this instance becomes empty.
+	 *
+	 * @param dest A string that receives the output.
+	 */
+	void moveTo(std::string &dest);
+
 	void startObject(const char *member = NULL);
 	void startObject(const std::string &member);
 	void endObject(void);
@@ -42,8 +87,26 @@ public:
 	void addFalse(const std::string &member);
 	void addNull(const std::string &member);
 
+protected:
+	void startValue(const char *member);
+	void appendString(const char *str, const size_t &length);
+	void appendInteger(const gint64 &value);
+	void flushIfNeeded(void);
+
 private:
-	JsonBuilder *m_builder;
+	enum ContainerType {
+		CONTAINER_OBJECT,
+		CONTAINER_ARRAY,
+	};
+	struct Container {
+		ContainerType type;
+		bool          empty;
+	};
+
+	std::string            m_buffer;
+	std::vector<Container> m_containerStack;
+	ChunkSink              m_sink;
+	size_t                 m_chunkSize;
 };
 
 #endif // JSONBuilder_h
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2013,2015 Project Hatohol
+ * Copyright (C) 2013,2015-2016 Project Hatohol
  *
  * This file is part of Hatohol.
  *
@@ -19,19 +19,47 @@
 
 #include <Logger.h>
 #include <string.h>
+#include <errno.h>
+#include <ctype.h>
 #include <stdexcept>
+#include <vector>
 #include "JSONParser.h"
 using namespace std;
 using namespace mlpl;
 
 struct JSONParser::Impl
+{
+	virtual ~Impl()
+	{
+	}
+
+	virtual const char *getErrorMessage(void) = 0;
+	virtual bool hasError(void) = 0;
+	virtual bool hasCurrentNode(void) = 0;
+	virtual ValueType getValueType(void) = 0;
+	virtual bool getBoolean(void) = 0;
+	virtual int64_t getInt(void) = 0;
+	virtual double getDouble(void) = 0;
+	virtual void getString(StringView &dest) = 0;
+	virtual bool isMember(const string &member) = 0;
+	virtual void getMemberNames(set<string> &members) = 0;
+	virtual void startObject(const string &member) = 0;
+	virtual void endObject(void) = 0;
+	virtual bool startElement(const unsigned int &index) = 0;
+	virtual unsigned int countElements(void) = 0;
+};
+
+// ---------------------------------------------------------------------------
+// JSONGLibImpl
+// ---------------------------------------------------------------------------
+struct JSONParser::JSONGLibImpl : public JSONParser::Impl
 {
 	JsonParser *parser;
 	JsonNode *currentNode;
 	JsonNode *previousNode;
 	GError *error;
 
-	Impl(const string &data)
+	JSONGLibImpl(const string &data)
 	: parser(NULL),
 	  currentNode(NULL),
 	  previousNode(NULL),
@@ -43,21 +71,775 @@ struct JSONParser::Impl
 		currentNode = json_parser_get_root(parser);
 	}
 
-	virtual ~Impl()
+	virtual ~JSONGLibImpl()
 	{
 		if (error)
 			g_error_free(error);
 		if (parser)
 			g_object_unref(parser);
 	}
+
+	virtual const char *getErrorMessage(void) override
+	{
+		if (!error)
+			return "No error";
+		return error->message;
+	}
+
+	virtual bool hasError(void) override
+	{
+		return error != NULL;
+	}
+
+	virtual bool hasCurrentNode(void) override
+	{
+		return currentNode;
+	}
+
+	virtual ValueType getValueType(void) override
+	{
+		ValueType type = VALUE_TYPE_UNKNOWN;
+		JsonNodeType nodeType = json_node_get_node_type(currentNode);
+		switch (nodeType) {
+		case JSON_NODE_OBJECT:
+			type = VALUE_TYPE_OBJECT;
+			break;
+		case JSON_NODE_ARRAY:
+			type = VALUE_TYPE_ARRAY;
+			break;
+		case JSON_NODE_VALUE:
+		{
+			GType gtype = json_node_get_value_type(currentNode);
+			switch(gtype) {
+			case G_TYPE_INVALID:
+				type = VALUE_TYPE_NULL;
+				break;
+			case G_TYPE_BOOLEAN:
+				type = VALUE_TYPE_BOOLEAN;
+				break;
+			case G_TYPE_INT64:
+				type = VALUE_TYPE_INT64;
+				break;
+			case G_TYPE_DOUBLE:
+				type = VALUE_TYPE_DOUBLE;
+				break;
+			case G_TYPE_STRING:
+				type = VALUE_TYPE_STRING;
+				break;
+			default:
+				break;
+			}
+			break;
+		}
+		case JSON_NODE_NULL:
+			type = VALUE_TYPE_NULL;
+			break;
+		default:
+			break;
+		};
+		return type;
+	}
+
+	virtual bool getBoolean(void) override
+	{
+		return json_node_get_boolean(currentNode);
+	}
+
+	virtual int64_t getInt(void) override
+	{
+		return json_node_get_int(currentNode);
+	}
+
+	virtual double getDouble(void) override
+	{
+		return json_node_get_double(currentNode);
+	}
+
+	virtual void getString(StringView &dest) override
+	{
+		const gchar *str = json_node_get_string(currentNode);
+		dest.data = str ? str : "";
+		dest.size = strlen(dest.data);
+	}
+
+	virtual bool isMember(const string &member) override
+	{
+		JsonObject *object = json_node_get_object(currentNode);
+		return json_object_has_member(object, member.c_str());
+	}
+
+	virtual void getMemberNames(set<string> &members) override
+	{
+		auto memberCollector = [] (gpointer data, gpointer priv) {
+			const gchar *name = static_cast<const gchar *>(data);
+			set<string> *members = static_cast<set<string> *>(priv);
+			members->insert(name);
+		};
+
+		JsonObject *obj = json_node_get_object(currentNode);
+		GList *memberList = json_object_get_members(obj);
+		g_list_foreach(memberList, memberCollector, &members);
+		g_list_free(memberList);
+	}
+
+	virtual void startObject(const string &member) override
+	{
+		JsonObject *object = json_node_get_object(currentNode);
+		previousNode = currentNode;
+		currentNode = json_object_get_member(object, member.c_str());
+	}
+
+	virtual void endObject(void) override
+	{
+		JsonNode *tmp;
+
+		if (previousNode != NULL)
+			tmp = json_node_get_parent(previousNode);
+		else
+			tmp = NULL;
+
+		currentNode = previousNode;
+		previousNode = tmp;
+	}
+
+	virtual bool startElement(const unsigned int &index) override
+	{
+		switch (json_node_get_node_type(currentNode)) {
+		case JSON_NODE_ARRAY: {
+			JsonArray * array = json_node_get_array(currentNode);
+
+			if (index >= json_array_get_length(array)) {
+				MLPL_DBG("The index '%d' is greater than the size of "
+					"the array at the current position.\n", index);
+				return false;
+			}
+
+			previousNode = currentNode;
+			currentNode = json_array_get_element(array, index);
+		}
+		break;
+		case JSON_NODE_OBJECT: {
+			JsonObject *object = json_node_get_object(currentNode);
+			GList *members;
+			const gchar *name;
+
+			if(index >= json_object_get_size(object)) {
+				MLPL_DBG("The index '%d' is greater than the size of "
+					"the array at the current position.\n", index);
+				return false;
+			}
+
+			previousNode = currentNode;
+			members = json_object_get_members(object);
+			name = static_cast<gchar *>(g_list_nth_data(members, index));
+			currentNode = json_object_get_member(object, name);
+
+			g_list_free(members);
+		}
+		break;
+		default:
+			HATOHOL_ASSERT(false, "The node isn't neither JSON_NODE_ARRAY nor JSON_NODE_OBJECT.");
+			return false;
+		}
+
+		return true;
+	}
+
+	virtual unsigned int countElements(void) override
+	{
+		return json_array_get_length(json_node_get_array(currentNode));
+	}
+};
+
+// ---------------------------------------------------------------------------
+// InSituImpl
+// ---------------------------------------------------------------------------
+static const size_t INVALID_INDEX = SIZE_MAX;
+static const size_t MAX_DEPTH = 512;
+
+struct JSONParser::InSituImpl : public JSONParser::Impl
+{
+
+	// A node of the parsed data. The nodes are stored in document order,
+	// so the children of a container follow it and 'end' points to the
+	// node just after the last descendant.
+	struct Node {
+		ValueType   type;
+		size_t      parent;
+		size_t      end;
+		size_t      numChildren;
+		const char *name;
+		size_t      nameLength;
+		const char *str;
+		size_t      strLength;
+		union {
+			bool    boolean;
+			int64_t integer;
+			double  real;
+		};
+	};
+
+	string         buffer;
+	vector<Node>   nodes;
+	size_t         currentNode;
+	string         errorMessage;
+	const char    *head;
+	const char    *tail;
+
+	// The last child accessed by startElement(). It makes reading
+	// elements in order O(1) per element.
+	size_t         cachedParent;
+	size_t         cachedIndex;
+	size_t         cachedChild;
+
+	InSituImpl(const string &data)
+	: buffer(data),
+	  currentNode(INVALID_INDEX),
+	  head(NULL),
+	  tail(NULL),
+	  cachedParent(INVALID_INDEX),
+	  cachedIndex(0),
+	  cachedChild(INVALID_INDEX)
+	{
+		char *p = &buffer[0];
+		head = p;
+		tail = p + buffer.size();
+		nodes.reserve(buffer.size() / 16 + 1);
+
+		skipWhitespace(p);
+		if (p == tail) {
+			setError(p, "Empty data");
+			return;
+		}
+		if (!parseValue(p, INVALID_INDEX, NULL, 0, 0))
+			return;
+		skipWhitespace(p);
+		if (p != tail) {
+			setError(p, "Unexpected data after the root value");
+			return;
+		}
+		currentNode = 0;
+	}
+
+	virtual const char *getErrorMessage(void) override
+	{
+		if (errorMessage.empty())
+			return "No error";
+		return errorMessage.c_str();
+	}
+
+	virtual bool hasError(void) override
+	{
+		return !errorMessage.empty();
+	}
+
+	virtual bool hasCurrentNode(void) override
+	{
+		return currentNode != INVALID_INDEX;
+	}
+
+	virtual ValueType getValueType(void) override
+	{
+		return current().type;
+	}
+
+	virtual bool getBoolean(void) override
+	{
+		const Node &node = current();
+		switch (node.type) {
+		case VALUE_TYPE_BOOLEAN:
+			return node.boolean;
+		case VALUE_TYPE_INT64:
+			return node.integer != 0;
+		case VALUE_TYPE_DOUBLE:
+			return node.real != 0.0;
+		default:
+			return false;
+		}
+	}
+
+	virtual int64_t getInt(void) override
+	{
+		const Node &node = current();
+		switch (node.type) {
+		case VALUE_TYPE_BOOLEAN:
+			return node.boolean;
+		case VALUE_TYPE_INT64:
+			return node.integer;
+		case VALUE_TYPE_DOUBLE:
+			return node.real;
+		default:
+			return 0;
+		}
+	}
+
+	virtual double getDouble(void) override
+	{
+		const Node &node = current();
+		switch (node.type) {
+		case VALUE_TYPE_BOOLEAN:
+			return node.boolean;
+		case VALUE_TYPE_INT64:
+			return node.integer;
+		case VALUE_TYPE_DOUBLE:
+			return node.real;
+		default:
+			return 0.0;
+		}
+	}
+
+	virtual void getString(StringView &dest) override
+	{
+		const Node &node = current();
+		if (node.type != VALUE_TYPE_STRING) {
+			dest = StringView();
+			return;
+		}
+		dest.data = node.str;
+		dest.size = node.strLength;
+	}
+
+	virtual bool isMember(const string &member) override
+	{
+		return findMember(member) != INVALID_INDEX;
+	}
+
+	virtual void getMemberNames(set<string> &members) override
+	{
+		const Node &node = current();
+		if (node.type != VALUE_TYPE_OBJECT)
+			return;
+		size_t child = currentNode + 1;
+		for (size_t i = 0; i < node.numChildren; i++) {
+			const Node &childNode = nodes[child];
+			members.insert(string(childNode.name,
+			                      childNode.nameLength));
+			child = childNode.end;
+		}
+	}
+
+	virtual void startObject(const string &member) override
+	{
+		currentNode = findMember(member);
+	}
+
+	virtual void endObject(void) override
+	{
+		if (currentNode == INVALID_INDEX)
+			return;
+		currentNode = nodes[currentNode].parent;
+	}
+
+	virtual bool startElement(const unsigned int &index) override
+	{
+		const Node &node = current();
+		if (node.type != VALUE_TYPE_ARRAY &&
+		    node.type != VALUE_TYPE_OBJECT) {
+			HATOHOL_ASSERT(false, "The node isn't neither an array nor an object.");
+			return false;
+		}
+		if (index >= node.numChildren) {
+			MLPL_DBG("The index '%d' is greater than the size of "
+				"the array at the current position.\n", index);
+			return false;
+		}
+
+		size_t child = currentNode + 1;
+		size_t skip = index;
+		if (cachedParent == currentNode && cachedIndex <= index) {
+			child = cachedChild;
+			skip = index - cachedIndex;
+		}
+		for (size_t i = 0; i < skip; i++)
+			child = nodes[child].end;
+
+		cachedParent = currentNode;
+		cachedIndex = index;
+		cachedChild = child;
+		currentNode = child;
+		return true;
+	}
+
+	virtual unsigned int countElements(void) override
+	{
+		const Node &node = current();
+		if (node.type != VALUE_TYPE_ARRAY)
+			return 0;
+		return node.numChildren;
+	}
+
+protected:
+	const Node &current(void)
+	{
+		return nodes[currentNode];
+	}
+
+	size_t findMember(const string &member)
+	{
+		const Node &node = current();
+		if (node.type != VALUE_TYPE_OBJECT)
+			return INVALID_INDEX;
+
+		// When a name is duplicated, the last one is used
+		// in the same way as json-glib.
+		size_t found = INVALID_INDEX;
+		size_t child = currentNode + 1;
+		for (size_t i = 0; i < node.numChildren; i++) {
+			const Node &childNode = nodes[child];
+			if (childNode.nameLength == member.size() &&
+			    memcmp(childNode.name, member.data(),
+			           member.size()) == 0) {
+				found = child;
+			}
+			child = childNode.end;
+		}
+		return found;
+	}
+
+	bool setError(const char *p, const char *message)
+	{
+		errorMessage = StringUtils::sprintf(
+		  "%s at offset %zu", message, static_cast<size_t>(p - head));
+		nodes.clear();
+		return false;
+	}
+
+	void skipWhitespace(char *&p)
+	{
+		while (p < tail &&
+		       (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+			p++;
+	}
+
+	bool parseLiteral(char *&p, const char *literal)
+	{
+		const size_t length = strlen(literal);
+		if (static_cast<size_t>(tail - p) < length ||
+		    strncmp(p, literal, length) != 0)
+			return setError(p, "Invalid literal");
+		p += length;
+		return true;
+	}
+
+	bool parseValue(char *&p, const size_t &parent,
+	                const char *name, const size_t &nameLength,
+	                const size_t &depth)
+	{
+		if (depth > MAX_DEPTH)
+			return setError(p, "Too deep nesting");
+
+		const size_t index = nodes.size();
+		nodes.push_back(Node());
+		{
+			Node &node = nodes.back();
+			node.type = VALUE_TYPE_UNKNOWN;
+			node.parent = parent;
+			node.numChildren = 0;
+			node.name = name;
+			node.nameLength = nameLength;
+			node.str = NULL;
+			node.strLength = 0;
+			node.integer = 0;
+		}
+
+		if (p == tail)
+			return setError(p, "Unexpected end of data");
+
+		switch (*p) {
+		case '{':
+			nodes[index].type = VALUE_TYPE_OBJECT;
+			if (!parseObject(p, index, depth))
+				return false;
+			break;
+		case '[':
+			nodes[index].type = VALUE_TYPE_ARRAY;
+			if (!parseArray(p, index, depth))
+				return false;
+			break;
+		case '"':
+		{
+			const char *str = NULL;
+			size_t length = 0;
+			if (!parseString(p, str, length))
+				return false;
+			Node &node = nodes[index];
+			node.type = VALUE_TYPE_STRING;
+			node.str = str;
+			node.strLength = length;
+			break;
+		}
+		case 't':
+			if (!parseLiteral(p, "true"))
+				return false;
+			nodes[index].type = VALUE_TYPE_BOOLEAN;
+			nodes[index].boolean = true;
+			break;
+		case 'f':
+			if (!parseLiteral(p, "false"))
+				return false;
+			nodes[index].type = VALUE_TYPE_BOOLEAN;
+			nodes[index].boolean = false;
+			break;
+		case 'n':
+			if (!parseLiteral(p, "null"))
+				return false;
+			nodes[index].type = VALUE_TYPE_NULL;
+			break;
+		default:
+			if (!parseNumber(p, nodes[index]))
+				return false;
+			break;
+		}
+		nodes[index].end = nodes.size();
+		return true;
+	}
+
+	bool parseObject(char *&p, const size_t &index, const size_t &depth)
+	{
+		p++; // '{'
+		skipWhitespace(p);
+		if (p < tail && *p == '}') {
+			p++;
+			return true;
+		}
+		while (true) {
+			skipWhitespace(p);
+			if (p == tail || *p != '"')
+				return setError(p, "A member name is expected");
+			const char *name = NULL;
+			size_t nameLength = 0;
+			if (!parseString(p, name, nameLength))
+				return false;
+			skipWhitespace(p);
+			if (p == tail || *p != ':')
+				return setError(p, "':' is expected");
+			p++;
+			skipWhitespace(p);
+			if (!parseValue(p, index, name, nameLength, depth + 1))
+				return false;
+			nodes[index].numChildren++;
+			skipWhitespace(p);
+			if (p == tail)
+				break;
+			if (*p == ',') {
+				p++;
+				continue;
+			}
+			if (*p == '}') {
+				p++;
+				return true;
+			}
+			break;
+		}
+		return setError(p, "',' or '}' is expected");
+	}
+
+	bool parseArray(char *&p, const size_t &index, const size_t &depth)
+	{
+		p++; // '['
+		skipWhitespace(p);
+		if (p < tail && *p == ']') {
+			p++;
+			return true;
+		}
+		while (true) {
+			skipWhitespace(p);
+			if (!parseValue(p, index, NULL, 0, depth + 1))
+				return false;
+			nodes[index].numChildren++;
+			skipWhitespace(p);
+			if (p == tail)
+				break;
+			if (*p == ',') {
+				p++;
+				continue;
+			}
+			if (*p == ']') {
+				p++;
+				return true;
+			}
+			break;
+		}
+		return setError(p, "',' or ']' is expected");
+	}
+
+	static int parseHex(const char *p)
+	{
+		int value = 0;
+		for (int i = 0; i < 4; i++) {
+			const char c = p[i];
+			value <<= 4;
+			if (c >= '0' && c <= '9')
+				value |= c - '0';
+			else if (c >= 'a' && c <= 'f')
+				value |= c - 'a' + 10;
+			else if (c >= 'A' && c <= 'F')
+				value |= c - 'A' + 10;
+			else
+				return -1;
+		}
+		return value;
+	}
+
+	static char *writeUTF8(char *dest, const uint32_t &code)
+	{
+		if (code < 0x80) {
+			*dest++ = code;
+		} else if (code < 0x800) {
+			*dest++ = 0xc0 | (code >> 6);
+			*dest++ = 0x80 | (code & 0x3f);
+		} else if (code < 0x10000) {
+			*dest++ = 0xe0 | (code >> 12);
+			*dest++ = 0x80 | ((code >> 6) & 0x3f);
+			*dest++ = 0x80 | (code & 0x3f);
+		} else {
+			*dest++ = 0xf0 | (code >> 18);
+			*dest++ = 0x80 | ((code >> 12) & 0x3f);
+			*dest++ = 0x80 | ((code >> 6) & 0x3f);
+			*dest++ = 0x80 | (code & 0x3f);
+		}
+		return dest;
+	}
+
+	bool parseUnicodeEscape(char *&p, char *&dest)
+	{
+		// p points to 'u'
+		if (tail - p < 5)
+			return setError(p, "Invalid unicode escape");
+		int code = parseHex(p + 1);
+		if (code < 0)
+			return setError(p, "Invalid unicode escape");
+		p += 5;
+		if (code >= 0xd800 && code <= 0xdbff) {
+			int low = -1;
+			if (tail - p >= 6 && p[0] == '\\' && p[1] == 'u')
+				low = parseHex(p + 2);
+			if (low >= 0xdc00 && low <= 0xdfff) {
+				code = 0x10000 +
+				       ((code - 0xd800) << 10) + (low - 0xdc00);
+				p += 6;
+			} else {
+				code = 0xfffd;
+			}
+		} else if (code >= 0xdc00 && code <= 0xdfff) {
+			code = 0xfffd;
+		}
+		// The decoded bytes are always shorter than the escape
+		// sequence, so they can be written in place.
+		dest = writeUTF8(dest, code);
+		return true;
+	}
+
+	bool parseString(char *&p, const char *&str, size_t &length)
+	{
+		p++; // '"'
+		char *start = p;
+		while (p < tail && *p != '"' && *p != '\\')
+			p++;
+		if (p == tail)
+			return setError(p, "Unterminated string");
+		if (*p == '"') {
+			str = start;
+			length = p - start;
+			p++;
+			return true;
+		}
+
+		// Decode escape sequences in place.
+		char *dest = p;
+		while (p < tail) {
+			const char c = *p;
+			if (c == '"') {
+				str = start;
+				length = dest - start;
+				p++;
+				return true;
+			}
+			if (c != '\\') {
+				*dest++ = c;
+				p++;
+				continue;
+			}
+			p++;
+			if (p == tail)
+				break;
+			switch (*p) {
+			case '"':  *dest++ = '"';  break;
+			case '\\': *dest++ = '\\'; break;
+			case '/':  *dest++ = '/';  break;
+			case 'b':  *dest++ = '\b'; break;
+			case 'f':  *dest++ = '\f'; break;
+			case 'n':  *dest++ = '\n'; break;
+			case 'r':  *dest++ = '\r'; break;
+			case 't':  *dest++ = '\t'; break;
+			case 'u':
+				if (!parseUnicodeEscape(p, dest))
+					return false;
+				continue;
+			default:
+				return setError(p, "Invalid escape sequence");
+			}
+			p++;
+		}
+		return setError(p, "Unterminated string");
+	}
+
+	bool parseNumber(char *&p, Node &node)
+	{
+		char *start = p;
+		bool isDouble = false;
+		if (p < tail && *p == '-')
+			p++;
+		if (p == tail || !isdigit(*p))
+			return setError(start, "Invalid value");
+		while (p < tail && isdigit(*p))
+			p++;
+		if (p < tail && *p == '.') {
+			isDouble = true;
+			p++;
+			if (p == tail || !isdigit(*p))
+				return setError(start, "Invalid number");
+			while (p < tail && isdigit(*p))
+				p++;
+		}
+		if (p < tail && (*p == 'e' || *p == 'E')) {
+			isDouble = true;
+			p++;
+			if (p < tail && (*p == '+' || *p == '-'))
+				p++;
+			if (p == tail || !isdigit(*p))
+				return setError(start, "Invalid number");
+			while (p < tail && isdigit(*p))
+				p++;
+		}
+
+		// The buffer is terminated with '\0' and a number is
+		// followed by a non-numeric character, so the conversion
+		// functions stop at p.
+		if (!isDouble) {
+			errno = 0;
+			const gint64 value = g_ascii_strtoll(start, NULL, 10);
+			if (errno != ERANGE) {
+				node.type = VALUE_TYPE_INT64;
+				node.integer = value;
+				return true;
+			}
+		}
+		node.type = VALUE_TYPE_DOUBLE;
+		node.real = g_ascii_strtod(start, NULL);
+		return true;
+	}
 };
 
 // ---------------------------------------------------------------------------
 // Public methods
 // ---------------------------------------------------------------------------
-JSONParser::JSONParser(const string &data)
-: m_impl(new Impl(data))
+JSONParser::JSONParser(const string &data, const Backend &backend)
 {
+	if (backend == BACKEND_IN_SITU)
+		m_impl.reset(new InSituImpl(data));
+	else
+		m_impl.reset(new JSONGLibImpl(data));
 }
 
 JSONParser::~JSONParser()
@@ -66,14 +848,12 @@ JSONParser::~JSONParser()
 
 const char *JSONParser::getErrorMessage(void)
 {
-	if (!m_impl->error)
-		return "No error";
-	return m_impl->error->message;
+	return m_impl->getErrorMessage();
 }
 
 bool JSONParser::hasError(void)
 {
-	return m_impl->error != NULL;
+	return m_impl->hasError();
 }
 
 bool JSONParser::read(const string &member, bool &dest)
@@ -82,7 +862,7 @@ bool JSONParser::read(const string &member, bool &dest)
 	if (!startObject(member))
 		return false;
 
-	dest = json_node_get_boolean(m_impl->currentNode);
+	dest = m_impl->getBoolean();
 	endObject();
 	return true;
 }
@@ -93,19 +873,27 @@ bool JSONParser::read(const string &member, int64_t &dest)
 	if (!startObject(member))
 		return false;
 
-	dest = json_node_get_int(m_impl->currentNode);
+	dest = m_impl->getInt();
 	endObject();
 	return true;
 }
 
 bool JSONParser::read(const string &member, string &dest)
+{
+	StringView view;
+	if (!read(member, view))
+		return false;
+	dest.assign(view.data, view.size);
+	return true;
+}
+
+bool JSONParser::read(const string &member, StringView &dest)
 {
 	internalCheck();
 	if (!startObject(member))
 		return false;
 
-	const gchar *str = json_node_get_string(m_impl->currentNode);
-	dest = str ? str : "";
+	m_impl->getString(dest);
 	endObject();
 	return true;
 }
@@ -116,19 +904,27 @@ bool JSONParser::read(const std::string &member, double &dest)
 	if (!startObject(member))
 		return false;
 
-	dest = json_node_get_double(m_impl->currentNode);
+	dest = m_impl->getDouble();
 	endObject();
 	return true;
 }
 
 bool JSONParser::read(int index, string &dest)
+{
+	StringView view;
+	if (!read(index, view))
+		return false;
+	dest.assign(view.data, view.size);
+	return true;
+}
+
+bool JSONParser::read(int index, StringView &dest)
 {
 	internalCheck();
 	if (!startElement(index))
 		return false;
 
-	const gchar *str = json_node_get_string(m_impl->currentNode);
-	dest = str ? str : "";
+	m_impl->getString(dest);
 	endElement();
 	return true;
 }
@@ -139,20 +935,14 @@ bool JSONParser::isNull(const string &member, bool &dest)
 	if (!startObject(member))
 		return false;
 
-	dest = JSON_NODE_HOLDS_NULL(m_impl->currentNode);
+	dest = (m_impl->getValueType() == VALUE_TYPE_NULL);
 	endObject();
 	return true;
 }
 
 bool JSONParser::isMember(const string &member)
 {
-	JsonObject *object;
-
-	object = json_node_get_object(m_impl->currentNode);
-	if(!json_object_has_member(object, member.c_str()))
-		return false;
-
-	return true;
+	return m_impl->isMember(member);
 }
 
 JSONParser::ValueType JSONParser::getValueType(const std::string &member)
@@ -169,134 +959,37 @@ JSONParser::ValueType JSONParser::getValueType(const std::string &member)
 	if (!startObject(member))
 		return type;
 
-	JsonNodeType nodeType = json_node_get_node_type(m_impl->currentNode);
-	switch (nodeType) {
-	case JSON_NODE_OBJECT:
-		type = VALUE_TYPE_OBJECT;
-		break;
-	case JSON_NODE_ARRAY:
-		type = VALUE_TYPE_ARRAY;
-		break;
-	case JSON_NODE_VALUE:
-	{
-		GType gtype = json_node_get_value_type(m_impl->currentNode);
-		switch(gtype) {
-		case G_TYPE_INVALID:
-			type = VALUE_TYPE_NULL;
-			break;
-		case G_TYPE_BOOLEAN:
-			type = VALUE_TYPE_BOOLEAN;
-			break;
-		case G_TYPE_INT64:
-			type = VALUE_TYPE_INT64;
-			break;
-		case G_TYPE_DOUBLE:
-			type = VALUE_TYPE_DOUBLE;
-			break;
-		case G_TYPE_STRING:
-			type = VALUE_TYPE_STRING;
-			break;
-		default:
-			break;
-		}
-		break;
-	}
-	case JSON_NODE_NULL:
-		type = VALUE_TYPE_NULL;
-		break;
-	default:
-		break;
-	};
-
+	type = m_impl->getValueType();
 	endObject();
 	return type;
 }
 
 bool JSONParser::getMemberNames(set<string> &members) const
 {
-	auto memberCollector = [] (gpointer data, gpointer priv) {
-		const gchar *name = static_cast<const gchar *>(data);
-		set<string> *members = static_cast<set<string> *>(priv);
-		members->insert(name);
-	};
-
-	JsonObject *obj = json_node_get_object(m_impl->currentNode);
-	GList *memberList = json_object_get_members(obj);
-	g_list_foreach(memberList, memberCollector, &members);
-	g_list_free(memberList);
+	m_impl->getMemberNames(members);
 	return true;
 }
 
 bool JSONParser::startObject(const string &member)
 {
-	JsonObject *object;
-
 	if (!isMember(member)) {
 		MLPL_DBG("The member '%s' is not defined in the current node.\n",
 			 member.c_str());
 		return false;
 	}
 
-	object = json_node_get_object(m_impl->currentNode);
-	m_impl->previousNode = m_impl->currentNode;
-	m_impl->currentNode = json_object_get_member(object, member.c_str());
+	m_impl->startObject(member);
 	return true;
 }
 
 void JSONParser::endObject(void)
 {
-	JsonNode *tmp;
-
-	if (m_impl->previousNode != NULL)
-		tmp = json_node_get_parent(m_impl->previousNode);
-	else
-		tmp = NULL;
-
-	m_impl->currentNode = m_impl->previousNode;
-	m_impl->previousNode = tmp;
+	m_impl->endObject();
 }
 
 bool JSONParser::startElement(unsigned int index)
 {
-	switch (json_node_get_node_type(m_impl->currentNode)) {
-	case JSON_NODE_ARRAY: {
-		JsonArray * array = json_node_get_array(m_impl->currentNode);
-
-		if (index >= json_array_get_length(array)) {
-			MLPL_DBG("The index '%d' is greater than the size of "
-				"the array at the current position.\n", index);
-			return false;
-		}
-
-		m_impl->previousNode = m_impl->currentNode;
-		m_impl->currentNode = json_array_get_element(array, index);
-	}
-	break;
-	case JSON_NODE_OBJECT: {
-		JsonObject *object = json_node_get_object(m_impl->currentNode);
-		GList *members;
-		const gchar *name;
-
-		if(index >= json_object_get_size(object)) {
-			MLPL_DBG("The index '%d' is greater than the size of "
-				"the array at the current position.\n", index);
-			return false;
-		}
-
-		m_impl->previousNode = m_impl->currentNode;
-		members = json_object_get_members(object);
-		name = static_cast<gchar *>(g_list_nth_data(members, index));
-		m_impl->currentNode = json_object_get_member(object, name);
-
-		g_list_free(members);
-	}
-	break;
-	default:
-		HATOHOL_ASSERT(false, "The node isn't neither JSON_NODE_ARRAY nor JSON_NODE_OBJECT.");
-		return false;
-	}
-
-	return true;
+	return m_impl->startElement(index);
 }
 
 void JSONParser::endElement(void)
@@ -306,7 +999,7 @@ void JSONParser::endElement(void)
 
 unsigned int JSONParser::countElements(void)
 {
-	return json_array_get_length(json_node_get_array(m_impl->currentNode));
+	return m_impl->countElements();
 }
 
 // ---------------------------------------------------------------------------
@@ -314,5 +1007,5 @@ unsigned int JSONParser::countElements(void)
 // ---------------------------------------------------------------------------
 void JSONParser::internalCheck(void)
 {
-	HATOHOL_ASSERT(m_impl->currentNode, "CurrentNode: NULL");
+	HATOHOL_ASSERT(m_impl->hasCurrentNode(), "CurrentNode: NULL");
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2013 Project Hatohol
+ * Copyright (C) 2013,2016 Project Hatohol
  *
  * This file is part of Hatohol.
  *
@@ -21,6 +21,7 @@
 #define JSONParser_h
 
 #include <string>
+#include <cstring>
 #include <memory>
 #include <stack>
 #include <stdint.h>
@@ -44,6 +45,44 @@ public:
 		VALUE_TYPE_ARRAY
 	};
 
+	/**
+	 * A backend that parses the data.
+	 *
+	 * BACKEND_IN_SITU doesn't build a DOM tree. It scans the data once
+	 * into a flat array of nodes and decodes strings in place, so that
+	 * the strings can be read as StringView without copy.
+	 */
+	enum Backend {
+		BACKEND_JSON_GLIB,
+		BACKEND_IN_SITU,
+	};
+
+	/**
+	 * A reference to a string owned by the parser. It is valid while
+	 * the parser is alive. Note that the data may not be terminated
+	 * with '\0'.
+	 */
+	struct StringView {
+		const char *data;
+		size_t      size;
+
+		StringView(void)
+		: data(""),
+		  size(0)
+		{
+		}
+
+		std::string toString(void) const
+		{
+			return std::string(data, size);
+		}
+
+		bool operator==(const char *str) const
+		{
+			return size == strlen(str) && !memcmp(data, str, size);
+		}
+	};
+
 	class PositionStack {
 	public:
 		PositionStack(JSONParser &parser);
@@ -57,7 +96,8 @@ public:
 		std::stack<int>  m_stack;
 	};
 
-	JSONParser(const std::string &data);
+	JSONParser(const std::string &data,
+	           const Backend &backend = BACKEND_JSON_GLIB);
 	virtual ~JSONParser();
 	const char *getErrorMessage(void);
 	bool hasError(void);
@@ -65,7 +105,9 @@ public:
 	bool read(const std::string &member, int64_t &dest);
 	bool read(const std::string &member, std::string &dest);
 	bool read(const std::string &member, double &dest);
+	bool read(const std::string &member, StringView &dest);
 	bool read(int index, std::string &dest);
+	bool read(int index, StringView &dest);
 	bool isMember(const std::string &member);
 	ValueType getValueType(const std::string &member);
 	bool getMemberNames(std::set<std::string> &members) const;
@@ -95,6 +137,8 @@ protected:
 
 private:
 	struct Impl;
+	struct JSONGLibImpl;
+	struct InSituImpl;
 	std::unique_ptr<Impl> m_impl;
 };
 
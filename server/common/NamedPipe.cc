@@ -498,6 +498,9 @@ bool NamedPipe::openPipe(const string &name)
 	}
 
 	// open the fifo
+	// The processes spawned by the owner (e.g. the actions spawned by
+	// hatohol-action-spawner) must not inherit it.
+	openFlag |= O_CLOEXEC;
 retry:
 	m_impl->fd = open(m_impl->path.c_str(), openFlag);
 	if (m_impl->fd == -1) {
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <Logger.h>
+#include <SmartQueue.h>
+#include <thread>
+#include <vector>
+#include "WorkerPool.h"
+#include "HatoholThreadBase.h"
+#include "HatoholException.h"
+
+using namespace std;
+using namespace mlpl;
+
+struct WorkerPool::Worker : public HatoholThreadBase {
+	SmartQueue<Task> &m_queue;
+
+	Worker(SmartQueue<Task> &queue)
+	: m_queue(queue)
+	{
+	}
+
+protected:
+	virtual gpointer mainThread(HatoholThreadArg *arg) override
+	{
+		while (true) {
+			// An empty task is the request to exit.
+			Task task = m_queue.pop();
+			if (!task)
+				break;
+			runTask(task);
+		}
+		return NULL;
+	}
+
+	void runTask(const Task &task)
+	{
+		try {
+			task();
+		} catch (const HatoholException &e) {
+			MLPL_ERR("Got exception: %s\n",
+			         e.getFancyMessage().c_str());
+		} catch (const exception &e) {
+			MLPL_ERR("Got exception: %s\n", e.what());
+		}
+	}
+};
+
+struct WorkerPool::Impl {
+	SmartQueue<Task> m_queue;
+	vector<unique_ptr<Worker>> m_workers;
+
+	Impl(const size_t &numWorkers)
+	{
+		for (size_t i = 0; i < numWorkers; i++) {
+			Worker *worker = new Worker(m_queue);
+			m_workers.emplace_back(worker);
+			worker->start();
+		}
+	}
+
+	~Impl()
+	{
+		for (size_t i = 0; i < m_workers.size(); i++)
+			m_queue.push(Task());
+		for (auto &worker : m_workers)
+			worker->waitExit();
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+WorkerPool::WorkerPool(const size_t &numWorkers)
+{
+	size_t num = numWorkers;
+	if (num == 0)
+		num = thread::hardware_concurrency();
+	if (num == 0)
+		num = 1;
+	m_impl.reset(new Impl(num));
+}
+
+WorkerPool::~WorkerPool()
+{
+}
+
+void WorkerPool::post(const Task &task)
+{
+	HATOHOL_ASSERT(task, "An empty task is posted.");
+	m_impl->m_queue.push(task);
+}
+
+size_t WorkerPool::getNumberOfWorkers(void) const
+{
+	return m_impl->m_workers.size();
+}
+
+size_t WorkerPool::getNumberOfPendingTasks(void) const
+{
+	return m_impl->m_queue.size();
+}
+
+WorkerPool &WorkerPool::getShared(void)
+{
+	static WorkerPool pool;
+	return pool;
+}
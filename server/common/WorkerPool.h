@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef WorkerPool_h
+#define WorkerPool_h
+
+#include <functional>
+#include <memory>
+
+/**
+ * A fixed number of threads that run posted tasks.
+ *
+ * Tasks are run in the posted order, but tasks posted in a row can run
+ * concurrently on different workers. A user who needs serialization
+ * has to implement it by itself.
+ */
+class WorkerPool {
+public:
+	typedef std::function<void (void)> Task;
+
+	/**
+	 * Create workers and start them.
+	 *
+	 * @param numWorkers
+	 * The number of the worker threads. If it is 0, the number of the
+	 * CPU cores is used.
+	 */
+	WorkerPool(const size_t &numWorkers = 0);
+
+	/**
+	 * Run all tasks that have already been posted and stop workers.
+	 */
+	virtual ~WorkerPool();
+
+	/**
+	 * Post a task. This method is MT-safe and doesn't block.
+	 *
+	 * @param task A task to be run on one of the workers.
+	 */
+	void post(const Task &task);
+
+	size_t getNumberOfWorkers(void) const;
+	size_t getNumberOfPendingTasks(void) const;
+
+	/**
+	 * Get the pool shared in the process. It is created on the first
+	 * call.
+	 *
+	 * @return A reference to the shared pool.
+	 */
+	static WorkerPool &getShared(void);
+
+private:
+	struct Worker;
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // WorkerPool_h
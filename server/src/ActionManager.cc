@@ -18,11 +18,14 @@
  */
 
 #include <cstring>
+#include <chrono>
 #include <deque>
+#include <mutex>
 #include <errno.h>
 #include "ActionManager.h"
 #include "ActorCollector.h"
 #include "DBTablesAction.h"
+#include "ActionRuleIndex.h"
 #include "DBTablesMonitoring.h"
 #include "NamedPipe.h"
 #include "ResidentProtocol.h"
@@ -37,8 +40,10 @@
 #include "ChildProcessManager.h"
 #include "IncidentSenderManager.h"
 #include "ThreadLocalDBCache.h"
+#include "AtomicValue.h"
 
 using namespace std;
+using namespace std::chrono;
 using namespace mlpl;
 
 struct ResidentInfo;
@@ -47,6 +52,9 @@ struct ActionManager::ResidentNotifyInfo {
 	uint64_t  logId;
 	EventInfo eventInfo; // a replica
 	string    sessionId;
+	uint32_t  requestId; // valid after the event is sent
+	steady_clock::time_point dispatchTime;
+	steady_clock::time_point sentTime;
 
 	ResidentNotifyInfo(ResidentInfo *_residentInfo);
 	virtual ~ResidentNotifyInfo();
@@ -69,7 +77,6 @@ enum ResidentStatus {
 	RESIDENT_STAT_INIT,
 	RESIDENT_STAT_WAIT_LAUNCHED,
 	RESIDENT_STAT_WAIT_PARAM_ACK,
-	RESIDENT_STAT_WAIT_NOTIFY_ACK,
 	RESIDENT_STAT_IDLE,
 };
 
@@ -79,18 +86,24 @@ struct SpawnPostprocCommandActionCtx {
 	ActorInfo *actorInfoCopy;
 	size_t     reservationId;
 	WaitingCommandActionInfo *waitCmdInfo;
+	steady_clock::time_point dispatchTime;
 
 	// constructor
 	SpawnPostprocCommandActionCtx(void)
 	: actorInfoCopy(NULL),
 	  reservationId(-1),
-	  waitCmdInfo(NULL)
+	  waitCmdInfo(NULL),
+	  dispatchTime(steady_clock::now())
 	{
 	}
 };
 
 struct ResidentInfo :
    public ResidentPullHelper<ActionManager::ResidentNotifyInfo> {
+	// The maximum number of events that have been sent to
+	// hatohol-resident-yard but not been acknowledged yet.
+	static const size_t NOTIFY_WINDOW_SIZE = 32;
+
 	static Mutex              residentMapLock;
 	static RunningResidentMap runningResidentMap;
 	ActionManager *actionManager;
@@ -102,6 +115,12 @@ struct ResidentInfo :
 	ResidentNotifyQueue notifyQueue; // should be used with queueLock.
 	ResidentStatus      status;      // should be used with queueLock.
 
+	// The first 'numInFlight' elements of notifyQueue have been sent.
+	// The following members should also be used with queueLock.
+	size_t   numInFlight;
+	uint32_t nextRequestId;
+	bool     waitingAck;
+
 	NamedPipe pipeRd, pipeWr;
 	string pipeName;
 	string modulePath;
@@ -113,6 +132,9 @@ struct ResidentInfo :
 	  pid(0),
 	  inRunningResidentMap(false),
 	  status(RESIDENT_STAT_INIT),
+	  numInFlight(0),
+	  nextRequestId(0),
+	  waitingAck(false),
 	  pipeRd(NamedPipe::END_TYPE_MASTER_READ),
 	  pipeWr(NamedPipe::END_TYPE_MASTER_WRITE)
 	{
@@ -138,9 +160,12 @@ struct ResidentInfo :
 		while (!notifyQueue.empty()) {
 			ActionManager::ResidentNotifyInfo *notifyInfo
 			  = notifyQueue.front();
-			MLPL_BUG("ResidentNotifyInfo is deleted, "
-			         "but not logged: logId: %" PRIu64 "\n",
-			         notifyInfo->logId);
+			// The log ID is cleared when the end is logged.
+			if (notifyInfo->logId != INVALID_ACTION_LOG_ID) {
+				MLPL_BUG("ResidentNotifyInfo is deleted, "
+				         "but not logged: logId: %" PRIu64 "\n",
+				         notifyInfo->logId);
+			}
 			delete notifyInfo;
 			notifyQueue.pop_front();
 		}
@@ -195,21 +220,39 @@ struct ResidentInfo :
 		ActionManager::ResidentNotifyInfo *notifyInfo
 		   = notifyQueue.front();
 		notifyQueue.pop_front();
+		if (numInFlight > 0)
+			numInFlight--;
 		queueLock.unlock();
 
 		delete notifyInfo;
 	}
+
+	/**
+	 * Get the number of events that can be sent now.
+	 * NOTE: queueLock has to be taken by the caller.
+	 */
+	size_t getNumberOfEventsToSend(void) const
+	{
+		if (numInFlight >= NOTIFY_WINDOW_SIZE)
+			return 0;
+		size_t num = notifyQueue.size() - numInFlight;
+		num = min(num, NOTIFY_WINDOW_SIZE - numInFlight);
+		return min(num, RESIDENT_PROTO_EVENT_BATCH_MAX_NUM_EVENTS);
+	}
 };
 
 Mutex              ResidentInfo::residentMapLock;
 RunningResidentMap ResidentInfo::runningResidentMap;
+const size_t       ResidentInfo::NOTIFY_WINDOW_SIZE;
 
 // ---------------------------------------------------------------------------
 // methods of ResidentNotifyInfo
 // ---------------------------------------------------------------------------
 ActionManager::ResidentNotifyInfo::ResidentNotifyInfo(ResidentInfo *_residentInfo)
 : residentInfo(_residentInfo),
-  logId(INVALID_ACTION_LOG_ID)
+  logId(INVALID_ACTION_LOG_ID),
+  requestId(0),
+  dispatchTime(steady_clock::now())
 {
 	SessionManager *sessionMgr = SessionManager::getInstance();
 	sessionId = sessionMgr->create(residentInfo->actionDef.ownerUserId,
@@ -230,6 +273,7 @@ struct WaitingCommandActionInfo {
 	ActionDef actionDef;
 	EventInfo eventInfo;
 	StringVector argVect;
+	steady_clock::time_point dispatchTime;
 
 	// The following variable is used only when the waiting action passes
 	// a reservation ID from the collectedCallback to the
@@ -376,6 +420,7 @@ protected:
 		waitCmdInfo->actionDef = actionDef;
 		waitCmdInfo->eventInfo = eventInfo;
 		waitCmdInfo->argVect   = argVect;
+		waitCmdInfo->dispatchTime = steady_clock::now();
 		waitingList.push_back(waitCmdInfo);
 		return waitCmdInfo;
 	}
@@ -451,9 +496,65 @@ private:
 struct ActionManager::Impl {
 	static string pathForAction;
 	static string ldLibraryPathForAction;
+	static mutex  spawnerPoolLock;
+	static unique_ptr<ActionSpawnerPool> spawnerPool;
+
+	// Statistics. Launch latencies are measured from runAction().
+	static AtomicValue<uint64_t> numDispatchedActions;
+	static AtomicValue<uint64_t> numCommandTimeouts;
+	static AtomicValue<uint64_t> numResidentTimeouts;
+	static LatencyHistogram      commandLaunchLatency;
+	static LatencyHistogram      commandRunTime;
+	static LatencyHistogram      residentLaunchLatency;
+	static LatencyHistogram      residentRunTime;
+
+	static void resetStatistics(void)
+	{
+		numDispatchedActions = 0;
+		numCommandTimeouts = 0;
+		numResidentTimeouts = 0;
+		commandLaunchLatency.reset();
+		commandRunTime.reset();
+		residentLaunchLatency.reset();
+		residentRunTime.reset();
+	}
+
+	/**
+	 * Get the pool of hatohol-action-spawner. The pool is created on
+	 * the first call.
+	 *
+	 * @return
+	 * A pointer of the pool or NULL if the spawners are disabled.
+	 */
+	static ActionSpawnerPool *getSpawnerPool(void)
+	{
+		ConfigManager *configMgr = ConfigManager::getInstance();
+		const int numSpawners = configMgr->getNumberOfActionSpawners();
+		if (numSpawners <= 0)
+			return NULL;
+
+		lock_guard<mutex> lock(spawnerPoolLock);
+		if (!spawnerPool) {
+			string path = configMgr->getResidentYardDirectory();
+			path += "/";
+			path += ActionSpawnerPool::SPAWNER_NAME;
+			spawnerPool.reset(
+			  new ActionSpawnerPool(numSpawners, path));
+		}
+		return spawnerPool.get();
+	}
 };
 string ActionManager::Impl::pathForAction;
 string ActionManager::Impl::ldLibraryPathForAction;
+mutex  ActionManager::Impl::spawnerPoolLock;
+unique_ptr<ActionSpawnerPool> ActionManager::Impl::spawnerPool;
+AtomicValue<uint64_t> ActionManager::Impl::numDispatchedActions(0);
+AtomicValue<uint64_t> ActionManager::Impl::numCommandTimeouts(0);
+AtomicValue<uint64_t> ActionManager::Impl::numResidentTimeouts(0);
+LatencyHistogram      ActionManager::Impl::commandLaunchLatency;
+LatencyHistogram      ActionManager::Impl::commandRunTime;
+LatencyHistogram      ActionManager::Impl::residentLaunchLatency;
+LatencyHistogram      ActionManager::Impl::residentRunTime;
 
 // ---------------------------------------------------------------------------
 // Public methods
@@ -468,6 +569,7 @@ const char *ActionManager::ENV_NAME_SESSION_ID = "HATOHOL_SESSION_ID";
 
 void ActionManager::reset(void)
 {
+	ActionRuleIndex::invalidate();
 	setupPathForAction(Impl::pathForAction,
 	                   Impl::ldLibraryPathForAction);
 
@@ -485,6 +587,63 @@ void ActionManager::reset(void)
 	ResidentInfo::runningResidentMap.clear();
 
 	CommandActionContext::reset();
+	Impl::resetStatistics();
+
+	lock_guard<mutex> lock(Impl::spawnerPoolLock);
+	Impl::spawnerPool.reset();
+}
+
+ActionManager::Statistics::Statistics(void)
+: numDispatchedActions(0),
+  numCommandTimeouts(0),
+  numResidentTimeouts(0),
+  numOnstageCommandActions(0),
+  numWaitingCommandActions(0),
+  numPendingSpawnerRequests(0),
+  numResidentYards(0),
+  numQueuedResidentEvents(0),
+  numInFlightResidentEvents(0)
+{
+}
+
+void ActionManager::getStatistics(Statistics &stats)
+{
+	stats.numDispatchedActions = Impl::numDispatchedActions;
+	stats.numCommandTimeouts = Impl::numCommandTimeouts;
+	stats.numResidentTimeouts = Impl::numResidentTimeouts;
+	Impl::commandLaunchLatency.getSnapshot(stats.commandLaunchLatency);
+	Impl::commandRunTime.getSnapshot(stats.commandRunTime);
+	Impl::residentLaunchLatency.getSnapshot(stats.residentLaunchLatency);
+	Impl::residentRunTime.getSnapshot(stats.residentRunTime);
+
+	CommandActionContext::lock.lock();
+	stats.numOnstageCommandActions =
+	  CommandActionContext::runningSet.size() +
+	  CommandActionContext::reservedSet.size();
+	stats.numWaitingCommandActions =
+	  CommandActionContext::waitingList.size();
+	CommandActionContext::lock.unlock();
+
+	Impl::spawnerPoolLock.lock();
+	if (Impl::spawnerPool) {
+		stats.numPendingSpawnerRequests =
+		  Impl::spawnerPool->getNumberOfPendingRequests();
+	}
+	Impl::spawnerPoolLock.unlock();
+
+	stats.numQueuedResidentEvents = 0;
+	stats.numInFlightResidentEvents = 0;
+	ResidentInfo::residentMapLock.lock();
+	stats.numResidentYards = ResidentInfo::runningResidentMap.size();
+	for (auto &idResidentPair : ResidentInfo::runningResidentMap) {
+		ResidentInfo *residentInfo = idResidentPair.second;
+		residentInfo->queueLock.lock();
+		stats.numQueuedResidentEvents +=
+		  residentInfo->notifyQueue.size() - residentInfo->numInFlight;
+		stats.numInFlightResidentEvents += residentInfo->numInFlight;
+		residentInfo->queueLock.unlock();
+	}
+	ResidentInfo::residentMapLock.unlock();
 }
 
 ActionManager::ActionManager(void)
@@ -522,21 +681,37 @@ void ActionManager::checkEvents(const EventInfoList &eventList)
 {
 	ThreadLocalDBCache cache;
 	DBTablesAction &dbAction = cache.getAction();
-	EventInfoListConstIterator it = eventList.begin();
-	for (; it != eventList.end(); ++it) {
+	shared_ptr<const ActionRuleIndex> ruleIndex =
+	  ActionRuleIndex::getShared();
+
+	EventInfoList targetEventList;
+	for (auto &eventInfo : eventList) {
+		if (eventInfo.id != DISCONNECT_SERVER_EVENT_ID &&
+		    shouldSkipByTime(eventInfo))
+			continue;
+		targetEventList.push_back(eventInfo);
+	}
+	if (targetEventList.empty())
+		return;
+	ServerEventIdPairSet loggedEventSet;
+	dbAction.getLoggedEvents(loggedEventSet, targetEventList);
+
+	EventInfoListConstIterator it = targetEventList.begin();
+	for (; it != targetEventList.end(); ++it) {
 		ActionDefList actionDefList;
 		const EventInfo &eventInfo = *it;
 		if (eventInfo.id != DISCONNECT_SERVER_EVENT_ID) {
-			if (shouldSkipByTime(eventInfo))
-				continue;
-			if (shouldSkipByLog(eventInfo, dbAction))
+			// TODO: We shouldn't skip if status is
+			//       ACTLOG_STAT_QUEUING.
+			// The event is registered here so that the same
+			// event in the list isn't processed twice.
+			ServerEventIdPair serverEventId(eventInfo.serverId,
+			                                eventInfo.id);
+			if (!loggedEventSet.insert(serverEventId).second)
 				continue;
 		}
-		ActionsQueryOption option(USER_ID_SYSTEM);
 		// TODO: sort IncidentSender type actions by priority
-		option.setActionType(ACTION_ALL);
-		option.setTargetEventInfo(&eventInfo);
-		dbAction.getActionList(actionDefList, option);
+		ruleIndex->match(actionDefList, eventInfo);
 		ActionDefListIterator actIt = actionDefList.begin();
 		ActionIdType incidentSenderActionId = 0;
 		for (; actIt != actionDefList.end(); ++actIt) {
@@ -612,6 +787,7 @@ HatoholError ActionManager::runAction(const ActionDef &actionDef,
 	if (!checkActionOwner(actionDef))
 		return HTERR_INVALID_USER;
 
+	Impl::numDispatchedActions.add(1);
 	if (actionDef.type == ACTION_COMMAND) {
 		execCommandAction(actionDef, eventInfo, dbAction);
 	} else if (actionDef.type == ACTION_RESIDENT) {
@@ -809,6 +985,8 @@ void ActionManager::spawnPostprocCommandAction(ActorInfo *actorInfo,
 	if (!actorInfo)
 		return;
 	actorInfo->collectedCb = commandActorCollectedCb;
+	actorInfo->startTime = steady_clock::now();
+	Impl::commandLaunchLatency.recordSince(ctx->dispatchTime);
 
 	// set the timeout
 	if (actionDef.timeout <= 0)
@@ -829,6 +1007,13 @@ void ActionManager::execCommandActionCore(
   DBTablesAction &dbAction, void *postprocCtx,
   const StringVector &argVect)
 {
+	ActionSpawnerPool *spawnerPool = Impl::getSpawnerPool();
+	if (spawnerPool) {
+		execCommandActionBySpawner(*spawnerPool, actionDef, eventInfo,
+		                           dbAction, postprocCtx, argVect);
+		return;
+	}
+
 	const gchar *argv[argVect.size()+1];
 	for (size_t i = 0; i < argVect.size(); i++)
 		argv[i] = argVect[i].c_str();
@@ -839,6 +1024,120 @@ void ActionManager::execCommandActionCore(
 	// spawnPostprocCommandAction() is called in the above spawn().
 }
 
+/*
+ * executed on the following thread(s)
+ * - Threads that call checkEvents()
+ *     [from execCommandActionCore()]
+ * - The default GLIB event dispacther thread (main)
+ *     [from execCommandActionCore() from commandActorPostCollectedCb()]
+ * - ActorCollector thread
+ *     [from execCommandActionCore() from commandActorPostCollectedCb()]
+ */
+void ActionManager::execCommandActionBySpawner(
+  ActionSpawnerPool &spawnerPool,
+  const ActionDef &actionDef, const EventInfo &eventInfo,
+  DBTablesAction &dbAction, void *_postprocCtx,
+  const StringVector &argVect)
+{
+	SpawnPostprocCommandActionCtx *postprocCtx =
+	  static_cast<SpawnPostprocCommandActionCtx *>(_postprocCtx);
+
+	// The process is regarded as started here, because the spawner
+	// reports only the result.
+	shared_ptr<ActorInfo> actorInfo = make_shared<ActorInfo>();
+	WaitingCommandActionInfo *waitCmdInfo = postprocCtx->waitCmdInfo;
+	if (waitCmdInfo) {
+		dbAction.updateLogStatusToStart(waitCmdInfo->logId);
+		actorInfo->logId = waitCmdInfo->logId;
+	} else {
+		actorInfo->logId =
+		  dbAction.createActionLog(actionDef, eventInfo,
+		                           ACTLOG_EXECFAIL_NONE,
+		                           ACTLOG_STAT_STARTED);
+	}
+	CommandActionContext::add(postprocCtx->reservationId,
+	                          actorInfo->logId);
+	if (postprocCtx->actorInfoCopy)
+		postprocCtx->actorInfoCopy->logId = actorInfo->logId;
+
+	ActionSpawnerPool::Request request;
+	request.args = argVect;
+	request.envs.push_back(Impl::pathForAction);
+	request.envs.push_back(Impl::ldLibraryPathForAction);
+	request.envs.push_back(
+	  makeSessionIdEnv(actionDef, actorInfo->sessionId));
+	request.workingDirectory = actionDef.workingDir;
+	request.timeout = actionDef.timeout;
+
+	// The time to the submission is added to the launch latency
+	// reported by the pool.
+	const uint64_t submitUsec = duration_cast<microseconds>(
+	  steady_clock::now() - postprocCtx->dispatchTime).count();
+
+	// The session is removed when actorInfo is destroyed.
+	spawnerPool.submit(request,
+	  [actorInfo, submitUsec](const ActionSpawnerPool::Result &result) {
+		commandActionSpawnerCompletedCb(*actorInfo, result,
+		                                submitUsec);
+	});
+}
+
+/*
+ * executed on the following thread(s)
+ * - The default GLIB event dispacther thread (main)
+ */
+void ActionManager::commandActionSpawnerCompletedCb(
+  const ActorInfo &actorInfo, const ActionSpawnerPool::Result &result,
+  const uint64_t &submitUsec)
+{
+	if (result.errorNumber == 0 && !result.lostSpawner) {
+		Impl::commandLaunchLatency.record(
+		  submitUsec + result.dispatchUsec);
+		Impl::commandRunTime.record(result.runUsec);
+	}
+	if (result.killedByTimeout)
+		Impl::numCommandTimeouts.add(1);
+
+	DBTablesAction::LogEndExecActionArg logArg;
+	logArg.logId = actorInfo.logId;
+	if (result.errorNumber != 0) {
+		MLPL_ERR("Failed to spawn an action: log ID: %" PRIu64 ", "
+		         "%s\n", actorInfo.logId,
+		         g_strerror(result.errorNumber));
+		logArg.status = ACTLOG_STAT_FAILED;
+		logArg.failureCode = (result.errorNumber == ENOENT) ?
+		  ACTLOG_EXECFAIL_ENTRY_NOT_FOUND :
+		  ACTLOG_EXECFAIL_EXEC_FAILURE;
+		logArg.nullFlags = ACTLOG_FLAG_EXIT_CODE;
+	} else if (result.lostSpawner) {
+		logArg.status = ACTLOG_STAT_FAILED;
+		logArg.failureCode = ACTLOG_EXECFAIL_UNEXPECTED_EXIT;
+		logArg.nullFlags = ACTLOG_FLAG_EXIT_CODE;
+	} else if (result.killedByTimeout) {
+		logArg.status = ACTLOG_STAT_FAILED;
+		logArg.failureCode = ACTLOG_EXECFAIL_KILLED_TIMEOUT;
+		logArg.exitCode = 0;
+	} else {
+		if (result.code == CLD_EXITED) {
+			logArg.status = ACTLOG_STAT_SUCCEEDED;
+		} else if (result.code == CLD_DUMPED) {
+			logArg.status = ACTLOG_STAT_FAILED;
+			logArg.failureCode = ACTLOG_EXECFAIL_DUMPED_SIGNAL;
+		} else {
+			logArg.status = ACTLOG_STAT_FAILED;
+			logArg.failureCode = ACTLOG_EXECFAIL_KILLED_SIGNAL;
+		}
+		logArg.exitCode = result.status;
+	}
+	ThreadLocalDBCache cache;
+	cache.getAction().logEndExecAction(logArg);
+
+	// Run a waiting command action in the same way as ActorCollector.
+	commandActorCollectedCb(&actorInfo);
+	if (actorInfo.postCollectedCb)
+		(*actorInfo.postCollectedCb)(&actorInfo);
+}
+
 void ActionManager::addCommandDirectory(string &path)
 {
 	// add the action command directory
@@ -1052,34 +1351,101 @@ void ActionManager::gotNotifyEventAckCb(GIOStatus stat, SmartBuffer &sbuf,
 	}
 
 	int pktType = ResidentCommunicator::getPacketType(sbuf);
-	if (pktType != RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_ACK) {
+	if (pktType != RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH_ACK) {
 		MLPL_ERR("Unexpected packet: %d\n", pktType);
 		obj->closeResident(notifyInfo,
 		                   ACTLOG_EXECFAIL_PIPE_READ_DATA_UNEXPECTED);
 		return;
 	}
 
-	// get the result code
-	sbuf.resetIndex();
-	sbuf.incIndex(RESIDENT_PROTO_HEADER_LEN);
-	uint32_t resultCode = *sbuf.getPointer<uint32_t>();
+	// request to get the results
+	residentInfo->pullData(ResidentCommunicator::getBodySize(sbuf),
+	                       gotNotifyEventBatchAckCb);
+}
 
-	// log the end of action
-	HATOHOL_ASSERT(notifyInfo->logId != INVALID_ACTION_LOG_ID,
-	               "log ID: %" PRIx64, notifyInfo->logId);
-	DBTablesAction::LogEndExecActionArg logArg;
-	logArg.logId = notifyInfo->logId;
-	logArg.status = ACTLOG_STAT_SUCCEEDED,
-	logArg.exitCode = resultCode;
+/*
+ * executed on the following thread(s)
+ * - The default GLIB event dispacther thread (main)
+ *     [callback registered by pullData()]
+ */
+void ActionManager::gotNotifyEventBatchAckCb(GIOStatus stat,
+                                             SmartBuffer &sbuf, size_t size,
+                                             ResidentNotifyInfo *notifyInfo)
+{
+	ResidentInfo *residentInfo = notifyInfo->residentInfo;
+	ActionManager *obj = residentInfo->actionManager;
+	if (stat != G_IO_STATUS_NORMAL) {
+		MLPL_ERR("Error: status: %x\n", stat);
+		obj->closeResident(notifyInfo, ACTLOG_EXECFAIL_PIPE_READ_ERR);
+		return;
+	}
+
+	sbuf.resetIndex();
+	const uint16_t numResults = *sbuf.getPointerAndIncIndex<uint16_t>();
+	if (size != RESIDENT_PROTO_EVENT_BATCH_ACK_NUM_RESULTS_LEN +
+	            RESIDENT_PROTO_EVENT_BATCH_ACK_RESULT_LEN * numResults) {
+		MLPL_ERR("Invalid size: %zd, numResults: %" PRIu16 "\n",
+		         size, numResults);
+		obj->closeResident(notifyInfo,
+		                   ACTLOG_EXECFAIL_PIPE_READ_DATA_UNEXPECTED);
+		return;
+	}
 
+	// The results come in the same order as the events were sent.
+	// So the acknowledged event is always at the top of the queue.
 	ThreadLocalDBCache cache;
-	cache.getAction().logEndExecAction(logArg);
+	for (uint16_t i = 0; i < numResults; i++) {
+		const uint32_t requestId =
+		  *sbuf.getPointerAndIncIndex<uint32_t>();
+		const uint32_t resultCode =
+		  *sbuf.getPointerAndIncIndex<uint32_t>();
 
-	// remove the notifyInfo 
-	residentInfo->deleteFrontNotifyInfo();
+		ResidentNotifyInfo *frontInfo = NULL;
+		residentInfo->queueLock.lock();
+		if (residentInfo->numInFlight > 0)
+			frontInfo = residentInfo->notifyQueue.front();
+		residentInfo->queueLock.unlock();
+		if (!frontInfo) {
+			MLPL_ERR("No event in flight: request ID: %" PRIu32
+			         "\n", requestId);
+			obj->closeResident(residentInfo);
+			return;
+		}
+		if (frontInfo->requestId != requestId) {
+			MLPL_ERR("Unexpected request ID: %" PRIu32
+			         " (expected: %" PRIu32 ")\n",
+			         requestId, frontInfo->requestId);
+			obj->closeResident(
+			  frontInfo, ACTLOG_EXECFAIL_PIPE_READ_DATA_UNEXPECTED);
+			return;
+		}
+
+		// log the end of action
+		HATOHOL_ASSERT(frontInfo->logId != INVALID_ACTION_LOG_ID,
+		               "log ID: %" PRIx64, frontInfo->logId);
+		DBTablesAction::LogEndExecActionArg logArg;
+		logArg.logId = frontInfo->logId;
+		logArg.status = ACTLOG_STAT_SUCCEEDED,
+		logArg.exitCode = resultCode;
+		cache.getAction().logEndExecAction(logArg);
+		Impl::residentRunTime.recordSince(frontInfo->sentTime);
+
+		// remove the notifyInfo 
+		residentInfo->deleteFrontNotifyInfo();
+	}
+
+	// wait for the ack of the next batch if any
+	residentInfo->queueLock.lock();
+	if (residentInfo->numInFlight > 0) {
+		residentInfo->setPullCallbackArg(
+		  residentInfo->notifyQueue.front());
+		residentInfo->pullHeader(gotNotifyEventAckCb);
+	} else {
+		residentInfo->waitingAck = false;
+	}
+	residentInfo->queueLock.unlock();
 
 	// send the next notificaiton if it exists
-	residentInfo->setStatus(RESIDENT_STAT_IDLE);
 	obj->tryNotifyEvent(residentInfo);
 }
 
@@ -1124,6 +1490,7 @@ gboolean ActionManager::commandActionTimeoutCb(gpointer data)
 	cache.getAction().logEndExecAction(logArg);
 	ActorCollector::setDontLog(actorInfo->pid);
 	kill(actorInfo->pid, SIGKILL);
+	Impl::numCommandTimeouts.add(1);
 	actorInfo->timerTag = INVALID_EVENT_ID;
 	return FALSE;
 }
@@ -1151,6 +1518,7 @@ void ActionManager::residentActionTimeoutCb(NamedPipe *namedPipe, gpointer data)
 	}
 
 	// log the incident and kill the resident.
+	Impl::numResidentTimeouts.add(1);
 	obj->closeResident(notifyInfo, ACTLOG_EXECFAIL_KILLED_TIMEOUT);
 }
 
@@ -1252,52 +1620,70 @@ ResidentInfo *ActionManager::launchResidentActionYard
  *     [from execResidentAction()]
  * - The default GLIB event dispacther thread (main)
  *     [from moduleLoadedCb()]
- *     [from gotNotifyEventAckCb]
+ *     [from gotNotifyEventBatchAckCb]
  */
 void ActionManager::tryNotifyEvent(ResidentInfo *residentInfo)
 {
+	// notifyEvent() is called with queueLock so that batches are
+	// pushed to the pipe in the same order as notifyQueue.
 	residentInfo->queueLock.lock();
-	ResidentNotifyInfo *notifyInfo = NULL;
-	if (residentInfo->status != RESIDENT_STAT_IDLE) {
-		residentInfo->queueLock.unlock();
-		return;
-	}
-	if (!residentInfo->notifyQueue.empty()) {
-		notifyInfo = residentInfo->notifyQueue.front();
-		residentInfo->status = RESIDENT_STAT_WAIT_NOTIFY_ACK;
+	if (residentInfo->status == RESIDENT_STAT_IDLE) {
+		size_t numEvents = residentInfo->getNumberOfEventsToSend();
+		if (numEvents > 0)
+			notifyEvent(residentInfo, numEvents);
 	}
 	residentInfo->queueLock.unlock();
-	if (notifyInfo)
-		notifyEvent(residentInfo, notifyInfo);
 }
 
 /*
  * executed on the following thread(s)
  * - Threads that call checkEvents()
- *     [from notifyEvent()]
+ *     [from tryNotifyEvent()]
  * - The default GLIB event dispacther thread (main)
- *     [from notifyEvent()]
+ *     [from tryNotifyEvent()]
  */
-void ActionManager::notifyEvent(ResidentInfo *residentInfo,
-                                ResidentNotifyInfo *notifyInfo)
+void ActionManager::notifyEvent(ResidentInfo *residentInfo, size_t numEvents)
 {
+	ResidentNotifyQueue &queue = residentInfo->notifyQueue;
+	const size_t head = residentInfo->numInFlight;
+	const size_t tail = head + numEvents;
+	size_t bodySize = RESIDENT_PROTO_EVENT_BATCH_NUM_EVENTS_LEN;
+	for (size_t i = head; i < tail; i++) {
+		bodySize += RESIDENT_PROTO_EVENT_BATCH_ITEM_HEADER_LEN;
+		bodySize += ResidentCommunicator::calcNotifyEventBodySize(
+		              queue[i]->eventInfo);
+	}
+
 	ResidentCommunicator comm;
-	comm.setNotifyEventBody(residentInfo->actionDef.id,
-	                        notifyInfo->eventInfo,
-	                        notifyInfo->sessionId);
+	comm.setNotifyEventBatchHeader(bodySize, numEvents);
+	ThreadLocalDBCache cache;
+	for (size_t i = head; i < tail; i++) {
+		ResidentNotifyInfo *notifyInfo = queue[i];
+		notifyInfo->requestId = residentInfo->nextRequestId++;
+		comm.addNotifyEventBatchItem(notifyInfo->requestId,
+		                             residentInfo->actionDef.id,
+		                             notifyInfo->eventInfo,
+		                             notifyInfo->sessionId);
+
+		// The log is updated before the push. Or the ack might be
+		// processed before it.
+		HATOHOL_ASSERT(notifyInfo->logId != INVALID_ACTION_LOG_ID,
+		               "An action log ID is not set.");
+		cache.getAction().updateLogStatusToStart(notifyInfo->logId);
+		notifyInfo->sentTime = steady_clock::now();
+		Impl::residentLaunchLatency.recordSince(
+		  notifyInfo->dispatchTime);
+	}
 	comm.push(residentInfo->pipeWr);
+	residentInfo->numInFlight = tail;
 
-	// wait for result code
-	residentInfo->setPullCallbackArg(notifyInfo);
-	residentInfo->pullData(RESIDENT_PROTO_HEADER_LEN +
-	                       RESIDENT_PROTO_EVENT_ACK_CODE_LEN,
-	                       gotNotifyEventAckCb);
-
-	// create or update an action log
-	HATOHOL_ASSERT(notifyInfo->logId != INVALID_ACTION_LOG_ID,
-	               "An action log ID is not set.");
-	ThreadLocalDBCache cache;
-	cache.getAction().updateLogStatusToStart(notifyInfo->logId);
+	// Only one pull for the ack is pending at a time. The acks of
+	// the following batches are pulled in gotNotifyEventBatchAckCb().
+	if (residentInfo->waitingAck)
+		return;
+	residentInfo->waitingAck = true;
+	residentInfo->setPullCallbackArg(queue.front());
+	residentInfo->pullHeader(gotNotifyEventAckCb);
 }
 
 /*
@@ -1306,7 +1692,8 @@ void ActionManager::notifyEvent(ResidentInfo *residentInfo,
  */
 static void onIncidentSenderJobStatusChanged(
   const IncidentSender &sender, const EventInfo &info,
-  const IncidentSender::JobStatus &status, void *userData)
+  const IncidentSender::JobStatus &status, const HatoholError &result,
+  void *userData)
 {
 	DBTablesAction::LogEndExecActionArg *logArg
 	  = static_cast<DBTablesAction::LogEndExecActionArg *>(userData);
@@ -1366,8 +1753,12 @@ void ActionManager::execIncidentSenderAction(const ActionDef &actionDef,
 	logArg->logId = dbAction.createActionLog(actionDef, eventInfo,
 						 ACTLOG_EXECFAIL_NONE,
 						 ACTLOG_STAT_QUEUING);
+	// Events that an action sends repeatedly for the same trigger are
+	// coalesced into one incident.
+	const bool coalescable = true;
 	senderManager.queue(trackerId, eventInfo,
-			    onIncidentSenderJobStatusChanged, logArg);
+			    onIncidentSenderJobStatusChanged, logArg,
+			    USER_ID_SYSTEM, coalescable);
 }
 
 /*
@@ -1376,6 +1767,11 @@ void ActionManager::execIncidentSenderAction(const ActionDef &actionDef,
  */
 void ActionManager::commandActorCollectedCb(const ActorInfo *actorInfo)
 {
+	// The run time of the spawner case is recorded with the result
+	// from the spawner.
+	if (actorInfo->startTime != steady_clock::time_point())
+		Impl::commandRunTime.recordSince(actorInfo->startTime);
+
 	// remove this actor from CommandActionContext::runningSet.
 	CommandActionContext::remove(actorInfo->logId);
 
@@ -1415,6 +1811,7 @@ void ActionManager::commandActorPostCollectedCb(const ActorInfo *actorInfo)
 	postprocCtx.actorInfoCopy = NULL;
 	postprocCtx.reservationId = waitCmdInfo->reservationId;
 	postprocCtx.waitCmdInfo = waitCmdInfo;
+	postprocCtx.dispatchTime = waitCmdInfo->dispatchTime;
 	ThreadLocalDBCache cache;
 	execCommandActionCore(waitCmdInfo->actionDef, waitCmdInfo->eventInfo,
 	                      cache.getAction(),
@@ -1488,21 +1885,38 @@ void ActionManager::closeResident(ResidentInfo *residentInfo)
 void ActionManager::closeResident(ResidentNotifyInfo *notifyInfo,
                                   ActionLogExecFailureCode failureCode)
 {
-	DBTablesAction::LogEndExecActionArg logArg;
-	logArg.logId = notifyInfo->logId;
-	logArg.status = ACTLOG_STAT_FAILED;
-	logArg.failureCode = failureCode;
-	logArg.exitCode = 0;
+	// The other events in flight are never acknowledged after
+	// hatohol-resident-yard is killed. So they are also logged as failed.
+	// The log ID of a logged one is cleared so that it isn't logged
+	// again when the pipe is closed.
+	ResidentInfo *residentInfo = notifyInfo->residentInfo;
+	vector<uint64_t> logIds;
+	residentInfo->queueLock.lock();
+	if (notifyInfo->logId != INVALID_ACTION_LOG_ID) {
+		logIds.push_back(notifyInfo->logId);
+		notifyInfo->logId = INVALID_ACTION_LOG_ID;
+	}
+	for (size_t i = 0; i < residentInfo->numInFlight; i++) {
+		ResidentNotifyInfo *inFlightInfo = residentInfo->notifyQueue[i];
+		if (inFlightInfo->logId == INVALID_ACTION_LOG_ID)
+			continue;
+		logIds.push_back(inFlightInfo->logId);
+		inFlightInfo->logId = INVALID_ACTION_LOG_ID;
+	}
+	residentInfo->queueLock.unlock();
+
 	ThreadLocalDBCache cache;
-	cache.getAction().logEndExecAction(logArg);
+	for (size_t i = 0; i < logIds.size(); i++) {
+		DBTablesAction::LogEndExecActionArg logArg;
+		logArg.logId = logIds[i];
+		logArg.status = ACTLOG_STAT_FAILED;
+		logArg.failureCode = failureCode;
+		logArg.exitCode = 0;
+		cache.getAction().logEndExecAction(logArg);
+	}
 
-	// remove this notifyInfo from the queue in the parent ResidentInfo
-	ResidentInfo *residentInfo = notifyInfo->residentInfo;
 	pid_t pid = residentInfo->pid;
 	ActorCollector::setDontLog(pid);
-	// NOTE: Hereafter we cannot access 'notifyInfo', because it is
-	//       deleted in the above function.
-
 	closeResident(residentInfo);
 }
 
@@ -1566,10 +1980,8 @@ void ActionManager::fillTriggerInfoInEventInfo(EventInfo &eventInfo)
 	ThreadLocalDBCache cache;
 	DBTablesMonitoring &dbMonitoring = cache.getMonitoring();
 	TriggerInfo triggerInfo;
-	TriggersQueryOption option(USER_ID_SYSTEM);
-	option.setTargetServerId(eventInfo.serverId);
-	option.setTargetId(eventInfo.triggerId);
-	bool succedded = dbMonitoring.getTriggerInfo(triggerInfo, option);
+	bool succedded = dbMonitoring.getTriggerInfo(
+	  triggerInfo, eventInfo.serverId, eventInfo.triggerId);
 	if (succedded) {
 		eventInfo.severity = triggerInfo.severity;
 		eventInfo.globalHostId   = triggerInfo.globalHostId;
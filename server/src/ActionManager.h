@@ -27,6 +27,8 @@
 #include "ActorCollector.h"
 #include "NamedPipe.h"
 #include "StringUtils.h"
+#include "ActionSpawnerPool.h"
+#include "LatencyHistogram.h"
 
 struct ResidentInfo;
 
@@ -54,7 +56,37 @@ public:
 	static const char *ENV_NAME_SESSION_ID;
 
 	struct ResidentNotifyInfo;
+
+	/**
+	 * Statistics of actions. Latencies are in microseconds.
+	 */
+	struct Statistics {
+		uint64_t numDispatchedActions;
+		uint64_t numCommandTimeouts;
+		uint64_t numResidentTimeouts;
+
+		// From runAction() to the start of the actor.
+		LatencyHistogram::Snapshot commandLaunchLatency;
+		// From the start of the actor to the exit.
+		LatencyHistogram::Snapshot commandRunTime;
+		// From runAction() to the notification to the yard.
+		LatencyHistogram::Snapshot residentLaunchLatency;
+		// From the notification to the ack.
+		LatencyHistogram::Snapshot residentRunTime;
+
+		// Gauges at the time of getStatistics()
+		size_t numOnstageCommandActions;
+		size_t numWaitingCommandActions;
+		size_t numPendingSpawnerRequests;
+		size_t numResidentYards;
+		size_t numQueuedResidentEvents;
+		size_t numInFlightResidentEvents;
+
+		Statistics(void);
+	};
+
 	static void reset(void);
+	static void getStatistics(Statistics &stats);
 
 	ActionManager(void);
 	virtual ~ActionManager();
@@ -99,6 +131,10 @@ protected:
 	static void gotNotifyEventAckCb(GIOStatus stat, mlpl::SmartBuffer &sbuf,
 	                                size_t size,
 	                                ResidentNotifyInfo *residentInfo);
+	static void gotNotifyEventBatchAckCb(GIOStatus stat,
+	                                     mlpl::SmartBuffer &sbuf,
+	                                     size_t size,
+	                                     ResidentNotifyInfo *notifyInfo);
 	static void sendParameters(ResidentInfo *residentInfo);
 	static gboolean commandActionTimeoutCb(gpointer data);
 	static void residentActionTimeoutCb(NamedPipe *namedPipe,
@@ -164,6 +200,25 @@ protected:
 	  const ActionDef &actionDef, const EventInfo &eventInfo,
 	  DBTablesAction &dbAction, void *postprocCtx,
 	  const mlpl::StringVector &argVect);
+
+	/**
+	 * Execute a command-type action with hatohol-action-spawner instead
+	 * of spawn(). This is used when ConfigManager has a positive
+	 * number of the action spawners.
+	 *
+	 * @param spawnerPool An ActionSpawnerPool instance.
+	 *
+	 * Other parameters are the same as execCommandActionCore().
+	 */
+	static void execCommandActionBySpawner(
+	  ActionSpawnerPool &spawnerPool,
+	  const ActionDef &actionDef, const EventInfo &eventInfo,
+	  DBTablesAction &dbAction, void *postprocCtx,
+	  const mlpl::StringVector &argVect);
+
+	static void commandActionSpawnerCompletedCb(
+	  const ActorInfo &actorInfo, const ActionSpawnerPool::Result &result,
+	  const uint64_t &submitUsec);
 	
 	static void addCommandDirectory(std::string &path);
 
@@ -194,28 +249,27 @@ protected:
 	                                       DBTablesAction &dbAction,
 	                                       ActorInfo *actorInfoCopy);
 	/**
-	 * notify hatohol-resident-yard of an event only when it is idle and
-	 * there is at least one element in residentInfo->notifyQueue.
-	 * Othewise the request is processed later.
+	 * notify hatohol-resident-yard of events that have not been sent
+	 * in residentInfo->notifyQueue when the module has been loaded.
+	 * Events are sent without waiting for the ack of the previous ones
+	 * as long as the number of unacknowledged events is within the
+	 * window. Othewise the request is processed later.
 	 *
 	 * @param residentInfo A residentInfo instance.
 	 */
 	void tryNotifyEvent(ResidentInfo *residentInfo);
 
 	/**
-	 * notify hatohol-resident-yard of an event at the top of notifyQueue.
+	 * notify hatohol-resident-yard of events with a Notify Event Batch
+	 * packet. The events are the ones that follow the in-flight events
+	 * in notifyQueue. The action logs of them are updated to STARTED.
 	 * NOTE: This function is assumed to be called only from
-	 * tryNotifyEvent().
+	 * tryNotifyEvent() with taking queueLock.
 	 *
 	 * @param residentInfo A residentInfo instance.
-	 *
-	 * @param notifyInfo.
-	 * A ResidentNotifyInfo instance. If the member: logId is
-	 * INVALID_ACTION_LOG_ID, the new log record is created.
-	 * Otherwise the record with it will be updated.
+	 * @param numEvents The number of events to be sent.
 	 */
-	void notifyEvent(ResidentInfo *residentInfo,
-	                 ResidentNotifyInfo *notifyInfo);
+	void notifyEvent(ResidentInfo *residentInfo, size_t numEvents);
 
 	void execIncidentSenderAction(const ActionDef &actionDef,
 				      const EventInfo &eventInfo,
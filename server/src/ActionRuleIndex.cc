@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <set>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "ActionRuleIndex.h"
+#include "ThreadLocalDBCache.h"
+#include "UnifiedDataStore.h"
+
+using namespace std;
+using namespace mlpl;
+
+typedef vector<size_t> ActionPositionVect;
+
+struct ActionRuleIndex::Impl
+{
+	// Sorted by the action ID.
+	vector<ActionDef> m_actions;
+
+	unordered_map<TriggerIdType, ActionPositionVect>   m_byTrigger;
+	unordered_map<LocalHostIdType, ActionPositionVect> m_byHost;
+	unordered_map<HostgroupIdType, ActionPositionVect> m_byHostgroup;
+	unordered_map<ServerIdType, ActionPositionVect>    m_byServer;
+	ActionPositionVect                                 m_others;
+
+	map<ServerIdType, unordered_map<LocalHostIdType, set<HostgroupIdType>>>
+	  m_hostgroupMap;
+
+	void addAction(const size_t &pos)
+	{
+		const ActionCondition &cond = m_actions[pos].condition;
+		if (cond.isEnable(ACTCOND_TRIGGER_ID))
+			m_byTrigger[cond.triggerId].push_back(pos);
+		else if (cond.isEnable(ACTCOND_HOST_ID))
+			m_byHost[cond.hostIdInServer].push_back(pos);
+		else if (cond.isEnable(ACTCOND_HOST_GROUP_ID))
+			m_byHostgroup[cond.hostgroupId].push_back(pos);
+		else if (cond.isEnable(ACTCOND_SERVER_ID))
+			m_byServer[cond.serverId].push_back(pos);
+		else
+			m_others.push_back(pos);
+	}
+
+	const set<HostgroupIdType> *findHostgroups(
+	  const EventInfo &eventInfo) const
+	{
+		auto serverIt = m_hostgroupMap.find(eventInfo.serverId);
+		if (serverIt == m_hostgroupMap.end())
+			return NULL;
+		auto hostIt = serverIt->second.find(eventInfo.hostIdInServer);
+		if (hostIt == serverIt->second.end())
+			return NULL;
+		return &hostIt->second;
+	}
+
+	static bool matchSeverity(const ActionCondition &cond,
+	                          const EventInfo &eventInfo)
+	{
+		if (!cond.isEnable(ACTCOND_TRIGGER_SEVERITY))
+			return true;
+		switch (cond.triggerSeverityCompType) {
+		case CMP_EQ:
+			return eventInfo.severity == cond.triggerSeverity;
+		case CMP_EQ_GT:
+			return eventInfo.severity >= cond.triggerSeverity;
+		default:
+			return false;
+		}
+	}
+
+	static bool matchCondition(const ActionCondition &cond,
+	                           const EventInfo &eventInfo,
+	                           const set<HostgroupIdType> *hostgroups)
+	{
+		if (cond.isEnable(ACTCOND_SERVER_ID) &&
+		    cond.serverId != eventInfo.serverId)
+			return false;
+		if (cond.isEnable(ACTCOND_HOST_ID) &&
+		    cond.hostIdInServer != eventInfo.hostIdInServer)
+			return false;
+		if (cond.isEnable(ACTCOND_HOST_GROUP_ID) &&
+		    (!hostgroups || !hostgroups->count(cond.hostgroupId)))
+			return false;
+		if (cond.isEnable(ACTCOND_TRIGGER_ID) &&
+		    cond.triggerId != eventInfo.triggerId)
+			return false;
+		if (cond.isEnable(ACTCOND_TRIGGER_STATUS) &&
+		    cond.triggerStatus != eventInfo.status)
+			return false;
+		return matchSeverity(cond, eventInfo);
+	}
+
+	template<typename KeyType>
+	void collect(ActionPositionVect &positions,
+	             const unordered_map<KeyType, ActionPositionVect> &table,
+	             const KeyType &key) const
+	{
+		auto it = table.find(key);
+		if (it != table.end())
+			collect(positions, it->second);
+	}
+
+	void collect(ActionPositionVect &positions,
+	             const ActionPositionVect &candidates) const
+	{
+		positions.insert(positions.end(),
+		                 candidates.begin(), candidates.end());
+	}
+};
+
+struct SharedActionRuleIndex {
+	mutex lock;
+	atomic<uint64_t> generation;
+	uint64_t compiledGeneration;
+	shared_ptr<const ActionRuleIndex> index;
+
+	SharedActionRuleIndex(void)
+	: generation(0),
+	  compiledGeneration(0)
+	{
+	}
+
+	shared_ptr<const ActionRuleIndex> compile(void)
+	{
+		ActionDefList actionDefList;
+		ActionsQueryOption actionOption(USER_ID_SYSTEM);
+		actionOption.setActionType(ACTION_ALL);
+		ThreadLocalDBCache cache;
+		cache.getAction().getActionList(actionDefList, actionOption);
+
+		HostgroupMemberVect hostgroupMembers;
+		HostgroupMembersQueryOption memberOption(USER_ID_SYSTEM);
+		UnifiedDataStore::getInstance()->getHostgroupMembers(
+		  hostgroupMembers, memberOption);
+
+		return make_shared<ActionRuleIndex>(actionDefList,
+		                                    hostgroupMembers);
+	}
+};
+
+static SharedActionRuleIndex sharedIndex;
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+ActionRuleIndex::ActionRuleIndex(const ActionDefList &actionDefList,
+                                 const HostgroupMemberVect &hostgroupMembers)
+: m_impl(new Impl())
+{
+	m_impl->m_actions.assign(actionDefList.begin(), actionDefList.end());
+	sort(m_impl->m_actions.begin(), m_impl->m_actions.end(),
+	     [](const ActionDef &lhs, const ActionDef &rhs) {
+		return lhs.id < rhs.id;
+	});
+	for (size_t pos = 0; pos < m_impl->m_actions.size(); pos++)
+		m_impl->addAction(pos);
+
+	for (auto &member : hostgroupMembers) {
+		m_impl->m_hostgroupMap[member.serverId][member.hostIdInServer]
+		  .insert(member.hostgroupIdInServer);
+	}
+}
+
+ActionRuleIndex::~ActionRuleIndex()
+{
+}
+
+void ActionRuleIndex::match(ActionDefList &actionDefList,
+                            const EventInfo &eventInfo) const
+{
+	const set<HostgroupIdType> *hostgroups =
+	  m_impl->findHostgroups(eventInfo);
+
+	// Each action is registered in only one table. So there's no
+	// duplication in the candidates.
+	ActionPositionVect candidates;
+	m_impl->collect(candidates, m_impl->m_byTrigger, eventInfo.triggerId);
+	m_impl->collect(candidates, m_impl->m_byHost, eventInfo.hostIdInServer);
+	if (hostgroups) {
+		for (auto &hostgroupId : *hostgroups) {
+			m_impl->collect(candidates, m_impl->m_byHostgroup,
+			                hostgroupId);
+		}
+	}
+	m_impl->collect(candidates, m_impl->m_byServer, eventInfo.serverId);
+	m_impl->collect(candidates, m_impl->m_others);
+
+	sort(candidates.begin(), candidates.end());
+	for (auto pos : candidates) {
+		const ActionDef &actionDef = m_impl->m_actions[pos];
+		if (Impl::matchCondition(actionDef.condition, eventInfo,
+		                         hostgroups))
+			actionDefList.push_back(actionDef);
+	}
+}
+
+size_t ActionRuleIndex::getNumberOfActions(void) const
+{
+	return m_impl->m_actions.size();
+}
+
+shared_ptr<const ActionRuleIndex> ActionRuleIndex::getShared(void)
+{
+	lock_guard<mutex> lock(sharedIndex.lock);
+	// The generation is read before the compilation so that a change
+	// during it makes the next call compile again.
+	const uint64_t generation = sharedIndex.generation;
+	if (!sharedIndex.index ||
+	    sharedIndex.compiledGeneration != generation) {
+		sharedIndex.index = sharedIndex.compile();
+		sharedIndex.compiledGeneration = generation;
+	}
+	return sharedIndex.index;
+}
+
+void ActionRuleIndex::invalidate(void)
+{
+	sharedIndex.generation++;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef ActionRuleIndex_h
+#define ActionRuleIndex_h
+
+#include <memory>
+#include "DBTablesAction.h"
+#include "DBTablesHost.h"
+
+/**
+ * Action definitions compiled for matching events in memory.
+ *
+ * Each action is registered in a hash table keyed by the most selective
+ * condition it has (trigger, host, hostgroup, server in this order).
+ * match() looks up the tables with the values of an event and checks
+ * the rest of the conditions of the found actions only. The result is
+ * the same as DBTablesAction::getActionList() with
+ * ActionsQueryOption::setTargetEventInfo() for USER_ID_SYSTEM.
+ */
+class ActionRuleIndex {
+public:
+	ActionRuleIndex(const ActionDefList &actionDefList,
+	                const HostgroupMemberVect &hostgroupMembers);
+	virtual ~ActionRuleIndex();
+
+	/**
+	 * Get actions whose conditions match an event.
+	 *
+	 * @param actionDefList
+	 * Matched actions are appended in the ascending order of the ID.
+	 * @param eventInfo A target event.
+	 */
+	void match(ActionDefList &actionDefList,
+	           const EventInfo &eventInfo) const;
+
+	size_t getNumberOfActions(void) const;
+
+	/**
+	 * Get the index shared in the process. It is compiled from the DB
+	 * on the first call and on the call after invalidate().
+	 *
+	 * @return The compiled index. It isn't changed by invalidate().
+	 */
+	static std::shared_ptr<const ActionRuleIndex> getShared(void);
+
+	/**
+	 * Mark the shared index outdated. This has to be called when
+	 * actions, hostgroup members, or the things ActionValidator checks
+	 * (users and incident trackers) are changed. This method is
+	 * MT-safe and doesn't access the DB.
+	 */
+	static void invalidate(void);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // ActionRuleIndex_h
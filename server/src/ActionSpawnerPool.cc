@@ -0,0 +1,566 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <errno.h>
+#include <signal.h>
+#include <Logger.h>
+#include "ActionSpawnerPool.h"
+#include "ActionSpawnerProtocol.h"
+#include "ResidentCommunicator.h"
+#include "ChildProcessManager.h"
+#include "NamedPipe.h"
+#include "Utils.h"
+using namespace std;
+using namespace std::chrono;
+using namespace mlpl;
+
+typedef ActionSpawnerPool::CompletedCallback CompletedCallback;
+
+struct SpawnJob {
+	uint64_t                  requestId;
+	ActionSpawnerPool::Request request;
+	CompletedCallback         completedCb;
+	steady_clock::time_point  submittedTime;
+	ActionSpawnerPool::Result result;
+};
+typedef shared_ptr<SpawnJob>     SpawnJobPtr;
+typedef deque<SpawnJobPtr>       SpawnJobQueue;
+typedef map<uint64_t, SpawnJobPtr> SpawnJobMap;
+
+struct Spawner;
+
+// A pair of the pipes to a spawner process. This is made for each launch,
+// so that a pending pull of the previous process does not remain.
+struct SpawnerPipe : public ResidentPullHelper<Spawner> {
+	NamedPipe rd;
+	NamedPipe wr;
+
+	SpawnerPipe(Spawner *spawner)
+	: rd(NamedPipe::END_TYPE_MASTER_READ),
+	  wr(NamedPipe::END_TYPE_MASTER_WRITE)
+	{
+		initResidentPullHelper(&rd, spawner);
+	}
+};
+
+// This is shared by the pool and its spawners, because a spawner can
+// outlive the pool until the spawner process is collected.
+struct SpawnerPoolContext {
+	mutex            lock;
+	bool             closed;
+	string           spawnerPath;
+	vector<Spawner *> spawners;
+	SpawnJobQueue    waitingJobs; // jobs before any spawner gets ready
+	uint64_t         lastRequestId;
+	ActionSpawnerPool::Statistics stats;
+
+	SpawnerPoolContext(void)
+	: closed(false),
+	  lastRequestId(0)
+	{
+	}
+};
+typedef shared_ptr<SpawnerPoolContext> SpawnerPoolContextPtr;
+
+static void completeJobs(SpawnJobQueue &jobs)
+{
+	for (auto &job : jobs) {
+		if (job->completedCb)
+			job->completedCb(job->result);
+	}
+}
+
+/*
+ * The callbacks of the pipes are executed on the default GLIB event
+ * dispatcher thread (main). onCollected() and onReset() are executed
+ * on the ChildProcessManager thread. So they only schedule close() on
+ * the main thread.
+ */
+struct Spawner : public ChildProcessManager::EventCallback {
+
+	SpawnerPoolContextPtr  ctx;
+	const size_t           index;
+	string                 pipeName;
+	unique_ptr<SpawnerPipe> pipe;
+	pid_t                  pid;
+	bool                   alive; // should be used with ctx->lock
+	bool                   ready; // should be used with ctx->lock
+	SpawnJobMap            jobMap; // should be used with ctx->lock
+
+	Spawner(SpawnerPoolContextPtr _ctx, const size_t &_index)
+	: ctx(_ctx),
+	  index(_index),
+	  pid(0),
+	  alive(false),
+	  ready(false)
+	{
+		pipeName = StringUtils::sprintf("action-spawner-%zd", index);
+	}
+
+	/**
+	 * Launch a spawner process. ctx->lock must be taken.
+	 *
+	 * @return true if the process is created. Otherwise false.
+	 */
+	bool launch(void)
+	{
+		pipe.reset(new SpawnerPipe(this));
+		if (!pipe->rd.init(pipeName, pipeErrCb, this) ||
+		    !pipe->wr.init(pipeName, pipeErrCb, this)) {
+			pipe.reset();
+			return false;
+		}
+
+		ChildProcessManager::CreateArg arg;
+		arg.args.push_back(ctx->spawnerPath);
+		arg.args.push_back(pipeName);
+		ref(); // The reference is released in ~CreateArg().
+		arg.eventCb = this;
+		HatoholError err = ChildProcessManager::getInstance()->create(arg);
+		if (err != HTERR_OK) {
+			pipe.reset();
+			return false;
+		}
+		pid = arg.pid;
+		alive = true;
+		ready = false;
+		pipe->pullHeader(launchedCb);
+		return true;
+	}
+
+	void send(SpawnJobPtr job)
+	{
+		// This function assumes that ctx->lock is being locked.
+		const ActionSpawnerPool::Request &req = job->request;
+		size_t bodySize = ACTION_SPAWNER_SPAWN_REQUEST_ID_LEN +
+		                  ACTION_SPAWNER_SPAWN_TIMEOUT_LEN +
+		                  ACTION_SPAWNER_SPAWN_STRING_SIZE_LEN +
+		                  req.workingDirectory.size() +
+		                  ACTION_SPAWNER_SPAWN_NUM_ARGS_LEN +
+		                  ACTION_SPAWNER_SPAWN_NUM_ENVS_LEN;
+		for (auto &arg : req.args)
+			bodySize += ACTION_SPAWNER_SPAWN_STRING_SIZE_LEN + arg.size();
+		for (auto &env : req.envs)
+			bodySize += ACTION_SPAWNER_SPAWN_STRING_SIZE_LEN + env.size();
+
+		ResidentCommunicator comm;
+		comm.setHeader(bodySize, ACTION_SPAWNER_PKT_TYPE_SPAWN);
+		SmartBuffer &sbuf = comm.getBuffer();
+		sbuf.add64(job->requestId);
+		sbuf.add32(req.timeout > 0 ? req.timeout : 0);
+		addString(sbuf, req.workingDirectory);
+		sbuf.add16(req.args.size());
+		for (auto &arg : req.args)
+			addString(sbuf, arg);
+		sbuf.add16(req.envs.size());
+		for (auto &env : req.envs)
+			addString(sbuf, env);
+		comm.push(pipe->wr);
+
+		jobMap[job->requestId] = job;
+	}
+
+	void terminate(void)
+	{
+		if (pid && kill(pid, SIGKILL)) {
+			MLPL_ERR("Failed to kill. pid: %d, %s\n",
+			         pid, g_strerror(errno));
+		}
+	}
+
+	virtual void onCollected(const siginfo_t *siginfo) override
+	{
+		MLPL_WARN("%s (pid: %d) exited: code: %d, status: %d\n",
+		          ActionSpawnerPool::SPAWNER_NAME, siginfo->si_pid,
+		          siginfo->si_code, siginfo->si_status);
+		scheduleClose();
+	}
+
+	virtual void onReset(void) override
+	{
+		scheduleClose();
+	}
+
+protected:
+	virtual ~Spawner()
+	{
+	}
+
+	static void addString(SmartBuffer &sbuf, const string &str)
+	{
+		sbuf.add32(str.size());
+		sbuf.add(str.c_str(), str.size());
+	}
+
+	void scheduleClose(void)
+	{
+		ref(); // released in closeOnGLibEventLoop()
+		Utils::executeOnGLibEventLoop<Spawner>(
+		  closeOnGLibEventLoop, this, ASYNC);
+	}
+
+	static void closeOnGLibEventLoop(Spawner *obj)
+	{
+		SpawnJobQueue lostJobs;
+		unique_lock<mutex> lock(obj->ctx->lock);
+		obj->pipe.reset();
+		obj->alive = false;
+		obj->ready = false;
+		obj->pid = 0;
+		for (auto &jobPair : obj->jobMap) {
+			SpawnJobPtr job = jobPair.second;
+			job->result.lostSpawner = true;
+			lostJobs.push_back(job);
+		}
+		obj->jobMap.clear();
+		obj->ctx->stats.numLost += lostJobs.size();
+
+		// Jobs waiting for the spawner will never be dispatched
+		// if no other spawner is alive.
+		bool hasAliveSpawner = false;
+		for (auto spawner : obj->ctx->spawners)
+			hasAliveSpawner |= spawner->alive;
+		if (!hasAliveSpawner) {
+			for (auto &job : obj->ctx->waitingJobs) {
+				job->result.errorNumber = ECHILD;
+				lostJobs.push_back(job);
+			}
+			obj->ctx->waitingJobs.clear();
+		}
+		const bool closed = obj->ctx->closed;
+		lock.unlock();
+
+		if (!closed)
+			completeJobs(lostJobs);
+		obj->unref();
+	}
+
+	static gboolean pipeErrCb(GIOChannel *source, GIOCondition condition,
+	                          gpointer data)
+	{
+		Spawner *obj = static_cast<Spawner *>(data);
+		MLPL_ERR("Pipe error: condition: %s (%x)\n",
+		         Utils::getStringFromGIOCondition(condition).c_str(),
+		         condition);
+		// The pipes are closed after the process is collected.
+		obj->terminate();
+		return FALSE;
+	}
+
+	static bool checkStatus(GIOStatus stat, Spawner *obj)
+	{
+		if (stat == G_IO_STATUS_NORMAL)
+			return true;
+		MLPL_ERR("Error: status: %x\n", stat);
+		obj->terminate();
+		return false;
+	}
+
+	static void launchedCb(GIOStatus stat, SmartBuffer &sbuf,
+	                       size_t size, Spawner *obj)
+	{
+		if (!checkStatus(stat, obj))
+			return;
+		int pktType = ResidentCommunicator::getPacketType(sbuf);
+		if (pktType != ACTION_SPAWNER_PKT_TYPE_LAUNCHED) {
+			MLPL_ERR("Unexpected packet: %d\n", pktType);
+			obj->terminate();
+			return;
+		}
+
+		lock_guard<mutex> lock(obj->ctx->lock);
+		obj->ready = true;
+		SpawnJobQueue &waitingJobs = obj->ctx->waitingJobs;
+		while (!waitingJobs.empty()) {
+			obj->send(waitingJobs.front());
+			waitingJobs.pop_front();
+		}
+		obj->pipe->pullHeader(replyCb);
+	}
+
+	static void replyCb(GIOStatus stat, SmartBuffer &sbuf,
+	                    size_t size, Spawner *obj)
+	{
+		if (!checkStatus(stat, obj))
+			return;
+		int pktType = ResidentCommunicator::getPacketType(sbuf);
+		size_t bodySize = ResidentCommunicator::getBodySize(sbuf);
+		if (pktType == ACTION_SPAWNER_PKT_TYPE_SPAWNED &&
+		    bodySize == ACTION_SPAWNER_SPAWNED_BODY_LEN) {
+			obj->pipe->pullData(bodySize, spawnedCb);
+		} else if (pktType == ACTION_SPAWNER_PKT_TYPE_EXITED &&
+		           bodySize == ACTION_SPAWNER_EXITED_BODY_LEN) {
+			obj->pipe->pullData(bodySize, exitedCb);
+		} else {
+			MLPL_ERR("Unexpected packet: %d, size: %zd\n",
+			         pktType, bodySize);
+			obj->terminate();
+		}
+	}
+
+	static void spawnedCb(GIOStatus stat, SmartBuffer &sbuf,
+	                      size_t size, Spawner *obj)
+	{
+		if (!checkStatus(stat, obj))
+			return;
+		const uint64_t requestId = sbuf.getValueAndIncIndex<uint64_t>();
+		const int32_t errorNumber = sbuf.getValueAndIncIndex<int32_t>();
+		const uint32_t pid = sbuf.getValueAndIncIndex<uint32_t>();
+		const uint64_t spawnUsec = sbuf.getValueAndIncIndex<uint64_t>();
+
+		SpawnJobQueue failedJobs;
+		unique_lock<mutex> lock(obj->ctx->lock);
+		SpawnJobMap::iterator it = obj->jobMap.find(requestId);
+		if (it == obj->jobMap.end()) {
+			MLPL_BUG("Unknown request ID: %" PRIu64 "\n", requestId);
+		} else {
+			SpawnJobPtr job = it->second;
+			ActionSpawnerPool::Result &result = job->result;
+			result.errorNumber = errorNumber;
+			result.pid = pid;
+			result.spawnUsec = spawnUsec;
+			result.dispatchUsec = duration_cast<microseconds>(
+			  steady_clock::now() - job->submittedTime).count();
+
+			ActionSpawnerPool::Statistics &stats = obj->ctx->stats;
+			if (errorNumber == 0)
+				stats.numSpawned++;
+			else
+				stats.numSpawnFailures++;
+			stats.totalDispatchUsec += result.dispatchUsec;
+			stats.totalSpawnUsec += result.spawnUsec;
+			if (result.dispatchUsec > stats.maxDispatchUsec)
+				stats.maxDispatchUsec = result.dispatchUsec;
+			if (result.spawnUsec > stats.maxSpawnUsec)
+				stats.maxSpawnUsec = result.spawnUsec;
+
+			// No exited notify comes on failure.
+			if (errorNumber != 0) {
+				failedJobs.push_back(job);
+				obj->jobMap.erase(it);
+			}
+		}
+		obj->pipe->pullHeader(replyCb);
+		lock.unlock();
+		completeJobs(failedJobs);
+	}
+
+	static void exitedCb(GIOStatus stat, SmartBuffer &sbuf,
+	                     size_t size, Spawner *obj)
+	{
+		if (!checkStatus(stat, obj))
+			return;
+		const uint64_t requestId = sbuf.getValueAndIncIndex<uint64_t>();
+		const int32_t code = sbuf.getValueAndIncIndex<int32_t>();
+		const int32_t status = sbuf.getValueAndIncIndex<int32_t>();
+		const uint8_t killedByTimeout = sbuf.getValueAndIncIndex<uint8_t>();
+		const uint64_t runUsec = sbuf.getValueAndIncIndex<uint64_t>();
+
+		SpawnJobQueue exitedJobs;
+		unique_lock<mutex> lock(obj->ctx->lock);
+		SpawnJobMap::iterator it = obj->jobMap.find(requestId);
+		if (it == obj->jobMap.end()) {
+			MLPL_BUG("Unknown request ID: %" PRIu64 "\n", requestId);
+		} else {
+			SpawnJobPtr job = it->second;
+			job->result.code = code;
+			job->result.status = status;
+			job->result.killedByTimeout = killedByTimeout;
+			job->result.runUsec = runUsec;
+			exitedJobs.push_back(job);
+			obj->jobMap.erase(it);
+		}
+		obj->pipe->pullHeader(replyCb);
+		lock.unlock();
+
+		for (auto &job : exitedJobs) {
+			const ActionSpawnerPool::Result &result = job->result;
+			MLPL_DBG("Actor: %d, request: %" PRIu64 ", "
+			         "dispatch: %" PRIu64 "us, spawn: %" PRIu64 "us, "
+			         "run: %" PRIu64 "us\n",
+			         result.pid, job->requestId, result.dispatchUsec,
+			         result.spawnUsec, result.runUsec);
+		}
+		completeJobs(exitedJobs);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Request, Result and Statistics
+// ---------------------------------------------------------------------------
+ActionSpawnerPool::Request::Request(void)
+: timeout(0)
+{
+}
+
+ActionSpawnerPool::Result::Result(void)
+: errorNumber(0),
+  pid(0),
+  code(0),
+  status(0),
+  killedByTimeout(false),
+  lostSpawner(false),
+  dispatchUsec(0),
+  spawnUsec(0),
+  runUsec(0)
+{
+}
+
+ActionSpawnerPool::Statistics::Statistics(void)
+: numSpawned(0),
+  numSpawnFailures(0),
+  numLost(0),
+  totalDispatchUsec(0),
+  maxDispatchUsec(0),
+  totalSpawnUsec(0),
+  maxSpawnUsec(0)
+{
+}
+
+// ---------------------------------------------------------------------------
+// Impl
+// ---------------------------------------------------------------------------
+struct ActionSpawnerPool::Impl {
+	SpawnerPoolContextPtr ctx;
+
+	Impl(const size_t &numSpawners, const string &spawnerPath)
+	: ctx(make_shared<SpawnerPoolContext>())
+	{
+		HATOHOL_ASSERT(numSpawners > 0, "numSpawners is zero.");
+		ctx->spawnerPath = spawnerPath;
+		for (size_t i = 0; i < numSpawners; i++)
+			ctx->spawners.push_back(new Spawner(ctx, i));
+	}
+
+	virtual ~Impl()
+	{
+		lock_guard<mutex> lock(ctx->lock);
+		ctx->closed = true;
+		ctx->waitingJobs.clear();
+		for (auto spawner : ctx->spawners) {
+			spawner->terminate();
+			spawner->unref();
+		}
+		ctx->spawners.clear();
+	}
+
+	/**
+	 * Select the least loaded spawner that is ready. Dead spawners are
+	 * launched on the way. ctx->lock must be taken.
+	 *
+	 * @param hasAliveSpawner
+	 * true is set when there is at least one alive spawner.
+	 *
+	 * @return A pointer of the spawner or NULL if no spawner is ready.
+	 */
+	Spawner *selectSpawner(bool &hasAliveSpawner)
+	{
+		Spawner *selected = NULL;
+		hasAliveSpawner = false;
+		for (auto spawner : ctx->spawners) {
+			if (!spawner->alive && !spawner->launch())
+				continue;
+			hasAliveSpawner = true;
+			if (!spawner->ready)
+				continue;
+			if (!selected ||
+			    spawner->jobMap.size() < selected->jobMap.size())
+				selected = spawner;
+		}
+		return selected;
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+const char *ActionSpawnerPool::SPAWNER_NAME = "hatohol-action-spawner";
+
+ActionSpawnerPool::ActionSpawnerPool(const size_t &numSpawners,
+                                     const string &spawnerPath)
+: m_impl(new Impl(numSpawners, spawnerPath))
+{
+}
+
+ActionSpawnerPool::~ActionSpawnerPool()
+{
+}
+
+void ActionSpawnerPool::submit(const Request &request,
+                               CompletedCallback completedCb)
+{
+	SpawnJobPtr job = make_shared<SpawnJob>();
+	job->request = request;
+	job->completedCb = completedCb;
+	job->submittedTime = steady_clock::now();
+
+	unique_lock<mutex> lock(m_impl->ctx->lock);
+	job->requestId = ++m_impl->ctx->lastRequestId;
+	bool hasAliveSpawner = false;
+	Spawner *spawner = m_impl->selectSpawner(hasAliveSpawner);
+	if (spawner) {
+		spawner->send(job);
+		return;
+	}
+	if (hasAliveSpawner) {
+		// The job is sent when a spawner gets ready.
+		m_impl->ctx->waitingJobs.push_back(job);
+		return;
+	}
+	m_impl->ctx->stats.numSpawnFailures++;
+	lock.unlock();
+
+	MLPL_ERR("No %s is available.\n", SPAWNER_NAME);
+	struct Task {
+		static void run(SpawnJob *job) {
+			job->result.errorNumber = ECHILD;
+			if (job->completedCb)
+				job->completedCb(job->result);
+			delete job;
+		}
+	};
+	SpawnJob *failedJob = new SpawnJob(*job);
+	Utils::executeOnGLibEventLoop<SpawnJob>(Task::run, failedJob, ASYNC);
+}
+
+size_t ActionSpawnerPool::getNumberOfSpawners(void) const
+{
+	return m_impl->ctx->spawners.size();
+}
+
+size_t ActionSpawnerPool::getNumberOfPendingRequests(void) const
+{
+	lock_guard<mutex> lock(m_impl->ctx->lock);
+	size_t num = m_impl->ctx->waitingJobs.size();
+	for (auto spawner : m_impl->ctx->spawners)
+		num += spawner->jobMap.size();
+	return num;
+}
+
+ActionSpawnerPool::Statistics ActionSpawnerPool::getStatistics(void) const
+{
+	lock_guard<mutex> lock(m_impl->ctx->lock);
+	return m_impl->ctx->stats;
+}
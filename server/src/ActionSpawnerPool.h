@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ActionSpawnerPool_h
+#define ActionSpawnerPool_h
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <sys/types.h>
+#include <StringUtils.h>
+
+/**
+ * A pool of long-lived hatohol-action-spawner processes that create
+ * command actions on behalf of Hatohol.
+ *
+ * Creating a process with fork() in Hatohol gets slower as its address
+ * space grows. A spawner has a small address space and creates the
+ * process with posix_spawn(). Requests are dispatched to the least loaded
+ * spawner over named pipes. A spawner is launched lazily and is launched
+ * again on the next request after it dies.
+ */
+class ActionSpawnerPool {
+public:
+	static const char *SPAWNER_NAME;
+
+	struct Request {
+		mlpl::StringVector args;
+		mlpl::StringVector envs;
+		std::string workingDirectory;
+		int timeout; // in millisecond. 0 means no time-out.
+
+		Request(void);
+	};
+
+	struct Result {
+		// errno of the spawn. 0 means that the process was created.
+		int      errorNumber;
+		pid_t    pid;
+		// CLD_EXITED, CLD_KILLED, or CLD_DUMPED with the exit status
+		// or the signal number. They are valid only when
+		// errorNumber is 0 and lostSpawner is false.
+		int      code;
+		int      status;
+		bool     killedByTimeout;
+		// true when the spawner died before the process ended.
+		bool     lostSpawner;
+
+		// Latency of the action in microsecond.
+		uint64_t dispatchUsec; // from submit() to the spawned notify
+		uint64_t spawnUsec;    // posix_spawn() in the spawner
+		uint64_t runUsec;      // from the spawn to the exit
+
+		Result(void);
+	};
+
+	struct Statistics {
+		uint64_t numSpawned;
+		uint64_t numSpawnFailures;
+		uint64_t numLost;
+		uint64_t totalDispatchUsec;
+		uint64_t maxDispatchUsec;
+		uint64_t totalSpawnUsec;
+		uint64_t maxSpawnUsec;
+
+		Statistics(void);
+	};
+
+	/**
+	 * Called once for each request on the default GLib event loop
+	 * when the process exited, the spawn failed, or the spawner died.
+	 */
+	typedef std::function<void (const Result &result)> CompletedCallback;
+
+	/**
+	 * Constructor.
+	 *
+	 * @param numSpawners The number of spawner processes.
+	 * @param spawnerPath The path of hatohol-action-spawner.
+	 */
+	ActionSpawnerPool(const size_t &numSpawners,
+	                  const std::string &spawnerPath);
+	virtual ~ActionSpawnerPool();
+
+	/**
+	 * Request to create a process. This function returns without
+	 * waiting for the creation.
+	 *
+	 * @param request     A request.
+	 * @param completedCb A callback called when the request completes.
+	 */
+	void submit(const Request &request, CompletedCallback completedCb);
+
+	size_t getNumberOfSpawners(void) const;
+
+	/**
+	 * Get the number of requests that are submitted but not completed.
+	 */
+	size_t getNumberOfPendingRequests(void) const;
+
+	Statistics getStatistics(void) const;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // ActionSpawnerPool_h
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ActionSpawnerProtocol_h
+#define ActionSpawnerProtocol_h
+
+#include "ResidentProtocol.h"
+
+// The packets between Hatohol and hatohol-action-spawner have the same
+// header as ResidentProtocol (see ResidentProtocol.h). So
+// ResidentCommunicator and ResidentPullHelper can be used to send and
+// receive them.
+
+// definitions of packet types
+enum
+{
+	ACTION_SPAWNER_PKT_TYPE_LAUNCHED,
+	ACTION_SPAWNER_PKT_TYPE_SPAWN,
+	ACTION_SPAWNER_PKT_TYPE_SPAWNED,
+	ACTION_SPAWNER_PKT_TYPE_EXITED,
+};
+
+// NOTE: Characters in Bytes column in this file means the following.
+//  'U': Unsigned integer.
+//  'S': Signed integer.
+//  'V': variable length.
+// * Byte order: Little endian
+//
+// A string is encoded as 4U (length not including a NULL terminator)
+// followed by V (the characters).
+
+// [Launched notify]
+// Direction: Slave -> Master
+// packet type: ACTION_SPAWNER_PKT_TYPE_LAUNCHED
+// <Body> None
+
+// [Spawn]
+// Direction: Master -> Slave
+// packet type: ACTION_SPAWNER_PKT_TYPE_SPAWN
+// <Body>
+// Bytes: Description
+//    8U: Request ID.
+//    4U: Time-out in millisecond. 0 means no time-out.
+//     V: Working directory. An empty string means the current one.
+//    2U: Number of arguments.
+//     V: Arguments. The first one is the path of the command.
+//    2U: Number of environment variables.
+//     V: Environment variables. ("NAME=VALUE")
+
+static const size_t ACTION_SPAWNER_SPAWN_REQUEST_ID_LEN  = 8;
+static const size_t ACTION_SPAWNER_SPAWN_TIMEOUT_LEN     = 4;
+static const size_t ACTION_SPAWNER_SPAWN_STRING_SIZE_LEN = 4;
+static const size_t ACTION_SPAWNER_SPAWN_NUM_ARGS_LEN    = 2;
+static const size_t ACTION_SPAWNER_SPAWN_NUM_ENVS_LEN    = 2;
+
+// [Spawned notify]
+// Direction: Slave -> Master
+// packet type: ACTION_SPAWNER_PKT_TYPE_SPAWNED
+// <Body>
+// Bytes: Description
+//    8U: Request ID.
+//    4S: errno of posix_spawn(). 0 means success.
+//    4U: PID of the spawned process. 0 on failure.
+//    8U: Time taken by posix_spawn() in microsecond.
+
+static const size_t ACTION_SPAWNER_SPAWNED_BODY_LEN = 8 + 4 + 4 + 8;
+
+// [Exited notify]
+// Direction: Slave -> Master
+// packet type: ACTION_SPAWNER_PKT_TYPE_EXITED
+// This is sent only after the successful spawned notify.
+// <Body>
+// Bytes: Description
+//    8U: Request ID.
+//    4S: The reason of the exit: CLD_EXITED, CLD_KILLED or CLD_DUMPED.
+//    4S: Exit status or the signal number.
+//    1U: 1 if the process was killed due to the time-out. Otherwise 0.
+//    8U: Running time of the process in microsecond.
+
+static const size_t ACTION_SPAWNER_EXITED_BODY_LEN = 8 + 4 + 4 + 1 + 8;
+
+#endif // ActionSpawnerProtocol_h
@@ -81,6 +81,7 @@ ActorInfo &ActorInfo::operator=(const ActorInfo &actorInfo)
 	postCollectedCb = actorInfo.postCollectedCb;
 	collectedCbPriv = actorInfo.collectedCbPriv;
 	timerTag        = actorInfo.timerTag;
+	startTime       = actorInfo.startTime;
 
 	return *this;
 }
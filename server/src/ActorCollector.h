@@ -20,6 +20,7 @@
 #ifndef ActorCollector_h
 #define ActorCollector_h
 
+#include <chrono>
 #include "HatoholThreadBase.h"
 #include "HatoholError.h"
 
@@ -38,6 +39,8 @@ struct ActorInfo {
 	mutable ActorCollectedFunc postCollectedCb;
 	mutable void              *collectedCbPriv;
 	guint timerTag;
+	// The time when the actor is started. It's set by the owner.
+	std::chrono::steady_clock::time_point startTime;
 	
 	// constructor and destructor
 	ActorInfo(void);
@@ -22,7 +22,11 @@
 #include "ThreadLocalDBCache.h"
 #include "JSONParser.h"
 #include "UnifiedDataStore.h"
+#include "DBTablesLastInfo.h"
+#include "WorkerPool.h"
 #include <mutex>
+#include <map>
+#include <algorithm>
 #include <time.h>
 #include <libsoup/soup.h>
 
@@ -33,38 +37,83 @@ using namespace mlpl;
 static const char *MIME_JSON = "application/json";
 static const guint DEFAULT_TIMEOUT_SECONDS = 60;
 
+static const int DEFAULT_PAGE_SIZE = 100;
 static const int DEFAULT_PAGE_LIMIT = 100;
+static const size_t DEFAULT_NUM_PAGE_FETCHERS = 4;
 
-typedef enum {
-	PARSE_RESULT_OK,
-	PARSE_RESULT_ERROR,
-	PARSE_RESULT_NEED_NEXT_PAGE,
-} ParseResult;
+struct LastUpdateTimeUpserter : public DBAgent::TransactionHooks {
+	const IncidentTrackerIdType trackerId;
+	const time_t lastUpdateTime;
+
+	LastUpdateTimeUpserter(const IncidentTrackerIdType &_trackerId,
+	                       const time_t &_lastUpdateTime)
+	: trackerId(_trackerId),
+	  lastUpdateTime(_lastUpdateTime)
+	{
+	}
+
+	virtual bool postAction(DBAgent &dbAgent) override
+	{
+		ThreadLocalDBCache cache;
+		OperationPrivilege privilege(USER_ID_SYSTEM);
+		LastInfoDef lastInfoDef;
+		lastInfoDef.id = AUTO_INCREMENT_VALUE;
+		lastInfoDef.dataType = LAST_INFO_INCIDENT;
+		lastInfoDef.value = StringUtils::toString(
+		                      static_cast<uint64_t>(lastUpdateTime));
+		lastInfoDef.serverId = trackerId;
+		const bool useTransaction = false;
+		cache.getLastInfo().upsertLastInfo(lastInfoDef, privilege,
+		                                   useTransaction);
+		return true;
+	}
+};
 
 struct ArmRedmine::Impl
 {
+	struct Page {
+		ArmPollingResult  result;
+		IncidentInfoVect  incidents;
+		int64_t           totalCount;
+		int64_t           limit;
+		// True when an issue older than m_lastUpdateTime is found
+		bool              reachedOldIssue;
+
+		Page(void)
+		: result(COLLECT_NG_INTERNAL_ERROR),
+		  totalCount(0),
+		  limit(0),
+		  reachedOldIssue(false)
+		{
+		}
+	};
+
 	IncidentTrackerInfo m_incidentTrackerInfo;
 	SoupSession *m_session;
 	string m_url;
 	// Don't use hash table to allow duplicated keys
 	string m_baseQuery;
-	int m_page;
 	int m_pageLimit;
+	size_t m_numPageFetchers;
+	// The high-water mark of updated_on of the issues. It's also
+	// stored in the last_info table to resume from it after restart.
 	time_t m_lastUpdateTime;
-	time_t m_lastUpdateTimePending;
 	mutex m_startMutex;
 
 	Impl(const IncidentTrackerInfo &trackerInfo)
 	: m_incidentTrackerInfo(trackerInfo),
 	  m_session(NULL),
-	  m_page(1),
 	  m_pageLimit(DEFAULT_PAGE_LIMIT),
-	  m_lastUpdateTime(0),
-	  m_lastUpdateTimePending(0)
+	  m_numPageFetchers(DEFAULT_NUM_PAGE_FETCHERS),
+	  m_lastUpdateTime(0)
 	{
 		checkLastUpdateTime();
+		// The session is shared with the page fetchers
 		m_session = soup_session_sync_new_with_options(
-			SOUP_SESSION_TIMEOUT, DEFAULT_TIMEOUT_SECONDS, NULL);
+			SOUP_SESSION_TIMEOUT, DEFAULT_TIMEOUT_SECONDS,
+			SOUP_SESSION_MAX_CONNS_PER_HOST,
+			static_cast<int>(m_numPageFetchers),
+			NULL);
 		connectSessionSignals();
 
 		buildURL();
@@ -76,8 +125,27 @@ struct ArmRedmine::Impl
 		g_object_unref(m_session);
 	}
 
+	bool loadLastUpdateTime()
+	{
+		ThreadLocalDBCache cache;
+		LastInfoQueryOption option(USER_ID_SYSTEM);
+		option.setLastInfoType(LAST_INFO_INCIDENT);
+		option.setTargetServerId(m_incidentTrackerInfo.id);
+		LastInfoDefList lastInfoList;
+		cache.getLastInfo().getLastInfoList(lastInfoList, option);
+		if (lastInfoList.empty())
+			return false;
+		m_lastUpdateTime = atoll(lastInfoList.begin()->value.c_str());
+		return (m_lastUpdateTime > 0);
+	}
+
 	bool checkLastUpdateTime()
 	{
+		if (loadLastUpdateTime())
+			return true;
+
+		// Fall back to the incidents table when the tracker has never
+		// been synchronized.
 		IncidentTrackerIdType trackerId = m_incidentTrackerInfo.id;
 		UnifiedDataStore *dataStore = UnifiedDataStore::getInstance();
 		m_lastUpdateTime
@@ -119,9 +187,10 @@ struct ArmRedmine::Impl
 		m_baseQuery.clear();
 		string &projectId = m_incidentTrackerInfo.projectId;
 		string &trackerId = m_incidentTrackerInfo.trackerId;
+		string limit = StringUtils::toString(DEFAULT_PAGE_SIZE);
 		char *query = soup_form_encode("project_id", projectId.c_str(),
 					       "tracker_id", trackerId.c_str(),
-					       "limit", "100",
+					       "limit", limit.c_str(),
 					       "sort", "updated_on:desc",
 					       "f[]", "status_id",
 					       "op[status_id]", "*",
@@ -142,7 +211,7 @@ struct ArmRedmine::Impl
 		return string(buf);
 	}
 
-	string getQuery()
+	string getQuery(const int &page = 1)
 	{
 		string query = m_baseQuery;
 		if (m_lastUpdateTime > 0) {
@@ -155,9 +224,9 @@ struct ArmRedmine::Impl
 			query += updatedOnQuery;
 			g_free(updatedOnQuery);
 		}
-		if (m_page > 1) {
+		if (page > 1) {
 			query += "&page=";
-			query += StringUtils::toString(m_page);
+			query += StringUtils::toString(page);
 		}
 		return query;
 	}
@@ -175,66 +244,143 @@ struct ArmRedmine::Impl
 		}
 	}
 
-	ParseResult parseResponse(const string &response)
+	// This method is called on the page fetchers concurrently.
+	void fetchPage(const int &pageNumber, Page &page)
+	{
+		const IncidentTrackerInfo &trackerInfo = m_incidentTrackerInfo;
+		string url = m_url;
+		url += "?";
+		url += getQuery(pageNumber);
+
+		MLPL_DBG("Send request:\n"
+			 "  Tracker ID: %d\n"
+			 "  Nickname: %s\n"
+			 "  Query: %s\n",
+			 trackerInfo.id, trackerInfo.nickname.c_str(),
+			 url.c_str());
+
+		SoupMessage *msg
+		  = soup_message_new(SOUP_METHOD_GET, url.c_str());
+		if (!msg) {
+			MLPL_ERR("Can't prepare to connect to: %s\n",
+				 url.c_str());
+			page.result = COLLECT_NG_DISCONNECT_REDMINE;
+			return;
+		}
+		soup_message_headers_set_content_type(msg->request_headers,
+		                                      MIME_JSON, NULL);
+		guint soupStatus = soup_session_send_message(m_session, msg);
+		string response(msg->response_body->data,
+		                msg->response_body->length);
+		g_object_unref(msg);
+
+		if (!SOUP_STATUS_IS_SUCCESSFUL(soupStatus)) {
+			handleError(soupStatus, response);
+			page.result = COLLECT_NG_DISCONNECT_REDMINE;
+			return;
+		}
+
+		if (!parseResponse(response, page)) {
+			page.result = COLLECT_NG_PARSER_ERROR;
+			return;
+		}
+		page.result = COLLECT_OK;
+	}
+
+	/**
+	 * Fetch the pages after the first one. Up to m_numPageFetchers
+	 * requests are sent concurrently. Since issues are sorted by
+	 * updated_on, the rest aren't fetched once an issue older than
+	 * m_lastUpdateTime is found.
+	 *
+	 * @param pages
+	 * Fetched pages are appended to it. The first element has to be
+	 * already fetched.
+	 *
+	 * @param numPages The number of all pages.
+	 */
+	void fetchRestPages(vector<Page> &pages, const size_t &numPages)
+	{
+		while (pages.size() < numPages) {
+			const size_t begin = pages.size();
+			const size_t end =
+			  min(begin + m_numPageFetchers, numPages);
+			pages.resize(end);
+			{
+				// The destructor waits for all of the tasks.
+				WorkerPool fetchers(end - begin);
+				for (size_t i = begin; i < end; i++) {
+					Page *page = &pages[i];
+					const int pageNumber = i + 1;
+					fetchers.post([this, page, pageNumber] {
+						fetchPage(pageNumber, *page);
+					});
+				}
+			}
+			for (size_t i = begin; i < end; i++) {
+				if (pages[i].result != COLLECT_OK ||
+				    pages[i].reachedOldIssue) {
+					return;
+				}
+			}
+		}
+	}
+
+	int countPages(const Page &firstPage)
+	{
+		if (firstPage.reachedOldIssue)
+			return 1;
+		// Redmine may limit the page size less than we requested
+		int64_t limit = firstPage.limit > 0 ?
+		  firstPage.limit : DEFAULT_PAGE_SIZE;
+		int64_t numPages = (firstPage.totalCount + limit - 1) / limit;
+		return max(numPages, static_cast<int64_t>(1));
+	}
+
+	bool parseResponse(const string &response, Page &page)
 	{
 		JSONParser agent(response);
 		if (agent.hasError()) {
 			MLPL_ERR("Failed to parse error response: %s\n",
 				 agent.getErrorMessage());
-			return PARSE_RESULT_ERROR;
+			return false;
 		}
 		if (agent.isMember("errors")) {
 			RedmineAPI::logErrors(agent);
-			return PARSE_RESULT_ERROR;
+			return false;
 		}
 
-		bool succeeded = agent.startObject("issues");
-		if (!succeeded) {
+		if (!agent.startObject("issues")) {
 			MLPL_ERR("Failed to parse issues.\n");
 			MLPL_DBG("Response: %s\n", response.c_str());
-			return PARSE_RESULT_ERROR;
+			return false;
 		}
 
-		if (m_lastUpdateTime > m_lastUpdateTimePending)
-			m_lastUpdateTimePending = m_lastUpdateTime;
-
-		ThreadLocalDBCache cache;
-		size_t i, num = agent.countElements();
-		for (i = 0; i < num; i++) {
+		size_t num = agent.countElements();
+		page.incidents.reserve(num);
+		for (size_t i = 0; i < num; i++) {
 			agent.startElement(i);
 			IncidentInfo incident;
-			succeeded = succeeded && parseIssue(agent, incident);
+			bool succeeded = parseIssue(agent, incident);
 			agent.endObject();
 
-			time_t updateTime = incident.updatedAt.tv_sec;
-			if (updateTime > m_lastUpdateTimePending)
-				m_lastUpdateTimePending = updateTime;
-			if (updateTime >= m_lastUpdateTime) {
-				DBTablesMonitoring &dbMonitoring
-					= cache.getMonitoring();
-				dbMonitoring.updateIncidentInfo(incident);
-			} else {
-				// All incidents are updated
+			if (!succeeded) {
+				MLPL_WARN("Skip an invalid issue: %s\n",
+					  incident.identifier.c_str());
+				continue;
+			}
+			if (incident.updatedAt.tv_sec < m_lastUpdateTime) {
+				// Issues are sorted by updated_on in
+				// descending order. The rest are older.
+				page.reachedOldIssue = true;
 				break;
 			}
+			page.incidents.push_back(move(incident));
 		}
 		agent.endObject();
 
-		if (num != 0 && i == num && hasNextPage(agent, num))
-			return PARSE_RESULT_NEED_NEXT_PAGE;
-
-		m_lastUpdateTime = m_lastUpdateTimePending;
-		return PARSE_RESULT_OK;
-	}
-
-	bool hasNextPage(JSONParser &agent, const int &numIssues)
-	{
-		int64_t offset = 0;
-		int64_t total = 0;
-		agent.read("offset", offset);
-		agent.read("total_count", total);
-		if (offset + numIssues >= total)
-			return false;
+		agent.read("total_count", page.totalCount);
+		agent.read("limit", page.limit);
 		return true;
 	}
 
@@ -247,6 +393,53 @@ struct ArmRedmine::Impl
 						  incident.identifier);
 		return succeeded;
 	}
+
+	/**
+	 * Apply the fetched issues to the incidents table and advance
+	 * m_lastUpdateTime in the same transaction.
+	 *
+	 * @param pages Fetched pages.
+	 */
+	void applyPages(vector<Page> &pages)
+	{
+		// An issue updated while fetching can be seen twice since
+		// it moves to the first page.
+		map<string, IncidentInfo> latestIncidents;
+		time_t lastUpdateTime = m_lastUpdateTime;
+		for (auto &page : pages) {
+			for (auto &incident : page.incidents) {
+				const time_t &updateTime
+				  = incident.updatedAt.tv_sec;
+				if (updateTime > lastUpdateTime)
+					lastUpdateTime = updateTime;
+				auto it = latestIncidents.find(
+				            incident.identifier);
+				if (it != latestIncidents.end() &&
+				    it->second.updatedAt.tv_sec > updateTime) {
+					continue;
+				}
+				latestIncidents[incident.identifier]
+				  = move(incident);
+			}
+		}
+		if (latestIncidents.empty())
+			return;
+
+		IncidentInfoVect incidents;
+		incidents.reserve(latestIncidents.size());
+		for (auto &pair : latestIncidents)
+			incidents.push_back(move(pair.second));
+
+		ThreadLocalDBCache cache;
+		LastUpdateTimeUpserter upserter(m_incidentTrackerInfo.id,
+		                                lastUpdateTime);
+		size_t numUpdated = cache.getMonitoring().updateIncidentInfoVect(
+		                      incidents, &upserter);
+		MLPL_DBG("Updated incidents: %zd/%zd (Tracker ID: %d)\n",
+			 numUpdated, incidents.size(),
+			 m_incidentTrackerInfo.id);
+		m_lastUpdateTime = lastUpdateTime;
+	}
 };
 
 ArmRedmine::ArmRedmine(const IncidentTrackerInfo &trackerInfo)
@@ -289,55 +482,29 @@ ArmBase::ArmPollingResult ArmRedmine::mainThreadOneProc(void)
 	}
 
 	const IncidentTrackerInfo &trackerInfo = m_impl->m_incidentTrackerInfo;
-	m_impl->m_page = 1;
-
-RETRY:
-	string url = m_impl->m_url;
-	url += "?";
-	url += getQuery();
-
-	MLPL_DBG("Send request:\n"
-		 "  Tracker ID: %d\n"
-		 "  Nickname: %s\n"
-		 "  Query: %s\n",
-		 trackerInfo.id, trackerInfo.nickname.c_str(), url.c_str());
-
-	SoupMessage *msg = soup_message_new(SOUP_METHOD_GET, url.c_str());
-	if (!msg) {
-		MLPL_ERR("Can't prepare to connect to: %s\n",
-			 url.c_str());
-		return COLLECT_NG_DISCONNECT_REDMINE;
+
+	// The first page tells us how many pages should be fetched.
+	vector<Impl::Page> pages(1);
+	m_impl->fetchPage(1, pages[0]);
+	if (pages[0].result != COLLECT_OK)
+		return pages[0].result;
+
+	int numPages = m_impl->countPages(pages[0]);
+	if (numPages > m_impl->m_pageLimit) {
+		MLPL_ERR("Too many updated records "
+			 "or something is wrong!\n");
+		return COLLECT_NG_INTERNAL_ERROR;
 	}
-	soup_message_headers_set_content_type(msg->request_headers,
-	                                      MIME_JSON, NULL);
-	guint soupStatus = soup_session_send_message(m_impl->m_session, msg);
-	string response(msg->response_body->data, msg->response_body->length);
-	g_object_unref(msg);
-
-	if (!SOUP_STATUS_IS_SUCCESSFUL(soupStatus)) {
-		m_impl->handleError(soupStatus, response);
-		return COLLECT_NG_DISCONNECT_REDMINE;
+	m_impl->fetchRestPages(pages, numPages);
+	for (const auto &page : pages) {
+		if (page.result != COLLECT_OK)
+			return page.result;
 	}
 
-	ParseResult result = m_impl->parseResponse(response);
-
-	switch (result) {
-	case PARSE_RESULT_NEED_NEXT_PAGE:
-		if (m_impl->m_page >= m_impl->m_pageLimit) {
-			MLPL_ERR("Too many updated records "
-				 "or something is wrong!\n");
-			return COLLECT_NG_INTERNAL_ERROR;
-		}
-		++m_impl->m_page;
-		goto RETRY;
-	case PARSE_RESULT_OK:
-		MLPL_DBG("Succeeded to update for Tracker ID: %d\n",
-			 trackerInfo.id);
-		return COLLECT_OK;
-	case PARSE_RESULT_ERROR:
-	default:
-		return COLLECT_NG_PARSER_ERROR;
-	}
+	m_impl->applyPages(pages);
+	MLPL_DBG("Succeeded to update for Tracker ID: %d\n",
+		 trackerInfo.id);
+	return COLLECT_OK;
 }
 
 void ArmRedmine::startIfNeeded(void)
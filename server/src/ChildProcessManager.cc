@@ -18,27 +18,42 @@
  */
 
 #include <map>
-#include <semaphore.h>
+#include <vector>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
 #include <Logger.h>
 #include <AtomicValue.h>
 #include "ChildProcessManager.h"
 #include "HatoholException.h"
-#include "Reaper.h"
 #include "EventSemaphore.h"
 
 using namespace std;
 using namespace mlpl;
 
+static int openPidFd(const pid_t &pid)
+{
+#ifdef SYS_pidfd_open
+	return syscall(SYS_pidfd_open, pid, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
 struct ChildInfo {
 	const pid_t pid;
 	ChildProcessManager::EventCallback * const eventCb;
 	AtomicValue<bool> killed;
+	int pidFd;
 
 	ChildInfo(pid_t _pid, ChildProcessManager::EventCallback *_eventCb)
 	: pid(_pid),
 	  eventCb(_eventCb),
-	  killed(false)
+	  killed(false),
+	  pidFd(-1)
 	{
 		if (eventCb)
 			eventCb->ref();
@@ -46,6 +61,8 @@ struct ChildInfo {
 
 	virtual ~ChildInfo()
 	{
+		if (pidFd >= 0)
+			close(pidFd);
 		if (eventCb)
 			eventCb->unref();
 	}
@@ -71,6 +88,8 @@ typedef ChildMap::iterator       ChildMapIterator;
 typedef ChildMap::const_iterator ChildMapConstIterator;
 
 struct ChildProcessManager::Impl {
+	static const int MAX_EPOLL_EVENTS = 16;
+
 	static ChildProcessManager *instance;
 	static ReadWriteLock        instanceLock;
 
@@ -80,39 +99,171 @@ struct ChildProcessManager::Impl {
 	ReadWriteLock childrenMapLock;
 	ChildMap      childrenMap;
 
+	// When a pidfd is available, each child is watched with it in
+	// epollFd. Otherwise the thread blocks in waitid() as long as
+	// there is a child, and waits for wakeupFd when there's none.
+	AtomicValue<bool> usePidFd;
+	int               wakeupFd;
+	int               epollFd;
+
 	Impl(void)
 	: resetRequest(false),
-	  resetSem(0)
+	  resetSem(0),
+	  usePidFd(false),
+	  wakeupFd(-1),
+	  epollFd(-1)
 	{
-		HATOHOL_ASSERT(sem_init(&waitChildSem, 0, 0) == 0,
-		               "Failed to call sem_init(): %d\n", errno);
+		wakeupFd = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+		HATOHOL_ASSERT(wakeupFd >= 0,
+		               "Failed to call eventfd(): %d\n", errno);
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+		HATOHOL_ASSERT(epollFd >= 0,
+		               "Failed to call epoll_create1(): %d\n", errno);
+		addToEpoll(wakeupFd);
+
+		int pidFd = openPidFd(getpid());
+		if (pidFd >= 0) {
+			close(pidFd);
+			usePidFd = true;
+		} else {
+			MLPL_INFO("pidfd is not available (%d). "
+			          "waitid() is used to wait for children.\n",
+			          errno);
+		}
 	}
 
 	virtual ~Impl(void)
 	{
 		// TODO: wait all children
+		if (epollFd >= 0)
+			close(epollFd);
+		if (wakeupFd >= 0)
+			close(wakeupFd);
+	}
+
+	bool addToEpoll(const int &fd)
+	{
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+			MLPL_ERR("Failed to call epoll_ctl(ADD): %d\n",
+			         errno);
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Watch the child with a pidfd. If it fails, the waiting mode is
+	 * changed to the one with waitid().
+	 * NOTE: childrenMapLock has to be taken by the caller.
+	 */
+	void watchPidFd(ChildInfo &childInfo)
+	{
+		if (!usePidFd)
+			return;
+		int pidFd = openPidFd(childInfo.pid);
+		if (pidFd == -1) {
+			MLPL_WARN("Failed to open pidfd (%d): %d. "
+			          "waitid() is used hereafter.\n",
+			          childInfo.pid, errno);
+			usePidFd = false;
+			return;
+		}
+		if (!addToEpoll(pidFd)) {
+			close(pidFd);
+			usePidFd = false;
+			return;
+		}
+		childInfo.pidFd = pidFd;
 	}
 
-	void postWaitChildSem(void)
+	/**
+	 * NOTE: childrenMapLock has to be taken by the caller.
+	 */
+	void unwatchPidFd(ChildInfo &childInfo)
 	{
+		if (childInfo.pidFd < 0)
+			return;
+		if (epoll_ctl(epollFd, EPOLL_CTL_DEL, childInfo.pidFd,
+		              NULL) == -1) {
+			MLPL_ERR("Failed to call epoll_ctl(DEL): %d\n",
+			         errno);
+		}
+		close(childInfo.pidFd);
+		childInfo.pidFd = -1;
+	}
+
+	void wakeUp(void)
+	{
+		const uint64_t buf = 1;
 		while (true) {
-			if (sem_post(&waitChildSem) == 0)
+			if (write(wakeupFd, &buf, sizeof(buf)) != -1)
 				break;
 			if (errno == EINTR)
 				continue;
-			HATOHOL_ASSERT(true, "sem_post() failed: %d", errno);
+			// EAGAIN means that the counter is full.
+			// It's enough to wake up the thread.
+			HATOHOL_ASSERT(errno == EAGAIN,
+			               "Failed to write wakeupFd: %d", errno);
+			break;
+		}
+	}
+
+	void consumeWakeUp(void)
+	{
+		uint64_t buf;
+		while (true) {
+			if (read(wakeupFd, &buf, sizeof(buf)) != -1)
+				break;
+			if (errno == EINTR)
+				continue;
+			HATOHOL_ASSERT(errno == EAGAIN,
+			               "Failed to read wakeupFd: %d", errno);
+			break;
+		}
+	}
+
+	/**
+	 * Block until any child becomes waitable without reaping it.
+	 *
+	 * @return false if there's no child. Otherwise true.
+	 */
+	bool waitAnyChild(void)
+	{
+		siginfo_t siginfo;
+		while (true) {
+			int ret = waitid(P_ALL, 0, &siginfo, WEXITED|WNOWAIT);
+			if (ret == 0)
+				return true;
+			if (errno == EINTR)
+				continue;
+			if (errno != ECHILD)
+				MLPL_ERR("Failed to call waitid: %d\n", errno);
+			return false;
 		}
 	}
 
-	void waitWaitChildSem(void)
+	void waitForEvent(void)
 	{
+		if (!usePidFd && waitAnyChild())
+			return;
+
+		struct epoll_event events[MAX_EPOLL_EVENTS];
 		while (true) {
-			if (sem_wait(&waitChildSem) == 0)
+			int ret = epoll_wait(epollFd, events,
+			                     MAX_EPOLL_EVENTS, -1);
+			if (ret >= 0)
 				break;
 			if (errno == EINTR)
 				continue;
-			HATOHOL_ASSERT(true, "sem_wait() failed: %d", errno);
+			MLPL_ERR("Failed to call epoll_wait: %d\n", errno);
+			break;
 		}
+		// Exited children are looked up with waitid() after this.
+		// So we don't care which pidfd is ready.
+		consumeWakeUp();
 	}
 
 	void resetOnCollectThread(void)
@@ -122,6 +273,7 @@ struct ChildProcessManager::Impl {
 			ChildMapIterator childInfoItr = childrenMap.begin();
 			ChildInfo *childInfo = childInfoItr->second;
 			childrenMap.erase(childInfoItr);
+			unwatchPidFd(*childInfo);
 			// We send SIGKILL again, because new children
 			// may be addded in the map after reset() is called.
 			childInfo->sendKill();
@@ -135,9 +287,6 @@ struct ChildProcessManager::Impl {
 		HATOHOL_ASSERT(err == 0,
 		               "Failed to call resetSem.post(): %d\n", err);
 	}
-
-private:
-	sem_t         waitChildSem;
 };
 
 ChildProcessManager *ChildProcessManager::Impl::instance = NULL;
@@ -242,7 +391,7 @@ void ChildProcessManager::reset(void)
 	};
 
 	m_impl->resetRequest = true;
-	m_impl->postWaitChildSem();
+	m_impl->wakeUp();
 
 	// We send SIGKILL to unblock waitid().
 	m_impl->childrenMapLock.readLock();
@@ -302,6 +451,7 @@ HatoholError ChildProcessManager::create(CreateArg &arg)
 	}
 
 	ChildInfo *childInfo = new ChildInfo(arg.pid, arg.eventCb);
+	m_impl->watchPidFd(*childInfo);
 
 	pair<ChildMapIterator, bool> result =
 	  m_impl->childrenMap.insert(pair<
@@ -312,7 +462,10 @@ HatoholError ChildProcessManager::create(CreateArg &arg)
 		HATOHOL_ASSERT(true,
 		  "The previous data might still remain: %d\n", arg.pid);
 	}
-	m_impl->postWaitChildSem();
+	// The thread may be waiting without any child. A pidfd added
+	// to epollFd wakes it up by itself.
+	if (!m_impl->usePidFd)
+		m_impl->wakeUp();
 
 	return HTERR_OK;
 }
@@ -331,27 +484,15 @@ ChildProcessManager::~ChildProcessManager()
 
 gpointer ChildProcessManager::mainThread(HatoholThreadArg *arg)
 {
-	MLPL_INFO("started ChildProcessManager::mainThread.\n");
+	MLPL_INFO("started ChildProcessManager::mainThread (%s).\n",
+	          m_impl->usePidFd ? "pidfd" : "waitid");
 	while (true) {
-		m_impl->waitWaitChildSem();
+		m_impl->waitForEvent();
 		if (m_impl->resetRequest) {
 			m_impl->resetOnCollectThread();
 			continue;
 		}
-
-		siginfo_t siginfo;
-		int ret = 0;
-		while (true) {
-			ret = waitid(P_ALL, 0, &siginfo, WEXITED);
-			if (ret == -1 && errno == EINTR)
-				continue;
-			break;
-		}
-		if (ret == -1) {
-			MLPL_ERR("Failed to call wait_id: %d\n", errno);
-			continue;
-		}
-		collected(&siginfo);
+		collectChildren();
 	}
 	return NULL;
 }
@@ -367,37 +508,62 @@ bool ChildProcessManager::isDead(const siginfo_t *siginfo)
 	return false;
 }
 
-void ChildProcessManager::collected(const siginfo_t *siginfo)
+void ChildProcessManager::collectChildren(void)
 {
-	ChildInfo *childInfo = NULL;
+	struct CollectedChild {
+		ChildInfo *childInfo;
+		siginfo_t  siginfo;
+	};
+	vector<CollectedChild> collectedChildren;
 
-	// We use Reaper, because an exectpion might happen in onCollcted().
-	Reaper<ReadWriteLock> unlocker(
-	  &m_impl->childrenMapLock, ReadWriteLock::unlock);
+	// Reap all exited children at once. The lock is taken only
+	// while the map is looked up and updated.
 	m_impl->childrenMapLock.writeLock();
+	while (true) {
+		CollectedChild collected;
+		collected.siginfo.si_pid = 0;
+		int ret = waitid(P_ALL, 0, &collected.siginfo,
+		                 WEXITED|WNOHANG);
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno != ECHILD)
+				MLPL_ERR("Failed to call waitid: %d\n", errno);
+			break;
+		}
+		const pid_t pid = collected.siginfo.si_pid;
+		if (pid == 0)
+			break; // No more exited children
 
-	ChildMapIterator it = m_impl->childrenMap.find(siginfo->si_pid);
-	if (it != m_impl->childrenMap.end())
-		childInfo = it->second;
-	if (!childInfo) {
-		unlocker.reap();
-		m_impl->postWaitChildSem();
-		MLPL_INFO("Collected unwatched child: %d\n", siginfo->si_pid);
-		return;
+		ChildMapIterator it = m_impl->childrenMap.find(pid);
+		if (it == m_impl->childrenMap.end()) {
+			MLPL_INFO("Collected unwatched child: %d\n", pid);
+			continue;
+		}
+		ChildInfo *childInfo = it->second;
+		if (childInfo->killed) {
+			// cleanup will be in resetOnCollectThread()
+			m_impl->unwatchPidFd(*childInfo);
+			continue;
+		}
+		if (childInfo->eventCb && !isDead(&collected.siginfo))
+			continue; // Ex. SIGSTOP
+		m_impl->unwatchPidFd(*childInfo);
+		m_impl->childrenMap.erase(it);
+		collected.childInfo = childInfo;
+		collectedChildren.push_back(collected);
 	}
-	if (childInfo->killed)
-		return; // cleanup will be in resetOnCollectThread()
+	m_impl->childrenMapLock.unlock();
 
-	if (childInfo->eventCb) {
-		if (!isDead(siginfo)) { // Ex. SIGSTOP
-			m_impl->postWaitChildSem();
-			return;
+	// Each childInfo has been removed from the map. So the callbacks
+	// can be called without the lock.
+	for (size_t i = 0; i < collectedChildren.size(); i++) {
+		CollectedChild &collected = collectedChildren[i];
+		ChildInfo *childInfo = collected.childInfo;
+		if (childInfo->eventCb) {
+			childInfo->eventCb->onCollected(&collected.siginfo);
+			childInfo->eventCb->onFinalized();
 		}
-		childInfo->eventCb->onCollected(siginfo);
+		delete childInfo;
 	}
-	m_impl->childrenMap.erase(it);
-	unlocker.reap();
-	if (childInfo->eventCb)
-		childInfo->eventCb->onFinalized();
-	delete childInfo;
 }
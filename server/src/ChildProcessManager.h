@@ -52,6 +52,8 @@ public:
 		 * this object is received.
 		 * Note that this method is called only when the signal code
 		 * is any of CLD_EXITED, CLD_KILLED, or CLD_DUMPED.
+		 * This is called outside of the critical section. So
+		 * ChildProcessManager::create() can be called in it.
 		 */
 		virtual void onCollected(const siginfo_t *siginfo);
 
@@ -117,7 +119,11 @@ protected:
 	virtual gpointer mainThread(HatoholThreadArg *arg) override;
 
 	bool isDead(const siginfo_t *siginfo);
-	void collected(const siginfo_t *siginfo);
+
+	/**
+	 * Reap all exited children and call the callbacks of them.
+	 */
+	void collectChildren(void);
 
 private:
 	struct Impl;
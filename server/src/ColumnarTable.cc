@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <inttypes.h>
+#include "ColumnarTable.h"
+#include "SQLUtils.h"
+#include "HatoholException.h"
+
+using namespace std;
+
+static ItemDataType toItemType(const SQLColumnType &sqlType)
+{
+	switch (sqlType) {
+	case SQL_COLUMN_TYPE_INT:
+	case SQL_COLUMN_TYPE_DATETIME:
+		return ITEM_TYPE_INT;
+	case SQL_COLUMN_TYPE_BIGUINT:
+		return ITEM_TYPE_UINT64;
+	case SQL_COLUMN_TYPE_VARCHAR:
+	case SQL_COLUMN_TYPE_CHAR:
+	case SQL_COLUMN_TYPE_TEXT:
+		return ITEM_TYPE_STRING;
+	case SQL_COLUMN_TYPE_DOUBLE:
+		return ITEM_TYPE_DOUBLE;
+	default:
+		THROW_HATOHOL_EXCEPTION("Unknown column type: %d\n", sqlType);
+	}
+	return ITEM_TYPE_INT;
+}
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+ColumnarTable::ColumnarTable(void)
+: m_numRows(0),
+  m_addIndex(0)
+{
+}
+
+void ColumnarTable::setColumnTypes(const vector<SQLColumnType> &columnTypes)
+{
+	m_columns.clear();
+	m_columns.resize(columnTypes.size());
+	for (size_t i = 0; i < columnTypes.size(); i++) {
+		m_columns[i].sqlType = columnTypes[i];
+		m_columns[i].itemType = toItemType(columnTypes[i]);
+	}
+	m_stringArena.clear();
+	m_numRows = 0;
+	m_addIndex = 0;
+}
+
+void ColumnarTable::clearRows(void)
+{
+	for (auto &column : m_columns) {
+		column.intValues.clear();
+		column.uint64Values.clear();
+		column.doubleValues.clear();
+		column.stringValues.clear();
+		column.nullFlags.clear();
+	}
+	m_stringArena.clear();
+	m_numRows = 0;
+	m_addIndex = 0;
+}
+
+void ColumnarTable::reserve(const size_t &numRows)
+{
+	for (auto &column : m_columns) {
+		switch (column.itemType) {
+		case ITEM_TYPE_INT:
+			column.intValues.reserve(numRows);
+			break;
+		case ITEM_TYPE_UINT64:
+			column.uint64Values.reserve(numRows);
+			break;
+		case ITEM_TYPE_DOUBLE:
+			column.doubleValues.reserve(numRows);
+			break;
+		case ITEM_TYPE_STRING:
+			column.stringValues.reserve(numRows);
+			break;
+		default:
+			break;
+		}
+		column.nullFlags.reserve(numRows);
+	}
+}
+
+size_t ColumnarTable::getNumberOfColumns(void) const
+{
+	return m_columns.size();
+}
+
+size_t ColumnarTable::getNumberOfRows(void) const
+{
+	return m_numRows;
+}
+
+ItemDataType ColumnarTable::getItemType(const size_t &columnIndex) const
+{
+	HATOHOL_ASSERT(columnIndex < m_columns.size(),
+	               "Invalid column index: %zd (%zd)",
+	               columnIndex, m_columns.size());
+	return m_columns[columnIndex].itemType;
+}
+
+void ColumnarTable::addInt(const int &val)
+{
+	Column &column = getColumnToAdd(ITEM_TYPE_INT);
+	column.intValues.push_back(val);
+	column.nullFlags.push_back(false);
+}
+
+void ColumnarTable::addUint64(const uint64_t &val)
+{
+	Column &column = getColumnToAdd(ITEM_TYPE_UINT64);
+	column.uint64Values.push_back(val);
+	column.nullFlags.push_back(false);
+}
+
+void ColumnarTable::addDouble(const double &val)
+{
+	Column &column = getColumnToAdd(ITEM_TYPE_DOUBLE);
+	column.doubleValues.push_back(val);
+	column.nullFlags.push_back(false);
+}
+
+void ColumnarTable::addString(const char *str, const size_t &length)
+{
+	Column &column = getColumnToAdd(ITEM_TYPE_STRING);
+	StringRef ref = {m_stringArena.size(), length};
+	m_stringArena.insert(m_stringArena.end(), str, str + length);
+	column.stringValues.push_back(ref);
+	column.nullFlags.push_back(false);
+}
+
+void ColumnarTable::addNull(void)
+{
+	HATOHOL_ASSERT(!m_columns.empty(), "No columns.");
+	Column &column = getColumnToAdd(m_columns[m_addIndex].itemType);
+	switch (column.itemType) {
+	case ITEM_TYPE_INT:
+		column.intValues.push_back(0);
+		break;
+	case ITEM_TYPE_UINT64:
+		column.uint64Values.push_back(0);
+		break;
+	case ITEM_TYPE_DOUBLE:
+		column.doubleValues.push_back(0);
+		break;
+	case ITEM_TYPE_STRING:
+	{
+		StringRef ref = {m_stringArena.size(), 0};
+		column.stringValues.push_back(ref);
+		break;
+	}
+	default:
+		HATOHOL_ASSERT(false, "Unexpected type: %d", column.itemType);
+	}
+	column.nullFlags.push_back(true);
+}
+
+void ColumnarTable::addFromString(const char *str, const size_t &length)
+{
+	HATOHOL_ASSERT(!m_columns.empty(), "No columns.");
+	if (!str) {
+		addNull();
+		return;
+	}
+	const Column &column = m_columns[m_addIndex];
+	switch (column.itemType) {
+	case ITEM_TYPE_INT:
+		if (column.sqlType == SQL_COLUMN_TYPE_DATETIME) {
+			ItemDataPtr itemData =
+			  SQLUtils::createFromString(str, column.sqlType);
+			const int &time = *itemData;
+			addInt(time);
+		} else {
+			addInt(atoi(str));
+		}
+		break;
+	case ITEM_TYPE_UINT64:
+	{
+		uint64_t val = 0;
+		sscanf(str, "%" PRIu64, &val);
+		addUint64(val);
+		break;
+	}
+	case ITEM_TYPE_DOUBLE:
+		addDouble(atof(str));
+		break;
+	case ITEM_TYPE_STRING:
+		addString(str, length);
+		break;
+	default:
+		HATOHOL_ASSERT(false, "Unexpected type: %d", column.itemType);
+	}
+}
+
+bool ColumnarTable::isNull(const size_t &row, const size_t &columnIndex) const
+{
+	HATOHOL_ASSERT(columnIndex < m_columns.size(),
+	               "Invalid column index: %zd (%zd)",
+	               columnIndex, m_columns.size());
+	HATOHOL_ASSERT(row < m_numRows,
+	               "Invalid row: %zd (%zd)", row, m_numRows);
+	return m_columns[columnIndex].nullFlags[row];
+}
+
+const int &ColumnarTable::getInt(const size_t &row,
+                                 const size_t &columnIndex) const
+{
+	const Column &column = getColumn(columnIndex, ITEM_TYPE_INT);
+	HATOHOL_ASSERT(row < m_numRows,
+	               "Invalid row: %zd (%zd)", row, m_numRows);
+	return column.intValues[row];
+}
+
+const uint64_t &ColumnarTable::getUint64(const size_t &row,
+                                         const size_t &columnIndex) const
+{
+	const Column &column = getColumn(columnIndex, ITEM_TYPE_UINT64);
+	HATOHOL_ASSERT(row < m_numRows,
+	               "Invalid row: %zd (%zd)", row, m_numRows);
+	return column.uint64Values[row];
+}
+
+const double &ColumnarTable::getDouble(const size_t &row,
+                                       const size_t &columnIndex) const
+{
+	const Column &column = getColumn(columnIndex, ITEM_TYPE_DOUBLE);
+	HATOHOL_ASSERT(row < m_numRows,
+	               "Invalid row: %zd (%zd)", row, m_numRows);
+	return column.doubleValues[row];
+}
+
+const char *ColumnarTable::getString(const size_t &row,
+                                     const size_t &columnIndex,
+                                     size_t &length) const
+{
+	const Column &column = getColumn(columnIndex, ITEM_TYPE_STRING);
+	HATOHOL_ASSERT(row < m_numRows,
+	               "Invalid row: %zd (%zd)", row, m_numRows);
+	const StringRef &ref = column.stringValues[row];
+	length = ref.length;
+	if (m_stringArena.empty())
+		return "";
+	return &m_stringArena[ref.offset];
+}
+
+string ColumnarTable::getString(const size_t &row,
+                                const size_t &columnIndex) const
+{
+	size_t length;
+	const char *str = getString(row, columnIndex, length);
+	return string(str, length);
+}
+
+// ---------------------------------------------------------------------------
+// Private methods
+// ---------------------------------------------------------------------------
+ColumnarTable::Column &ColumnarTable::getColumnToAdd(
+  const ItemDataType &itemType)
+{
+	HATOHOL_ASSERT(!m_columns.empty(), "No columns.");
+	Column &column = m_columns[m_addIndex];
+	HATOHOL_ASSERT(column.itemType == itemType,
+	               "Unexpected type: %d, expected: %d (column: %zd)",
+	               itemType, column.itemType, m_addIndex);
+	m_addIndex++;
+	if (m_addIndex == m_columns.size()) {
+		m_addIndex = 0;
+		m_numRows++;
+	}
+	return column;
+}
+
+const ColumnarTable::Column &ColumnarTable::getColumn(
+  const size_t &columnIndex, const ItemDataType &itemType) const
+{
+	HATOHOL_ASSERT(columnIndex < m_columns.size(),
+	               "Invalid column index: %zd (%zd)",
+	               columnIndex, m_columns.size());
+	const Column &column = m_columns[columnIndex];
+	HATOHOL_ASSERT(column.itemType == itemType,
+	               "Unexpected type: %d, expected: %d (column: %zd)",
+	               column.itemType, itemType, columnIndex);
+	return column;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef ColumnarTable_h
+#define ColumnarTable_h
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdint.h>
+#include "ItemData.h"
+#include "SQLProcessorTypes.h"
+
+/**
+ * A typed, column oriented container of a SELECT result.
+ *
+ * Values of each column are stored in a contiguous vector of the native
+ * type instead of individually allocated ItemData instances. Strings of all
+ * columns are stored in a single arena and referred by the offset.
+ */
+class ColumnarTable {
+public:
+	ColumnarTable(void);
+
+	/**
+	 * Set the column types. Stored rows are cleared.
+	 *
+	 * @param columnTypes SQL types of the columns.
+	 */
+	void setColumnTypes(const std::vector<SQLColumnType> &columnTypes);
+
+	/**
+	 * Remove all rows. The column types and the allocated space are
+	 * kept so that the table can be reused without reallocation.
+	 */
+	void clearRows(void);
+
+	/**
+	 * Reserve the space for rows.
+	 *
+	 * @param numRows The number of rows expected to be stored.
+	 */
+	void reserve(const size_t &numRows);
+
+	size_t getNumberOfColumns(void) const;
+	size_t getNumberOfRows(void) const;
+
+	/**
+	 * Get the item type of the column.
+	 *
+	 * @param columnIndex A column index.
+	 *
+	 * @return
+	 * ITEM_TYPE_INT, ITEM_TYPE_UINT64, ITEM_TYPE_DOUBLE or
+	 * ITEM_TYPE_STRING.
+	 */
+	ItemDataType getItemType(const size_t &columnIndex) const;
+
+	/**
+	 * Add values of the next row. The following add*() methods have to
+	 * be called once for each column in the column order.
+	 */
+	void addInt(const int &val);
+	void addUint64(const uint64_t &val);
+	void addDouble(const double &val);
+	void addString(const char *str, const size_t &length);
+	void addNull(void);
+
+	/**
+	 * Add a value converted from a string in the same way as
+	 * SQLUtils::createFromString().
+	 *
+	 * @param str A string or NULL that represents a NULL value.
+	 * @param length The length of the string.
+	 */
+	void addFromString(const char *str, const size_t &length);
+
+	bool isNull(const size_t &row, const size_t &columnIndex) const;
+	const int &getInt(const size_t &row, const size_t &columnIndex) const;
+	const uint64_t &getUint64(const size_t &row,
+	                          const size_t &columnIndex) const;
+	const double &getDouble(const size_t &row,
+	                        const size_t &columnIndex) const;
+
+	/**
+	 * Get a string in the arena without copy.
+	 *
+	 * The returned pointer is valid until a row is added.
+	 *
+	 * @param row A row index.
+	 * @param columnIndex A column index.
+	 * @param length The length of the string is returned.
+	 *
+	 * @return A pointer of the head of the string.
+	 */
+	const char *getString(const size_t &row, const size_t &columnIndex,
+	                      size_t &length) const;
+	std::string getString(const size_t &row,
+	                      const size_t &columnIndex) const;
+
+private:
+	struct StringRef {
+		size_t offset;
+		size_t length;
+	};
+
+	struct Column {
+		SQLColumnType          sqlType;
+		ItemDataType           itemType;
+		std::vector<int>       intValues;
+		std::vector<uint64_t>  uint64Values;
+		std::vector<double>    doubleValues;
+		std::vector<StringRef> stringValues;
+		std::vector<bool>      nullFlags;
+	};
+
+	Column &getColumnToAdd(const ItemDataType &itemType);
+	const Column &getColumn(const size_t &columnIndex,
+	                        const ItemDataType &itemType) const;
+
+	std::vector<Column> m_columns;
+	std::vector<char>   m_stringArena;
+	size_t              m_numRows;
+	size_t              m_addIndex;
+};
+
+typedef std::shared_ptr<ColumnarTable> ColumnarTablePtr;
+
+#endif // ColumnarTable_h
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <StringUtils.h>
+#include "ColumnarTableStream.h"
+#include "HatoholException.h"
+
+using namespace std;
+using namespace mlpl;
+
+template<> uint64_t ColumnarTableStream::read<string, uint64_t>(void)
+{
+	string str;
+	uint64_t dest;
+	*this >> str;
+	Utils::conv(dest, str);
+	return dest;
+}
+
+template<typename T>
+static string readTempl(ColumnarTableStream &stream, const char *fmt)
+{
+	T val;
+	stream >> val;
+	return StringUtils::sprintf(fmt, val);
+}
+
+template<> string ColumnarTableStream::read<int, string>(void)
+{
+	return readTempl<int>(*this, "%d");
+}
+
+template<> string ColumnarTableStream::read<uint64_t, string>(void)
+{
+	return readTempl<uint64_t>(*this, "%" PRIu64);
+}
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+ColumnarTableStream::ColumnarTableStream(const ColumnarTable &table)
+: m_table(table),
+  m_row(0),
+  m_column(0),
+  m_started(false)
+{
+}
+
+bool ColumnarTableStream::next(void)
+{
+	if (m_started)
+		m_row++;
+	else
+		m_started = true;
+	m_column = 0;
+	return m_row < m_table.getNumberOfRows();
+}
+
+bool ColumnarTableStream::isNull(void) const
+{
+	return m_table.isNull(m_row, m_column);
+}
+
+void ColumnarTableStream::skip(void)
+{
+	nextColumn();
+}
+
+size_t ColumnarTableStream::getRow(void) const
+{
+	return m_row;
+}
+
+void ColumnarTableStream::operator>>(int &rhs)
+{
+	rhs = m_table.getInt(m_row, nextColumn());
+}
+
+void ColumnarTableStream::operator>>(uint64_t &rhs)
+{
+	const size_t column = nextColumn();
+	if (m_table.getItemType(column) == ITEM_TYPE_INT) {
+		// Compatible with the cast of ItemInt to uint64_t
+		const int &val = m_table.getInt(m_row, column);
+		if (val < 0) {
+			THROW_HATOHOL_EXCEPTION(
+			  "Failed to cast a negative value to uint64_t: "
+			  "%d (row: %zd, column: %zd)", val, m_row, column);
+		}
+		rhs = val;
+		return;
+	}
+	rhs = m_table.getUint64(m_row, column);
+}
+
+void ColumnarTableStream::operator>>(double &rhs)
+{
+	rhs = m_table.getDouble(m_row, nextColumn());
+}
+
+void ColumnarTableStream::operator>>(string &rhs)
+{
+	size_t length;
+	const char *str = m_table.getString(m_row, nextColumn(), length);
+	rhs.assign(str, length);
+}
+
+// ---------------------------------------------------------------------------
+// Private methods
+// ---------------------------------------------------------------------------
+size_t ColumnarTableStream::nextColumn(void)
+{
+	HATOHOL_ASSERT(m_started, "next() has not been called.");
+	HATOHOL_ASSERT(m_column < m_table.getNumberOfColumns(),
+	               "Invalid column: %zd (%zd)",
+	               m_column, m_table.getNumberOfColumns());
+	return m_column++;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef ColumnarTableStream_h
+#define ColumnarTableStream_h
+
+#include <string>
+#include "ColumnarTable.h"
+
+/**
+ * A row-by-row reader of ColumnarTable with the same '>>' interface as
+ * ItemGroupStream.
+ *
+ * Usage:
+ *   ColumnarTableStream stream(table);
+ *   while (stream.next()) {
+ *     stream >> a;
+ *     stream >> b;
+ *   }
+ */
+class ColumnarTableStream {
+public:
+	ColumnarTableStream(const ColumnarTable &table);
+
+	/**
+	 * Move the stream position to the head of the next row.
+	 *
+	 * @return true if the row exists, otherwise false.
+	 */
+	bool next(void);
+
+	/**
+	 * Check if the value at the current position is NULL.
+	 *
+	 * This method doesn't move the stream position.
+	 *
+	 * @return true if the value is NULL.
+	 */
+	bool isNull(void) const;
+
+	/**
+	 * Skip the value at the current position.
+	 */
+	void skip(void);
+
+	/**
+	 * Get the index of the current row.
+	 *
+	 * @return The row index.
+	 */
+	size_t getRow(void) const;
+
+	template <typename NATIVE_TYPE>
+	NATIVE_TYPE read(void)
+	{
+		NATIVE_TYPE val;
+		*this >> val;
+		return val;
+	}
+
+	template <typename NATIVE_TYPE, typename CAST_TYPE>
+	CAST_TYPE read(void)
+	{
+		return static_cast<CAST_TYPE>(read<NATIVE_TYPE>());
+	}
+
+	void operator>>(int &rhs);
+	void operator>>(uint64_t &rhs);
+	void operator>>(double &rhs);
+	void operator>>(std::string &rhs);
+
+	void operator>>(time_t &rhs)
+	{
+		rhs = read<int, time_t>();
+	}
+
+private:
+	size_t nextColumn(void);
+
+	const ColumnarTable &m_table;
+	size_t               m_row;
+	size_t               m_column;
+	bool                 m_started;
+};
+
+template<> uint64_t ColumnarTableStream::read<std::string, uint64_t>(void);
+template<> std::string ColumnarTableStream::read<int, std::string>(void);
+template<> std::string ColumnarTableStream::read<uint64_t, std::string>(void);
+
+#endif // ColumnarTableStream_h
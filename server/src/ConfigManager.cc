@@ -27,6 +27,7 @@
 #include "DBTablesConfig.h"
 #include "Reaper.h"
 #include "ThreadLocalDBCache.h"
+#include "RestResponseCache.h"
 using namespace std;
 using namespace mlpl;
 
@@ -36,6 +37,8 @@ enum {
 	CONF_MGR_ERROR_INVALID_LOG_LEVEL,
 	CONF_MGR_ERROR_INTERNAL,
 	CONF_MGR_ERROR_INVALID_NUM_WORKERS,
+	CONF_MGR_ERROR_INVALID_NUM_SPAWNERS,
+	CONF_MGR_ERROR_INVALID_NUM_INCIDENT_SENDER_JOBS,
 };
 
 const char *ConfigManager::HATOHOL_DB_DIR_ENV_VAR_NAME = "HATOHOL_DB_DIR";
@@ -105,6 +108,58 @@ static gboolean parseFaceRestNumWorkers(
 	return TRUE;
 }
 
+static gboolean parseNumActionSpawners(
+  const gchar *option_name, const gchar *value,
+  gpointer data, GError **error)
+{
+	GQuark quark =
+	  g_quark_from_static_string("config-manager-quark");
+	CommandLineOptions *obj =
+	  static_cast<CommandLineOptions *>(data);
+	if (!value) {
+		g_set_error(error, quark, CONF_MGR_ERROR_NULL,
+		            "value is NULL.");
+		return FALSE;
+	}
+
+	int numSpawners = atoi(value);
+	if (numSpawners < 0) {
+		g_set_error(error, quark, CONF_MGR_ERROR_INVALID_NUM_SPAWNERS,
+		            "value: %s, %d.", value, numSpawners);
+		return FALSE;
+	}
+
+	obj->numActionSpawners = numSpawners;
+
+	return TRUE;
+}
+
+static gboolean parseNumIncidentSenderJobs(
+  const gchar *option_name, const gchar *value,
+  gpointer data, GError **error)
+{
+	GQuark quark =
+	  g_quark_from_static_string("config-manager-quark");
+	CommandLineOptions *obj =
+	  static_cast<CommandLineOptions *>(data);
+	if (!value) {
+		g_set_error(error, quark, CONF_MGR_ERROR_NULL,
+		            "value is NULL.");
+		return FALSE;
+	}
+
+	int numJobs = atoi(value);
+	if (numJobs <= 0) {
+		g_set_error(error, quark,
+		            CONF_MGR_ERROR_INVALID_NUM_INCIDENT_SENDER_JOBS,
+		            "value: %s, %d.", value, numJobs);
+		return FALSE;
+	}
+
+	obj->numIncidentSenderJobs = numJobs;
+
+	return TRUE;
+}
 
 // ---------------------------------------------------------------------------
 // CommandLineOptions
@@ -119,7 +174,12 @@ CommandLineOptions::CommandLineOptions(void)
   foreground(FALSE),
   testMode(FALSE),
   faceRestPort(-1),
-  faceRestNumWorkers(0)
+  faceRestNumWorkers(0),
+  numActionSpawners(-1),
+  numIncidentSenderJobs(0),
+  disableTriggerStatisticsCache(FALSE),
+  restResponseCacheSize(-1),
+  faceRestNumReactors(-1)
 {
 }
 
@@ -141,6 +201,11 @@ struct ConfigManager::Impl {
 	string                user;
 	string                pidFilePath;
 	int                   faceRestNumWorkers;
+	int                   numActionSpawners;
+	int                   numIncidentSenderJobs;
+	bool                  triggerStatisticsCacheEnabled;
+	size_t                restResponseCacheSize;
+	size_t                faceRestNumReactors;
 
 	// methods
 	Impl(void)
@@ -150,7 +215,12 @@ struct ConfigManager::Impl {
 	  testMode(false),
 	  faceRestPort(0),
 	  pidFilePath(DEFAULT_PID_FILE_PATH),
-	  faceRestNumWorkers(0)
+	  faceRestNumWorkers(0),
+	  numActionSpawners(0),
+	  numIncidentSenderJobs(0),
+	  triggerStatisticsCacheEnabled(true),
+	  restResponseCacheSize(RestResponseCache::DEFAULT_MAX_BYTES),
+	  faceRestNumReactors(1)
 	{
 	}
 
@@ -233,6 +303,20 @@ struct ConfigManager::Impl {
 			user = cmdLineOpts.user;
 		if (cmdLineOpts.faceRestNumWorkers > 0)
 			faceRestNumWorkers = cmdLineOpts.faceRestNumWorkers;
+		if (cmdLineOpts.numActionSpawners >= 0)
+			numActionSpawners = cmdLineOpts.numActionSpawners;
+		if (cmdLineOpts.numIncidentSenderJobs > 0) {
+			numIncidentSenderJobs =
+			  cmdLineOpts.numIncidentSenderJobs;
+		}
+		if (cmdLineOpts.disableTriggerStatisticsCache)
+			triggerStatisticsCacheEnabled = false;
+		if (cmdLineOpts.restResponseCacheSize >= 0) {
+			restResponseCacheSize =
+			  cmdLineOpts.restResponseCacheSize * 1024 * 1024;
+		}
+		if (cmdLineOpts.faceRestNumReactors >= 0)
+			faceRestNumReactors = cmdLineOpts.faceRestNumReactors;
 	}
 
 private:
@@ -331,6 +415,27 @@ bool ConfigManager::parseCommandLine(gint *argc, gchar ***argv,
 		{"face-rest-workers",
 		 'T', 0, G_OPTION_ARG_CALLBACK, (gpointer)parseFaceRestNumWorkers,
 		 "Number of FaceRest worker threads", NULL},
+		{"action-spawners",
+		 'S', 0, G_OPTION_ARG_CALLBACK, (gpointer)parseNumActionSpawners,
+		 "Number of processes that create command actions "
+		 "(0: created by Hatohol itself)", NULL},
+		{"incident-sender-jobs",
+		 'J', 0, G_OPTION_ARG_CALLBACK,
+		 (gpointer)parseNumIncidentSenderJobs,
+		 "Number of incidents sent concurrently to a tracker", NULL},
+		{"disable-trigger-statistics-cache",
+		 0, 0, G_OPTION_ARG_NONE,
+		 &cmdLineOpts->disableTriggerStatisticsCache,
+		 "Count triggers for the overview with DB queries "
+		 "instead of in memory", NULL},
+		{"rest-response-cache-size",
+		 0, 0, G_OPTION_ARG_INT, &cmdLineOpts->restResponseCacheSize,
+		 "Memory for the response cache of FaceRest in MiB "
+		 "(0: disabled)", NULL},
+		{"face-rest-reactors",
+		 0, 0, G_OPTION_ARG_INT, &cmdLineOpts->faceRestNumReactors,
+		 "Number of FaceRest event loops sharing the port "
+		 "(0: one per CPU)", NULL},
 		{ NULL }
 	};
 
@@ -463,6 +568,54 @@ void ConfigManager::setResidentYardDirectory(const string &dir)
 	m_impl->residentYardDirectory = dir;
 }
 
+int ConfigManager::getNumberOfActionSpawners(void)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	return m_impl->numActionSpawners;
+}
+
+void ConfigManager::setNumberOfActionSpawners(const int &num)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	m_impl->numActionSpawners = num;
+}
+
+int ConfigManager::getNumberOfIncidentSenderJobs(void)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	return m_impl->numIncidentSenderJobs;
+}
+
+void ConfigManager::setNumberOfIncidentSenderJobs(const int &num)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	m_impl->numIncidentSenderJobs = num;
+}
+
+bool ConfigManager::isTriggerStatisticsCacheEnabled(void)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	return m_impl->triggerStatisticsCacheEnabled;
+}
+
+void ConfigManager::setTriggerStatisticsCacheEnabled(const bool &enabled)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	m_impl->triggerStatisticsCacheEnabled = enabled;
+}
+
+size_t ConfigManager::getRestResponseCacheSize(void)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	return m_impl->restResponseCacheSize;
+}
+
+void ConfigManager::setRestResponseCacheSize(const size_t &bytes)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	m_impl->restResponseCacheSize = bytes;
+}
+
 bool ConfigManager::isTestMode(void) const
 {
 	return m_impl->testMode;
@@ -498,6 +651,18 @@ void ConfigManager::setFaceRestNumWorkers(const int &num)
 	m_impl->faceRestNumWorkers = num;
 }
 
+size_t ConfigManager::getFaceRestNumReactors(void)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	return m_impl->faceRestNumReactors;
+}
+
+void ConfigManager::setFaceRestNumReactors(const size_t &num)
+{
+	lock_guard<mutex> lock(m_impl->mutex);
+	m_impl->faceRestNumReactors = num;
+}
+
 // ---------------------------------------------------------------------------
 // Protected methods
 // ---------------------------------------------------------------------------
@@ -35,6 +35,11 @@ struct CommandLineOptions {
 	gboolean  testMode;
 	gint      faceRestPort;
 	gint      faceRestNumWorkers;
+	gint      numActionSpawners;
+	gint      numIncidentSenderJobs;
+	gboolean  disableTriggerStatisticsCache;
+	gint      restResponseCacheSize;
+	gint      faceRestNumReactors;
 
 	CommandLineOptions(void);
 };
@@ -97,6 +102,47 @@ public:
 	std::string getResidentYardDirectory(void);
 	void setResidentYardDirectory(const std::string &dir);
 
+	/**
+	 * Get the number of hatohol-action-spawner processes that create
+	 * command actions.
+	 *
+	 * @return
+	 * The number of the processes. If this is 0, command actions are
+	 * created by Hatohol itself.
+	 */
+	int getNumberOfActionSpawners(void);
+	void setNumberOfActionSpawners(const int &num);
+
+	/**
+	 * Get the number of incidents sent concurrently to a tracker.
+	 *
+	 * @return
+	 * The number of the jobs. If this is 0, the default of
+	 * IncidentSender is used.
+	 */
+	int getNumberOfIncidentSenderJobs(void);
+	void setNumberOfIncidentSenderJobs(const int &num);
+
+	/**
+	 * Check if the trigger statistics for the overview are kept in
+	 * memory by TriggerStatisticsCache.
+	 *
+	 * @return
+	 * true if the cache is used. If false, the statistics are
+	 * obtained with grouped queries for each request.
+	 */
+	bool isTriggerStatisticsCacheEnabled(void);
+	void setTriggerStatisticsCacheEnabled(const bool &enabled);
+
+	/**
+	 * Get the limit of the memory used by the response cache of
+	 * FaceRest.
+	 *
+	 * @return The limit in bytes. If this is 0, the cache is disabled.
+	 */
+	size_t getRestResponseCacheSize(void);
+	void setRestResponseCacheSize(const size_t &bytes);
+
 	bool isTestMode(void) const;
 
 	/**
@@ -118,6 +164,17 @@ public:
 
 	void setFaceRestNumWorkers(const int &num);
 
+	/**
+	 * Get the number of the event loops that accept the connections
+	 * to FaceRest.
+	 *
+	 * @return
+	 * The number of the event loops. If this is 0, an event loop is
+	 * run for each online CPU.
+	 */
+	size_t getFaceRestNumReactors(void);
+	void setFaceRestNumReactors(const size_t &num);
+
 protected:
 	void loadConfFile(void);
 	static gboolean parseLogLevel(
@@ -83,13 +83,16 @@ DBAgent::TableProfile::TableProfile(
 : name(_name),
   columnDefs(_columnDefs),
   numColumns(numIndexes),
-  indexDefArray(_indexDefArray)
+  indexDefArray(_indexDefArray),
+  autoIncrementColumnIndex(IndexDef::END)
 {
 	// We assume there's one (combined) unique key at most every table.
 	// This limited is in order to realize upsert on SQLite3.
 	size_t numUniqueKeys = 0;
 	for (size_t i = 0; i < numIndexes; i++) {
 		const ColumnDef &columnDef = columnDefs[i];
+		if (columnDef.flags & SQL_COLUMN_FLAG_AUTO_INC)
+			autoIncrementColumnIndex = i;
 		if (columnDef.keyType != SQL_KEY_UNI)
 			continue;
 		numUniqueKeys++;
@@ -169,6 +172,23 @@ void DBAgent::InsertArg::add(const time_t &val,
 	row->addNewItem(val, nullFlag);
 }
 
+// ---------------------------------------------------------------------------
+// DBAgent::BulkInsertArg
+// ---------------------------------------------------------------------------
+DBAgent::BulkInsertArg::BulkInsertArg(const TableProfile &profile)
+: tableProfile(profile),
+  upsertOnDuplicate(false)
+{
+}
+
+void DBAgent::BulkInsertArg::add(const InsertArg &insertArg)
+{
+	HATOHOL_ASSERT(&insertArg.tableProfile == &tableProfile,
+	               "Table mismatch: %s, %s",
+	               insertArg.tableProfile.name, tableProfile.name);
+	rows.push_back(insertArg.row);
+}
+
 // ---------------------------------------------------------------------------
 // DBAgent::UpdateArg
 // ---------------------------------------------------------------------------
@@ -245,7 +265,8 @@ DBAgent::SelectExArg::SelectExArg(const TableProfile &profile)
   limit(0),
   offset(0),
   useFullName(false),
-  useDistinct(false)
+  useDistinct(false),
+  useColumnarTable(false)
 {
 }
 
@@ -355,6 +376,35 @@ DBAgent::~DBAgent()
 {
 }
 
+void DBAgent::bulkInsert(const BulkInsertArg &bulkInsertArg)
+{
+	const TableProfile &tableProfile = bulkInsertArg.tableProfile;
+	const bool hasAutoIncColumn =
+	  (tableProfile.autoIncrementColumnIndex != IndexDef::END);
+	bulkInsertArg.insertIds.clear();
+	for (const auto &row : bulkInsertArg.rows) {
+		InsertArg arg(tableProfile);
+		arg.row = row;
+		arg.upsertOnDuplicate = bulkInsertArg.upsertOnDuplicate;
+		insert(arg);
+		if (hasAutoIncColumn)
+			bulkInsertArg.insertIds.push_back(getLastInsertId());
+	}
+}
+
+void DBAgent::selectEach(const SelectExArg &selectExArg,
+                         const RowHandler &handler)
+{
+	SelectExArg arg(selectExArg);
+	arg.useColumnarTable = true;
+	select(arg);
+	ColumnarTableStream stream(*arg.columnarTable);
+	while (stream.next()) {
+		if (!handler(stream))
+			break;
+	}
+}
+
 void DBAgent::dropTable(const std::string &tableName)
 {
 	string sql = "DROP TABLE ";
@@ -491,6 +541,27 @@ struct TrxInsert : public DBAgent::TransactionProc {
 	}
 };
 
+void DBAgent::runTransaction(const SelectExArg &arg,
+                             const RowHandler &handler)
+{
+	struct TrxProc : public DBAgent::TransactionProc {
+		const SelectExArg &arg;
+		const RowHandler  &handler;
+
+		TrxProc(const SelectExArg &_arg, const RowHandler &_handler)
+		: arg(_arg),
+		  handler(_handler)
+		{
+		}
+
+		void operator ()(DBAgent &dbAgent) override
+		{
+			dbAgent.selectEach(arg, handler);
+		}
+	} trx(arg, handler);
+	runTransaction(trx);
+}
+
 void DBAgent::runTransaction(const InsertArg &arg, int *id)
 {
 	TrxInsert<int> trx(arg, id);
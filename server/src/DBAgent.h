@@ -22,10 +22,12 @@
 
 #include <string>
 #include <memory>
+#include <functional>
 #include <glib.h>
 #include <stdint.h>
 #include "Params.h"
 #include "SQLProcessorTypes.h"
+#include "ColumnarTableStream.h"
 #include "DBTermCodec.h"
 
 static const int CURR_DATETIME = -1;
@@ -71,6 +73,8 @@ public:
 
 		// The following members are initialized in the constructor
 		std::vector<int>    uniqueKeyColumnIndexes;
+		// IndexDef::END if there's no AUTO_INCREMENT column.
+		int                 autoIncrementColumnIndex;
 
 		TableProfile(const char *name,  const ColumnDef *columnDefs,
 		             const size_t &numIndexes,
@@ -126,6 +130,26 @@ public:
 		                                     = ITEM_DATA_NOT_NULL);
 	};
 
+	struct BulkInsertArg {
+		const TableProfile               &tableProfile;
+		std::vector<VariableItemGroupPtr> rows;
+		bool                              upsertOnDuplicate;
+		// output: IDs of the AUTO_INCREMENT column in the order of rows.
+		// This is filled only when the table has such a column.
+		mutable std::vector<uint64_t>     insertIds;
+
+		BulkInsertArg(const TableProfile &tableProfile);
+
+		/**
+		 * Append the row of an InsertArg.
+		 *
+		 * @param insertArg
+		 * An InsertArg instance for the same table. Only its row is
+		 * used; upsertOnDuplicate of it is ignored.
+		 */
+		void add(const InsertArg &insertArg);
+	};
+
 	struct UpdateArg {
 		const TableProfile             &tableProfile;
 		std::string                     condition;
@@ -169,8 +193,12 @@ public:
 		std::string                tableField;
 		bool                       useFullName;
 		bool                       useDistinct;
+		// If this is true, the result is stored in columnarTable
+		// instead of dataTable.
+		bool                       useColumnarTable;
 		// output
 		mutable ItemTablePtr        dataTable;
+		mutable ColumnarTablePtr    columnarTable;
 
 		SelectExArg(const TableProfile &tableProfile);
 		void add(const size_t &columnIndex);
@@ -199,6 +227,18 @@ public:
 		                        const size_t &columnIndex);
 	};
 
+	/**
+	 * A function called for each row by selectEach().
+	 *
+	 * The given stream is positioned at the head of the row and is valid
+	 * only in the call.
+	 *
+	 * @return
+	 * true to continue. If false is returned, the remaining rows are
+	 * discarded.
+	 */
+	typedef std::function<bool (ColumnarTableStream &)> RowHandler;
+
 	struct DeleteArg {
 		const TableProfile &tableProfile;
 		std::string         condition;
@@ -226,9 +266,38 @@ public:
 	virtual void execSql(const std::string &sql) = 0;
 	virtual void createTable(const TableProfile &tableProfile) = 0;
 	virtual void insert(const InsertArg &insertArg) = 0;
+
+	/**
+	 * Insert multiple rows.
+	 *
+	 * The default implementation calls insert() for each row.
+	 * A sub class can override it to issue fewer statements.
+	 *
+	 * @param bulkInsertArg A BulkInsertArg instance.
+	 */
+	virtual void bulkInsert(const BulkInsertArg &bulkInsertArg);
 	virtual void update(const UpdateArg &updateArg) = 0;
 	virtual void select(const SelectArg &selectArg) = 0;
 	virtual void select(const SelectExArg &selectExArg) = 0;
+
+	/**
+	 * Execute a SELECT and pass each row to the handler as soon as it is
+	 * received. The whole result is not stored, so that a large result
+	 * can be processed in constant memory.
+	 *
+	 * The default implementation stores the result in a ColumnarTable and
+	 * then calls the handler for each row. A sub class can override it to
+	 * stream rows from the server.
+	 *
+	 * The handler must not use this DBAgent instance since the connection
+	 * can be occupied until all rows are read.
+	 *
+	 * @param selectExArg A SelectExArg instance. The output members are
+	 *                    not used.
+	 * @param handler A function called for each row.
+	 */
+	virtual void selectEach(const SelectExArg &selectExArg,
+	                        const RowHandler &handler);
 	virtual void deleteRows(const DeleteArg &deleteArg) = 0;
 	virtual void addColumns(const AddColumnsArg &addColumnsArg) = 0;
 	virtual void changeColumnDef(const TableProfile &tableProfile,
@@ -374,6 +443,14 @@ public:
 		_runTransaction<const SelectExArg, &DBAgent::select>(arg);
 	}
 
+	/**
+	 * Call selectEach() in runTransaction.
+	 *
+	 * @param arg A SelectExArg instance.
+	 * @param handler A function called for each row.
+	 */
+	void runTransaction(const SelectExArg &arg, const RowHandler &handler);
+
 	void runTransaction(const UpdateArg &arg)
 	{
 		_runTransaction<const UpdateArg, &DBAgent::update>(arg);
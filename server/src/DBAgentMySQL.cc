@@ -21,6 +21,8 @@
 #include <unistd.h>
 #include <semaphore.h>
 #include <errno.h>
+#include <cstring>
+#include <type_traits>
 #include <AtomicValue.h>
 #include <SimpleSemaphore.h>
 #include "DBAgentMySQL.h"
@@ -34,6 +36,67 @@ static const size_t DEFAULT_NUM_RETRY = 5;
 static const size_t RETRY_INTERVAL[DEFAULT_NUM_RETRY] = {
   0, 10, 60, 60, 60 };
 
+// A multi-row INSERT statement is split so that it doesn't exceed
+// max_allowed_packet (1MB by default on old servers).
+static const size_t MAX_ROWS_IN_BULK_INSERT = 1000;
+static const size_t MAX_BULK_INSERT_STATEMENT_LENGTH = 512 * 1024;
+
+// innodb_autoinc_lock_mode = 2 (interleaved) doesn't guarantee
+// consecutive IDs in a multi-row INSERT.
+static const int AUTOINC_LOCK_MODE_INTERLEAVED = 2;
+
+// A buffer for a string column in a result is extended on demand.
+static const size_t DEFAULT_RESULT_STRING_BUFFER_SIZE = 256;
+
+// my_bool was removed in MySQL 8.0 (and is still char in MariaDB).
+typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type MySQLBool;
+
+struct DBAgentMySQL::PreparedStatement {
+	std::string sql;
+	MYSQL_STMT *stmt;
+
+	PreparedStatement(void)
+	: stmt(NULL)
+	{
+	}
+
+	~PreparedStatement()
+	{
+		close();
+	}
+
+	void close(void)
+	{
+		if (stmt)
+			mysql_stmt_close(stmt);
+		stmt = NULL;
+	}
+};
+
+// Storage of a value bound to a parameter or a result column.
+struct BindBuffer {
+	int           intVal;
+	uint64_t      uint64Val;
+	double        doubleVal;
+	MYSQL_TIME    timeVal;
+	string        strVal;
+	vector<char>  strBuf;
+	unsigned long length;
+	MySQLBool     isNull;
+	MySQLBool     error;
+
+	BindBuffer(void)
+	: intVal(0),
+	  uint64Val(0),
+	  doubleVal(0),
+	  length(0),
+	  isNull(0),
+	  error(0)
+	{
+		memset(&timeVal, 0, sizeof(timeVal));
+	}
+};
+
 struct DBAgentMySQL::Impl {
 	static string engineStr;
 	static set<unsigned int> retryErrorSet;
@@ -47,18 +110,30 @@ struct DBAgentMySQL::Impl {
 	bool inTransaction;
 	AtomicValue<bool> disposed;
 	SimpleSemaphore waitSem;
+	int autoIncLockMode;  // -1 means not fetched yet
+	uint64_t autoIncIncrement;
+	static bool defaultUsePreparedStatement;
+	bool usePreparedStatement;
+	map<string, unique_ptr<PreparedStatement>> prepStmtMap;
+	// Set when the last statement was executed as a prepared one.
+	MYSQL_STMT *lastExecutedStmt;
 
 	Impl(void)
 	: connected(false),
 	  port(0),
 	  inTransaction(false),
 	  disposed(false),
-	  waitSem(0)
+	  waitSem(0),
+	  autoIncLockMode(-1),
+	  autoIncIncrement(1),
+	  usePreparedStatement(defaultUsePreparedStatement),
+	  lastExecutedStmt(NULL)
 	{
 	}
 
 	~Impl(void)
 	{
+		closePreparedStatements();
 		if (connected) {
 			mysql_close(&mysql);
 		}
@@ -68,10 +143,183 @@ struct DBAgentMySQL::Impl {
 	{
 		return retryErrorSet.find(errorNumber) != retryErrorSet.end();
 	}
+
+	// Statement handles are invalid after the connection is closed.
+	// The SQL is kept to prepare it again on the new connection.
+	void closePreparedStatements(void)
+	{
+		for (auto &prepStmtPair : prepStmtMap)
+			prepStmtPair.second->close();
+		lastExecutedStmt = NULL;
+	}
 };
 
 string DBAgentMySQL::Impl::engineStr;
 set<unsigned int> DBAgentMySQL::Impl::retryErrorSet;
+bool DBAgentMySQL::Impl::defaultUsePreparedStatement = false;
+
+static void setDatetime(MYSQL_TIME &mysqlTime, const int &datetime)
+{
+	time_t clock;
+	if (datetime == CURR_DATETIME)
+		time(&clock);
+	else
+		clock = (time_t)datetime;
+	struct tm tm;
+	localtime_r(&clock, &tm);
+	memset(&mysqlTime, 0, sizeof(mysqlTime));
+	mysqlTime.year   = tm.tm_year + 1900;
+	mysqlTime.month  = tm.tm_mon + 1;
+	mysqlTime.day    = tm.tm_mday;
+	mysqlTime.hour   = tm.tm_hour;
+	mysqlTime.minute = tm.tm_min;
+	mysqlTime.second = tm.tm_sec;
+	mysqlTime.time_type = MYSQL_TIMESTAMP_DATETIME;
+}
+
+static int getDatetime(const MYSQL_TIME &mysqlTime)
+{
+	struct tm tm;
+	memset(&tm, 0, sizeof(tm));
+	tm.tm_year = mysqlTime.year - 1900;
+	tm.tm_mon  = mysqlTime.month - 1;
+	tm.tm_mday = mysqlTime.day;
+	tm.tm_hour = mysqlTime.hour;
+	tm.tm_min  = mysqlTime.minute;
+	tm.tm_sec  = mysqlTime.second;
+	return (int)mktime(&tm);
+}
+
+static void bindParam(MYSQL_BIND &bind, BindBuffer &buf,
+                      const ColumnDef &columnDef, const ItemData *itemData)
+{
+	memset(&bind, 0, sizeof(bind));
+	buf.isNull = itemData->isNull();
+	bind.is_null = &buf.isNull;
+	if (buf.isNull) {
+		bind.buffer_type = MYSQL_TYPE_NULL;
+		return;
+	}
+
+	if (columnDef.type == SQL_COLUMN_TYPE_DATETIME) {
+		setDatetime(buf.timeVal, *itemData);
+		bind.buffer_type = MYSQL_TYPE_DATETIME;
+		bind.buffer = &buf.timeVal;
+		return;
+	}
+
+	switch (itemData->getItemType()) {
+	case ITEM_TYPE_BOOL:
+		buf.intVal = static_cast<const bool &>(*itemData);
+		bind.buffer_type = MYSQL_TYPE_LONG;
+		bind.buffer = &buf.intVal;
+		break;
+	case ITEM_TYPE_INT:
+		buf.intVal = *itemData;
+		bind.buffer_type = MYSQL_TYPE_LONG;
+		bind.buffer = &buf.intVal;
+		break;
+	case ITEM_TYPE_UINT64:
+		buf.uint64Val = *itemData;
+		bind.buffer_type = MYSQL_TYPE_LONGLONG;
+		bind.buffer = &buf.uint64Val;
+		bind.is_unsigned = 1;
+		break;
+	case ITEM_TYPE_DOUBLE:
+		buf.doubleVal = *itemData;
+		bind.buffer_type = MYSQL_TYPE_DOUBLE;
+		bind.buffer = &buf.doubleVal;
+		break;
+	case ITEM_TYPE_STRING:
+		buf.strVal = static_cast<const string &>(*itemData);
+		buf.length = buf.strVal.size();
+		bind.buffer_type = MYSQL_TYPE_STRING;
+		bind.buffer = const_cast<char *>(buf.strVal.data());
+		bind.buffer_length = buf.length;
+		bind.length = &buf.length;
+		break;
+	default:
+		HATOHOL_ASSERT(false, "Unknown item type: %d (%s)",
+		               itemData->getItemType(), columnDef.columnName);
+	}
+}
+
+static void bindResult(MYSQL_BIND &bind, BindBuffer &buf,
+                       const SQLColumnType &type)
+{
+	memset(&bind, 0, sizeof(bind));
+	bind.is_null = &buf.isNull;
+	bind.error = &buf.error;
+	bind.length = &buf.length;
+	switch (type) {
+	case SQL_COLUMN_TYPE_INT:
+		bind.buffer_type = MYSQL_TYPE_LONG;
+		bind.buffer = &buf.intVal;
+		break;
+	case SQL_COLUMN_TYPE_BIGUINT:
+		bind.buffer_type = MYSQL_TYPE_LONGLONG;
+		bind.buffer = &buf.uint64Val;
+		bind.is_unsigned = 1;
+		break;
+	case SQL_COLUMN_TYPE_DOUBLE:
+		bind.buffer_type = MYSQL_TYPE_DOUBLE;
+		bind.buffer = &buf.doubleVal;
+		break;
+	case SQL_COLUMN_TYPE_VARCHAR:
+	case SQL_COLUMN_TYPE_CHAR:
+	case SQL_COLUMN_TYPE_TEXT:
+		if (buf.strBuf.empty())
+			buf.strBuf.resize(DEFAULT_RESULT_STRING_BUFFER_SIZE);
+		bind.buffer_type = MYSQL_TYPE_STRING;
+		bind.buffer = buf.strBuf.data();
+		bind.buffer_length = buf.strBuf.size();
+		break;
+	case SQL_COLUMN_TYPE_DATETIME:
+		bind.buffer_type = MYSQL_TYPE_DATETIME;
+		bind.buffer = &buf.timeVal;
+		break;
+	default:
+		HATOHOL_ASSERT(false, "Unknown column type: %d", type);
+	}
+}
+
+static ItemDataPtr createItemData(const BindBuffer &buf,
+                                  const SQLColumnType &type)
+{
+	const ItemDataNullFlagType nullFlag =
+	  buf.isNull ? ITEM_DATA_NULL : ITEM_DATA_NOT_NULL;
+	ItemData *itemData = NULL;
+	switch (type) {
+	case SQL_COLUMN_TYPE_INT:
+		itemData = new ItemInt(buf.isNull ? 0 : buf.intVal, nullFlag);
+		break;
+	case SQL_COLUMN_TYPE_BIGUINT:
+		itemData = new ItemUint64(buf.isNull ? 0 : buf.uint64Val,
+		                          nullFlag);
+		break;
+	case SQL_COLUMN_TYPE_DOUBLE:
+		itemData = new ItemDouble(buf.isNull ? 0 : buf.doubleVal,
+		                          nullFlag);
+		break;
+	case SQL_COLUMN_TYPE_VARCHAR:
+	case SQL_COLUMN_TYPE_CHAR:
+	case SQL_COLUMN_TYPE_TEXT:
+		if (buf.isNull) {
+			itemData = new ItemString("", nullFlag);
+		} else {
+			itemData = new ItemString(
+			  string(buf.strBuf.data(), buf.length));
+		}
+		break;
+	case SQL_COLUMN_TYPE_DATETIME:
+		itemData = new ItemInt(buf.isNull ? 0 : getDatetime(buf.timeVal),
+		                       nullFlag);
+		break;
+	default:
+		THROW_HATOHOL_EXCEPTION("Unknown column type: %d\n", type);
+	}
+	return ItemDataPtr(itemData, false);
+}
 
 // ---------------------------------------------------------------------------
 // Public methods
@@ -84,6 +332,12 @@ void DBAgentMySQL::init(void)
 		Impl::engineStr = " ENGINE=MEMORY";
 	}
 	Impl::retryErrorSet.insert(CR_SERVER_GONE_ERROR);
+
+	env = getenv("HATOHOL_MYSQL_PREPARED_STATEMENT");
+	if (env && atoi(env) == 1) {
+		MLPL_INFO("Use prepared statements\n");
+		Impl::defaultUsePreparedStatement = true;
+	}
 }
 
 DBAgentMySQL::DBAgentMySQL(const char *db, const char *user, const char *passwd,
@@ -314,6 +568,11 @@ void DBAgentMySQL::insert(const DBAgent::InsertArg &insertArg)
 {
 	using mlpl::StringUtils::sprintf;
 
+	if (m_impl->usePreparedStatement) {
+		insertWithPreparedStatement(insertArg);
+		return;
+	}
+
 	const size_t numColumns = insertArg.tableProfile.numColumns;
 	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
 	HATOHOL_ASSERT(numColumns == insertArg.row->getNumberOfItems(),
@@ -390,9 +649,93 @@ void DBAgentMySQL::insert(const DBAgent::InsertArg &insertArg)
 	execSql(query);
 }
 
+void DBAgentMySQL::bulkInsert(const BulkInsertArg &bulkInsertArg)
+{
+	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
+	if (!canUseMultiRowInsert(bulkInsertArg)) {
+		DBAgent::bulkInsert(bulkInsertArg);
+		return;
+	}
+
+	const TableProfile &tableProfile = bulkInsertArg.tableProfile;
+	const size_t numColumns = tableProfile.numColumns;
+	const bool hasAutoIncColumn =
+	  (tableProfile.autoIncrementColumnIndex != IndexDef::END);
+
+	SeparatorInjector commaInjector(",");
+	string header = StringUtils::sprintf("INSERT INTO %s (",
+	                                     tableProfile.name);
+	string updateClause;
+	for (size_t i = 0; i < numColumns; i++) {
+		const ColumnDef &columnDef = tableProfile.columnDefs[i];
+		commaInjector(header);
+		header += columnDef.columnName;
+		if (!bulkInsertArg.upsertOnDuplicate)
+			continue;
+		if (columnDef.keyType == SQL_KEY_PRI)
+			continue;
+		if (!updateClause.empty())
+			updateClause += ",";
+		updateClause += StringUtils::sprintf(
+		  "%s=VALUES(%s)", columnDef.columnName, columnDef.columnName);
+	}
+	header += ") VALUES ";
+	if (!updateClause.empty())
+		updateClause.insert(0, " ON DUPLICATE KEY UPDATE ");
+
+	string query;
+	size_t numRowsInQuery = 0;
+	auto flush = [&] {
+		query += updateClause;
+		execSql(query);
+		if (hasAutoIncColumn) {
+			const uint64_t numAffectedRows =
+			  getNumberOfAffectedRows();
+			HATOHOL_ASSERT(numAffectedRows == numRowsInQuery,
+			               "numAffectedRows: %" PRIu64 ", "
+			               "numRows: %zd",
+			               numAffectedRows, numRowsInQuery);
+			// mysql_insert_id() returns the ID of the first row.
+			const uint64_t firstId = mysql_insert_id(&m_impl->mysql);
+			for (size_t i = 0; i < numRowsInQuery; i++) {
+				bulkInsertArg.insertIds.push_back(
+				  firstId + i * m_impl->autoIncIncrement);
+			}
+		}
+		query.clear();
+		numRowsInQuery = 0;
+	};
+
+	bulkInsertArg.insertIds.clear();
+	bulkInsertArg.insertIds.reserve(bulkInsertArg.rows.size());
+	for (const auto &row : bulkInsertArg.rows) {
+		HATOHOL_ASSERT(numColumns == row->getNumberOfItems(),
+		               "numColumn: %zd != row: %zd",
+		               numColumns, row->getNumberOfItems());
+		query += (numRowsInQuery == 0) ? header : string(",");
+		query += "(";
+		commaInjector.clear();
+		for (size_t i = 0; i < numColumns; i++) {
+			const ColumnDef &columnDef = tableProfile.columnDefs[i];
+			commaInjector(query);
+			query += getColumnValueString(&columnDef,
+			                              row->getItemAt(i));
+		}
+		query += ")";
+		numRowsInQuery++;
+		if (numRowsInQuery >= MAX_ROWS_IN_BULK_INSERT ||
+		    query.size() >= MAX_BULK_INSERT_STATEMENT_LENGTH)
+			flush();
+	}
+	if (numRowsInQuery > 0)
+		flush();
+}
 
 void DBAgentMySQL::update(const UpdateArg &updateArg)
 {
+	// A prepared statement isn't used even in the prepared statement
+	// mode, because the condition differs for each call (see the
+	// comment of setPreparedStatementEnabled()).
 	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
 	string sql = makeUpdateStatement(updateArg);
 	execSql(sql);
@@ -401,6 +744,10 @@ void DBAgentMySQL::update(const UpdateArg &updateArg)
 void DBAgentMySQL::select(const DBAgent::SelectArg &selectArg)
 {
 	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
+	if (m_impl->usePreparedStatement) {
+		selectWithPreparedStatement(selectArg);
+		return;
+	}
 
 	string query = makeSelectStatement(selectArg);
 	execSql(query);
@@ -432,6 +779,7 @@ void DBAgentMySQL::select(const DBAgent::SelectArg &selectArg)
 
 void DBAgentMySQL::select(const SelectExArg &selectExArg)
 {
+	// Same as update(), this isn't covered by the prepared statement mode.
 	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
 
 	string query = makeSelectStatement(selectExArg);
@@ -444,8 +792,22 @@ void DBAgentMySQL::select(const SelectExArg &selectExArg)
 	}
 
 	MYSQL_ROW row;
-	VariableItemTablePtr dataTable;
 	size_t numColumns = selectExArg.statements.size();
+	if (selectExArg.useColumnarTable) {
+		ColumnarTablePtr table = make_shared<ColumnarTable>();
+		table->setColumnTypes(selectExArg.columnTypes);
+		table->reserve(mysql_num_rows(result));
+		while ((row = mysql_fetch_row(result))) {
+			unsigned long *lengths = mysql_fetch_lengths(result);
+			for (size_t i = 0; i < numColumns; i++)
+				table->addFromString(row[i], lengths[i]);
+		}
+		mysql_free_result(result);
+		selectExArg.columnarTable = table;
+		return;
+	}
+
+	VariableItemTablePtr dataTable;
 	while ((row = mysql_fetch_row(result))) {
 		VariableItemGroupPtr itemGroup;
 		for (size_t i = 0; i < numColumns; i++) {
@@ -469,6 +831,45 @@ void DBAgentMySQL::select(const SelectExArg &selectExArg)
 	             numTableRows, numTableColumns, numColumns);
 }
 
+void DBAgentMySQL::selectEach(const SelectExArg &selectExArg,
+                              const RowHandler &handler)
+{
+	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
+
+	string query = makeSelectStatement(selectExArg);
+	execSql(query);
+
+	// mysql_use_result() doesn't buffer the whole result in the client.
+	// mysql_free_result() reads and discards the remaining rows even when
+	// the handler stops the iteration or throws an exception.
+	unique_ptr<MYSQL_RES, void (*)(MYSQL_RES *)> result(
+	  mysql_use_result(&m_impl->mysql), mysql_free_result);
+	if (!result) {
+		THROW_HATOHOL_EXCEPTION("Failed to call mysql_use_result: %s\n",
+		                      mysql_error(&m_impl->mysql));
+	}
+
+	// The same table is reused for every row to avoid reallocation.
+	ColumnarTable table;
+	table.setColumnTypes(selectExArg.columnTypes);
+	const size_t numColumns = selectExArg.statements.size();
+	MYSQL_ROW row;
+	while ((row = mysql_fetch_row(result.get()))) {
+		unsigned long *lengths = mysql_fetch_lengths(result.get());
+		table.clearRows();
+		for (size_t i = 0; i < numColumns; i++)
+			table.addFromString(row[i], lengths[i]);
+		ColumnarTableStream stream(table);
+		stream.next();
+		if (!handler(stream))
+			return;
+	}
+	if (mysql_errno(&m_impl->mysql)) {
+		THROW_HATOHOL_EXCEPTION("Failed to call mysql_fetch_row: %s\n",
+		                      mysql_error(&m_impl->mysql));
+	}
+}
+
 void DBAgentMySQL::deleteRows(const DeleteArg &deleteArg)
 {
 	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
@@ -498,6 +899,8 @@ uint64_t DBAgentMySQL::getLastInsertId(void)
 uint64_t DBAgentMySQL::getNumberOfAffectedRows(void)
 {
 	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
+	if (m_impl->lastExecutedStmt)
+		return mysql_stmt_affected_rows(m_impl->lastExecutedStmt);
 	my_ulonglong num = mysql_affected_rows(&m_impl->mysql);
 	// According to the referece manual, mysql_affected_rows()
 	// doesn't return an error.
@@ -575,6 +978,16 @@ void DBAgentMySQL::dispose(void)
 	m_impl->waitSem.post();
 }
 
+void DBAgentMySQL::setPreparedStatementEnabled(const bool &enable)
+{
+	m_impl->usePreparedStatement = enable;
+}
+
+bool DBAgentMySQL::isPreparedStatementEnabled(void) const
+{
+	return m_impl->usePreparedStatement;
+}
+
 // ---------------------------------------------------------------------------
 // Protected methods
 // ---------------------------------------------------------------------------
@@ -609,6 +1022,7 @@ void DBAgentMySQL::sleepAndReconnect(unsigned int sleepTimeSec)
 {
 	m_impl->waitSem.timedWait(sleepTimeSec * 1000);
 
+	m_impl->closePreparedStatements();
 	mysql_close(&m_impl->mysql);
 	m_impl->connected = false;
 	connect();
@@ -629,6 +1043,7 @@ void DBAgentMySQL::queryWithRetry(const string &statement)
 {
 	unsigned int errorNumber = 0;
 	size_t numRetry = DEFAULT_NUM_RETRY;
+	m_impl->lastExecutedStmt = NULL;
 	for (size_t i = 0; i < numRetry; i++) {
 		if (throwExceptionIfDisposed())
 			break;
@@ -676,6 +1091,261 @@ void DBAgentMySQL::queryWithRetry(const string &statement)
 	}
 }
 
+DBAgentMySQL::PreparedStatement &DBAgentMySQL::getPreparedStatement(
+  const string &key)
+{
+	unique_ptr<PreparedStatement> &prepStmt = m_impl->prepStmtMap[key];
+	if (!prepStmt)
+		prepStmt.reset(new PreparedStatement());
+	return *prepStmt;
+}
+
+void DBAgentMySQL::executeStatementWithRetry(PreparedStatement &prepStmt,
+                                             MYSQL_BIND *params)
+{
+	unsigned int errorNumber = 0;
+	string errorMessage;
+	auto execute = [&] {
+		if (!prepStmt.stmt) {
+			prepStmt.stmt = mysql_stmt_init(&m_impl->mysql);
+			if (!prepStmt.stmt) {
+				errorNumber = mysql_errno(&m_impl->mysql);
+				errorMessage = mysql_error(&m_impl->mysql);
+				return false;
+			}
+			if (mysql_stmt_prepare(prepStmt.stmt, prepStmt.sql.c_str(),
+			                       prepStmt.sql.size()) != 0) {
+				errorNumber = mysql_stmt_errno(prepStmt.stmt);
+				errorMessage = mysql_stmt_error(prepStmt.stmt);
+				prepStmt.close();
+				return false;
+			}
+		}
+		if ((params && mysql_stmt_bind_param(prepStmt.stmt, params)) ||
+		    mysql_stmt_execute(prepStmt.stmt)) {
+			errorNumber = mysql_stmt_errno(prepStmt.stmt);
+			errorMessage = mysql_stmt_error(prepStmt.stmt);
+			return false;
+		}
+		return true;
+	};
+
+	HATOHOL_ASSERT(m_impl->connected, "Not connected.");
+	m_impl->lastExecutedStmt = NULL;
+	size_t numRetry = DEFAULT_NUM_RETRY;
+	for (size_t i = 0; i < numRetry; i++) {
+		if (throwExceptionIfDisposed())
+			break;
+		if (execute()) {
+			if (i >= 1) {
+				MLPL_INFO("Recoverd: %s (retry #%zd).\n",
+				          prepStmt.sql.c_str(), i);
+			}
+			m_impl->lastExecutedStmt = prepStmt.stmt;
+			return;
+		}
+		if (!m_impl->shouldRetry(errorNumber))
+			break;
+		if (m_impl->inTransaction)
+			break;
+		MLPL_ERR("Failed to execute: %s: (%u) %s.\n",
+		         prepStmt.sql.c_str(), errorNumber,
+		         errorMessage.c_str());
+		if (i == numRetry - 1)
+			break;
+
+		// The statement is prepared again on the new connection.
+		for (; i < numRetry; i++) {
+			if (throwExceptionIfDisposed())
+				break;
+			size_t sleepTimeSec = RETRY_INTERVAL[i];
+			MLPL_INFO("Try to connect after %zd sec. (%zd/%zd)\n",
+			          sleepTimeSec, i+1, numRetry);
+			sleepAndReconnect(sleepTimeSec);
+			if (m_impl->connected)
+				break;
+		}
+	}
+	if (errorNumber == CR_SERVER_GONE_ERROR || errorNumber == CR_SERVER_LOST ) {
+		THROW_HATOHOL_EXCEPTION_WITH_ERROR_CODE(
+		  HTERR_FAILED_CONNECT_MYSQL,
+		  "Failed to connect to MySQL: %s: (%u) %s\n",
+		  m_impl->dbName.c_str(), errorNumber, errorMessage.c_str());
+	} else {
+		THROW_HATOHOL_EXCEPTION("Failed to execute: %s: (%u) %s\n",
+		                        prepStmt.sql.c_str(), errorNumber,
+		                        errorMessage.c_str());
+	}
+}
+
+void DBAgentMySQL::insertWithPreparedStatement(const InsertArg &insertArg)
+{
+	const TableProfile &tableProfile = insertArg.tableProfile;
+	const size_t numColumns = tableProfile.numColumns;
+	HATOHOL_ASSERT(numColumns == insertArg.row->getNumberOfItems(),
+	               "numColumn: %zd != row: %zd",
+	               numColumns, insertArg.row->getNumberOfItems());
+
+	const char *operation =
+	  insertArg.upsertOnDuplicate ? "upsert" : "insert";
+	PreparedStatement &prepStmt = getPreparedStatement(
+	  StringUtils::sprintf("%s:%s", tableProfile.name, operation));
+	if (prepStmt.sql.empty()) {
+		SeparatorInjector commaInjector(",");
+		string sql = StringUtils::sprintf("INSERT INTO %s (",
+		                                  tableProfile.name);
+		string placeholders;
+		string updateClause;
+		for (size_t i = 0; i < numColumns; i++) {
+			const ColumnDef &columnDef = tableProfile.columnDefs[i];
+			commaInjector(sql);
+			sql += columnDef.columnName;
+			placeholders += (i == 0) ? "?" : ",?";
+			if (!insertArg.upsertOnDuplicate)
+				continue;
+#if MYSQL_VERSION_ID < 50112
+			if (columnDef.keyType == SQL_KEY_PRI) {
+				updateClause += StringUtils::sprintf(
+				  "%s%s=LAST_INSERT_ID(%s)",
+				  updateClause.empty() ? "" : ",",
+				  columnDef.columnName, columnDef.columnName);
+				continue;
+			}
+#else
+			if (columnDef.keyType == SQL_KEY_PRI)
+				continue;
+#endif
+			updateClause += StringUtils::sprintf(
+			  "%s%s=VALUES(%s)", updateClause.empty() ? "" : ",",
+			  columnDef.columnName, columnDef.columnName);
+		}
+		sql += ") VALUES (";
+		sql += placeholders;
+		sql += ")";
+		if (!updateClause.empty()) {
+			sql += " ON DUPLICATE KEY UPDATE ";
+			sql += updateClause;
+		}
+		prepStmt.sql = sql;
+	}
+
+	vector<MYSQL_BIND> params(numColumns);
+	vector<BindBuffer> buffers(numColumns);
+	for (size_t i = 0; i < numColumns; i++) {
+		bindParam(params[i], buffers[i], tableProfile.columnDefs[i],
+		          insertArg.row->getItemAt(i));
+	}
+	executeStatementWithRetry(prepStmt, params.data());
+}
+
+void DBAgentMySQL::selectWithPreparedStatement(const SelectArg &selectArg)
+{
+	const TableProfile &tableProfile = selectArg.tableProfile;
+	const size_t numColumns = selectArg.columnIndexes.size();
+	string key = StringUtils::sprintf("%s:select", tableProfile.name);
+	for (const auto &idx : selectArg.columnIndexes)
+		key += StringUtils::sprintf(":%zd", idx);
+	PreparedStatement &prepStmt = getPreparedStatement(key);
+	if (prepStmt.sql.empty())
+		prepStmt.sql = makeSelectStatement(selectArg);
+	executeStatementWithRetry(prepStmt, NULL);
+
+	MYSQL_STMT *stmt = prepStmt.stmt;
+	vector<MYSQL_BIND> binds(numColumns);
+	vector<BindBuffer> buffers(numColumns);
+	vector<SQLColumnType> types(numColumns);
+	for (size_t i = 0; i < numColumns; i++) {
+		const size_t idx = selectArg.columnIndexes[i];
+		types[i] = tableProfile.columnDefs[idx].type;
+		bindResult(binds[i], buffers[i], types[i]);
+	}
+
+	auto throwStmtError = [&] (const char *funcName) {
+		THROW_HATOHOL_EXCEPTION("Failed to call %s: %s\n",
+		                        funcName, mysql_stmt_error(stmt));
+	};
+	if (mysql_stmt_bind_result(stmt, binds.data()))
+		throwStmtError("mysql_stmt_bind_result");
+	if (mysql_stmt_store_result(stmt))
+		throwStmtError("mysql_stmt_store_result");
+
+	VariableItemTablePtr dataTable;
+	int ret;
+	while ((ret = mysql_stmt_fetch(stmt)) == 0 ||
+	       ret == MYSQL_DATA_TRUNCATED) {
+		bool rebind = false;
+		for (size_t i = 0; i < numColumns; i++) {
+			BindBuffer &buf = buffers[i];
+			if (!buf.error)
+				continue;
+			HATOHOL_ASSERT(binds[i].buffer_type == MYSQL_TYPE_STRING,
+			               "Unexpected truncation: column %zd", i);
+			// Only a string can be truncated. Fetch the rest with
+			// an enough buffer, which is also used for later rows.
+			buf.strBuf.resize(buf.length + 1);
+			binds[i].buffer = buf.strBuf.data();
+			binds[i].buffer_length = buf.strBuf.size();
+			if (mysql_stmt_fetch_column(stmt, &binds[i], i, 0))
+				throwStmtError("mysql_stmt_fetch_column");
+			rebind = true;
+		}
+		VariableItemGroupPtr itemGroup;
+		for (size_t i = 0; i < numColumns; i++)
+			itemGroup->add(createItemData(buffers[i], types[i]));
+		dataTable->add(itemGroup);
+		if (rebind && mysql_stmt_bind_result(stmt, binds.data()))
+			throwStmtError("mysql_stmt_bind_result");
+	}
+	mysql_stmt_free_result(stmt);
+	if (ret != MYSQL_NO_DATA)
+		throwStmtError("mysql_stmt_fetch");
+	selectArg.dataTable = dataTable;
+}
+
+bool DBAgentMySQL::canUseMultiRowInsert(const BulkInsertArg &bulkInsertArg)
+{
+	const int autoIncIdx =
+	  bulkInsertArg.tableProfile.autoIncrementColumnIndex;
+	if (autoIncIdx == IndexDef::END)
+		return true;
+
+	// Updated rows don't have a newly generated ID.
+	if (bulkInsertArg.upsertOnDuplicate)
+		return false;
+
+	for (const auto &row : bulkInsertArg.rows) {
+		const ItemData *item = row->getItemAt(autoIncIdx);
+		if (!item->isNull() && !isAutoIncrementValue(item))
+			return false;
+	}
+
+	// The MEMORY engine locks the whole table during an INSERT.
+	if (!Impl::engineStr.empty())
+		return true;
+
+	if (m_impl->autoIncLockMode < 0)
+		fetchAutoIncrementParams();
+	return m_impl->autoIncLockMode != AUTOINC_LOCK_MODE_INTERLEAVED;
+}
+
+void DBAgentMySQL::fetchAutoIncrementParams(void)
+{
+	execSql("SELECT @@innodb_autoinc_lock_mode,@@auto_increment_increment");
+	MYSQL_RES *result = mysql_store_result(&m_impl->mysql);
+	if (!result) {
+		THROW_HATOHOL_EXCEPTION(
+		  "Failed to call mysql_store_result: %s\n",
+		  mysql_error(&m_impl->mysql));
+	}
+	MYSQL_ROW row = mysql_fetch_row(result);
+	HATOHOL_ASSERT(row, "Failed to call mysql_fetch_row.");
+	// Assume the worst case if InnoDB isn't available.
+	m_impl->autoIncLockMode =
+	  row[0] ? atoi(row[0]) : AUTOINC_LOCK_MODE_INTERLEAVED;
+	m_impl->autoIncIncrement = row[1] ? atoi(row[1]) : 1;
+	mysql_free_result(result);
+}
+
 string DBAgentMySQL::getColumnValueString(const ColumnDef *columnDef,
 					  const ItemData *itemData)
 {
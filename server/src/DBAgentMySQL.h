@@ -56,9 +56,22 @@ public:
 	virtual void execSql(const std::string &sql) override;
 	virtual void createTable(const TableProfile &tableProfile); //override
 	virtual void insert(const InsertArg &insertArg) override;
+
+	/**
+	 * Insert rows with multi-row INSERT statements.
+	 *
+	 * IDs of an AUTO_INCREMENT column are calculated from the first
+	 * ID of each statement. So this falls back to the row-by-row
+	 * insert of the base class when the IDs can be non-consecutive:
+	 * upsertOnDuplicate is set, an explicit value is given to the
+	 * AUTO_INCREMENT column, or innodb_autoinc_lock_mode is 2.
+	 */
+	virtual void bulkInsert(const BulkInsertArg &bulkInsertArg) override;
 	virtual void update(const UpdateArg &updateArg) override;
 	virtual void select(const SelectArg &selectArg) override;
 	virtual void select(const SelectExArg &selectExArg) override;
+	virtual void selectEach(const SelectExArg &selectExArg,
+	                        const RowHandler &handler) override;
 	virtual void deleteRows(const DeleteArg &deleteArg) override;
 	virtual void addColumns(const AddColumnsArg &addColumnsArg);
 	virtual void changeColumnDef(const TableProfile &tableProfile,
@@ -83,12 +96,42 @@ public:
 	 */
 	void dispose(void);
 
+	/**
+	 * Enable or disable the prepared statement mode.
+	 *
+	 * In this mode, insert() and select(const SelectArg &) are executed
+	 * with prepared statements that are cached per table and operation
+	 * on this connection. Values are bound with the binary protocol
+	 * without escaping and results are fetched directly into ItemData.
+	 * update(), select(const SelectExArg &) and deleteRows() aren't
+	 * covered, because their conditions are SQL text with inline
+	 * values. A statement prepared for each condition would be used
+	 * only once, which costs an extra round trip and grows the cache
+	 * without bound.
+	 * The default is given by the environment variable
+	 * HATOHOL_MYSQL_PREPARED_STATEMENT=1 at init().
+	 *
+	 * @param enable true to enable the mode.
+	 */
+	void setPreparedStatementEnabled(const bool &enable);
+	bool isPreparedStatementEnabled(void) const;
+
 protected:
+	struct PreparedStatement;
+
 	static const char *getCStringOrNullIfEmpty(const std::string &str);
 	void connect(void);
 	void sleepAndReconnect(unsigned int sleepTimeSec);
 	bool throwExceptionIfDisposed(void) const;
 	void queryWithRetry(const std::string &statement);
+	bool canUseMultiRowInsert(const BulkInsertArg &bulkInsertArg);
+
+	PreparedStatement &getPreparedStatement(const std::string &key);
+	void executeStatementWithRetry(PreparedStatement &prepStmt,
+	                               MYSQL_BIND *params);
+	void insertWithPreparedStatement(const InsertArg &insertArg);
+	void selectWithPreparedStatement(const SelectArg &selectArg);
+	void fetchAutoIncrementParams(void);
 
 	// virtual methods
 	virtual std::string getColumnValueString(
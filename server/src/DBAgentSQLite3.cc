@@ -19,8 +19,13 @@
 
 #include <cstring>
 #include <cstdio>
+#include <cerrno>
+#include <cctype>
 #include <stdarg.h>
 #include <inttypes.h>
+#include <list>
+#include <vector>
+#include <unordered_map>
 #include <gio/gio.h>
 #include <Mutex.h>
 #include <Logger.h>
@@ -33,6 +38,11 @@ using namespace mlpl;
 #include "ConfigManager.h"
 
 const static int TRANSACTION_TIME_OUT_MSEC = 30 * 1000;
+const static size_t MAX_CACHED_STATEMENTS = 64;
+// Longer lists are kept inline, because each length makes another shape.
+const static size_t MAX_LIFTED_IN_LIST_ITEMS = 8;
+// SQLITE_MAX_VARIABLE_NUMBER of SQLite before 3.32.0
+const static size_t MAX_BOUND_PARAMETERS = 999;
 const char *DBAgentSQLite3::DEFAULT_DB_NAME = "DBAgentSQLite3-default";
 static __thread bool tls_lastUpsertDidUpdate = false;
 
@@ -54,11 +64,433 @@ string STR_NAME; \
 	va_end(ap); \
 } \
 
+// ---------------------------------------------------------------------------
+// StatementCache
+// ---------------------------------------------------------------------------
+/**
+ * An LRU cache of prepared statements that belong to one connection.
+ * The key is the shape of the statement, so that the statement can be
+ * reused with different bound values.
+ */
+struct DBAgentSQLite3::StatementCache {
+	// The front is the most recently used statement.
+	typedef list<pair<string, sqlite3_stmt *> > StatementList;
+	typedef unordered_map<string, StatementList::iterator> StatementMap;
+
+	StatementList lruList;
+	StatementMap  stmtMap;
+	// The last statement that isn't worth caching. It's finalized
+	// when the next one is prepared.
+	sqlite3_stmt *uncachedStmt;
+
+	StatementCache()
+	: uncachedStmt(NULL)
+	{
+	}
+
+	~StatementCache()
+	{
+		clear();
+	}
+
+	static sqlite3_stmt *prepareStatement(sqlite3 *db, const string &sql)
+	{
+		sqlite3_stmt *stmt = NULL;
+		int result = sqlite3_prepare_v2(db, sql.c_str(), sql.size(),
+		                                &stmt, NULL);
+		if (result != SQLITE_OK) {
+			sqlite3_finalize(stmt);
+			THROW_HATOHOL_EXCEPTION(
+			  "Failed to call sqlite3_prepare_v2(): %d, %s, %s",
+			  result, sqlite3_errmsg(db), sql.c_str());
+		}
+		return stmt;
+	}
+
+	sqlite3_stmt *find(const string &key)
+	{
+		StatementMap::iterator it = stmtMap.find(key);
+		if (it == stmtMap.end())
+			return NULL;
+		lruList.splice(lruList.begin(), lruList, it->second);
+		return it->second->second;
+	}
+
+	sqlite3_stmt *prepare(sqlite3 *db, const string &key, const string &sql)
+	{
+		sqlite3_stmt *stmt = prepareStatement(db, sql);
+		if (lruList.size() >= MAX_CACHED_STATEMENTS) {
+			sqlite3_finalize(lruList.back().second);
+			stmtMap.erase(lruList.back().first);
+			lruList.pop_back();
+		}
+		lruList.push_front(make_pair(key, stmt));
+		stmtMap[key] = lruList.begin();
+		return stmt;
+	}
+
+	sqlite3_stmt *get(sqlite3 *db, const string &key, const string &sql,
+	                  const bool &cacheable = true)
+	{
+		if (!cacheable) {
+			sqlite3_finalize(uncachedStmt);
+			uncachedStmt = NULL;
+			uncachedStmt = prepareStatement(db, sql);
+			return uncachedStmt;
+		}
+		sqlite3_stmt *stmt = find(key);
+		if (stmt)
+			return stmt;
+		return prepare(db, key, sql);
+	}
+
+	void clear(void)
+	{
+		StatementList::iterator it = lruList.begin();
+		for (; it != lruList.end(); ++it)
+			sqlite3_finalize(it->second);
+		lruList.clear();
+		stmtMap.clear();
+		sqlite3_finalize(uncachedStmt);
+		uncachedStmt = NULL;
+	}
+};
+
+/**
+ * Reset a cached statement and clear its bindings when the scope ends so
+ * that the statement doesn't keep a lock and can be reused.
+ */
+struct StatementResetter {
+	sqlite3_stmt *stmt;
+
+	StatementResetter(sqlite3_stmt *_stmt)
+	: stmt(_stmt)
+	{
+	}
+
+	~StatementResetter()
+	{
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// ParameterizedStatement
+// ---------------------------------------------------------------------------
+/**
+ * A statement whose literal values compared in the conditions (and
+ * assigned by SET) are replaced with '?'. Statements that differ only in
+ * those values get the same text, so they share one cached statement.
+ * Literals in the other places (e.g. 'ORDER BY 1' or 'LIMIT 10') are kept
+ * as they are, because they can change the meaning of the statement.
+ * The values of an 'IN (...)' list are lifted only when the list is short.
+ * A statement with a longer list isn't worth caching.
+ */
+struct ParameterizedStatement {
+	enum LiteralType {
+		LITERAL_INT,
+		LITERAL_DOUBLE,
+		LITERAL_TEXT,
+	};
+
+	struct Literal {
+		LiteralType type;
+		int64_t     intValue;
+		double      doubleValue;
+		string      text;
+	};
+
+	string          sql;
+	vector<Literal> literals;
+	bool            cacheable;
+
+	ParameterizedStatement(const string &source)
+	: cacheable(true),
+	  source(NULL),
+	  pos(0)
+	{
+		parse(source);
+	}
+
+	/**
+	 * Bind the lifted values to the statement. Text values are bound
+	 * without copying. So this object must live until the statement
+	 * is reset.
+	 */
+	void bind(sqlite3_stmt *stmt) const
+	{
+		for (size_t i = 0; i < literals.size(); i++) {
+			const Literal &literal = literals[i];
+			const int index = i + 1;
+			int result = SQLITE_OK;
+			switch (literal.type) {
+			case LITERAL_INT:
+				result = sqlite3_bind_int64(
+				  stmt, index, literal.intValue);
+				break;
+			case LITERAL_DOUBLE:
+				result = sqlite3_bind_double(
+				  stmt, index, literal.doubleValue);
+				break;
+			case LITERAL_TEXT:
+				result = sqlite3_bind_text(
+				  stmt, index, literal.text.c_str(),
+				  literal.text.size(), SQLITE_STATIC);
+				break;
+			}
+			if (result != SQLITE_OK) {
+				THROW_HATOHOL_EXCEPTION(
+				  "Failed to call sqlite3_bind_*(): %d, "
+				  "index: %d, %s",
+				  result, index, sql.c_str());
+			}
+		}
+	}
+
+private:
+	// An open parenthesis
+	struct Paren {
+		// Whether the values in it are lifted as a list of 'IN'.
+		bool   inList;
+		// The state just after the parenthesis to parse the list
+		// again without lifting.
+		size_t sourcePos;
+		size_t sqlSize;
+		size_t numLiterals;
+	};
+
+	// The state while parsing a source statement
+	const string *source;
+	size_t        pos;
+	string        lastToken;
+	vector<Paren> parenStack;
+
+	static bool isIdentifierChar(const char &c)
+	{
+		return isalnum((unsigned char)c) || c == '_' || c == '$';
+	}
+
+	static bool isDigit(const char &c)
+	{
+		return isdigit((unsigned char)c);
+	}
+
+	char charAt(const size_t &idx) const
+	{
+		return idx < source->size() ? (*source)[idx] : '\0';
+	}
+
+	size_t skipDigits(size_t idx) const
+	{
+		while (isDigit(charAt(idx)))
+			idx++;
+		return idx;
+	}
+
+	bool isLiftable(void) const
+	{
+		static const char *operators[] = {
+		  "=", "==", "<>", "!=", "<", ">", "<=", ">=", "like", "glob",
+		};
+		for (size_t i = 0; i < ARRAY_SIZE(operators); i++) {
+			if (lastToken == operators[i])
+				return true;
+		}
+		if (lastToken == "(" || lastToken == ",")
+			return !parenStack.empty() && parenStack.back().inList;
+		return false;
+	}
+
+	void inlineLongInList(void)
+	{
+		if (parenStack.empty())
+			return;
+		Paren &paren = parenStack.back();
+		if (!paren.inList ||
+		    literals.size() - paren.numLiterals <= MAX_LIFTED_IN_LIST_ITEMS)
+			return;
+		paren.inList = false;
+		sql.resize(paren.sqlSize);
+		literals.resize(paren.numLiterals);
+		pos = paren.sourcePos;
+		lastToken = "(";
+		cacheable = false;
+	}
+
+	void addLiteral(const LiteralType &type, const string &text)
+	{
+		Literal literal;
+		literal.type = type;
+		literal.intValue = 0;
+		literal.doubleValue = 0;
+		if (type == LITERAL_INT)
+			literal.intValue = strtoll(text.c_str(), NULL, 10);
+		else if (type == LITERAL_DOUBLE)
+			literal.doubleValue = strtod(text.c_str(), NULL);
+		else
+			literal.text = text;
+		literals.push_back(literal);
+		sql += "?";
+	}
+
+	void parse(const string &_source)
+	{
+		source = &_source;
+		pos = 0;
+		sql.reserve(source->size());
+		while (pos < source->size()) {
+			const char c = charAt(pos);
+			const bool liftable = isLiftable();
+			const bool isNegative =
+			  c == '-' && liftable && isDigit(charAt(pos + 1));
+			if (isspace((unsigned char)c)) {
+				sql += c;
+				pos++;
+			} else if (c == '\'') {
+				parseText(liftable);
+			} else if (c == '"' || c == '`' || c == '[') {
+				parseQuotedIdentifier();
+			} else if (isDigit(c) || isNegative) {
+				parseNumber(liftable);
+			} else if (isIdentifierChar(c)) {
+				parseWord();
+			} else {
+				parseOperator();
+			}
+			inlineLongInList();
+		}
+		if (literals.size() > MAX_BOUND_PARAMETERS) {
+			sql = *source;
+			literals.clear();
+			cacheable = false;
+		}
+	}
+
+	void parseText(const bool &liftable)
+	{
+		string value;
+		size_t end = pos + 1;
+		for (; end < source->size(); end++) {
+			if (charAt(end) != '\'')
+				value += charAt(end);
+			else if (charAt(end + 1) == '\'')
+				value += charAt(end++);
+			else
+				break;
+		}
+		if (end >= source->size()) {
+			// Not closed. SQLite will report the error.
+			sql.append(*source, pos, string::npos);
+			pos = source->size();
+			return;
+		}
+		end++;
+		if (liftable)
+			addLiteral(LITERAL_TEXT, value);
+		else
+			sql.append(*source, pos, end - pos);
+		lastToken = "'";
+		pos = end;
+	}
+
+	void parseQuotedIdentifier(void)
+	{
+		const char closer = (charAt(pos) == '[') ? ']' : charAt(pos);
+		size_t end = source->find(closer, pos + 1);
+		end = (end == string::npos) ? source->size() : end + 1;
+		sql.append(*source, pos, end - pos);
+		lastToken = "\"";
+		pos = end;
+	}
+
+	void parseNumber(bool liftable)
+	{
+		bool isReal = false;
+		size_t end = skipDigits(charAt(pos) == '-' ? pos + 1 : pos);
+		if (charAt(end) == '.') {
+			isReal = true;
+			end = skipDigits(end + 1);
+		}
+		if (charAt(end) == 'e' || charAt(end) == 'E') {
+			size_t expPos = end + 1;
+			if (charAt(expPos) == '+' || charAt(expPos) == '-')
+				expPos++;
+			if (isDigit(charAt(expPos))) {
+				isReal = true;
+				end = skipDigits(expPos);
+			}
+		}
+		lastToken = "0";
+		if (isIdentifierChar(charAt(end))) {
+			// Such as a hexadecimal number
+			while (isIdentifierChar(charAt(end)))
+				end++;
+			liftable = false;
+		}
+
+		const string number(*source, pos, end - pos);
+		pos = end;
+		if (!liftable) {
+			sql += number;
+			return;
+		}
+		if (isReal) {
+			addLiteral(LITERAL_DOUBLE, number);
+			return;
+		}
+		// A number out of the range of int64_t is a REAL in SQLite.
+		errno = 0;
+		strtoll(number.c_str(), NULL, 10);
+		if (errno == ERANGE)
+			sql += number;
+		else
+			addLiteral(LITERAL_INT, number);
+	}
+
+	void parseWord(void)
+	{
+		size_t end = pos;
+		while (isIdentifierChar(charAt(end)))
+			end++;
+		const string word(*source, pos, end - pos);
+		sql += word;
+		lastToken = StringUtils::toLower(word);
+		// A sub query in 'IN (...)' isn't a list of values.
+		if (lastToken == "select" && !parenStack.empty())
+			parenStack.back().inList = false;
+		pos = end;
+	}
+
+	void parseOperator(void)
+	{
+		size_t opLen = 1;
+		if (strchr("<>!=|", charAt(pos)) &&
+		    charAt(pos + 1) && strchr("<>=|", charAt(pos + 1)))
+			opLen = 2;
+		const string op(*source, pos, opLen);
+		sql += op;
+		pos += opLen;
+		if (op == "(") {
+			Paren paren;
+			paren.inList = (lastToken == "in");
+			paren.sourcePos = pos;
+			paren.sqlSize = sql.size();
+			paren.numLiterals = literals.size();
+			parenStack.push_back(paren);
+		} else if (op == ")" && !parenStack.empty()) {
+			parenStack.pop_back();
+		}
+		lastToken = op;
+	}
+};
+
 struct DBAgentSQLite3::Impl {
 	static DBTermCodecSQLite3 dbTermCodec;
 
-	string        dbPath;
-	sqlite3      *db;
+	string         dbPath;
+	sqlite3       *db;
+	StatementCache stmtCache;
 
 	// methods
 	Impl(void)
@@ -68,6 +500,8 @@ struct DBAgentSQLite3::Impl {
 
 	~Impl(void)
 	{
+		// All statements have to be finalized before closing the DB.
+		stmtCache.clear();
 		if (!db)
 			return;
 		int result = sqlite3_close(db);
@@ -121,12 +555,12 @@ void DBAgentSQLite3::getIndexes(vector<IndexStruct> &indexStructVect,
 
 	sqlite3_stmt *stmt;
 	int result;
-	result = sqlite3_prepare(m_impl->db, query.c_str(), query.size(),
-	                         &stmt, NULL);
+	result = sqlite3_prepare_v2(m_impl->db, query.c_str(), query.size(),
+	                            &stmt, NULL);
 	if (result != SQLITE_OK) {
 		sqlite3_finalize(stmt);
 		THROW_HATOHOL_EXCEPTION(
-		  "Failed to call sqlite3_prepare(): %d: %s",
+		  "Failed to call sqlite3_prepare_v2(): %d: %s",
 		  result, query.c_str());
 	}
 	sqlite3_reset(stmt);
@@ -154,25 +588,17 @@ bool DBAgentSQLite3::isRecordExisting(const string &tableName,
                                       const string &condition)
 {
 	int result;
-	sqlite3_stmt *stmt;
-	string query = StringUtils::sprintf(
-	                 "SELECT * FROM %s WHERE %s",
-	                 tableName.c_str(), condition.c_str());
-	result = sqlite3_prepare(m_impl->db, query.c_str(), query.size(),
-	                         &stmt, NULL);
-	if (result != SQLITE_OK) {
-		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION(
-		  "Failed to call sqlite3_prepare(): %d: %s",
-		  result, query.c_str());
-	}
-	sqlite3_reset(stmt);
+	const ParameterizedStatement statement(StringUtils::sprintf(
+	  "SELECT * FROM %s WHERE %s", tableName.c_str(), condition.c_str()));
+	sqlite3_stmt *stmt = m_impl->stmtCache.get(
+	  m_impl->db, statement.sql, statement.sql, statement.cacheable);
+	StatementResetter resetter(stmt);
+	statement.bind(stmt);
 	bool found = false;
 	while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
 		found = true;
 		break;
 	}
-	sqlite3_finalize(stmt);
 	if (result != SQLITE_ROW && result != SQLITE_DONE) {
 		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_step(): %d",
 		                      result);
@@ -213,31 +639,38 @@ void DBAgentSQLite3::createTable(const TableProfile &tableProfile)
 void DBAgentSQLite3::insert(const DBAgent::InsertArg &insertArg)
 {
 	HATOHOL_ASSERT(m_impl->db, "m_impl->db is NULL");
-	insert(m_impl->db, insertArg);
+	insert(m_impl->db, m_impl->stmtCache, insertArg);
 }
 
 void DBAgentSQLite3::update(const UpdateArg &updateArg)
 {
 	HATOHOL_ASSERT(m_impl->db, "m_impl->db is NULL");
-	update(m_impl->db, updateArg);
+	update(m_impl->db, m_impl->stmtCache, updateArg);
 }
 
 void DBAgentSQLite3::select(const SelectArg &selectArg)
 {
 	HATOHOL_ASSERT(m_impl->db, "m_impl->db is NULL");
-	select(m_impl->db, selectArg);
+	select(m_impl->db, m_impl->stmtCache, selectArg);
 }
 
 void DBAgentSQLite3::select(const SelectExArg &selectExArg)
 {
 	HATOHOL_ASSERT(m_impl->db, "m_impl->db is NULL");
-	select(m_impl->db, selectExArg);
+	select(m_impl->db, m_impl->stmtCache, selectExArg);
+}
+
+void DBAgentSQLite3::selectEach(const SelectExArg &selectExArg,
+                                const RowHandler &handler)
+{
+	HATOHOL_ASSERT(m_impl->db, "m_impl->db is NULL");
+	selectEach(m_impl->db, selectExArg, handler);
 }
 
 void DBAgentSQLite3::deleteRows(const DeleteArg &deleteArg)
 {
 	HATOHOL_ASSERT(m_impl->db, "m_impl->db is NULL");
-	deleteRows(m_impl->db, deleteArg);
+	deleteRows(m_impl->db, m_impl->stmtCache, deleteArg);
 }
 
 uint64_t DBAgentSQLite3::getLastInsertId(void)
@@ -339,6 +772,22 @@ void DBAgentSQLite3::execSql(sqlite3 *db, const char *fmt, ...)
 	_execSql(db, sql);
 }
 
+void DBAgentSQLite3::execParameterizedSql(sqlite3 *db,
+                                          StatementCache &stmtCache,
+                                          const string &sql)
+{
+	const ParameterizedStatement statement(sql);
+	sqlite3_stmt *stmt = stmtCache.get(db, statement.sql, statement.sql,
+	                                   statement.cacheable);
+	StatementResetter resetter(stmt);
+	statement.bind(stmt);
+	int result = sqlite3_step(stmt);
+	if (result != SQLITE_DONE) {
+		THROW_HATOHOL_EXCEPTION("Failed to exec: %d, %s, %s",
+		                      result, sqlite3_errmsg(db), sql.c_str());
+	}
+}
+
 bool DBAgentSQLite3::isTableExisting(sqlite3 *db,
                                      const string &tableName)
 {
@@ -346,10 +795,10 @@ bool DBAgentSQLite3::isTableExisting(sqlite3 *db,
 	sqlite3_stmt *stmt;
 	const char *query = "SELECT COUNT(*) FROM sqlite_master "
 	                    "WHERE type='table' AND name=?";
-	result = sqlite3_prepare(db, query, strlen(query), &stmt, NULL);
+	result = sqlite3_prepare_v2(db, query, strlen(query), &stmt, NULL);
 	if (result != SQLITE_OK) {
 		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_prepare(): %d",
+		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_prepare_v2(): %d",
 		                      result);
 	}
 
@@ -530,43 +979,106 @@ string DBAgentSQLite3::getColumnValueStringStatic(const ColumnDef *columnDef,
 	return valueStr;
 }
 
-void DBAgentSQLite3::insert(sqlite3 *db, const DBAgent::InsertArg &insertArg)
+string DBAgentSQLite3::makeInsertStatementStatic(const InsertArg &insertArg)
 {
-	size_t numColumns = insertArg.row->getNumberOfItems();
-	HATOHOL_ASSERT(numColumns == insertArg.tableProfile.numColumns,
-	               "Invalid number of columns: %zd, %zd",
-	               numColumns, insertArg.tableProfile.numColumns);
-
-	// make a SQL statement
 	string sql = "INSERT ";
 	sql += "INTO ";
 	sql += insertArg.tableProfile.name;
 	sql += " VALUES (";
-	for (size_t i = 0; i < numColumns; i++) {
+	for (size_t i = 0; i < insertArg.tableProfile.numColumns; i++) {
 		if (i > 0)
 			sql += ",";
-		const ColumnDef &columnDef =
-		  insertArg.tableProfile.columnDefs[i];
-		const ItemData *itemData = insertArg.row->getItemAt(i);
-		string valueStr;
-		if (itemData->isNull()) {
-			valueStr = "NULL";
-		} else {
-			valueStr = getColumnValueStringStatic(&columnDef, itemData);
-			if (columnDef.flags & SQL_COLUMN_FLAG_AUTO_INC) {
-				// Converting 0 to NULL makes the behavior
-				// compatible with DBAgentMySQL.
-				if (valueStr == "0")
-					valueStr = "NULL";
-			}
-		}
-		sql += valueStr;
+		sql += "?";
 	}
 	sql += ")";
+	return sql;
+}
+
+void DBAgentSQLite3::bindValue(sqlite3_stmt *stmt, const int &index,
+                               const ColumnDef &columnDef,
+                               const ItemData *itemData)
+{
+	int result = SQLITE_OK;
+	// Converting an auto increment value to NULL makes the behavior
+	// compatible with DBAgentMySQL.
+	if (itemData->isNull() ||
+	    ((columnDef.flags & SQL_COLUMN_FLAG_AUTO_INC) &&
+	     isAutoIncrementValue(itemData))) {
+		result = sqlite3_bind_null(stmt, index);
+	} else {
+		switch (columnDef.type) {
+		case SQL_COLUMN_TYPE_INT:
+			result = sqlite3_bind_int(stmt, index, (int)*itemData);
+			break;
+		case SQL_COLUMN_TYPE_BIGUINT:
+			result = sqlite3_bind_int64(
+			  stmt, index, (sqlite3_int64)(uint64_t)*itemData);
+			break;
+		case SQL_COLUMN_TYPE_VARCHAR:
+		case SQL_COLUMN_TYPE_CHAR:
+		case SQL_COLUMN_TYPE_TEXT:
+		{
+			// The string is owned by itemData that lives until
+			// the statement is reset.
+			const string &str = *itemData;
+			result = sqlite3_bind_text(stmt, index, str.c_str(),
+			                           str.size(), SQLITE_STATIC);
+			break;
+		}
+		case SQL_COLUMN_TYPE_DOUBLE:
+		{
+			// Round the value in the same way as the text protocol.
+			const string valueStr =
+			  getColumnValueStringStatic(&columnDef, itemData);
+			result = sqlite3_bind_double(
+			  stmt, index, strtod(valueStr.c_str(), NULL));
+			break;
+		}
+		case SQL_COLUMN_TYPE_DATETIME:
+		{
+			// Remove the quotation marks around the string.
+			const string quoted = makeDatetimeString(*itemData);
+			const string str = quoted.substr(1, quoted.size() - 2);
+			result = sqlite3_bind_text(stmt, index, str.c_str(),
+			                           str.size(), SQLITE_TRANSIENT);
+			break;
+		}
+		default:
+			HATOHOL_ASSERT(false, "Unknown column type: %d (%s)",
+			               columnDef.type, columnDef.columnName);
+		}
+	}
+	if (result != SQLITE_OK) {
+		THROW_HATOHOL_EXCEPTION(
+		  "Failed to call sqlite3_bind_*(): %d, index: %d (%s)",
+		  result, index, columnDef.columnName);
+	}
+}
+
+void DBAgentSQLite3::insert(sqlite3 *db, StatementCache &stmtCache,
+                            const DBAgent::InsertArg &insertArg)
+{
+	size_t numColumns = insertArg.row->getNumberOfItems();
+	HATOHOL_ASSERT(numColumns == insertArg.tableProfile.numColumns,
+	               "Invalid number of columns: %zd, %zd",
+	               numColumns, insertArg.tableProfile.numColumns);
+
+	// get a prepared statement
+	const string key = StringUtils::sprintf(
+	  "%s:insert:%zd", insertArg.tableProfile.name, numColumns);
+	sqlite3_stmt *stmt = stmtCache.find(key);
+	if (!stmt) {
+		stmt = stmtCache.prepare(db, key,
+		                         makeInsertStatementStatic(insertArg));
+	}
+	StatementResetter resetter(stmt);
+	for (size_t i = 0; i < numColumns; i++) {
+		bindValue(stmt, i + 1, insertArg.tableProfile.columnDefs[i],
+		          insertArg.row->getItemAt(i));
+	}
 
 	// exectute the SQL statement
-	char *errmsg;
-	int result = sqlite3_exec(db, sql.c_str(), NULL, NULL, &errmsg);
+	int result = sqlite3_step(stmt);
 	if (insertArg.upsertOnDuplicate && result == SQLITE_CONSTRAINT) {
 		// Using 'OR REPLACE', we cannot keep the value in
 		// an auto-incremented column since SQLite3 once deletes
@@ -574,16 +1086,15 @@ void DBAgentSQLite3::insert(sqlite3 *db, const DBAgent::InsertArg &insertArg)
 		// So we try to update here if 'insert' fails due to
 		// primary or unique key constraint.
 		if (isPrimaryOrUniqueKeyDuplicated(db)) {
-			update(db, insertArg);
+			update(db, stmtCache, insertArg);
 			tls_lastUpsertDidUpdate = true;
 			return;
 		}
 	}
-	if (result != SQLITE_OK) {
-		string err = errmsg;
-		sqlite3_free(errmsg);
+	if (result != SQLITE_DONE) {
 		THROW_HATOHOL_EXCEPTION("Failed to exec: %d, %s, %s",
-		                      result, err.c_str(), sql.c_str());
+		                      result, sqlite3_errmsg(db),
+		                      sqlite3_sql(stmt));
 	}
 	tls_lastUpsertDidUpdate = false;
 }
@@ -617,22 +1128,15 @@ string DBAgentSQLite3::makeUpdateStatementStatic(const UpdateArg &updateArg)
 	return statement;
 }
 
-void DBAgentSQLite3::update(sqlite3 *db, const UpdateArg &updateArg)
+void DBAgentSQLite3::update(sqlite3 *db, StatementCache &stmtCache,
+                            const UpdateArg &updateArg)
 {
-	string sql = makeUpdateStatementStatic(updateArg);
-
-	// exectute the SQL statement
-	char *errmsg;
-	int result = sqlite3_exec(db, sql.c_str(), NULL, NULL, &errmsg);
-	if (result != SQLITE_OK) {
-		string err = errmsg;
-		sqlite3_free(errmsg);
-		THROW_HATOHOL_EXCEPTION("Failed to exec: %d, %s, %s",
-		                      result, err.c_str(), sql.c_str());
-	}
+	execParameterizedSql(db, stmtCache,
+	                     makeUpdateStatementStatic(updateArg));
 }
 
-void DBAgentSQLite3::update(sqlite3 *db, const DBAgent::InsertArg &insertArg)
+void DBAgentSQLite3::update(sqlite3 *db, StatementCache &stmtCache,
+                            const DBAgent::InsertArg &insertArg)
 {
 	struct {
 		string operator()(
@@ -683,65 +1187,63 @@ void DBAgentSQLite3::update(sqlite3 *db, const DBAgent::InsertArg &insertArg)
 	}
 	arg.condition = cond;
 
-	update(db, arg);
+	update(db, stmtCache, arg);
 }
 
-void DBAgentSQLite3::select(sqlite3 *db, const SelectArg &selectArg)
+void DBAgentSQLite3::select(sqlite3 *db, StatementCache &stmtCache,
+                            const SelectArg &selectArg)
 {
-	string sql = makeSelectStatement(selectArg);
+	const ParameterizedStatement statement(makeSelectStatement(selectArg));
 
 	// exectute
 	int result;
-	sqlite3_stmt *stmt;
-	result = sqlite3_prepare(db, sql.c_str(), sql.size(), &stmt, NULL);
-	if (result != SQLITE_OK) {
-		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION(
-		  "Failed to call sqlite3_prepare(): %d, %s",
-		  result, sql.c_str());
-	}
-
-	sqlite3_reset(stmt);
-	if (result != SQLITE_OK) {
-		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_bind(): %d",
-		                      result);
-	}
+	sqlite3_stmt *stmt = stmtCache.get(db, statement.sql, statement.sql,
+	                                   statement.cacheable);
+	StatementResetter resetter(stmt);
+	statement.bind(stmt);
 	
 	VariableItemTablePtr dataTable;
 	while ((result = sqlite3_step(stmt)) == SQLITE_ROW)
 		selectGetValuesIteration(selectArg, stmt, dataTable);
 	selectArg.dataTable = dataTable;
 	if (result != SQLITE_DONE) {
-		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_step(): %d",
-		                      result);
+		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_step(): %d, %s",
+		                      result, sqlite3_errmsg(db));
 	}
-	sqlite3_finalize(stmt);
 }
 
-void DBAgentSQLite3::select(sqlite3 *db, const SelectExArg &selectExArg)
+void DBAgentSQLite3::select(sqlite3 *db, StatementCache &stmtCache,
+                            const SelectExArg &selectExArg)
 {
-	string sql = makeSelectStatement(selectExArg);
+	const ParameterizedStatement statement(
+	  makeSelectStatement(selectExArg));
 
 	// exectute
 	int result;
-	sqlite3_stmt *stmt;
-	result = sqlite3_prepare(db, sql.c_str(), sql.size(), &stmt, NULL);
-	if (result != SQLITE_OK) {
-		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION(
-		  "Failed to call sqlite3_prepare(): %d, %s",
-		  result, sql.c_str());
+	sqlite3_stmt *stmt = stmtCache.get(db, statement.sql, statement.sql,
+	                                   statement.cacheable);
+	StatementResetter resetter(stmt);
+	statement.bind(stmt);
+	size_t numColumns = selectExArg.statements.size();
+	if (selectExArg.useColumnarTable) {
+		ColumnarTablePtr table = make_shared<ColumnarTable>();
+		table->setColumnTypes(selectExArg.columnTypes);
+		while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+			for (size_t index = 0; index < numColumns; index++) {
+				addValueToColumnarTable(
+				  *table, stmt, index,
+				  selectExArg.columnTypes[index]);
+			}
+		}
+		if (result != SQLITE_DONE) {
+			THROW_HATOHOL_EXCEPTION(
+			  "Failed to call sqlite3_step(): %d, %s",
+			  result, sqlite3_errmsg(db));
+		}
+		selectExArg.columnarTable = table;
+		return;
 	}
 
-	sqlite3_reset(stmt);
-	if (result != SQLITE_OK) {
-		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_bind(): %d",
-		                      result);
-	}
-	size_t numColumns = selectExArg.statements.size();
 	VariableItemTablePtr dataTable;
 	while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
 		VariableItemGroupPtr itemGroup;
@@ -754,11 +1256,9 @@ void DBAgentSQLite3::select(sqlite3 *db, const SelectExArg &selectExArg)
 	}
 	selectExArg.dataTable = dataTable;
 	if (result != SQLITE_DONE) {
-		sqlite3_finalize(stmt);
-		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_step(): %d",
-		                      result);
+		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_step(): %d, %s",
+		                      result, sqlite3_errmsg(db));
 	}
-	sqlite3_finalize(stmt);
 
 	// check the result
 	size_t numTableRows = selectExArg.dataTable->getNumberOfRows();
@@ -770,10 +1270,49 @@ void DBAgentSQLite3::select(sqlite3 *db, const SelectExArg &selectExArg)
 	             numTableRows, numTableColumns, numColumns);
 }
 
-void DBAgentSQLite3::deleteRows(sqlite3 *db, const DeleteArg &deleteArg)
+void DBAgentSQLite3::selectEach(sqlite3 *db, const SelectExArg &selectExArg,
+                                const RowHandler &handler)
+{
+	string sql = makeSelectStatement(selectExArg);
+
+	// A statement only for this call is used instead of the cached ones,
+	// because it is kept while the handler runs.
+	sqlite3_stmt *_stmt = NULL;
+	int result = sqlite3_prepare_v2(db, sql.c_str(), sql.size(),
+	                                &_stmt, NULL);
+	unique_ptr<sqlite3_stmt, int (*)(sqlite3_stmt *)>
+	  stmt(_stmt, sqlite3_finalize);
+	if (result != SQLITE_OK) {
+		THROW_HATOHOL_EXCEPTION(
+		  "Failed to call sqlite3_prepare_v2(): %d, %s, %s",
+		  result, sqlite3_errmsg(db), sql.c_str());
+	}
+
+	// The same table is reused for every row to avoid reallocation.
+	ColumnarTable table;
+	table.setColumnTypes(selectExArg.columnTypes);
+	const size_t numColumns = selectExArg.statements.size();
+	while ((result = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+		table.clearRows();
+		for (size_t index = 0; index < numColumns; index++) {
+			addValueToColumnarTable(table, stmt.get(), index,
+			                        selectExArg.columnTypes[index]);
+		}
+		ColumnarTableStream stream(table);
+		stream.next();
+		if (!handler(stream))
+			return;
+	}
+	if (result != SQLITE_DONE) {
+		THROW_HATOHOL_EXCEPTION("Failed to call sqlite3_step(): %d, %s",
+		                      result, sqlite3_errmsg(db));
+	}
+}
+
+void DBAgentSQLite3::deleteRows(sqlite3 *db, StatementCache &stmtCache,
+                                const DeleteArg &deleteArg)
 {
-	string sql = makeDeleteStatement(deleteArg);
-	_execSql(db, sql.c_str());
+	execParameterizedSql(db, stmtCache, makeDeleteStatement(deleteArg));
 }
 
 void DBAgentSQLite3::addColumns(const AddColumnsArg &addColumnsArg)
@@ -883,6 +1422,47 @@ ItemDataPtr DBAgentSQLite3::getValue(sqlite3_stmt *stmt,
 	return ItemDataPtr(itemData, false);
 }
 
+void DBAgentSQLite3::addValueToColumnarTable(
+  ColumnarTable &table, sqlite3_stmt *stmt, const size_t &index,
+  const SQLColumnType &columnType)
+{
+	if (sqlite3_column_type(stmt, index) == SQLITE_NULL) {
+		table.addNull();
+		return;
+	}
+
+	switch (columnType) {
+	case SQL_COLUMN_TYPE_INT:
+	case SQL_COLUMN_TYPE_DATETIME:
+		table.addInt(sqlite3_column_int(stmt, index));
+		break;
+
+	case SQL_COLUMN_TYPE_BIGUINT:
+		table.addUint64(sqlite3_column_int64(stmt, index));
+		break;
+
+	case SQL_COLUMN_TYPE_VARCHAR:
+	case SQL_COLUMN_TYPE_CHAR:
+	case SQL_COLUMN_TYPE_TEXT:
+	{
+		const char *str =
+		  (const char *)sqlite3_column_text(stmt, index);
+		// sqlite3_column_bytes() has to be called after
+		// sqlite3_column_text() to get the length of the UTF-8 string.
+		const size_t length = sqlite3_column_bytes(stmt, index);
+		table.addString(str ? str : "", str ? length : 0);
+		break;
+	}
+
+	case SQL_COLUMN_TYPE_DOUBLE:
+		table.addDouble(sqlite3_column_double(stmt, index));
+		break;
+
+	default:
+		HATOHOL_ASSERT(false, "Unknown column type: %d", columnType);
+	}
+}
+
 void DBAgentSQLite3::createIndexIfNotExistsEach(
   sqlite3 *db, const TableProfile &tableProfile, const string &indexName,
   const vector<size_t> &targetIndexes, const bool &isUniqueKey)
@@ -985,6 +1565,11 @@ string DBAgentSQLite3::getDBPath(void) const
 	return m_impl->dbPath;
 }
 
+size_t DBAgentSQLite3::getNumberOfCachedStatements(void) const
+{
+	return m_impl->stmtCache.lruList.size();
+}
+
 //
 // Non static methods
 //
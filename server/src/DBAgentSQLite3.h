@@ -58,6 +58,8 @@ public:
 	virtual void update(const UpdateArg &updateArg) override;
 	virtual void select(const SelectArg &selectArg) override;
 	virtual void select(const SelectExArg &selectExArg) override;
+	virtual void selectEach(const SelectExArg &selectExArg,
+	                        const RowHandler &handler) override;
 	virtual void deleteRows(const DeleteArg &deleteArg) override;
 	virtual void addColumns(const AddColumnsArg &addColumnsArg) override;
 	virtual void changeColumnDef(const TableProfile &tableProfile,
@@ -76,7 +78,17 @@ public:
 
 	std::string getDBPath(void) const;
 
+	/**
+	 * Get the number of the prepared statements kept in the per-connection
+	 * cache.
+	 *
+	 * @return The number of the cached statements.
+	 */
+	size_t getNumberOfCachedStatements(void) const;
+
 protected:
+	struct StatementCache;
+
 	static std::string makeDBPathFromName(
 	  const std::string &name = DEFAULT_DB_NAME,
 	  const std::string &dbDir = "");
@@ -84,18 +96,34 @@ protected:
 	static sqlite3 *openDatabase(const std::string &dbPath);
 	static void execSql(sqlite3 *db, const char *fmt, ...);
 	static void _execSql(sqlite3 *db, const std::string &sql);
+	static void execParameterizedSql(sqlite3 *db,
+	                                 StatementCache &stmtCache,
+	                                 const std::string &sql);
 	static bool isTableExisting(sqlite3 *db,
 	                            const std::string &tableName);
 	static void createTable(sqlite3 *db, const TableProfile &tableProfile);
 	static std::string getColumnValueStringStatic(const ColumnDef *columnDef,
 						      const ItemData *itemData);
 	static std::string makeUpdateStatementStatic(const UpdateArg &updateArg);
-	static void insert(sqlite3 *db, const InsertArg &insertArg);
-	static void update(sqlite3 *db, const UpdateArg &updateArg);
-	static void update(sqlite3 *db, const InsertArg &updateArg);
-	static void select(sqlite3 *db, const SelectArg &selectArg);
-	static void select(sqlite3 *db, const SelectExArg &selectExArg);
-	static void deleteRows(sqlite3 *db, const DeleteArg &deleteArg);
+	static std::string makeInsertStatementStatic(
+	  const InsertArg &insertArg);
+	static void bindValue(sqlite3_stmt *stmt, const int &index,
+	                      const ColumnDef &columnDef,
+	                      const ItemData *itemData);
+	static void insert(sqlite3 *db, StatementCache &stmtCache,
+	                   const InsertArg &insertArg);
+	static void update(sqlite3 *db, StatementCache &stmtCache,
+	                   const UpdateArg &updateArg);
+	static void update(sqlite3 *db, StatementCache &stmtCache,
+	                   const InsertArg &updateArg);
+	static void select(sqlite3 *db, StatementCache &stmtCache,
+	                   const SelectArg &selectArg);
+	static void select(sqlite3 *db, StatementCache &stmtCache,
+	                   const SelectExArg &selectExArg);
+	static void selectEach(sqlite3 *db, const SelectExArg &selectExArg,
+	                       const RowHandler &handler);
+	static void deleteRows(sqlite3 *db, StatementCache &stmtCache,
+	                       const DeleteArg &deleteArg);
 	static void selectGetValuesIteration(const SelectArg &selectArg,
 	                                     sqlite3_stmt *stmt,
 	                                     VariableItemTablePtr &dataTable);
@@ -103,6 +131,10 @@ protected:
 	static uint64_t getNumberOfAffectedRows(sqlite3 *db);
 	static ItemDataPtr getValue(sqlite3_stmt *stmt, size_t index,
 	                            SQLColumnType columnType);
+	static void addValueToColumnarTable(ColumnarTable &table,
+	                                    sqlite3_stmt *stmt,
+	                                    const size_t &index,
+	                                    const SQLColumnType &columnType);
 	static void createIndexIfNotExistsEach(
 	  sqlite3 *db, const TableProfile &tableProfile,
 	  const std::string &indexName,
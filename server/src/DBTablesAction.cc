@@ -18,12 +18,16 @@
  */
 
 #include <exception>
+#include <mutex>
+#include <deque>
 #include <SeparatorInjector.h>
 #include "Utils.h"
 #include "ConfigManager.h"
 #include "ThreadLocalDBCache.h"
 #include "DBAgentFactory.h"
 #include "DBTablesAction.h"
+#include "ActionRuleIndex.h"
+#include "DataGeneration.h"
 #include "DBTablesMonitoring.h"
 #include "Mutex.h"
 #include "ItemGroupStream.h"
@@ -350,6 +354,16 @@ static bool updateDB(
 
 struct DBTablesAction::Impl
 {
+	// Events whose action log has been created or found recently.
+	// They are kept in the order of the registration and the oldest
+	// one is removed when the number exceeds MAX_RECENT_LOGGED_EVENTS.
+	// Note that a probabilistic set like a bloom filter can't be used,
+	// because a false positive causes a lost action.
+	static const size_t MAX_RECENT_LOGGED_EVENTS;
+	static mutex recentLoggedEventsLock;
+	static ServerEventIdPairSet recentLoggedEventSet;
+	static deque<ServerEventIdPair> recentLoggedEventQueue;
+
 	Impl(void)
 	{
 	}
@@ -357,8 +371,37 @@ struct DBTablesAction::Impl
 	virtual ~Impl()
 	{
 	}
+
+	static void addRecentLoggedEvent(const ServerEventIdPair &serverEventId)
+	{
+		lock_guard<mutex> lock(recentLoggedEventsLock);
+		if (!recentLoggedEventSet.insert(serverEventId).second)
+			return;
+		recentLoggedEventQueue.push_back(serverEventId);
+		if (recentLoggedEventQueue.size() > MAX_RECENT_LOGGED_EVENTS) {
+			recentLoggedEventSet.erase(
+			  recentLoggedEventQueue.front());
+			recentLoggedEventQueue.pop_front();
+		}
+	}
+
+	static void clearRecentLoggedEvents(void)
+	{
+		lock_guard<mutex> lock(recentLoggedEventsLock);
+		recentLoggedEventSet.clear();
+		recentLoggedEventQueue.clear();
+	}
 };
 
+const size_t DBTablesAction::Impl::MAX_RECENT_LOGGED_EVENTS = 100000;
+mutex DBTablesAction::Impl::recentLoggedEventsLock;
+ServerEventIdPairSet DBTablesAction::Impl::recentLoggedEventSet;
+deque<ServerEventIdPair> DBTablesAction::Impl::recentLoggedEventQueue;
+
+// The maximum number of event IDs in an IN clause of a query.
+// It's kept below the 999 variables of SQLite before 3.32.
+static const size_t MAX_EVENT_IDS_IN_QUERY = 500;
+
 struct deleteInvalidActionsContext {
 	guint timerId;
 	guint idleEventId;
@@ -392,6 +435,8 @@ void DBTablesAction::init(void)
 void DBTablesAction::reset(void)
 {
 	getSetupInfo().initialized = false;
+	Impl::clearRecentLoggedEvents();
+	DataGeneration::bump(DATA_GENERATION_ACTION);
 }
 
 const DBTables::SetupInfo &DBTablesAction::getConstSetupInfo(void)
@@ -427,6 +472,8 @@ DBTablesAction::~DBTablesAction()
 HatoholError DBTablesAction::addAction(ActionDef &actionDef,
                                        const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ACTION);
+
 	HatoholError err = checkPrivilegeForAdd(privilege, actionDef);
 	if (err != HTERR_OK)
 		return err;
@@ -465,12 +512,15 @@ HatoholError DBTablesAction::addAction(ActionDef &actionDef,
 	arg.add(ownerUserId);
 
 	getDBAgent().runTransaction(arg, &actionDef.id);
+	ActionRuleIndex::invalidate();
 	return HTERR_OK;
 }
 
 HatoholError DBTablesAction::updateAction(ActionDef &actionDef,
                                           const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ACTION);
+
 	HatoholError err = checkPrivilegeForUpdate(privilege, actionDef);
 	if (err != HTERR_OK)
 		return err;
@@ -514,6 +564,7 @@ HatoholError DBTablesAction::updateAction(ActionDef &actionDef,
 	arg.add(IDX_ACTIONS_OWNER_USER_ID, ownerUserId);
 
 	getDBAgent().runTransaction(arg);
+	ActionRuleIndex::invalidate();
 	return HTERR_OK;
 }
 
@@ -664,6 +715,8 @@ static string makeConditionForDelete(const ActionIdList &idList,
 HatoholError DBTablesAction::deleteActions(const ActionIdList &idList,
                                            const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ACTION);
+
 	HatoholError err = checkPrivilegeForDelete(privilege, idList);
 	if (err != HTERR_OK)
 		return err;
@@ -691,6 +744,7 @@ HatoholError DBTablesAction::deleteActions(const ActionIdList &idList,
 	} trx;
 	trx.arg.condition = makeConditionForDelete(idList, privilege);
 	getDBAgent().runTransaction(trx);
+	ActionRuleIndex::invalidate();
 
 	// Check the result
 	if (trx.numAffectedRows != idList.size()) {
@@ -782,6 +836,8 @@ uint64_t DBTablesAction::createActionLog(
 
 	ActionLogIdType logId;
 	getDBAgent().runTransaction(arg, &logId);
+	Impl::addRecentLoggedEvent(
+	  ServerEventIdPair(eventInfo.serverId, eventInfo.id));
 	return logId;
 }
 
@@ -846,6 +902,61 @@ bool DBTablesAction::getLog(
 	return getLog(actionLog, condition);
 }
 
+void DBTablesAction::getLoggedEvents(ServerEventIdPairSet &loggedEventSet,
+                                     const EventInfoList &eventInfoList)
+{
+	map<ServerIdType, set<EventIdType> > unknownEventIdsMap;
+	{
+		lock_guard<mutex> lock(Impl::recentLoggedEventsLock);
+		for (auto &eventInfo : eventInfoList) {
+			ServerEventIdPair serverEventId(eventInfo.serverId,
+			                                eventInfo.id);
+			if (Impl::recentLoggedEventSet.count(serverEventId))
+				loggedEventSet.insert(serverEventId);
+			else
+				unknownEventIdsMap[eventInfo.serverId].insert(
+				  eventInfo.id);
+		}
+	}
+
+	const ColumnDef *def = COLUMN_DEF_ACTION_LOGS;
+	const char *colNameSvId = def[IDX_ACTION_LOGS_SERVER_ID].columnName;
+	const char *colNameEvtId = def[IDX_ACTION_LOGS_EVENT_ID].columnName;
+	DBTermCStringProvider rhs(*getDBAgent().getDBTermCodec());
+	for (auto &pair : unknownEventIdsMap) {
+		const ServerIdType &serverId = pair.first;
+		const set<EventIdType> &eventIds = pair.second;
+		auto eventIdItr = eventIds.begin();
+		while (eventIdItr != eventIds.end()) {
+			string idList;
+			SeparatorInjector commaInjector(",");
+			for (size_t i = 0; i < MAX_EVENT_IDS_IN_QUERY &&
+			     eventIdItr != eventIds.end(); i++, ++eventIdItr) {
+				commaInjector(idList);
+				idList += rhs(*eventIdItr);
+			}
+
+			DBAgent::SelectExArg arg(tableProfileActionLogs);
+			arg.add(IDX_ACTION_LOGS_EVENT_ID);
+			arg.condition = StringUtils::sprintf(
+			  "%s=%" FMT_SERVER_ID " AND %s IN (%s)",
+			  colNameSvId, serverId, colNameEvtId, idList.c_str());
+			getDBAgent().runTransaction(arg);
+
+			const ItemGroupList &grpList =
+			  arg.dataTable->getItemGroupList();
+			for (auto &itemGroup : grpList) {
+				ItemGroupStream itemGroupStream(itemGroup);
+				ServerEventIdPair serverEventId;
+				serverEventId.first = serverId;
+				itemGroupStream >> serverEventId.second;
+				loggedEventSet.insert(serverEventId);
+				Impl::addRecentLoggedEvent(serverEventId);
+			}
+		}
+	}
+}
+
 bool DBTablesAction::isIncidentSenderEnabled(void)
 {
 	ActionDefList actionDefList;
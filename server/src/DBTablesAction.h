@@ -156,6 +156,9 @@ typedef std::set<ActionIdType>        ActionIdSet;
 typedef ActionIdSet::iterator         ActionIdSetIterator;
 typedef ActionIdSet::const_iterator   ActionIdSetConstIterator;
 
+typedef std::pair<ServerIdType, EventIdType> ServerEventIdPair;
+typedef std::set<ServerEventIdPair>          ServerEventIdPairSet;
+
 enum {
 	ACTLOG_FLAG_QUEUING_TIME = (1 << 0),
 	ACTLOG_FLAG_START_TIME   = (1 << 1),
@@ -365,6 +368,20 @@ public:
 	bool getLog(ActionLog &actionLog, const ServerIdType &serverId,
 	            const EventIdType &eventId);
 
+	/**
+	 * Get events that have an action log.
+	 *
+	 * Recently logged events are found without the DB access. Others
+	 * are looked up by one query for each server.
+	 *
+	 * @param loggedEventSet
+	 * Pairs of the server ID and the event ID of the logged events are
+	 * inserted.
+	 * @param eventInfoList Target events.
+	 */
+	void getLoggedEvents(ServerEventIdPairSet &loggedEventSet,
+	                     const EventInfoList &eventInfoList);
+
 	/**
 	 * Check whether IncidentSender type action exists or not
 	 *
@@ -23,6 +23,8 @@
 #include <Mutex.h>
 #include "DBAgentFactory.h"
 #include "DBTablesConfig.h"
+#include "ActionRuleIndex.h"
+#include "DataGeneration.h"
 #include "ThreadLocalDBCache.h"
 #include "ConfigManager.h"
 #include "HatoholError.h"
@@ -969,6 +971,7 @@ string IncidentTrackerQueryOption::getCondition(void) const
 void DBTablesConfig::reset(void)
 {
 	getSetupInfo().initialized = false;
+	DataGeneration::bump(DATA_GENERATION_CONFIG);
 }
 
 // TODO: Remove this method after replaced our conventional Arm such
@@ -1011,6 +1014,8 @@ string DBTablesConfig::getDatabaseDir(void)
 
 void DBTablesConfig::setDatabaseDir(const string &dir)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	DBAgent::UpdateArg arg(tableProfileSystem);
 	arg.add(IDX_SYSTEM_DATABASE_DIR, dir);
 	getDBAgent().runTransaction(arg);
@@ -1030,6 +1035,8 @@ int  DBTablesConfig::getFaceRestPort(void)
 
 void DBTablesConfig::setFaceRestPort(int port)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	DBAgent::UpdateArg arg(tableProfileSystem);
 	arg.add(IDX_SYSTEM_FACE_REST_PORT, port);
 	getDBAgent().runTransaction(arg);
@@ -1037,6 +1044,8 @@ void DBTablesConfig::setFaceRestPort(int port)
 
 void DBTablesConfig::registerServerType(const ServerTypeInfo &serverType)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	DBAgent::InsertArg arg(tableProfileServerTypes);
 	arg.add(serverType.type);
 	arg.add(serverType.name);
@@ -1158,6 +1167,8 @@ HatoholError DBTablesConfig::addTargetServer(
   ArmPluginInfo &armPluginInfo,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	if (!privilege.has(OPPRVLG_CREATE_SERVER))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -1232,6 +1243,8 @@ HatoholError DBTablesConfig::updateTargetServer(
   ArmPluginInfo &armPluginInfo,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	if (!canUpdateTargetServer(monitoringServerInfo, privilege))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -1310,6 +1323,8 @@ HatoholError DBTablesConfig::deleteTargetServer(
   const ServerIdType &serverId,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	if (!canDeleteTargetServer(serverId, privilege))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -1483,6 +1498,8 @@ bool DBTablesConfig::getArmPluginInfo(ArmPluginInfo &armPluginInfo,
 
 HatoholError DBTablesConfig::saveArmPluginInfo(ArmPluginInfo &armPluginInfo)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	struct TrxProc : public DBAgent::TransactionProc {
 		HatoholError    err;
 		string          condition;
@@ -1532,6 +1549,8 @@ HatoholError validIncidentTrackerInfo(
 HatoholError DBTablesConfig::addIncidentTracker(
   IncidentTrackerInfo &incidentTrackerInfo, const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	if (!privilege.has(OPPRVLG_CREATE_INCIDENT_SETTING))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -1550,12 +1569,15 @@ HatoholError DBTablesConfig::addIncidentTracker(
 	arg.add(incidentTrackerInfo.password);
 
 	getDBAgent().runTransaction(arg, &incidentTrackerInfo.id);
+	ActionRuleIndex::invalidate();
 	return HTERR_OK;
 }
 
 HatoholError DBTablesConfig::updateIncidentTracker(
   IncidentTrackerInfo &incidentTrackerInfo, const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	if (!privilege.has(OPPRVLG_UPDATE_INCIDENT_SETTING))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -1644,6 +1666,8 @@ HatoholError DBTablesConfig::deleteIncidentTracker(
   const IncidentTrackerIdType &incidentTrackerId,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	if (!privilege.has(OPPRVLG_DELETE_INCIDENT_SETTING))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -1654,6 +1678,7 @@ HatoholError DBTablesConfig::deleteIncidentTracker(
 	                                     colId.columnName, incidentTrackerId);
 
 	getDBAgent().runTransaction(arg);
+	ActionRuleIndex::invalidate();
 	return HTERR_OK;
 }
 
@@ -1686,6 +1711,8 @@ HatoholError DBTablesConfig::upsertSeverityRankInfo(
   SeverityRankInfo &severityRankInfo,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	HatoholError err =
 		checkPrivilegeForSeverityRankAdd(privilege, severityRankInfo);
 	if (err != HTERR_OK)
@@ -1708,6 +1735,8 @@ HatoholError DBTablesConfig::updateSeverityRankInfo(
   SeverityRankInfo &severityRankInfo,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	HatoholError err =
 		checkPrivilegeForSeverityRankUpdate(privilege, severityRankInfo);
 	if (err != HTERR_OK)
@@ -1791,6 +1820,8 @@ HatoholError DBTablesConfig::deleteSeverityRanks(
   const std::list<SeverityRankIdType> &idList,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	HatoholError err = checkPrivilegeForSeverityRankDelete(privilege, idList);
 	if (err != HTERR_OK)
 		return err;
@@ -1840,6 +1871,8 @@ HatoholError DBTablesConfig::upsertCustomIncidentStatus(
   CustomIncidentStatus &customIncidentStatus,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	HatoholError err =
 	  checkPrivilegeForCustomIncidentStatusAdd(privilege, customIncidentStatus);
 	if (err != HTERR_OK)
@@ -1860,6 +1893,8 @@ HatoholError DBTablesConfig::updateCustomIncidentStatus(
   CustomIncidentStatus &customIncidentStatus,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	HatoholError err =
 	  checkPrivilegeForCustomIncidentStatusUpdate(privilege,
 						      customIncidentStatus);
@@ -1937,6 +1972,8 @@ HatoholError DBTablesConfig::deleteCustomIncidentStatus(
   const std::list<CustomIncidentStatusIdType> &idList,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_CONFIG);
+
 	HatoholError err =
 		checkPrivilegeForCustomIncidentStatusDelete(privilege, idList);
 	if (err != HTERR_OK)
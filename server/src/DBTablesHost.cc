@@ -20,8 +20,11 @@
 #include <cstdio>
 #include <SeparatorInjector.h>
 #include "DBTablesHost.h"
+#include "ActionRuleIndex.h"
 #include "ItemGroupStream.h"
 #include "ThreadLocalDBCache.h"
+#include "TriggerStatisticsCache.h"
+#include "DataGeneration.h"
 #include "DBClientJoinBuilder.h"
 #include "DBTermCStringProvider.h"
 using namespace std;
@@ -559,6 +562,7 @@ HostgroupMembersQueryOption::HostgroupMembersQueryOption(
 void DBTablesHost::reset(void)
 {
 	getSetupInfo().initialized = false;
+	DataGeneration::bump(DATA_GENERATION_HOST);
 }
 
 const DBTables::SetupInfo &DBTablesHost::getConstSetupInfo(void)
@@ -578,6 +582,8 @@ DBTablesHost::~DBTablesHost()
 
 HostIdType DBTablesHost::addHost(const string &name)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	HostIdType hostId;
 	DBAgent::InsertArg arg(tableProfileHostList);
 	arg.add(AUTO_INCREMENT_VALUE);
@@ -611,6 +617,8 @@ static string setupFmtCondSelectSvHostDef(void)
 HostIdType DBTablesHost::upsertHost(
   const ServerHostDef &serverHostDef, const bool &useTransaction)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	HATOHOL_ASSERT(serverHostDef.hostId == AUTO_ASSIGNED_ID ||
 	               serverHostDef.hostId >= 0,
 	               "Invalid host ID: %" FMT_HOST_ID, serverHostDef.hostId);
@@ -803,6 +811,8 @@ void DBTablesHost::upsertHosts(
   const ServerHostDefVect &serverHostDefs,
   HostHostIdMap *hostHostIdMapPtr, DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	struct : public SeqTransactionProc<ServerHostDef, ServerHostDefVect> {
 		function<void (const ServerHostDef &svHostDef)> func;
 		void foreach(DBAgent &, const ServerHostDef &svHostDef) override
@@ -823,6 +833,8 @@ void DBTablesHost::upsertHosts(
 GenericIdType DBTablesHost::upsertServerHostDef(
   const ServerHostDef &serverHostDef)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	GenericIdType id;
 	DBAgent::InsertArg arg(tableProfileServerHostDef);
 	arg.add(serverHostDef.id);
@@ -838,6 +850,8 @@ GenericIdType DBTablesHost::upsertServerHostDef(
 
 GenericIdType DBTablesHost::upsertHostAccess(const HostAccess &hostAccess)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	GenericIdType id;
 	DBAgent::InsertArg arg(tableProfileHostAccess);
 	arg.add(hostAccess.id);
@@ -852,6 +866,8 @@ GenericIdType DBTablesHost::upsertHostAccess(const HostAccess &hostAccess)
 GenericIdType DBTablesHost::upsertVMInfo(const VMInfo &vmInfo,
                                          const bool &useTransaction)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	GenericIdType id;
 	DBAgent::InsertArg arg(tableProfileVMList);
 	arg.add(vmInfo.id);
@@ -872,6 +888,8 @@ GenericIdType DBTablesHost::upsertVMInfo(const VMInfo &vmInfo,
 void DBTablesHost::upsertVMInfoVect(const VMInfoVect &vmInfoVect,
                                     DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	struct : public SeqTransactionProc<VMInfo, VMInfoVect> {
 		void foreach(DBAgent &dbAgent, const VMInfo &vminfo) override
 		{
@@ -885,6 +903,8 @@ void DBTablesHost::upsertVMInfoVect(const VMInfoVect &vmInfoVect,
 GenericIdType DBTablesHost::upsertHostgroup(const Hostgroup &hostgroup,
 	                                    const bool &useTransaction)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	GenericIdType id;
 	DBAgent::InsertArg arg(tableProfileHostgroupList);
 	arg.add(hostgroup.id);
@@ -907,6 +927,8 @@ GenericIdType DBTablesHost::upsertHostgroup(const Hostgroup &hostgroup,
 void DBTablesHost::upsertHostgroups(const HostgroupVect &hostgroups,
                                     DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	struct : public SeqTransactionProc<Hostgroup, HostgroupVect> {
 		void foreach(DBAgent &, const Hostgroup &hostgrp) override
 		{
@@ -995,6 +1017,8 @@ static string makeConditionForDelete(const GenericIdList &idList)
 
 HatoholError DBTablesHost::deleteHostgroupList(const GenericIdList &idList)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	if (idList.empty()) {
 		MLPL_WARN("idList is empty.\n");
 		return HTERR_INVALID_PARAMETER;
@@ -1032,6 +1056,8 @@ HatoholError DBTablesHost::deleteHostgroupList(const GenericIdList &idList)
 GenericIdType DBTablesHost::upsertHostgroupMember(
   const HostgroupMember &hostgroupMember, const bool &useTransaction)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	GenericIdType id;
 	DBAgent::InsertArg arg(tableProfileHostgroupMember);
 	arg.add(hostgroupMember.id);
@@ -1044,6 +1070,9 @@ GenericIdType DBTablesHost::upsertHostgroupMember(
 	DBAgent &dbAgent = getDBAgent();
 	if (useTransaction) {
 		dbAgent.runTransaction(arg, &id);
+		ActionRuleIndex::invalidate();
+		TriggerStatisticsCache::getInstance().erase(
+		  hostgroupMember.serverId);
 	} else {
 		dbAgent.insert(arg);
 		id = dbAgent.getLastInsertId();
@@ -1056,6 +1085,8 @@ void DBTablesHost::upsertHostgroupMembers(
   const HostgroupMemberVect &hostgroupMembers,
   DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	struct :
 	  public SeqTransactionProc<HostgroupMember, HostgroupMemberVect> {
 		void foreach(DBAgent &, const HostgroupMember &hgrpMem) override
@@ -1066,6 +1097,11 @@ void DBTablesHost::upsertHostgroupMembers(
 	} proc;
 	proc.init(this, &hostgroupMembers);
 	getDBAgent().runTransaction(proc, hooks);
+	ActionRuleIndex::invalidate();
+	TriggerStatisticsCache &statisticsCache =
+	  TriggerStatisticsCache::getInstance();
+	for (const auto &hostgroupMember : hostgroupMembers)
+		statisticsCache.erase(hostgroupMember.serverId);
 }
 
 HatoholError DBTablesHost::getHostgroupMembers(
@@ -1103,6 +1139,8 @@ HatoholError DBTablesHost::getHostgroupMembers(
 HatoholError DBTablesHost::deleteHostgroupMemberList(
   const GenericIdList &idList)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	if (idList.empty()) {
 		MLPL_WARN("idList is empty.\n");
 		return HTERR_INVALID_PARAMETER;
@@ -1126,6 +1164,9 @@ HatoholError DBTablesHost::deleteHostgroupMemberList(
 	} trx;
 	trx.arg.condition = makeConditionForDelete(idList);
 	getDBAgent().runTransaction(trx);
+	ActionRuleIndex::invalidate();
+	// The server IDs of the deleted members are unknown here.
+	TriggerStatisticsCache::getInstance().clear();
 
 	// Check the result
 	if (trx.numAffectedRows != idList.size()) {
@@ -1174,6 +1215,8 @@ HatoholError DBTablesHost::getVirtualMachines(
 HatoholError DBTablesHost::deleteVMInfoList(
   const GenericIdList &idList)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	if (idList.empty()) {
 		MLPL_WARN("idList is empty.\n");
 		return HTERR_INVALID_PARAMETER;
@@ -1381,6 +1424,8 @@ HatoholError DBTablesHost::syncHosts(
   const ServerHostDefVect &svHostDefs, const ServerIdType &serverId,
   HostHostIdMap *hostHostIdMapPtr, DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	// Make a set that contains current hosts records
 	HostsQueryOption option(USER_ID_SYSTEM);
 	option.setStatusSet({HOST_STAT_NORMAL});
@@ -1441,6 +1486,8 @@ HatoholError DBTablesHost::syncHostgroups(
   const HostgroupVect &incomingHostgroups,
   const ServerIdType &serverId, DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	HostgroupsQueryOption option(USER_ID_SYSTEM);
 	option.setTargetServerId(serverId);
 	HostgroupVect _currHostgroups;
@@ -1485,6 +1532,8 @@ HatoholError DBTablesHost::syncHostgroupMembers(
   const ServerIdType &serverId,
   DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+
 	HostgroupMembersQueryOption option(USER_ID_SYSTEM);
 	option.setTargetServerId(serverId);
 	HostgroupMemberVect _currHostgroupMembers;
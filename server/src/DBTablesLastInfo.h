@@ -36,6 +36,8 @@ enum LastInfoType {
 	LAST_INFO_TRIGGER,
 	LAST_INFO_EVENT,
 	LAST_INFO_HOST_PARENT,
+	// The server ID column holds an incident tracker ID for this type
+	LAST_INFO_INCIDENT,
 	NUM_LAST_INFO_TYPES,
 };
 
@@ -28,9 +28,13 @@
 #include "SQLUtils.h"
 #include "Params.h"
 #include "ItemGroupStream.h"
+#include "ColumnarTableStream.h"
 #include "DBClientJoinBuilder.h"
 #include "DBTermCStringProvider.h"
 #include "StatisticsCounter.h"
+#include "TriggerInfoCache.h"
+#include "TriggerStatisticsCache.h"
+#include "DataGeneration.h"
 
 // TODO: rmeove the followin two include files!
 // This class should not be aware of it.
@@ -100,6 +104,26 @@ void operator>>(ItemGroupStream &itemGroupStream, TriggerValidity &rhs)
 	rhs = itemGroupStream.read<int, TriggerValidity>();
 }
 
+void operator>>(ColumnarTableStream &stream, TriggerStatusType &rhs)
+{
+	rhs = stream.read<int, TriggerStatusType>();
+}
+
+void operator>>(ColumnarTableStream &stream, TriggerSeverityType &rhs)
+{
+	rhs = stream.read<int, TriggerSeverityType>();
+}
+
+void operator>>(ColumnarTableStream &stream, EventType &rhs)
+{
+	rhs = stream.read<int, EventType>();
+}
+
+void operator>>(ColumnarTableStream &stream, TriggerValidity &rhs)
+{
+	rhs = stream.read<int, TriggerValidity>();
+}
+
 // ----------------------------------------------------------------------------
 // Table: triggers
 // ----------------------------------------------------------------------------
@@ -2070,6 +2094,12 @@ string IncidentHistoriesQueryOption::getCondition(void) const
 void DBTablesMonitoring::reset(void)
 {
 	getSetupInfo().initialized = false;
+	TriggerInfoCache::getInstance().clear();
+	TriggerStatisticsCache::getInstance().clear();
+	DataGeneration::bump(DATA_GENERATION_TRIGGER);
+	DataGeneration::bump(DATA_GENERATION_EVENT);
+	DataGeneration::bump(DATA_GENERATION_ITEM);
+	DataGeneration::bump(DATA_GENERATION_INCIDENT);
 }
 
 const DBTables::SetupInfo &DBTablesMonitoring::getConstSetupInfo(void)
@@ -2089,6 +2119,8 @@ DBTablesMonitoring::~DBTablesMonitoring()
 
 void DBTablesMonitoring::addTriggerInfo(const TriggerInfo *triggerInfo)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_TRIGGER);
+
 	struct TrxProc : public DBAgent::TransactionProc {
 		const TriggerInfo *triggerInfo;
 
@@ -2103,12 +2135,16 @@ void DBTablesMonitoring::addTriggerInfo(const TriggerInfo *triggerInfo)
 		}
 	} trx(triggerInfo);
 	getDBAgent().runTransaction(trx);
+	TriggerInfoCache::getInstance().update(*triggerInfo);
+	TriggerStatisticsCache::getInstance().update(*triggerInfo);
 }
 
 void DBTablesMonitoring::addTriggerInfoList(
   const TriggerInfoList &triggerInfoList,
   DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_TRIGGER);
+
 	struct : public SeqTransactionProc<TriggerInfo, TriggerInfoList> {
 		void foreach(DBAgent &dbag, const TriggerInfo &trig) override
 		{
@@ -2118,6 +2154,8 @@ void DBTablesMonitoring::addTriggerInfoList(
 	} trx;
 	trx.init(this, &triggerInfoList);
 	getDBAgent().runTransaction(trx, hooks);
+	TriggerInfoCache::getInstance().update(triggerInfoList);
+	TriggerStatisticsCache::getInstance().update(triggerInfoList);
 }
 
 bool DBTablesMonitoring::getTriggerInfo(TriggerInfo &triggerInfo,
@@ -2177,29 +2215,27 @@ void DBTablesMonitoring::getTriggerInfoList(TriggerInfoList &triggerInfoList,
 	if (!arg.limit && arg.offset)
 		return;
 
+	arg.useColumnarTable = true;
 	getDBAgent().runTransaction(arg);
 
 	// check the result and copy
-	const ItemGroupList &grpList = arg.dataTable->getItemGroupList();
-	ItemGroupListConstIterator itemGrpItr = grpList.begin();
-	for (; itemGrpItr != grpList.end(); ++itemGrpItr) {
-		ItemGroupStream itemGroupStream(*itemGrpItr);
-		TriggerInfo trigInfo;
-
-		itemGroupStream >> trigInfo.serverId;
-		itemGroupStream >> trigInfo.id;
-		itemGroupStream >> trigInfo.status;
-		itemGroupStream >> trigInfo.severity;
-		itemGroupStream >> trigInfo.lastChangeTime.tv_sec;
-		itemGroupStream >> trigInfo.lastChangeTime.tv_nsec;
-		itemGroupStream >> trigInfo.globalHostId;
-		itemGroupStream >> trigInfo.hostIdInServer;
-		itemGroupStream >> trigInfo.hostName;
-		itemGroupStream >> trigInfo.brief;
-		itemGroupStream >> trigInfo.extendedInfo;
-		itemGroupStream >> trigInfo.validity;
-
-		triggerInfoList.push_back(trigInfo);
+	ColumnarTableStream stream(*arg.columnarTable);
+	while (stream.next()) {
+		triggerInfoList.push_back(TriggerInfo());
+		TriggerInfo &trigInfo = triggerInfoList.back();
+
+		stream >> trigInfo.serverId;
+		stream >> trigInfo.id;
+		stream >> trigInfo.status;
+		stream >> trigInfo.severity;
+		stream >> trigInfo.lastChangeTime.tv_sec;
+		stream >> trigInfo.lastChangeTime.tv_nsec;
+		stream >> trigInfo.globalHostId;
+		stream >> trigInfo.hostIdInServer;
+		stream >> trigInfo.hostName;
+		stream >> trigInfo.brief;
+		stream >> trigInfo.extendedInfo;
+		stream >> trigInfo.validity;
 	}
 }
 
@@ -2207,6 +2243,8 @@ void DBTablesMonitoring::getTriggerInfoList(TriggerInfoList &triggerInfoList,
 void DBTablesMonitoring::setTriggerInfoList(
   const TriggerInfoList &triggerInfoList, const ServerIdType &serverId)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_TRIGGER);
+
 	DBAgent::DeleteArg deleteArg(tableProfileTriggers);
 	struct : public SeqTransactionProc<TriggerInfo, TriggerInfoList> {
 		function<bool (DBAgent &)> _preproc;
@@ -2241,6 +2279,11 @@ void DBTablesMonitoring::setTriggerInfoList(
 	trx._funcTopHalf = [&] (DBAgent &dbag) { dbag.deleteRows(deleteArg); };
 	trx.init(this, &triggerInfoList);
 	getDBAgent().runTransaction(trx);
+
+	TriggerInfoCache &triggerInfoCache = TriggerInfoCache::getInstance();
+	triggerInfoCache.erase(serverId);
+	triggerInfoCache.update(triggerInfoList);
+	TriggerStatisticsCache::getInstance().erase(serverId);
 }
 
 HatoholError DBTablesMonitoring::getTriggerBriefList(
@@ -2303,6 +2346,8 @@ int DBTablesMonitoring::getLastChangeTimeOfTrigger(const ServerIdType &serverId)
 void DBTablesMonitoring::updateTrigger(const TriggerInfoList &triggerInfoList,
 				       const ServerIdType &serverId)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_TRIGGER);
+
 	TriggersQueryOption option(USER_ID_SYSTEM);
 	option.setTargetServerId(serverId);
 	option.setExcludeFlags(EXCLUDE_SELF_MONITORING);
@@ -2373,9 +2418,70 @@ static string makeConditionForDeleteTrigger(const TriggerIdList &idList,
 	return condition;
 }
 
+static void setupTriggerSelectArg(DBAgent::SelectExArg &arg,
+                                  const ServerIdType &serverId,
+                                  const TriggerIdList &idList)
+{
+	arg.add(IDX_TRIGGERS_SERVER_ID);
+	arg.add(IDX_TRIGGERS_ID);
+	arg.add(IDX_TRIGGERS_STATUS);
+	arg.add(IDX_TRIGGERS_SEVERITY);
+	arg.add(IDX_TRIGGERS_LAST_CHANGE_TIME_SEC);
+	arg.add(IDX_TRIGGERS_LAST_CHANGE_TIME_NS);
+	arg.add(IDX_TRIGGERS_GLOBAL_HOST_ID);
+	arg.add(IDX_TRIGGERS_HOST_ID_IN_SERVER);
+	arg.add(IDX_TRIGGERS_HOSTNAME);
+	arg.add(IDX_TRIGGERS_BRIEF);
+	arg.add(IDX_TRIGGERS_EXTENDED_INFO);
+	arg.add(IDX_TRIGGERS_VALIDITY);
+	arg.condition = makeConditionForDeleteTrigger(idList, serverId);
+}
+
+static void readTriggerInfo(const ItemGroup *itemGroup,
+                            TriggerInfo &trigInfo)
+{
+	ItemGroupStream itemGroupStream(itemGroup);
+	itemGroupStream >> trigInfo.serverId;
+	itemGroupStream >> trigInfo.id;
+	itemGroupStream >> trigInfo.status;
+	itemGroupStream >> trigInfo.severity;
+	itemGroupStream >> trigInfo.lastChangeTime.tv_sec;
+	itemGroupStream >> trigInfo.lastChangeTime.tv_nsec;
+	itemGroupStream >> trigInfo.globalHostId;
+	itemGroupStream >> trigInfo.hostIdInServer;
+	itemGroupStream >> trigInfo.hostName;
+	itemGroupStream >> trigInfo.brief;
+	itemGroupStream >> trigInfo.extendedInfo;
+	itemGroupStream >> trigInfo.validity;
+}
+
+static bool selectTriggerInfo(DBAgent &dbAgent,
+                              const ServerIdType &serverId,
+                              const TriggerIdType &triggerId,
+                              TriggerInfo &triggerInfo)
+{
+	TriggerInfoCache &triggerInfoCache = TriggerInfoCache::getInstance();
+	if (triggerInfoCache.get(serverId, triggerId, triggerInfo))
+		return true;
+
+	const uint64_t generation = triggerInfoCache.getGeneration();
+	DBAgent::SelectExArg arg(tableProfileTriggers);
+	setupTriggerSelectArg(arg, serverId, TriggerIdList{triggerId});
+	dbAgent.select(arg);
+
+	const ItemGroupList &grpList = arg.dataTable->getItemGroupList();
+	if (grpList.empty())
+		return false;
+	readTriggerInfo(*grpList.begin(), triggerInfo);
+	triggerInfoCache.fill(triggerInfo, generation);
+	return true;
+}
+
 HatoholError DBTablesMonitoring::deleteTriggerInfo(const TriggerIdList &idList,
                                                    const ServerIdType &serverId)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_TRIGGER);
+
 	if (idList.empty()) {
 		MLPL_WARN("idList is empty.\n");
 		return HTERR_INVALID_PARAMETER;
@@ -2399,6 +2505,8 @@ HatoholError DBTablesMonitoring::deleteTriggerInfo(const TriggerIdList &idList,
 	} trx;
 	trx.arg.condition = makeConditionForDeleteTrigger(idList, serverId);
 	getDBAgent().runTransaction(trx);
+	TriggerInfoCache::getInstance().erase(serverId, idList);
+	TriggerStatisticsCache::getInstance().erase(serverId, idList);
 
 	// Check the result
 	if (trx.numAffectedRows != idList.size()) {
@@ -2410,6 +2518,40 @@ HatoholError DBTablesMonitoring::deleteTriggerInfo(const TriggerIdList &idList,
 	return HTERR_OK;
 }
 
+bool DBTablesMonitoring::getTriggerInfo(TriggerInfo &triggerInfo,
+                                        const ServerIdType &serverId,
+                                        const TriggerIdType &triggerId)
+{
+	TriggerInfoCache &triggerInfoCache = TriggerInfoCache::getInstance();
+	if (triggerInfoCache.get(serverId, triggerId, triggerInfo))
+		return true;
+
+	struct TrxProc : public DBAgent::TransactionProc {
+		const ServerIdType  &serverId;
+		const TriggerIdType &triggerId;
+		TriggerInfo         &triggerInfo;
+		bool                 found;
+
+		TrxProc(const ServerIdType &_serverId,
+		        const TriggerIdType &_triggerId,
+		        TriggerInfo &_triggerInfo)
+		: serverId(_serverId),
+		  triggerId(_triggerId),
+		  triggerInfo(_triggerInfo),
+		  found(false)
+		{
+		}
+
+		void operator ()(DBAgent &dbAgent) override
+		{
+			found = selectTriggerInfo(dbAgent, serverId, triggerId,
+			                          triggerInfo);
+		}
+	} trx(serverId, triggerId, triggerInfo);
+	getDBAgent().runTransaction(trx);
+	return trx.found;
+}
+
 static bool isTriggerDescriptionChanged(
   TriggerInfo trigger, map<TriggerIdType, const TriggerInfo *> currentTriggerMap)
 {
@@ -2454,6 +2596,8 @@ HatoholError DBTablesMonitoring::syncTriggers(
   const ServerIdType &serverId,
   DBAgent::TransactionHooks *hooks)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_TRIGGER);
+
 	TriggersQueryOption option(USER_ID_SYSTEM);
 	option.setTargetServerId(serverId);
 	TriggerInfoList _currTriggers;
@@ -2495,6 +2639,8 @@ HatoholError DBTablesMonitoring::syncTriggers(
 
 void DBTablesMonitoring::addEventInfo(EventInfo *eventInfo)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_EVENT);
+
 	struct TrxProc : public DBAgent::TransactionProc {
 		EventInfo *eventInfo;
 		uint64_t numAdded;
@@ -2518,17 +2664,25 @@ void DBTablesMonitoring::addEventInfo(EventInfo *eventInfo)
 void DBTablesMonitoring::addEventInfoList(EventInfoList &eventInfoList,
                                           DBAgent::TransactionHooks *hooks)
 {
-	struct : public MutableSeqTransactionProc<EventInfo, EventInfoList> {
+	DataGeneration::Bumper bumper(DATA_GENERATION_EVENT);
+
+	struct TrxProc : public DBAgent::TransactionProc {
+		EventInfoList &eventInfoList;
 		uint64_t numAdded;
-		void foreach(DBAgent &dbag, EventInfo &eventInfo) override
+
+		TrxProc(EventInfoList &_eventInfoList)
+		: eventInfoList(_eventInfoList),
+		  numAdded(0)
 		{
-			DBTablesMonitoring &dbMon = get<DBTablesMonitoring>();
-			dbMon.addEventInfoWithoutTransaction(dbag, eventInfo);
-			numAdded++;
 		}
-	} trx;
-	trx.numAdded = 0;
-	trx.init(this, &eventInfoList);
+
+		void operator ()(DBAgent &dbAgent) override
+		{
+			addEventInfoListWithoutTransaction(dbAgent,
+			                                   eventInfoList);
+			numAdded = eventInfoList.size();
+		}
+	} trx(eventInfoList);
 	getDBAgent().runTransaction(trx, hooks);
 	m_impl->addEventStatistics(trx.numAdded);
 }
@@ -2536,6 +2690,19 @@ void DBTablesMonitoring::addEventInfoList(EventInfoList &eventInfoList,
 HatoholError DBTablesMonitoring::getEventInfoList(
   EventInfoList &eventInfoList, const EventsQueryOption &option,
   IncidentInfoVect *incidentInfoVect)
+{
+	auto handler = [&](EventInfo &eventInfo, IncidentInfo *incidentInfo) {
+		eventInfoList.push_back(move(eventInfo));
+		if (incidentInfoVect)
+			incidentInfoVect->push_back(move(*incidentInfo));
+		return true;
+	};
+	return forEachEventInfo(option, handler, incidentInfoVect);
+}
+
+HatoholError DBTablesMonitoring::forEachEventInfo(
+  const EventsQueryOption &option, const EventInfoHandler &handler,
+  const bool &withIncidentInfo)
 {
 	DBClientJoinBuilder builder(tableProfileEvents, &option);
 	builder.add(IDX_EVENTS_UNIFIED_ID);
@@ -2553,7 +2720,7 @@ HatoholError DBTablesMonitoring::getEventInfoList(
 	builder.add(IDX_EVENTS_BRIEF);
 	builder.add(IDX_EVENTS_EXTENDED_INFO);
 
-	if (incidentInfoVect || !option.getIncidentStatuses().empty()) {
+	if (withIncidentInfo || !option.getIncidentStatuses().empty()) {
 		builder.addTable(
 		  tableProfileIncidents, DBClientJoinBuilder::LEFT_JOIN,
 		  tableProfileEvents, IDX_EVENTS_UNIFIED_ID, IDX_INCIDENTS_UNIFIED_EVENT_ID);
@@ -2592,51 +2759,43 @@ HatoholError DBTablesMonitoring::getEventInfoList(
 	if (!arg.limit && arg.offset)
 		return HTERR_OFFSET_WITHOUT_LIMIT;
 
-	getDBAgent().runTransaction(arg);
-
-	// check the result and copy
-	const ItemGroupList &grpList = arg.dataTable->getItemGroupList();
-	ItemGroupListConstIterator itemGrpItr = grpList.begin();
-	for (; itemGrpItr != grpList.end(); ++itemGrpItr) {
-		ItemGroupStream itemGroupStream(*itemGrpItr);
-		eventInfoList.push_back(EventInfo());
-		EventInfo &eventInfo = eventInfoList.back();
-
-		itemGroupStream >> eventInfo.unifiedId;
-		itemGroupStream >> eventInfo.serverId;
-		itemGroupStream >> eventInfo.id;
-		itemGroupStream >> eventInfo.time.tv_sec;
-		itemGroupStream >> eventInfo.time.tv_nsec;
-		itemGroupStream >> eventInfo.type;
-		itemGroupStream >> eventInfo.triggerId;
-		itemGroupStream >> eventInfo.status;
-		itemGroupStream >> eventInfo.severity;
-		itemGroupStream >> eventInfo.globalHostId;
-		itemGroupStream >> eventInfo.hostIdInServer;
-		itemGroupStream >> eventInfo.hostName;
-		itemGroupStream >> eventInfo.brief;
+	auto rowHandler = [&](ColumnarTableStream &stream) {
+		EventInfo eventInfo;
+		IncidentInfo incidentInfo;
+
+		stream >> eventInfo.unifiedId;
+		stream >> eventInfo.serverId;
+		stream >> eventInfo.id;
+		stream >> eventInfo.time.tv_sec;
+		stream >> eventInfo.time.tv_nsec;
+		stream >> eventInfo.type;
+		stream >> eventInfo.triggerId;
+		stream >> eventInfo.status;
+		stream >> eventInfo.severity;
+		stream >> eventInfo.globalHostId;
+		stream >> eventInfo.hostIdInServer;
+		stream >> eventInfo.hostName;
+		stream >> eventInfo.brief;
 
 		string triggerExtendedInfo;
-		itemGroupStream >> triggerExtendedInfo;
+		stream >> triggerExtendedInfo;
 		if (!triggerExtendedInfo.empty())
 			eventInfo.extendedInfo = triggerExtendedInfo;
 
-		if (incidentInfoVect) {
-			incidentInfoVect->push_back(IncidentInfo());
-			IncidentInfo &incidentInfo = incidentInfoVect->back();
-			itemGroupStream >> incidentInfo.trackerId;
-			itemGroupStream >> incidentInfo.identifier;
-			itemGroupStream >> incidentInfo.location;
-			itemGroupStream >> incidentInfo.status;
-			itemGroupStream >> incidentInfo.assignee;
-			itemGroupStream >> incidentInfo.createdAt.tv_sec;
-			itemGroupStream >> incidentInfo.createdAt.tv_nsec;
-			itemGroupStream >> incidentInfo.updatedAt.tv_sec;
-			itemGroupStream >> incidentInfo.updatedAt.tv_nsec;
-			itemGroupStream >> incidentInfo.priority;
-			itemGroupStream >> incidentInfo.doneRatio;
-			itemGroupStream >> incidentInfo.unifiedEventId;
-			itemGroupStream >> incidentInfo.commentCount;
+		if (withIncidentInfo) {
+			stream >> incidentInfo.trackerId;
+			stream >> incidentInfo.identifier;
+			stream >> incidentInfo.location;
+			stream >> incidentInfo.status;
+			stream >> incidentInfo.assignee;
+			stream >> incidentInfo.createdAt.tv_sec;
+			stream >> incidentInfo.createdAt.tv_nsec;
+			stream >> incidentInfo.updatedAt.tv_sec;
+			stream >> incidentInfo.updatedAt.tv_nsec;
+			stream >> incidentInfo.priority;
+			stream >> incidentInfo.doneRatio;
+			stream >> incidentInfo.unifiedEventId;
+			stream >> incidentInfo.commentCount;
 			incidentInfo.statusCode
 				= IncidentInfo::STATUS_UNKNOWN; // TODO: add column?
 			incidentInfo.serverId  = eventInfo.serverId;
@@ -2644,7 +2803,10 @@ HatoholError DBTablesMonitoring::getEventInfoList(
 			incidentInfo.triggerId = eventInfo.triggerId;
 			incidentInfo.unifiedEventId = eventInfo.unifiedId;
 		}
-	}
+		return handler(eventInfo,
+		               withIncidentInfo ? &incidentInfo : NULL);
+	};
+	getDBAgent().runTransaction(arg, rowHandler);
 	return HatoholError(HTERR_OK);
 }
 
@@ -2748,6 +2910,8 @@ SmartTime DBTablesMonitoring::getTimeOfLastEvent(
 
 void DBTablesMonitoring::addItemInfo(const ItemInfo *itemInfo)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ITEM);
+
 	struct TrxProc : public DBAgent::TransactionProc {
 		const ItemInfo *itemInfo;
 
@@ -2766,6 +2930,8 @@ void DBTablesMonitoring::addItemInfo(const ItemInfo *itemInfo)
 
 void DBTablesMonitoring::addItemInfoList(const ItemInfoList &itemInfoList)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ITEM);
+
 	struct : public SeqTransactionProc<ItemInfo, ItemInfoList> {
 		void foreach(DBAgent &dbag, const ItemInfo &itemInfo) override
 		{
@@ -2810,6 +2976,8 @@ static string makeConditionForDeleteItem(const ItemIdList &idList,
 HatoholError DBTablesMonitoring::deleteItemInfo(const ItemIdList &idList,
                                                 const ServerIdType &serverId)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ITEM);
+
 	if (idList.empty()) {
 		MLPL_WARN("idList is empty.\n");
 		return HTERR_INVALID_PARAMETER;
@@ -2887,6 +3055,8 @@ static LocalHostIdType getTargetHostId(const ItemInfoList itemInfoList)
 HatoholError DBTablesMonitoring::syncItems(const ItemInfoList &itemInfoList,
                                            const ServerIdType &serverId)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ITEM);
+
 	ItemsQueryOption option(USER_ID_SYSTEM);
 	ItemInfoList _currItems;
 
@@ -2959,13 +3129,12 @@ void DBTablesMonitoring::getItemInfoList(ItemInfoList &itemInfoList,
 		if (!arg.limit && arg.offset)
 			return;
 
+		arg.useColumnarTable = true;
 		getDBAgent().runTransaction(arg);
-		const auto &grpList = arg.dataTable->getItemGroupList();
-		itemGlobalIds.reserve(grpList.size());
-		for (const auto &grp: grpList) {
-			const GenericIdType globalId = *(grp->getItemAt(0));
-			itemGlobalIds.push_back(globalId);
-		}
+		ColumnarTableStream stream(*arg.columnarTable);
+		itemGlobalIds.reserve(arg.columnarTable->getNumberOfRows());
+		while (stream.next())
+			itemGlobalIds.push_back(stream.read<GenericIdType>());
 	};
 	getGlobalItemIds();
 	if (itemGlobalIds.empty())
@@ -3000,11 +3169,12 @@ void DBTablesMonitoring::getItemInfoList(ItemInfoList &itemInfoList,
 	}
 	arg.condition += ")";
 
+	arg.useColumnarTable = true;
 	getDBAgent().runTransaction(arg);
 
 	// check the result and copy
-	const ItemGroupList &grpList = arg.dataTable->getItemGroupList();
-	ItemGroupListConstIterator itemGrpItr = grpList.begin();
+	const ColumnarTable &table = *arg.columnarTable;
+	ColumnarTableStream stream(table);
 	map<GenericIdType, ItemInfo *> globalItemIdMap;
 	map<GenericIdType, ItemInfo *>::iterator itr;
 	
@@ -3014,17 +3184,15 @@ void DBTablesMonitoring::getItemInfoList(ItemInfoList &itemInfoList,
 		itemInfo.categoryNames.push_back(name);
 	};
 
-	for (; itemGrpItr != grpList.end(); ++itemGrpItr) {
+	while (stream.next()) {
 		GenericIdType globalId;
 		string category;
-		ItemGroupStream itemGroupStream(*itemGrpItr);
-		itemGroupStream >> globalId;
+		stream >> globalId;
 		itr = globalItemIdMap.find(globalId);
 		if (itr != globalItemIdMap.end()) {
 			ItemInfo &itemInfo = *itr->second;
-			const ItemData *categoryData =
-			  (*itemGrpItr)->getItemAt(NUM_IDX_ITEMS);
-			setCategoryName(itemInfo, *categoryData);
+			setCategoryName(itemInfo,
+			  table.getString(stream.getRow(), NUM_IDX_ITEMS));
 			continue;
 		}
 
@@ -3033,21 +3201,21 @@ void DBTablesMonitoring::getItemInfoList(ItemInfoList &itemInfoList,
 		globalItemIdMap.insert(
 		  pair<GenericIdType, ItemInfo *>(globalId, &itemInfo));
 		itemInfo.globalId = globalId;
-		itemGroupStream >> itemInfo.serverId;
-		itemGroupStream >> itemInfo.id;
-		itemGroupStream >> itemInfo.globalHostId;
-		itemGroupStream >> itemInfo.hostIdInServer;
-		itemGroupStream >> itemInfo.brief;
-		itemGroupStream >> itemInfo.lastValueTime.tv_sec;
-		itemGroupStream >> itemInfo.lastValueTime.tv_nsec;
-		itemGroupStream >> itemInfo.lastValue;
-		itemGroupStream >> itemInfo.prevValue;
+		stream >> itemInfo.serverId;
+		stream >> itemInfo.id;
+		stream >> itemInfo.globalHostId;
+		stream >> itemInfo.hostIdInServer;
+		stream >> itemInfo.brief;
+		stream >> itemInfo.lastValueTime.tv_sec;
+		stream >> itemInfo.lastValueTime.tv_nsec;
+		stream >> itemInfo.lastValue;
+		stream >> itemInfo.prevValue;
 		int valueType;
-		itemGroupStream >> valueType;
+		stream >> valueType;
 		itemInfo.valueType = static_cast<ItemInfoValueType>(valueType);
-		itemGroupStream >> itemInfo.unit;
+		stream >> itemInfo.unit;
 
-		itemGroupStream >> category;
+		stream >> category;
 		setCategoryName(itemInfo, category);
 	}
 }
@@ -3093,6 +3261,8 @@ void DBTablesMonitoring::getItemCategoryNames(
 void DBTablesMonitoring::addMonitoringServerStatus(
   const MonitoringServerStatus &serverStatus)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_ITEM);
+
 	struct TrxProc : public DBAgent::TransactionProc {
 		const MonitoringServerStatus &serverStatus;
 
@@ -3331,6 +3501,112 @@ size_t DBTablesMonitoring::getNumberOfEvents(const EventsQueryOption &option)
 	return itemGroupStream.read<int>();
 }
 
+// The hostgroup member table is joined in the same way as
+// HostResourceQueryOption does when a target hostgroup is specified.
+// The first column of the returned arg is the hostgroup ID.
+static DBAgent::SelectExArg &buildHostgroupGroupedArg(
+  DBClientJoinBuilder &builder, const TriggersQueryOption &option)
+{
+	if (!option.isHostgroupUsed()) {
+		builder.addTable(
+		  tableProfileHostgroupMember, DBClientJoinBuilder::INNER_JOIN,
+		  tableProfileTriggers, IDX_TRIGGERS_GLOBAL_HOST_ID,
+		  IDX_HOSTGROUP_MEMBER_HOST_ID);
+	}
+	DBAgent::SelectExArg &arg = builder.build();
+	arg.add(tableProfileHostgroupMember.getFullColumnName(
+	          IDX_HOSTGROUP_MEMBER_GROUP_ID),
+	        SQL_COLUMN_TYPE_VARCHAR);
+	return arg;
+}
+
+HatoholError DBTablesMonitoring::getBadTriggerCountMatrix(
+  BadTriggerCountMatrix &matrix, const TriggersQueryOption &option)
+{
+	if (option.getTargetServerId() == ALL_SERVERS)
+		return HTERR_INVALID_PARAMETER;
+
+	DBClientJoinBuilder builder(tableProfileTriggers, &option);
+	DBAgent::SelectExArg &arg = buildHostgroupGroupedArg(builder, option);
+	const string hostgroupIdColumnName =
+	  tableProfileHostgroupMember.getFullColumnName(
+	    IDX_HOSTGROUP_MEMBER_GROUP_ID);
+	const string severityColumnName =
+	  option.getColumnName(IDX_TRIGGERS_SEVERITY);
+	arg.add(severityColumnName, SQL_COLUMN_TYPE_INT);
+	// A trigger ID is unique in a server.
+	arg.add(StringUtils::sprintf("count(distinct %s)",
+	          option.getColumnName(IDX_TRIGGERS_ID).c_str()),
+	        SQL_COLUMN_TYPE_INT);
+
+	if (!arg.condition.empty())
+		arg.condition += " AND ";
+	arg.condition +=
+	  StringUtils::sprintf("%s=%d",
+	    option.getColumnName(IDX_TRIGGERS_STATUS).c_str(),
+	    TRIGGER_STATUS_PROBLEM);
+	arg.groupBy = StringUtils::sprintf("%s,%s",
+	                hostgroupIdColumnName.c_str(),
+	                severityColumnName.c_str());
+
+	getDBAgent().runTransaction(arg);
+
+	const ItemGroupList &grpList = arg.dataTable->getItemGroupList();
+	for (auto itemGrp : grpList) {
+		ItemGroupStream itemGroupStream(itemGrp);
+		HostgroupIdType hostgroupId;
+		int severity;
+		int num;
+		itemGroupStream >> hostgroupId;
+		itemGroupStream >> severity;
+		itemGroupStream >> num;
+		if (severity < 0 || severity >= NUM_TRIGGER_SEVERITY)
+			continue;
+		matrix[hostgroupId][severity] = num;
+	}
+	return HTERR_OK;
+}
+
+HatoholError DBTablesMonitoring::getHostStatusCountMap(
+  HostStatusCountMap &countMap, const TriggersQueryOption &option)
+{
+	if (option.getTargetServerId() == ALL_SERVERS)
+		return HTERR_INVALID_PARAMETER;
+
+	DBClientJoinBuilder builder(tableProfileTriggers, &option);
+	DBAgent::SelectExArg &arg = buildHostgroupGroupedArg(builder, option);
+	const string hostIdColumnName =
+	  option.getColumnName(IDX_TRIGGERS_HOST_ID_IN_SERVER);
+	arg.add(StringUtils::sprintf("count(distinct %s)",
+	          hostIdColumnName.c_str()),
+	        SQL_COLUMN_TYPE_INT);
+	// NULL returned by CASE for good triggers isn't counted.
+	arg.add(StringUtils::sprintf(
+	          "count(distinct CASE WHEN %s=%d THEN %s END)",
+	          option.getColumnName(IDX_TRIGGERS_STATUS).c_str(),
+	          TRIGGER_STATUS_PROBLEM, hostIdColumnName.c_str()),
+	        SQL_COLUMN_TYPE_INT);
+	arg.groupBy = tableProfileHostgroupMember.getFullColumnName(
+	                IDX_HOSTGROUP_MEMBER_GROUP_ID);
+
+	getDBAgent().runTransaction(arg);
+
+	const ItemGroupList &grpList = arg.dataTable->getItemGroupList();
+	for (auto itemGrp : grpList) {
+		ItemGroupStream itemGroupStream(itemGrp);
+		HostgroupIdType hostgroupId;
+		int numHosts;
+		int numBadHosts;
+		itemGroupStream >> hostgroupId;
+		itemGroupStream >> numHosts;
+		itemGroupStream >> numBadHosts;
+		HostStatusCounts &counts = countMap[hostgroupId];
+		counts.numGoodHosts = numHosts - numBadHosts;
+		counts.numBadHosts = numBadHosts;
+	}
+	return HTERR_OK;
+}
+
 size_t DBTablesMonitoring::getNumberOfHostsWithSpecifiedEvents(
   const EventsQueryOption &option)
 {
@@ -3393,6 +3669,8 @@ HatoholError DBTablesMonitoring::getEventSeverityStatistics(
 
 void DBTablesMonitoring::addIncidentInfo(IncidentInfo *incidentInfo)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_INCIDENT);
+
 	struct TrxProc : public DBAgent::TransactionProc {
 		IncidentInfo *incidentInfo;
 
@@ -3412,6 +3690,7 @@ void DBTablesMonitoring::addIncidentInfo(IncidentInfo *incidentInfo)
 
 HatoholError DBTablesMonitoring::updateIncidentInfo(IncidentInfo &incidentInfo)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_INCIDENT);
 
 	struct TrxProc : public DBAgent::TransactionProc {
 		HatoholError err;
@@ -3461,6 +3740,31 @@ HatoholError DBTablesMonitoring::updateIncidentInfo(IncidentInfo &incidentInfo)
 	return trx.err;
 }
 
+size_t DBTablesMonitoring::updateIncidentInfoVect(
+  IncidentInfoVect &incidentInfoVect, DBAgent::TransactionHooks *hooks)
+{
+	DataGeneration::Bumper bumper(DATA_GENERATION_INCIDENT);
+
+	struct TrxProc : public DBAgent::TransactionProc {
+		IncidentInfoVect &incidentInfoVect;
+		size_t numUpdated;
+
+		TrxProc(IncidentInfoVect &_incidentInfoVect)
+		: incidentInfoVect(_incidentInfoVect),
+		  numUpdated(0)
+		{
+		}
+
+		void operator ()(DBAgent &dbAgent) override
+		{
+			numUpdated = updateIncidentInfoVectWithoutTransaction(
+			               dbAgent, incidentInfoVect);
+		}
+	} trx(incidentInfoVect);
+	getDBAgent().runTransaction(trx, hooks);
+	return trx.numUpdated;
+}
+
 HatoholError DBTablesMonitoring::getIncidentInfoVect(
   IncidentInfoVect &incidentInfoVect, const IncidentsQueryOption &option)
 {
@@ -3710,6 +4014,8 @@ size_t DBTablesMonitoring::getIncidentCommentCount(
 HatoholError DBTablesMonitoring::updateIncidentCommentCount(
   UnifiedEventIdType unifiedEventId)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_INCIDENT);
+
 	struct TrxProc : public DBAgent::TransactionProc {
 		HatoholError err;
 		DBAgent::UpdateArg arg;
@@ -3805,12 +4111,9 @@ void DBTablesMonitoring::addTriggerInfoWithoutTransaction(
 	dbAgent.insert(arg);
 }
 
-void DBTablesMonitoring::addEventInfoWithoutTransaction(
-  DBAgent &dbAgent, EventInfo &eventInfo)
+static void setEventInfoToInsertArg(
+  DBAgent::InsertArg &arg, const EventInfo &eventInfo)
 {
-	mergeTriggerInfo(dbAgent, eventInfo);
-
-	DBAgent::InsertArg arg(tableProfileEvents);
 	arg.add(AUTO_INCREMENT_VALUE_U64);
 	arg.add(eventInfo.serverId);
 	arg.add(eventInfo.id);
@@ -3825,11 +4128,47 @@ void DBTablesMonitoring::addEventInfoWithoutTransaction(
 	arg.add(eventInfo.hostName);
 	arg.add(eventInfo.brief);
 	arg.add(eventInfo.extendedInfo);
+}
+
+void DBTablesMonitoring::addEventInfoWithoutTransaction(
+  DBAgent &dbAgent, EventInfo &eventInfo)
+{
+	mergeTriggerInfo(dbAgent, eventInfo);
+
+	DBAgent::InsertArg arg(tableProfileEvents);
+	setEventInfoToInsertArg(arg, eventInfo);
 	arg.upsertOnDuplicate = true;
 	dbAgent.insert(arg);
 	eventInfo.unifiedId = dbAgent.getLastInsertId();
 }
 
+void DBTablesMonitoring::addEventInfoListWithoutTransaction(
+  DBAgent &dbAgent, EventInfoList &eventInfoList)
+{
+	if (eventInfoList.empty())
+		return;
+	mergeTriggerInfo(dbAgent, eventInfoList);
+
+	// The events table has no unique key other than the auto-incremented
+	// unified_id. So an upsert never updates an existing row and
+	// a plain INSERT is equivalent. It allows the DBAgent to insert
+	// the rows with multi-row INSERT statements.
+	DBAgent::BulkInsertArg bulkArg(tableProfileEvents);
+	for (const auto &eventInfo : eventInfoList) {
+		DBAgent::InsertArg arg(tableProfileEvents);
+		setEventInfoToInsertArg(arg, eventInfo);
+		bulkArg.add(arg);
+	}
+	dbAgent.bulkInsert(bulkArg);
+
+	HATOHOL_ASSERT(bulkArg.insertIds.size() == eventInfoList.size(),
+	               "insertIds: %zd, events: %zd",
+	               bulkArg.insertIds.size(), eventInfoList.size());
+	auto idItr = bulkArg.insertIds.begin();
+	for (auto &eventInfo : eventInfoList)
+		eventInfo.unifiedId = *idItr++;
+}
+
 void DBTablesMonitoring::addItemCategoryWithoutTransaction(
   DBAgent &dbAgent, const ItemCategory &category)
 {
@@ -3981,10 +4320,9 @@ void DBTablesMonitoring::addMonitoringServerStatusWithoutTransaction(
 	dbAgent.insert(arg);
 }
 
-void DBTablesMonitoring::addIncidentInfoWithoutTransaction(
-  DBAgent &dbAgent, const IncidentInfo &incidentInfo)
+static void setIncidentInfoToInsertArg(
+  DBAgent::InsertArg &arg, const IncidentInfo &incidentInfo)
 {
-	DBAgent::InsertArg arg(tableProfileIncidents);
 	arg.add(incidentInfo.trackerId);
 	arg.add(incidentInfo.serverId);
 	arg.add(incidentInfo.eventId);
@@ -4001,10 +4339,109 @@ void DBTablesMonitoring::addIncidentInfoWithoutTransaction(
 	arg.add(incidentInfo.doneRatio);
 	arg.add(incidentInfo.unifiedEventId);
 	arg.add(incidentInfo.commentCount);
+}
+
+void DBTablesMonitoring::addIncidentInfoWithoutTransaction(
+  DBAgent &dbAgent, const IncidentInfo &incidentInfo)
+{
+	DBAgent::InsertArg arg(tableProfileIncidents);
+	setIncidentInfoToInsertArg(arg, incidentInfo);
 	arg.upsertOnDuplicate = true;
 	dbAgent.insert(arg);
 }
 
+size_t DBTablesMonitoring::updateIncidentInfoVectWithoutTransaction(
+  DBAgent &dbAgent, IncidentInfoVect &incidentInfoVect)
+{
+	if (incidentInfoVect.empty())
+		return 0;
+
+	// A long IN clause is split to keep the statement moderate.
+	static const size_t MAX_IDENTIFIERS_IN_QUERY = 500;
+
+	typedef pair<IncidentTrackerIdType, string> IncidentKey;
+	map<IncidentKey, IncidentInfo> storedIncidents;
+	DBTermCStringProvider rhs(*dbAgent.getDBTermCodec());
+	auto selectIncidents = [&] (
+	  const map<IncidentTrackerIdType, string> &identifierLists) {
+		DBAgent::SelectExArg arg(tableProfileIncidents);
+		arg.add(IDX_INCIDENTS_TRACKER_ID);
+		arg.add(IDX_INCIDENTS_IDENTIFIER);
+		arg.add(IDX_INCIDENTS_SERVER_ID);
+		arg.add(IDX_INCIDENTS_EVENT_ID);
+		arg.add(IDX_INCIDENTS_TRIGGER_ID);
+		arg.add(IDX_INCIDENTS_LOCATION);
+		arg.add(IDX_INCIDENTS_UNIFIED_EVENT_ID);
+		SeparatorInjector orInjector(" OR ");
+		for (const auto &trackerIdentifiers : identifierLists) {
+			orInjector(arg.condition);
+			arg.condition += StringUtils::sprintf(
+			  "(%s=%s AND %s IN (%s))",
+			  COLUMN_DEF_INCIDENTS[IDX_INCIDENTS_TRACKER_ID].columnName,
+			  rhs(trackerIdentifiers.first),
+			  COLUMN_DEF_INCIDENTS[IDX_INCIDENTS_IDENTIFIER].columnName,
+			  trackerIdentifiers.second.c_str());
+		}
+		dbAgent.select(arg);
+
+		for (const auto &itemGroup :
+		     arg.dataTable->getItemGroupList()) {
+			ItemGroupStream itemGroupStream(itemGroup);
+			IncidentInfo stored;
+			itemGroupStream >> stored.trackerId;
+			itemGroupStream >> stored.identifier;
+			itemGroupStream >> stored.serverId;
+			itemGroupStream >> stored.eventId;
+			itemGroupStream >> stored.triggerId;
+			itemGroupStream >> stored.location;
+			itemGroupStream >> stored.unifiedEventId;
+			IncidentKey key(stored.trackerId, stored.identifier);
+			storedIncidents[key] = move(stored);
+		}
+	};
+
+	// Look up the stored rows with a SELECT statement per chunk
+	map<IncidentTrackerIdType, string> identifierLists;
+	size_t numIdentifiers = 0;
+	for (const auto &incidentInfo : incidentInfoVect) {
+		string &identifiers = identifierLists[incidentInfo.trackerId];
+		if (!identifiers.empty())
+			identifiers += ",";
+		identifiers += rhs(incidentInfo.identifier);
+		if (++numIdentifiers < MAX_IDENTIFIERS_IN_QUERY)
+			continue;
+		selectIncidents(identifierLists);
+		identifierLists.clear();
+		numIdentifiers = 0;
+	}
+	if (!identifierLists.empty())
+		selectIncidents(identifierLists);
+
+	// Write them back with multi-row upsert statements
+	DBAgent::BulkInsertArg bulkArg(tableProfileIncidents);
+	bulkArg.upsertOnDuplicate = true;
+	for (auto &incidentInfo : incidentInfoVect) {
+		IncidentKey key(incidentInfo.trackerId, incidentInfo.identifier);
+		auto it = storedIncidents.find(key);
+		if (it == storedIncidents.end())
+			continue;
+		const IncidentInfo &stored = it->second;
+		incidentInfo.serverId       = stored.serverId;
+		incidentInfo.eventId        = stored.eventId;
+		incidentInfo.triggerId      = stored.triggerId;
+		incidentInfo.location       = stored.location;
+		incidentInfo.unifiedEventId = stored.unifiedEventId;
+
+		DBAgent::InsertArg insertArg(tableProfileIncidents);
+		setIncidentInfoToInsertArg(insertArg, incidentInfo);
+		bulkArg.add(insertArg);
+	}
+	if (bulkArg.rows.empty())
+		return 0;
+	dbAgent.bulkInsert(bulkArg);
+	return bulkArg.rows.size();
+}
+
 static bool updateDB(
   DBAgent &dbAgent, const DBTables::Version &oldPackedVer, void *data)
 {
@@ -4028,8 +4465,8 @@ static void substIfNeeded(T &lhs, const T &rhs, const T &initialValue)
 		lhs = rhs;
 }
 
-bool DBTablesMonitoring::mergeTriggerInfo(
-  DBAgent &dbAgent, EventInfo &eventInfo)
+static void setTriggerInfoIfNeeded(
+  EventInfo &eventInfo, const TriggerInfo &trigInfo)
 {
 	struct {
 		void operator()(string &lhs, const string &rhs)
@@ -4050,37 +4487,94 @@ bool DBTablesMonitoring::mergeTriggerInfo(
 		}
 	} setIfNeeded;
 
-	// Get the corresponding trigger
-	TriggersQueryOption option(USER_ID_SYSTEM);
-	option.setTargetServerId(eventInfo.serverId);
-	option.setTargetId(eventInfo.triggerId);
-	DBAgent::SelectExArg arg(tableProfileTriggers);
-	arg.add(IDX_TRIGGERS_SEVERITY);
-	arg.add(IDX_TRIGGERS_GLOBAL_HOST_ID);
-	arg.add(IDX_TRIGGERS_HOST_ID_IN_SERVER);
-	arg.add(IDX_TRIGGERS_HOSTNAME);
-	arg.add(IDX_TRIGGERS_BRIEF);
-	arg.add(IDX_TRIGGERS_EXTENDED_INFO);
-	arg.condition = option.getCondition();
-	dbAgent.select(arg);
-
-	const ItemGroupList &grpList = arg.dataTable->getItemGroupList();
-	if (grpList.empty())
-		return false;
-	ItemGroupStream itemGroupStream(*grpList.begin());
-	TriggerInfo trigInfo;
-	itemGroupStream >> trigInfo.severity;
-	itemGroupStream >> trigInfo.globalHostId;
-	itemGroupStream >> trigInfo.hostIdInServer;
-	itemGroupStream >> trigInfo.hostName;
-	itemGroupStream >> trigInfo.brief;
-	itemGroupStream >> trigInfo.extendedInfo;
-
 	setIfNeeded(eventInfo.severity,       trigInfo.severity);
 	setIfNeeded(eventInfo.globalHostId,   trigInfo.globalHostId);
 	setIfNeeded(eventInfo.hostIdInServer, trigInfo.hostIdInServer);
 	setIfNeeded(eventInfo.hostName,       trigInfo.hostName);
 	setIfNeeded(eventInfo.brief,          trigInfo.brief);
 	setIfNeeded(eventInfo.extendedInfo,   trigInfo.extendedInfo);
+}
+
+static bool hasUnsetTriggerInfo(const EventInfo &eventInfo)
+{
+	return eventInfo.severity == TRIGGER_SEVERITY_UNKNOWN ||
+	       eventInfo.globalHostId == INVALID_HOST_ID ||
+	       eventInfo.hostIdInServer.empty() ||
+	       eventInfo.hostName.empty() ||
+	       eventInfo.brief.empty() ||
+	       eventInfo.extendedInfo.empty();
+}
+
+bool DBTablesMonitoring::mergeTriggerInfo(
+  DBAgent &dbAgent, EventInfo &eventInfo)
+{
+	TriggerInfo trigInfo;
+	if (!selectTriggerInfo(dbAgent, eventInfo.serverId,
+	                       eventInfo.triggerId, trigInfo))
+		return false;
+	setTriggerInfoIfNeeded(eventInfo, trigInfo);
 	return true;
 }
+
+void DBTablesMonitoring::mergeTriggerInfo(
+  DBAgent &dbAgent, EventInfoList &eventInfoList)
+{
+	// A long IN clause is split to keep the statement moderate.
+	static const size_t MAX_TRIGGER_IDS_IN_QUERY = 500;
+
+	typedef pair<ServerIdType, TriggerIdType> TriggerKey;
+	TriggerInfoCache &triggerInfoCache = TriggerInfoCache::getInstance();
+	map<TriggerKey, TriggerInfo> triggerInfoMap;
+	map<ServerIdType, set<TriggerIdType>> triggerIdSetMap;
+	for (const auto &eventInfo : eventInfoList) {
+		if (!hasUnsetTriggerInfo(eventInfo))
+			continue;
+		const TriggerKey key(eventInfo.serverId, eventInfo.triggerId);
+		if (triggerInfoMap.find(key) != triggerInfoMap.end())
+			continue;
+		TriggerInfo trigInfo;
+		if (triggerInfoCache.get(key.first, key.second, trigInfo)) {
+			triggerInfoMap.insert(make_pair(key, trigInfo));
+			continue;
+		}
+		triggerIdSetMap[eventInfo.serverId].insert(eventInfo.triggerId);
+	}
+
+	const uint64_t generation = triggerInfoCache.getGeneration();
+	auto selectTriggers = [&] (const ServerIdType &serverId,
+	                           const TriggerIdList &idList) {
+		DBAgent::SelectExArg arg(tableProfileTriggers);
+		setupTriggerSelectArg(arg, serverId, idList);
+		dbAgent.select(arg);
+
+		for (const auto &itemGrp: arg.dataTable->getItemGroupList()) {
+			TriggerInfo trigInfo;
+			readTriggerInfo(itemGrp, trigInfo);
+			triggerInfoCache.fill(trigInfo, generation);
+			const TriggerKey key(serverId, trigInfo.id);
+			triggerInfoMap.insert(make_pair(key, trigInfo));
+		}
+	};
+
+	for (const auto &triggerIdSetPair : triggerIdSetMap) {
+		const ServerIdType &serverId = triggerIdSetPair.first;
+		TriggerIdList idList;
+		for (const auto &triggerId : triggerIdSetPair.second) {
+			idList.push_back(triggerId);
+			if (idList.size() < MAX_TRIGGER_IDS_IN_QUERY)
+				continue;
+			selectTriggers(serverId, idList);
+			idList.clear();
+		}
+		if (!idList.empty())
+			selectTriggers(serverId, idList);
+	}
+
+	for (auto &eventInfo : eventInfoList) {
+		const TriggerKey key(eventInfo.serverId, eventInfo.triggerId);
+		auto itr = triggerInfoMap.find(key);
+		if (itr == triggerInfoMap.end())
+			continue;
+		setTriggerInfoIfNeeded(eventInfo, itr->second);
+	}
+}
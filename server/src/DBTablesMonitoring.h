@@ -21,6 +21,7 @@
 #define DBTablesMonitoring_h
 
 #include <list>
+#include <array>
 #include "DBTables.h"
 #include "DataQueryOption.h"
 #include "DBTablesUser.h"
@@ -252,6 +253,22 @@ public:
 	 */
 	bool getTriggerInfo(TriggerInfo &triggerInfo,
 	                    const TriggersQueryOption &option);
+
+	/**
+	 * Get a trigger with TriggerInfoCache. The DB is read only when
+	 * the trigger isn't cached.
+	 *
+	 * @param triggerInfo
+	 * Obtained information is copied to this instance.
+	 *
+	 * @param serverId  A server ID to be obtained.
+	 * @param triggerId A trigger ID to be obtained.
+	 *
+	 * @return true if the trigger information is found. Otherwise false.
+	 */
+	bool getTriggerInfo(TriggerInfo &triggerInfo,
+	                    const ServerIdType &serverId,
+	                    const TriggerIdType &triggerId);
 	void getTriggerInfoList(TriggerInfoList &triggerInfoList,
 				const TriggersQueryOption &option);
 	void setTriggerInfoList(const TriggerInfoList &triggerInfoList,
@@ -275,6 +292,40 @@ public:
 	                              const EventsQueryOption &option,
 				      IncidentInfoVect *incidentInfoVect = NULL);
 
+	/**
+	 * A function called for each event by forEachEventInfo().
+	 *
+	 * @param eventInfo An EventInfo instance. It can be moved.
+	 * @param incidentInfo
+	 * An IncidentInfo instance when forEachEventInfo() is called with
+	 * withIncidentInfo = true. Otherwise NULL.
+	 *
+	 * @return true to continue, or false to stop the iteration.
+	 */
+	typedef std::function<bool (EventInfo &eventInfo,
+	                            IncidentInfo *incidentInfo)>
+	  EventInfoHandler;
+
+	/**
+	 * Get events one by one without storing the whole result.
+	 *
+	 * Rows are streamed from the database, so the memory usage doesn't
+	 * depend on the number of the events. The handler must not access
+	 * the database with the DBAgent of the calling thread, because the
+	 * connection is occupied during the iteration.
+	 *
+	 * @param option A query option.
+	 * @param handler A function called for each event.
+	 * @param withIncidentInfo
+	 * If this is true, the incident of each event is also passed to the
+	 * handler.
+	 *
+	 * @return A HatoholError instance.
+	 */
+	HatoholError forEachEventInfo(const EventsQueryOption &option,
+	                              const EventInfoHandler &handler,
+	                              const bool &withIncidentInfo = false);
+
 	/**
 	 * get the maximum event ID that belongs to the specified server
 	 *
@@ -346,6 +397,55 @@ public:
 	  std::vector<EventSeverityStatistics> &importantEventGroupVect,
 	  const EventsQueryOption &option);
 
+	typedef std::array<size_t, NUM_TRIGGER_SEVERITY> TriggerSeverityCounts;
+	typedef std::map<HostgroupIdType, TriggerSeverityCounts>
+	  BadTriggerCountMatrix;
+
+	/**
+	 * Get the number of bad triggers per hostgroup and severity with
+	 * one grouped query.
+	 *
+	 * @param matrix
+	 * The numbers are stored in this parameter. A hostgroup without
+	 * bad triggers doesn't appear in it.
+	 *
+	 * @param option
+	 * A query option. The target server has to be specified. The
+	 * triggers are counted in the same way as getNumberOfBadTriggers().
+	 *
+	 * @return
+	 * HTERR_INVALID_PARAMETER if the target server isn't specified.
+	 * Otherwise HTERR_OK.
+	 */
+	HatoholError getBadTriggerCountMatrix(
+	  BadTriggerCountMatrix &matrix, const TriggersQueryOption &option);
+
+	struct HostStatusCounts {
+		size_t numGoodHosts;
+		size_t numBadHosts;
+	};
+	typedef std::map<HostgroupIdType, HostStatusCounts> HostStatusCountMap;
+
+	/**
+	 * Get the number of good and bad hosts per hostgroup with one
+	 * grouped query.
+	 *
+	 * @param countMap
+	 * The numbers are stored in this parameter. A hostgroup without
+	 * triggers doesn't appear in it.
+	 *
+	 * @param option
+	 * A query option. The target server has to be specified. The hosts
+	 * are counted in the same way as getNumberOfGoodHosts() and
+	 * getNumberOfBadHosts().
+	 *
+	 * @return
+	 * HTERR_INVALID_PARAMETER if the target server isn't specified.
+	 * Otherwise HTERR_OK.
+	 */
+	HatoholError getHostStatusCountMap(HostStatusCountMap &countMap,
+	                                   const TriggersQueryOption &option);
+
 	void addIncidentInfo(IncidentInfo *incidentInfo);
 	HatoholError getIncidentInfoVect(IncidentInfoVect &incidentInfoVect,
 					 const IncidentsQueryOption &option);
@@ -365,6 +465,24 @@ public:
 	 */
 	HatoholError updateIncidentInfo(IncidentInfo &incidentInfo);
 
+	/**
+	 * Update incident information in bulk. The existing rows are looked
+	 * up at once and written back with a multi-row upsert in a single
+	 * transaction. Incidents which aren't stored in the DB are skipped
+	 * as updateIncidentInfo() does. The monitoring system side
+	 * information of each element is overwritten with the stored one.
+	 *
+	 * @param incidentInfoVect
+	 * IncidentInfo instances to update.
+	 *
+	 * @param hooks
+	 * Hooks called in the same transaction. It can be NULL.
+	 *
+	 * @return The number of the updated incidents.
+	 */
+	size_t updateIncidentInfoVect(IncidentInfoVect &incidentInfoVect,
+	                              DBAgent::TransactionHooks *hooks = NULL);
+
 	struct SystemInfo {
 		StatisticsCounter::Slot
 		  eventsCounterPrevSlots[NUM_EVENTS_COUNTERS],
@@ -389,6 +507,18 @@ protected:
 	  DBAgent &dbAgent, const TriggerInfo &triggerInfo);
 	static void addEventInfoWithoutTransaction(
 	  DBAgent &dbAgent, EventInfo &eventInfo);
+
+	/**
+	 * Add events with multi-row INSERT statements.
+	 * The corresponding triggers are also looked up at once.
+	 *
+	 * @param dbAgent       A DBAgent instance.
+	 * @param eventInfoList
+	 * EventInfo instances to be added. unifiedId of each element is
+	 * set on return.
+	 */
+	static void addEventInfoListWithoutTransaction(
+	  DBAgent &dbAgent, EventInfoList &eventInfoList);
 	static void addItemInfoWithoutTransaction(
 	  DBAgent &dbAgent, const ItemInfo &itemInfo);
 	static void addItemCategoryWithoutTransaction(
@@ -397,6 +527,8 @@ protected:
 	  DBAgent &dbAgent, const MonitoringServerStatus &serverStatus);
 	static void addIncidentInfoWithoutTransaction(
 	  DBAgent &dbAgent, const IncidentInfo &incidentInfo);
+	static size_t updateIncidentInfoVectWithoutTransaction(
+	  DBAgent &dbAgent, IncidentInfoVect &incidentInfoVect);
 
 	/**
 	 * Fill the following members if they are not set, with the
@@ -408,6 +540,8 @@ protected:
 	 *   - brief
 	 *   - extenededInfo
 	 *
+	 * The trigger is looked up in TriggerInfoCache first.
+	 *
 	 * @param eventInfo An EventInfo instance to be set.
 	 *
 	 * @return
@@ -416,6 +550,17 @@ protected:
 	 */
 	static bool mergeTriggerInfo(DBAgent &dbAgent, EventInfo &eventInfo);
 
+	/**
+	 * The batch version of the above mergeTriggerInfo().
+	 * The triggers that aren't cached are obtained with a SELECT
+	 * statement per server (and per a chunk of trigger IDs) instead of
+	 * one per event.
+	 *
+	 * @param eventInfoList EventInfo instances to be set.
+	 */
+	static void mergeTriggerInfo(DBAgent &dbAgent,
+	                             EventInfoList &eventInfoList);
+
 	size_t getNumberOfTriggers(const TriggersQueryOption &option,
 				   const std::string &additionalCondition);
 
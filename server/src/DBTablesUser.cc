@@ -19,6 +19,8 @@
 
 #include <stdint.h>
 #include "DBTablesUser.h"
+#include "ActionRuleIndex.h"
+#include "DataGeneration.h"
 #include "DBTablesConfig.h"
 #include "ItemGroupStream.h"
 #include "DBHatohol.h"
@@ -496,6 +498,7 @@ void DBTablesUser::init(void)
 void DBTablesUser::reset(void)
 {
 	getSetupInfo().initialized = false;
+	DataGeneration::bump(DATA_GENERATION_USER);
 }
 
 const DBTables::SetupInfo &DBTablesUser::getConstSetupInfo(void)
@@ -516,6 +519,8 @@ DBTablesUser::~DBTablesUser()
 HatoholError DBTablesUser::addUserInfo(
   UserInfo &userInfo, const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	HatoholError err;
 	if (!privilege.has(OPPRVLG_CREATE_USER))
 		return HatoholError(HTERR_NO_PRIVILEGE);
@@ -572,6 +577,8 @@ HatoholError DBTablesUser::addUserInfo(
 		}
 	} trx(userInfo);
 	getDBAgent().runTransaction(trx);
+	if (trx.err == HTERR_OK)
+		ActionRuleIndex::invalidate();
 	return trx.err;
 }
 
@@ -599,6 +606,8 @@ HatoholError DBTablesUser::hasPrivilegeForUpdateUserInfo(
 HatoholError DBTablesUser::updateUserInfo(
   UserInfo &userInfo, const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	HatoholError err = hasPrivilegeForUpdateUserInfo(userInfo, privilege);
 	if (err != HTERR_OK)
 		return err;
@@ -672,6 +681,8 @@ HatoholError DBTablesUser::updateUserInfoFlags(
   OperationPrivilegeFlag &oldUserFlag, OperationPrivilegeFlag &updateUserFlag,
   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	if (!privilege.has(OPPRVLG_UPDATE_USER))
 		return HTERR_NO_PRIVILEGE;
 	HatoholError err;
@@ -712,6 +723,8 @@ HatoholError DBTablesUser::updateUserInfoFlags(
 HatoholError DBTablesUser::deleteUserInfo(
   const UserIdType userId, const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	using mlpl::StringUtils::sprintf;
 	if (!privilege.has(OPPRVLG_DELETE_USER))
 		return HTERR_NO_PRIVILEGE;
@@ -740,6 +753,7 @@ HatoholError DBTablesUser::deleteUserInfo(
 		}
 	} trx(userId);
 	getDBAgent().runTransaction(trx);
+	ActionRuleIndex::invalidate();
 	return HTERR_OK;
 }
 
@@ -778,6 +792,8 @@ UserIdType DBTablesUser::getUserId(const string &user, const string &password)
 HatoholError DBTablesUser::addAccessInfo(AccessInfo &accessInfo,
 					 const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	if (!privilege.has(OPPRVLG_UPDATE_USER))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -820,6 +836,8 @@ HatoholError DBTablesUser::addAccessInfo(AccessInfo &accessInfo,
 HatoholError DBTablesUser::deleteAccessInfo(const AccessInfoIdType id,
 					    const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	if (!privilege.has(OPPRVLG_UPDATE_USER))
 		return HatoholError(HTERR_NO_PRIVILEGE);
 
@@ -970,6 +988,8 @@ void DBTablesUser::getServerHostGrpSetMap(
 HatoholError DBTablesUser::addUserRoleInfo(UserRoleInfo &userRoleInfo,
 					   const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	HatoholError err;
 	if (!privilege.has(OPPRVLG_CREATE_USER_ROLE))
 		return HatoholError(HTERR_NO_PRIVILEGE);
@@ -1031,6 +1051,8 @@ HatoholError DBTablesUser::addUserRoleInfo(UserRoleInfo &userRoleInfo,
 HatoholError DBTablesUser::updateUserRoleInfo(
   UserRoleInfo &userRoleInfo, const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	HatoholError err;
 	if (!privilege.has(OPPRVLG_UPDATE_ALL_USER_ROLE))
 		return HatoholError(HTERR_NO_PRIVILEGE);
@@ -1099,6 +1121,8 @@ HatoholError DBTablesUser::updateUserRoleInfo(
 HatoholError DBTablesUser::deleteUserRoleInfo(
   const UserRoleIdType userRoleId, const OperationPrivilege &privilege)
 {
+	DataGeneration::Bumper bumper(DATA_GENERATION_USER);
+
 	if (!privilege.has(OPPRVLG_DELETE_ALL_USER_ROLE))
 		return HTERR_NO_PRIVILEGE;
 
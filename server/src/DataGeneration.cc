@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <unistd.h>
+#include <sys/time.h>
+#include "HatoholException.h"
+#include "DataGeneration.h"
+
+using namespace std;
+using namespace mlpl;
+
+static atomic<uint64_t> g_generations[NUM_DATA_GENERATION_TYPES];
+static atomic<time_t> g_lastModifiedTimes[NUM_DATA_GENERATION_TYPES];
+
+static uint64_t makeEpoch(void)
+{
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	const uint64_t usec = tv.tv_sec * 1000000ULL + tv.tv_usec;
+	return (usec << 16) ^ getpid();
+}
+
+static const uint64_t g_epoch = makeEpoch();
+static const time_t g_startTime = time(NULL);
+
+static void assertValidType(const DataGenerationType &type)
+{
+	HATOHOL_ASSERT(type >= 0 && type < NUM_DATA_GENERATION_TYPES,
+	               "Invalid type: %d", type);
+}
+
+// ---------------------------------------------------------------------------
+// DataGeneration::Bumper
+// ---------------------------------------------------------------------------
+DataGeneration::Bumper::Bumper(const DataGenerationType &type)
+: m_type(type)
+{
+	assertValidType(type);
+}
+
+DataGeneration::Bumper::~Bumper()
+{
+	bump(m_type);
+}
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+void DataGeneration::bump(const DataGenerationType &type)
+{
+	assertValidType(type);
+	g_lastModifiedTimes[type] = time(NULL);
+	g_generations[type]++;
+}
+
+uint64_t DataGeneration::get(const DataGenerationType &type)
+{
+	assertValidType(type);
+	return g_generations[type];
+}
+
+time_t DataGeneration::getLastModifiedTime(const DataGenerationType &type)
+{
+	assertValidType(type);
+	const time_t lastModifiedTime = g_lastModifiedTimes[type];
+	return lastModifiedTime ? lastModifiedTime : g_startTime;
+}
+
+uint64_t DataGeneration::getEpoch(void)
+{
+	return g_epoch;
+}
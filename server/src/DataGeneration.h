@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DataGeneration_h
+#define DataGeneration_h
+
+#include <ctime>
+#include <stdint.h>
+#include <vector>
+
+enum DataGenerationType {
+	DATA_GENERATION_TRIGGER,
+	DATA_GENERATION_EVENT,
+	DATA_GENERATION_ITEM,
+	DATA_GENERATION_INCIDENT,
+	DATA_GENERATION_HOST,
+	DATA_GENERATION_CONFIG,
+	DATA_GENERATION_USER,
+	DATA_GENERATION_ACTION,
+	NUM_DATA_GENERATION_TYPES,
+};
+
+typedef std::vector<DataGenerationType> DataGenerationTypeVect;
+
+/**
+ * Counters that are incremented every time the data of the DB tables is
+ * changed by this process. A reader can tell that the data isn't changed
+ * since it read them last when the counters are the same.
+ *
+ * All methods are MT-safe and don't access the DB.
+ */
+class DataGeneration {
+public:
+	/**
+	 * Increment the counter when it's destroyed. The counter has to be
+	 * incremented after the change is committed. Otherwise a reader can
+	 * pair the new generation with the data before the change.
+	 */
+	class Bumper {
+	public:
+		Bumper(const DataGenerationType &type);
+		virtual ~Bumper();
+	private:
+		DataGenerationType m_type;
+	};
+
+	static void bump(const DataGenerationType &type);
+	static uint64_t get(const DataGenerationType &type);
+
+	/**
+	 * Get the time when the data was changed last.
+	 *
+	 * @param type A type of the data.
+	 * @return
+	 * The time of the last bump(). It is the start time of the process
+	 * when the data hasn't been changed yet.
+	 */
+	static time_t getLastModifiedTime(const DataGenerationType &type);
+
+	/**
+	 * Get a value that identifies the running process. The counters are
+	 * meaningful only with it because they restart from 0 every time.
+	 *
+	 * @return An identifier of the process.
+	 */
+	static uint64_t getEpoch(void);
+};
+
+#endif // DataGeneration_h
@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <Logger.h>
+#include <deque>
+#include <set>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include "EventIngestPipeline.h"
+#include "ThreadLocalDBCache.h"
+#include "DBTablesLastInfo.h"
+#include "ActionManager.h"
+#include "HatoholException.h"
+
+using namespace std;
+using namespace mlpl;
+
+const size_t EventIngestPipeline::DEFAULT_QUEUE_CAPACITY = 64;
+const size_t EventIngestPipeline::MAX_COALESCED_EVENTS = 10000;
+const size_t EventIngestPipeline::MAX_PERSIST_TRIALS = 3;
+const size_t EventIngestPipeline::MIN_PERSIST_RETRY_INTERVAL_MSEC = 100;
+const size_t EventIngestPipeline::MAX_PERSIST_RETRY_INTERVAL_MSEC = 5000;
+
+struct EventIngestPipeline::Impl
+{
+	// Failures that nobody waits for are forgotten beyond this.
+	static const size_t MAX_KEPT_FAILED_TICKETS = 1024;
+
+	struct Batch {
+		EventInfoList eventInfoList;
+		string lastInfo;
+		vector<Ticket> tickets;
+	};
+
+	struct StageContext {
+		deque<Batch> queue;
+		bool running;
+
+		StageContext(void)
+		: running(false)
+		{
+		}
+	};
+
+	EventIngestPipeline &m_pipeline;
+	const ServerIdType m_serverId;
+	WorkerPool &m_pool;
+	const size_t m_queueCapacity;
+	mutable mutex m_mutex;
+	condition_variable m_cond;
+	StageContext m_stages[NUM_STAGES];
+	bool m_stopping;
+	Ticket m_lastTicket;
+	// Tickets up to this one are stored or given up.
+	Ticket m_finishedTicket;
+	set<Ticket> m_failedTickets;
+
+	Impl(EventIngestPipeline &pipeline, const ServerIdType &serverId,
+	     WorkerPool &pool, const size_t &queueCapacity)
+	: m_pipeline(pipeline),
+	  m_serverId(serverId),
+	  m_pool(pool),
+	  m_queueCapacity(queueCapacity),
+	  m_stopping(false),
+	  m_lastTicket(0),
+	  m_finishedTicket(0)
+	{
+		HATOHOL_ASSERT(queueCapacity > 0, "queueCapacity must be > 0");
+	}
+
+	bool isFull(const Stage &stage) const
+	{
+		return m_stages[stage].queue.size() >= m_queueCapacity;
+	}
+
+	bool isIdle(void) const
+	{
+		for (size_t i = 0; i < NUM_STAGES; i++) {
+			const StageContext &ctx = m_stages[i];
+			if (ctx.running || !ctx.queue.empty())
+				return false;
+		}
+		return true;
+	}
+
+	// m_mutex has to be locked by the caller.
+	void scheduleIfReady(const Stage &stage)
+	{
+		StageContext &ctx = m_stages[stage];
+		if (ctx.running || ctx.queue.empty())
+			return;
+		const int next = stage + 1;
+		if (next < NUM_STAGES && isFull(static_cast<Stage>(next)))
+			return;
+		ctx.running = true;
+		m_pool.post([this, stage] { run(stage); });
+	}
+
+	void scheduleAll(void)
+	{
+		for (int i = NUM_STAGES - 1; i >= 0; i--)
+			scheduleIfReady(static_cast<Stage>(i));
+		m_cond.notify_all();
+	}
+
+	void run(const Stage &stage)
+	{
+		switch (stage) {
+		case STAGE_COALESCE:
+			coalesce();
+			break;
+		case STAGE_PERSIST:
+			persist();
+			break;
+		case STAGE_DISPATCH_ACTION:
+			dispatchActions();
+			break;
+		default:
+			HATOHOL_ASSERT(false, "Unknown stage: %d", stage);
+		}
+	}
+
+	static void append(Batch &dest, Batch &src)
+	{
+		dest.eventInfoList.splice(dest.eventInfoList.end(),
+		                          src.eventInfoList);
+		if (!src.lastInfo.empty())
+			dest.lastInfo = src.lastInfo;
+		dest.tickets.insert(dest.tickets.end(),
+		                    src.tickets.begin(), src.tickets.end());
+	}
+
+	void coalesce(void)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		deque<Batch> &inQueue = m_stages[STAGE_COALESCE].queue;
+		deque<Batch> &outQueue = m_stages[STAGE_PERSIST].queue;
+		// Batches that wait for the persist stage are grown while
+		// the stage is busy so that a slow commit is amortized.
+		while (!inQueue.empty()) {
+			Batch &batch = inQueue.front();
+			if (outQueue.empty() ||
+			    outQueue.back().eventInfoList.size() +
+			    batch.eventInfoList.size() > MAX_COALESCED_EVENTS) {
+				if (isFull(STAGE_PERSIST))
+					break;
+				outQueue.emplace_back();
+			}
+			append(outQueue.back(), batch);
+			inQueue.pop_front();
+		}
+		m_stages[STAGE_COALESCE].running = false;
+		scheduleAll();
+	}
+
+	bool tryPersist(Batch &batch)
+	{
+		try {
+			m_pipeline.persist(batch.eventInfoList, batch.lastInfo);
+			return true;
+		} catch (const HatoholException &e) {
+			MLPL_ERR("Failed to store events: serverId: %"
+			         FMT_SERVER_ID ", %s\n",
+			         m_serverId, e.getFancyMessage().c_str());
+		}
+		return false;
+	}
+
+	void persist(void)
+	{
+		Batch batch;
+		{
+			lock_guard<mutex> lock(m_mutex);
+			batch = move(m_stages[STAGE_PERSIST].queue.front());
+			m_stages[STAGE_PERSIST].queue.pop_front();
+		}
+
+		// A batch is retried only a few times so that the worker
+		// isn't occupied while the DB is down. The waiters of a
+		// given up batch let the sender deliver it again.
+		bool succeeded = false;
+		size_t intervalMSec = MIN_PERSIST_RETRY_INTERVAL_MSEC;
+		for (size_t trial = 1; !(succeeded = tryPersist(batch));
+		     trial++) {
+			unique_lock<mutex> lock(m_mutex);
+			if (trial >= MAX_PERSIST_TRIALS)
+				break;
+			const bool stopping = m_cond.wait_for(
+			  lock, chrono::milliseconds(intervalMSec),
+			  [this] { return m_stopping; });
+			if (stopping)
+				break;
+			intervalMSec = min(intervalMSec * 2,
+			                   MAX_PERSIST_RETRY_INTERVAL_MSEC);
+		}
+		if (!succeeded) {
+			MLPL_ERR("Gave up storing %zd events: "
+			         "serverId: %" FMT_SERVER_ID "\n",
+			         batch.eventInfoList.size(), m_serverId);
+		}
+
+		lock_guard<mutex> lock(m_mutex);
+		finishTickets(batch.tickets, succeeded);
+		if (succeeded && !batch.eventInfoList.empty())
+			m_stages[STAGE_DISPATCH_ACTION].queue.push_back(
+			  move(batch));
+		m_stages[STAGE_PERSIST].running = false;
+		scheduleAll();
+	}
+
+	// m_mutex has to be locked by the caller.
+	void finishTickets(const vector<Ticket> &tickets,
+	                   const bool &succeeded)
+	{
+		if (tickets.empty())
+			return;
+		if (!succeeded) {
+			m_failedTickets.insert(tickets.begin(), tickets.end());
+			while (m_failedTickets.size() > MAX_KEPT_FAILED_TICKETS)
+				m_failedTickets.erase(m_failedTickets.begin());
+		}
+		// The batches are stored in the order of the tickets.
+		m_finishedTicket = tickets.back();
+	}
+
+	void dispatchActions(void)
+	{
+		Batch batch;
+		{
+			lock_guard<mutex> lock(m_mutex);
+			deque<Batch> &queue =
+			  m_stages[STAGE_DISPATCH_ACTION].queue;
+			batch = move(queue.front());
+			queue.pop_front();
+		}
+		try {
+			m_pipeline.dispatchActions(batch.eventInfoList);
+		} catch (const HatoholException &e) {
+			MLPL_ERR("Failed to dispatch actions: serverId: %"
+			         FMT_SERVER_ID ", %s\n",
+			         m_serverId, e.getFancyMessage().c_str());
+		}
+
+		lock_guard<mutex> lock(m_mutex);
+		m_stages[STAGE_DISPATCH_ACTION].running = false;
+		scheduleAll();
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+EventIngestPipeline::EventIngestPipeline(const ServerIdType &serverId,
+                                         WorkerPool &pool,
+                                         const size_t &queueCapacity)
+: m_impl(new Impl(*this, serverId, pool, queueCapacity))
+{
+}
+
+EventIngestPipeline::~EventIngestPipeline()
+{
+	{
+		lock_guard<mutex> lock(m_impl->m_mutex);
+		m_impl->m_stopping = true;
+	}
+	m_impl->m_cond.notify_all();
+	flush();
+}
+
+EventIngestPipeline::Ticket EventIngestPipeline::push(
+  EventInfoList &eventInfoList, const string &lastInfo)
+{
+	unique_lock<mutex> lock(m_impl->m_mutex);
+	if (eventInfoList.empty() && lastInfo.empty())
+		return 0;
+	m_impl->m_cond.wait(lock, [&] {
+		return !m_impl->isFull(STAGE_COALESCE);
+	});
+	m_impl->m_stages[STAGE_COALESCE].queue.emplace_back();
+	Impl::Batch &batch = m_impl->m_stages[STAGE_COALESCE].queue.back();
+	batch.eventInfoList.splice(batch.eventInfoList.end(), eventInfoList);
+	batch.lastInfo = lastInfo;
+	batch.tickets.push_back(++m_impl->m_lastTicket);
+	m_impl->scheduleIfReady(STAGE_COALESCE);
+	return m_impl->m_lastTicket;
+}
+
+bool EventIngestPipeline::waitPersisted(const Ticket &ticket)
+{
+	unique_lock<mutex> lock(m_impl->m_mutex);
+	m_impl->m_cond.wait(lock, [&] {
+		return m_impl->m_finishedTicket >= ticket;
+	});
+	return m_impl->m_failedTickets.erase(ticket) == 0;
+}
+
+void EventIngestPipeline::flush(void)
+{
+	unique_lock<mutex> lock(m_impl->m_mutex);
+	m_impl->m_cond.wait(lock, [&] { return m_impl->isIdle(); });
+}
+
+size_t EventIngestPipeline::getQueueDepth(const Stage &stage) const
+{
+	HATOHOL_ASSERT(stage >= 0 && stage < NUM_STAGES,
+	               "Invalid stage: %d", stage);
+	lock_guard<mutex> lock(m_impl->m_mutex);
+	return m_impl->m_stages[stage].queue.size();
+}
+
+const char *EventIngestPipeline::getStageName(const Stage &stage)
+{
+	static const char *names[NUM_STAGES] = {
+		"coalesce",
+		"persist",
+		"dispatchAction",
+	};
+	HATOHOL_ASSERT(stage >= 0 && stage < NUM_STAGES,
+	               "Invalid stage: %d", stage);
+	return names[stage];
+}
+
+// ---------------------------------------------------------------------------
+// Protected methods
+// ---------------------------------------------------------------------------
+struct LastInfoUpserter : public DBAgent::TransactionHooks {
+	const ServerIdType serverId;
+	const string &lastInfo;
+
+	LastInfoUpserter(const ServerIdType &_serverId, const string &_lastInfo)
+	: serverId(_serverId),
+	  lastInfo(_lastInfo)
+	{
+	}
+
+	virtual bool postAction(DBAgent &dbAgent) override
+	{
+		ThreadLocalDBCache cache;
+		OperationPrivilege privilege(USER_ID_SYSTEM);
+		LastInfoDef lastInfoDef;
+		lastInfoDef.id = AUTO_INCREMENT_VALUE;
+		lastInfoDef.dataType = LAST_INFO_EVENT;
+		lastInfoDef.value = lastInfo;
+		lastInfoDef.serverId = serverId;
+		const bool useTransaction = false;
+		cache.getLastInfo().upsertLastInfo(lastInfoDef, privilege,
+		                                   useTransaction);
+		return true;
+	}
+};
+
+void EventIngestPipeline::persist(EventInfoList &eventInfoList,
+                                  const string &lastInfo)
+{
+	ThreadLocalDBCache cache;
+	LastInfoUpserter upserter(m_impl->m_serverId, lastInfo);
+	cache.getMonitoring().addEventInfoList(
+	  eventInfoList, lastInfo.empty() ? NULL : &upserter);
+}
+
+void EventIngestPipeline::dispatchActions(const EventInfoList &eventInfoList)
+{
+	ActionManager actionManager;
+	actionManager.checkEvents(eventInfoList);
+}
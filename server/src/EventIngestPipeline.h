@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef EventIngestPipeline_h
+#define EventIngestPipeline_h
+
+#include <string>
+#include <memory>
+#include <stdint.h>
+#include "Monitoring.h"
+#include "WorkerPool.h"
+
+/**
+ * Store events notified by a monitoring server and dispatch actions for
+ * them asynchronously.
+ *
+ * Events pushed by push() go through the following stages in order.
+ * Each stage has a bounded queue and runs on a WorkerPool. A stage
+ * isn't started while the queue of the next stage is full. push()
+ * blocks while the queue of the first stage is full.
+ *
+ * - STAGE_COALESCE: Merges pushed lists into a batch waiting for the
+ *   persist stage.
+ * - STAGE_PERSIST: Stores a batch in one transaction. A batch that
+ *   fails to be stored is retried up to MAX_PERSIST_TRIALS times with
+ *   an increasing interval. Then it's given up and reported to
+ *   waitPersisted(), so that the sender can deliver it again.
+ * - STAGE_DISPATCH_ACTION: Runs ActionManager::checkEvents().
+ *
+ * A stage runs on at most one worker at a time for an instance, so the
+ * order of the events is kept.
+ */
+class EventIngestPipeline {
+public:
+	enum Stage {
+		STAGE_COALESCE,
+		STAGE_PERSIST,
+		STAGE_DISPATCH_ACTION,
+		NUM_STAGES,
+	};
+
+	typedef uint64_t Ticket;
+
+	static const size_t DEFAULT_QUEUE_CAPACITY;
+	static const size_t MAX_COALESCED_EVENTS;
+	static const size_t MAX_PERSIST_TRIALS;
+	static const size_t MIN_PERSIST_RETRY_INTERVAL_MSEC;
+	static const size_t MAX_PERSIST_RETRY_INTERVAL_MSEC;
+
+	EventIngestPipeline(const ServerIdType &serverId,
+	                    WorkerPool &pool = WorkerPool::getShared(),
+	                    const size_t &queueCapacity
+	                      = DEFAULT_QUEUE_CAPACITY);
+
+	/**
+	 * Wait for all queued events to be processed. A batch that fails
+	 * to be stored isn't retried in the destructor.
+	 *
+	 * NOTE: A subclass that overrides persist() or dispatchActions()
+	 *       has to call flush() in its destructor.
+	 */
+	virtual ~EventIngestPipeline();
+
+	/**
+	 * Queue events. This method is MT-safe.
+	 *
+	 * @param eventInfoList
+	 * Events to be stored. The content is moved into the pipeline.
+	 * @param lastInfo
+	 * The last info saved with the events. It's ignored if empty.
+	 *
+	 * @return A ticket to pass to waitPersisted().
+	 */
+	Ticket push(EventInfoList &eventInfoList, const std::string &lastInfo);
+
+	/**
+	 * Wait until the events of a push() are stored or given up.
+	 * This method is MT-safe.
+	 *
+	 * @param ticket A ticket returned by push().
+	 *
+	 * @return
+	 * true if the events have been committed. false if they have been
+	 * given up.
+	 */
+	bool waitPersisted(const Ticket &ticket);
+
+	/**
+	 * Wait until all stages are empty and idle.
+	 */
+	void flush(void);
+
+	/**
+	 * Get the number of batches in the queue of a stage.
+	 *
+	 * @param stage A stage.
+	 * @return The number of the queued batches.
+	 */
+	size_t getQueueDepth(const Stage &stage) const;
+
+	static const char *getStageName(const Stage &stage);
+
+protected:
+	virtual void persist(EventInfoList &eventInfoList,
+	                     const std::string &lastInfo);
+	virtual void dispatchActions(const EventInfoList &eventInfoList);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // EventIngestPipeline_h
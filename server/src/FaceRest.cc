@@ -22,6 +22,10 @@
 
 #include <cstring>
 #include <queue>
+#include <map>
+#include <vector>
+#include <functional>
+#include <inttypes.h>
 #include <Logger.h>
 #include <Reaper.h>
 #include <Mutex.h>
@@ -30,6 +34,9 @@
 #include <errno.h>
 #include <uuid/uuid.h>
 #include <semaphore.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include "FaceRest.h"
 #include "FaceRestPrivate.h"
 #include "JSONBuilder.h"
@@ -50,10 +57,19 @@
 #include "RestResourceCustomIncidentStatus.h"
 #include "RestResourceUser.h"
 #include "ConfigManager.h"
+#include "DataGeneration.h"
 
 using namespace std;
 using namespace mlpl;
 
+// The reactors share the port by SO_REUSEPORT. A socket made by ourselves
+// can be given to SoupServer since libsoup 2.48.
+#if defined(SO_REUSEPORT) && defined(SOUP_CHECK_VERSION)
+#if SOUP_CHECK_VERSION(2, 48, 0)
+#define FACE_REST_REACTORS_SUPPORTED
+#endif
+#endif
+
 int FaceRest::API_VERSION = 4;
 const char *FaceRest::SESSION_ID_HEADER_NAME = "X-Hatohol-Session";
 const int FaceRest::DEFAULT_NUM_WORKERS = 4;
@@ -68,6 +84,8 @@ static const char *MIME_HTML = "text/html";
 static const char *MIME_JSON = "application/json";
 static const char *MIME_JAVASCRIPT = "text/javascript";
 
+static const char *MAIN_CONTEXT_KEY = "hatohol-face-rest-main-context";
+
 #define RETURN_IF_NOT_TEST_MODE(TEST_MODE, JOB) \
 do { \
 	if (!TEST_MODE) { \
@@ -103,7 +121,11 @@ struct FaceRest::Impl {
 	GMainContext       *gMainCtx;
 	FaceRestParam      *param;
 	AtomicValue<bool>   quitRequest;
-	set<string>         handlerPathSet;
+	map<string, ResourceHandlerFactory *> handlerFactoryMap;
+
+	// for reactor mode
+	size_t              numReactors;
+	vector<Reactor *>   reactors;
 
 	// for async mode
 	bool             asyncMode;
@@ -113,12 +135,15 @@ struct FaceRest::Impl {
 	Mutex            restJobLock;
 	sem_t            waitJobSemaphore;
 
+	RestResponseCache responseCache;
+
 	Impl(FaceRestParam *_param)
 	: port(DEFAULT_PORT),
 	  soupServer(NULL),
 	  gMainCtx(NULL),
 	  param(_param),
 	  quitRequest(false),
+	  numReactors(1),
 	  asyncMode(true),
 	  numPreLoadWorkers(DEFAULT_NUM_WORKERS)
 	{
@@ -161,23 +186,152 @@ struct FaceRest::Impl {
 		return job;
 	}
 
+	bool isReactorMode(void) const
+	{
+		return numReactors > 1;
+	}
+
 	void addHandler(const char *path, ResourceHandlerFactory *factory)
 	{
+		// The factories are owned here since they are shared by
+		// the servers of all the reactors.
+		map<string, ResourceHandlerFactory *>::iterator it =
+		  handlerFactoryMap.find(path);
+		if (it != handlerFactoryMap.end())
+			ResourceHandlerFactory::destroy(it->second);
+		handlerFactoryMap[path] = factory;
 		soup_server_add_handler(soupServer, path,
-					queueRestJob, factory,
-					ResourceHandlerFactory::destroy);
-		handlerPathSet.insert(path);
+					queueRestJob, factory, NULL);
+	}
+
+	void registerHandlers(SoupServer *server)
+	{
+		soup_server_add_handler(server, NULL, handlerDefault, NULL, NULL);
+		map<string, ResourceHandlerFactory *>::iterator it =
+		  handlerFactoryMap.begin();
+		for (; it != handlerFactoryMap.end(); ++it) {
+			soup_server_add_handler(server, it->first.c_str(),
+						queueRestJob, it->second, NULL);
+		}
 	}
 
 	void removeAllHandlers(void)
 	{
-		if (!soupServer)
+		map<string, ResourceHandlerFactory *>::iterator it =
+		  handlerFactoryMap.begin();
+		for (; it != handlerFactoryMap.end(); ++it) {
+			if (soupServer) {
+				soup_server_remove_handler(
+				  soupServer, it->first.c_str());
+			}
+			ResourceHandlerFactory::destroy(it->second);
+		}
+		handlerFactoryMap.clear();
+	}
+
+#ifdef FACE_REST_REACTORS_SUPPORTED
+	static int openReusePortSocket(const guint &port)
+	{
+		int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd == -1) {
+			MLPL_ERR("Failed to create a socket: %s\n",
+				 g_strerror(errno));
+			return -1;
+		}
+
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_ANY);
+		addr.sin_port = htons(port);
+		const int on = 1;
+		if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR,
+			       &on, sizeof(on)) == -1 ||
+		    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+			       &on, sizeof(on)) == -1 ||
+		    bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 ||
+		    listen(fd, SOMAXCONN) == -1) {
+			const int errorNumber = errno;
+			MLPL_ERR("Failed to listen: %u, errno: %d (%s)\n",
+				 port, errorNumber, g_strerror(errorNumber));
+			if (errorNumber == EADDRINUSE) {
+				MLPL_ERR("%s",
+				  Utils::getUsingPortInfo(port).c_str());
+			}
+			close(fd);
+			return -1;
+		}
+		return fd;
+	}
+#endif // FACE_REST_REACTORS_SUPPORTED
+
+	/**
+	 * Create a server that accepts the connections in the given
+	 * context. The port is shared with the servers of the other
+	 * reactors and the kernel distributes the connections among them.
+	 *
+	 * @param ctx A context in which the server is run.
+	 * @return A new server or NULL on failure.
+	 */
+	SoupServer *createReactorServer(GMainContext *ctx)
+	{
+#ifdef FACE_REST_REACTORS_SUPPORTED
+		const int fd = openReusePortSocket(port);
+		if (fd == -1)
+			return NULL;
+
+		GError *error = NULL;
+		GSocket *sock = g_socket_new_from_fd(fd, &error);
+		if (!sock) {
+			MLPL_ERR("Failed to create GSocket: %s\n",
+				 error->message);
+			g_error_free(error);
+			close(fd);
+			return NULL;
+		}
+
+		// The listener is attached to the thread default context.
+		SoupServer *server = soup_server_new(NULL, NULL);
+		g_main_context_push_thread_default(ctx);
+		gboolean listening = soup_server_listen_socket(
+		  server, sock, static_cast<SoupServerListenOptions>(0),
+		  &error);
+		g_main_context_pop_thread_default(ctx);
+		g_object_unref(sock);
+		if (!listening) {
+			MLPL_ERR("Failed to listen: %s\n", error->message);
+			g_error_free(error);
+			g_object_unref(server);
+			return NULL;
+		}
+		g_object_set_data(G_OBJECT(server), MAIN_CONTEXT_KEY, ctx);
+		return server;
+#else
+		return NULL;
+#endif // FACE_REST_REACTORS_SUPPORTED
+	}
+
+	static void disconnectServer(SoupServer *server, const bool &legacy)
+	{
+		if (legacy) {
+			SoupSocket *sock = soup_server_get_listener(server);
+			soup_socket_disconnect(sock);
 			return;
+		}
+#ifdef FACE_REST_REACTORS_SUPPORTED
+		soup_server_disconnect(server);
+#endif // FACE_REST_REACTORS_SUPPORTED
+	}
 
-		set<string>::iterator it = handlerPathSet.begin();
-		for (; it != handlerPathSet.end(); it++)
-			soup_server_remove_handler(soupServer, (*it).c_str());
-		handlerPathSet.clear();
+	static void wakeUp(GMainContext *ctx)
+	{
+		// To return g_main_context_iteration() of the loop
+		struct IterAlarm {
+			static gboolean task(gpointer data) {
+				return G_SOURCE_REMOVE;
+			}
+		};
+		Utils::setGLibIdleEvent(IterAlarm::task, NULL, ctx);
 	}
 
 	static void queueRestJob
@@ -238,6 +392,62 @@ private:
 	FaceRest *m_faceRest;
 };
 
+class FaceRest::Reactor : public HatoholThreadBase {
+public:
+	Reactor(FaceRest *faceRest)
+	: m_faceRest(faceRest),
+	  m_gMainCtx(g_main_context_new()),
+	  m_soupServer(NULL),
+	  m_quitRequest(false)
+	{
+	}
+
+	virtual ~Reactor()
+	{
+		waitExit();
+		if (m_soupServer) {
+			FaceRest::Impl::disconnectServer(m_soupServer, false);
+			g_object_unref(m_soupServer);
+		}
+		g_main_context_unref(m_gMainCtx);
+	}
+
+	bool listen(void)
+	{
+		FaceRest::Impl *impl = m_faceRest->m_impl.get();
+		m_soupServer = impl->createReactorServer(m_gMainCtx);
+		if (!m_soupServer)
+			return false;
+		impl->registerHandlers(m_soupServer);
+		return true;
+	}
+
+	virtual void waitExit(void) override
+	{
+		if (!isStarted())
+			return;
+		m_quitRequest.set(true);
+		FaceRest::Impl::wakeUp(m_gMainCtx);
+		HatoholThreadBase::waitExit();
+	}
+
+protected:
+	virtual gpointer mainThread(HatoholThreadArg *arg)
+	{
+		MLPL_INFO("start face-rest reactor\n");
+		while (!m_quitRequest.get())
+			g_main_context_iteration(m_gMainCtx, TRUE);
+		MLPL_INFO("exited face-rest reactor\n");
+		return NULL;
+	}
+
+private:
+	FaceRest          *m_faceRest;
+	GMainContext      *m_gMainCtx;
+	SoupServer        *m_soupServer;
+	AtomicValue<bool>  m_quitRequest;
+};
+
 // ---------------------------------------------------------------------------
 // Public methods
 // ---------------------------------------------------------------------------
@@ -265,24 +475,44 @@ FaceRest::FaceRest(FaceRestParam *param)
 			m_impl->port = port;
 	}
 
+	m_impl->responseCache.setMaxBytes(
+	  ConfigManager::getInstance()->getRestResponseCacheSize());
+
 	int num = ConfigManager::getInstance()->getFaceRestNumWorkers();
 	if (num > 0) {
 		setNumberOfPreLoadWorkers(num);
 	}
 
-	MLPL_INFO("started face-rest, port: %d, workers: %zu\n",
-		  m_impl->port, m_impl->numPreLoadWorkers);
+	size_t numReactors =
+	  ConfigManager::getInstance()->getFaceRestNumReactors();
+	if (numReactors == 0) {
+		const long numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+		numReactors = numCPUs > 0 ? numCPUs : 1;
+	}
+#ifndef FACE_REST_REACTORS_SUPPORTED
+	if (numReactors > 1) {
+		MLPL_WARN("Multiple reactors aren't supported by this build. "
+			  "Only one is used.\n");
+		numReactors = 1;
+	}
+#endif // FACE_REST_REACTORS_SUPPORTED
+	m_impl->numReactors = numReactors;
+
+	MLPL_INFO("started face-rest, port: %d, workers: %zu, "
+		  "reactors: %zu\n",
+		  m_impl->port, m_impl->numPreLoadWorkers, m_impl->numReactors);
 }
 
 FaceRest::~FaceRest()
 {
 	waitExit();
+	stopReactors();
 
 	MLPL_INFO("FaceRest: stop process: started.\n");
+	m_impl->removeAllHandlers();
 	if (m_impl->soupServer) {
-		SoupSocket *sock = soup_server_get_listener(m_impl->soupServer);
-		soup_socket_disconnect(sock);
-		m_impl->removeAllHandlers();
+		Impl::disconnectServer(m_impl->soupServer,
+				       !m_impl->isReactorMode());
 		g_object_unref(m_impl->soupServer);
 	}
 	MLPL_INFO("FaceRest: stop process: completed.\n");
@@ -292,14 +522,7 @@ void FaceRest::waitExit(void)
 {
 	if (isStarted()) {
 		m_impl->quitRequest.set(true);
-
-		// To return g_main_context_iteration() in mainThread()
-		struct IterAlarm {
-			static gboolean task(gpointer data) {
-				return G_SOURCE_REMOVE;
-			}
-		};
-		Utils::setGLibIdleEvent(IterAlarm::task, NULL, m_impl->gMainCtx);
+		Impl::wakeUp(m_impl->gMainCtx);
 	}
 
 	HatoholThreadBase::waitExit();
@@ -316,6 +539,11 @@ void FaceRest::addResourceHandlerFactory(const char *path,
 	m_impl->addHandler(path, factory);
 }
 
+RestResponseCache &FaceRest::getResponseCache(void)
+{
+	return m_impl->responseCache;
+}
+
 // ---------------------------------------------------------------------------
 // Protected methods
 // ---------------------------------------------------------------------------
@@ -371,20 +599,55 @@ void FaceRest::stopWorkers(void)
 	workers.clear();
 }
 
+void FaceRest::startReactors(void)
+{
+	// The first reactor is this thread.
+	for (size_t i = 1; i < m_impl->numReactors; i++) {
+		Reactor *reactor = new Reactor(this);
+		m_impl->reactors.push_back(reactor);
+		HATOHOL_ASSERT(reactor->listen(),
+		               "Failed to start a reactor: port: %u\n",
+		               m_impl->port);
+		reactor->start();
+	}
+}
+
+void FaceRest::stopReactors(void)
+{
+	vector<Reactor *> &reactors = m_impl->reactors;
+	for (size_t i = 0; i < reactors.size(); i++) {
+		// destructor will call waitExit()
+		delete reactors[i];
+	}
+	reactors.clear();
+}
+
 gpointer FaceRest::mainThread(HatoholThreadArg *arg)
 {
 	Impl::MainThreadCleaner cleaner(m_impl.get());
 	Reaper<Impl::MainThreadCleaner>
 	   reaper(&cleaner, Impl::MainThreadCleaner::callgate);
 
-	m_impl->soupServer = soup_server_new(SOUP_SERVER_PORT, m_impl->port,
-	                                    SOUP_SERVER_ASYNC_CONTEXT,
-	                                    m_impl->gMainCtx, NULL);
-	if (errno == EADDRINUSE)
-		MLPL_ERR("%s", Utils::getUsingPortInfo(m_impl->port).c_str());
-	HATOHOL_ASSERT(m_impl->soupServer,
-	               "failed: soup_server_new: %u, errno: %d (%s)\n",
-	               m_impl->port, errno, g_strerror(errno));
+	if (m_impl->isReactorMode()) {
+		// Each reactor calls the handlers by itself.
+		m_impl->asyncMode = false;
+		m_impl->soupServer =
+		  m_impl->createReactorServer(m_impl->gMainCtx);
+		HATOHOL_ASSERT(m_impl->soupServer,
+		               "Failed to start a reactor: port: %u\n",
+		               m_impl->port);
+	} else {
+		m_impl->soupServer = soup_server_new(
+		  SOUP_SERVER_PORT, m_impl->port,
+		  SOUP_SERVER_ASYNC_CONTEXT, m_impl->gMainCtx, NULL);
+		if (errno == EADDRINUSE) {
+			MLPL_ERR("%s",
+			  Utils::getUsingPortInfo(m_impl->port).c_str());
+		}
+		HATOHOL_ASSERT(m_impl->soupServer,
+		               "failed: soup_server_new: %u, errno: %d (%s)\n",
+		               m_impl->port, errno, g_strerror(errno));
+	}
 	soup_server_add_handler(m_impl->soupServer, NULL,
 	                        handlerDefault, this, NULL);
 	m_impl->addHandler(
@@ -410,10 +673,16 @@ gpointer FaceRest::mainThread(HatoholThreadArg *arg)
 	RestResourceSummary::registerFactories(this);
 	RestResourceCustomIncidentStatus::registerFactories(this);
 
+	if (m_impl->isReactorMode())
+		startReactors();
+
 	if (m_impl->param)
 		m_impl->param->setupDoneNotifyFunc();
-	soup_server_run_async(m_impl->soupServer);
-	cleaner.running = true;
+	if (!m_impl->isReactorMode()) {
+		// The server in reactor mode has been listening.
+		soup_server_run_async(m_impl->soupServer);
+		cleaner.running = true;
+	}
 
 	if (isAsyncMode())
 		startWorkers();
@@ -423,6 +692,7 @@ gpointer FaceRest::mainThread(HatoholThreadArg *arg)
 
 	if (isAsyncMode())
 		stopWorkers();
+	stopReactors();
 
 	MLPL_INFO("exited face-rest\n");
 	return NULL;
@@ -481,6 +751,9 @@ void FaceRest::Impl::queueRestJob
 	  = static_cast<ResourceHandlerFactory *>(user_data);
 	FaceRest *face = factory->m_faceRest;
 	ResourceHandler *job = factory->createHandler();
+	job->m_soupServer = server;
+	job->m_gMainContext = static_cast<GMainContext *>(
+	  g_object_get_data(G_OBJECT(server), MAIN_CONTEXT_KEY));
 	bool succeeded = job->setRequest(msg, path, query, client);
 	if (!succeeded) {
 		job->unref();
@@ -625,9 +898,10 @@ void FaceRest::handlerLogout(ResourceHandler *job)
 // FaceRest::ResourceHandler
 // ---------------------------------------------------------------------------
 FaceRest::ResourceHandler::ResourceHandler(FaceRest *faceRest)
-: m_faceRest(faceRest), m_message(NULL),
-  m_path(), m_query(NULL), m_client(NULL), m_mimeType(NULL),
-  m_userId(INVALID_USER_ID), m_replyIsPrepared(false)
+: m_faceRest(faceRest), m_soupServer(NULL), m_gMainContext(NULL),
+  m_message(NULL), m_path(), m_query(NULL), m_client(NULL), m_mimeType(NULL),
+  m_userId(INVALID_USER_ID), m_replyIsPrepared(false),
+  m_lastModifiedTime(0)
 {
 }
 
@@ -668,11 +942,15 @@ void FaceRest::ResourceHandler::handleInTryBlock(void)
 
 SoupServer *FaceRest::ResourceHandler::getSoupServer(void)
 {
+	if (m_soupServer)
+		return m_soupServer;
 	return m_faceRest ? m_faceRest->getSoupServer() : NULL;
 }
 
 GMainContext *FaceRest::ResourceHandler::getGMainContext(void)
 {
+	if (m_gMainContext)
+		return m_gMainContext;
 	return m_faceRest ? m_faceRest->getGMainContext() : NULL;
 }
 
@@ -856,14 +1134,37 @@ void FaceRest::ResourceHandler::replyError(const HatoholErrorCode &errorCode,
 	replyError(hatoholError, statusCode);
 }
 
-static string wrapForJSONP(const string &jsonBody,
-			   const string &callbackName)
+static void deleteBody(gpointer data)
 {
-	string jsonp = callbackName;
-	jsonp += "(";
-	jsonp += jsonBody;
-	jsonp += ")";
-	return jsonp;
+	delete static_cast<RestResponseCache::Body *>(data);
+}
+
+static RestResponseCache::Body makeBody(JSONBuilder &agent)
+{
+	string *json = new string();
+	agent.moveTo(*json);
+	return RestResponseCache::Body(json);
+}
+
+static void appendJSONBody(SoupMessageBody *body,
+                           const RestResponseCache::Body &json,
+                           const string &callbackName)
+{
+	// The JSON is handed to libsoup without copy. The buffer holds a
+	// reference since it may be shared with the response cache.
+	if (!callbackName.empty()) {
+		const string prefix = callbackName + "(";
+		soup_message_body_append(body, SOUP_MEMORY_COPY,
+		                         prefix.c_str(), prefix.size());
+	}
+	SoupBuffer *buffer =
+	  soup_buffer_new_with_owner(json->data(), json->size(),
+	                             new RestResponseCache::Body(json),
+	                             deleteBody);
+	soup_message_body_append_buffer(body, buffer);
+	soup_buffer_free(buffer);
+	if (!callbackName.empty())
+		soup_message_body_append(body, SOUP_MEMORY_STATIC, ")", 1);
 }
 
 void FaceRest::ResourceHandler::replyError(const HatoholError &hatoholError,
@@ -888,13 +1189,10 @@ void FaceRest::ResourceHandler::replyError(const HatoholError &hatoholError,
 	agent.startObject();
 	addHatoholError(agent, hatoholError);
 	agent.endObject();
-	string response = agent.generate();
-	if (!m_jsonpCallbackName.empty())
-		response = wrapForJSONP(response, m_jsonpCallbackName);
 	soup_message_headers_set_content_type(m_message->response_headers,
 	                                      MIME_JSON, NULL);
-	soup_message_body_append(m_message->response_body, SOUP_MEMORY_COPY,
-	                         response.c_str(), response.size());
+	appendJSONBody(m_message->response_body, makeBody(agent),
+	               m_jsonpCallbackName);
 	soup_message_set_status(m_message, statusCode);
 
 	m_replyIsPrepared = true;
@@ -909,18 +1207,170 @@ void FaceRest::ResourceHandler::replyHttpStatus(const guint &statusCode)
 void FaceRest::ResourceHandler::replyJSONData(JSONBuilder &agent,
 					      const guint &statusCode)
 {
-	string response = agent.generate();
-	if (!m_jsonpCallbackName.empty())
-		response = wrapForJSONP(response, m_jsonpCallbackName);
+	RestResponseCache::Body body = makeBody(agent);
+	if (statusCode == SOUP_STATUS_OK && !m_responseCacheKey.empty()) {
+		m_faceRest->getResponseCache().put(
+		  m_responseCacheKey, m_responseCacheGenerations, body);
+	}
+	replyJSONBody(body, statusCode);
+}
+
+void FaceRest::ResourceHandler::replyJSONBody(
+  const RestResponseCache::Body &body, const guint &statusCode)
+{
 	soup_message_headers_set_content_type(m_message->response_headers,
 	                                      m_mimeType, NULL);
-	soup_message_body_append(m_message->response_body, SOUP_MEMORY_COPY,
-	                         response.c_str(), response.size());
+	appendJSONBody(m_message->response_body, body, m_jsonpCallbackName);
+	if (statusCode == SOUP_STATUS_OK)
+		appendValidatorHeaders();
 	soup_message_set_status(m_message, statusCode);
 
 	m_replyIsPrepared = true;
 }
 
+static void copyQueryParameter(gpointer key, gpointer value, gpointer data)
+{
+	map<string, string> &params = *static_cast<map<string, string> *>(data);
+	params[static_cast<const char *>(key)] =
+	  static_cast<const char *>(value);
+}
+
+string FaceRest::ResourceHandler::makeEntityTag(
+  const DataGenerationTypeVect &types,
+  const RestResponseCache::Generations &generations)
+{
+	// The parameters are sorted since the order in m_query is undefined.
+	map<string, string> params;
+	if (m_query)
+		g_hash_table_foreach(m_query, copyQueryParameter, &params);
+
+	string key = StringUtils::sprintf("%" FMT_USER_ID "\n%s\n",
+	                                  m_userId, m_path.c_str());
+	for (auto &param : params)
+		key += param.first + "=" + param.second + "\n";
+	for (size_t i = 0; i < types.size(); i++) {
+		key += StringUtils::sprintf("%d:%" PRIu64 "\n",
+		                            types[i], generations[i]);
+	}
+	const uint64_t keyHash = hash<string>()(key);
+	return StringUtils::sprintf("\"%" PRIx64 "-%" PRIx64 "\"",
+	                            DataGeneration::getEpoch(), keyHash);
+}
+
+bool FaceRest::ResourceHandler::matchIfNoneMatch(void)
+{
+	const char *ifNoneMatch =
+	  soup_message_headers_get_list(m_message->request_headers,
+	                                "If-None-Match");
+	if (!ifNoneMatch)
+		return false;
+
+	StringVector entityTags;
+	StringUtils::split(entityTags, ifNoneMatch, ',');
+	for (auto &entityTag : entityTags) {
+		string tag = StringUtils::stripBothEndsSpaces(entityTag);
+		// A weak comparison is used for GET as RFC 7232 specifies.
+		if (StringUtils::hasPrefix(tag, "W/"))
+			tag.erase(0, 2);
+		if (tag == "*" || tag == m_entityTag)
+			return true;
+	}
+	return false;
+}
+
+void FaceRest::ResourceHandler::appendValidatorHeaders(void)
+{
+	if (m_entityTag.empty())
+		return;
+
+	SoupMessageHeaders *headers = m_message->response_headers;
+	soup_message_headers_replace(headers, "ETag", m_entityTag.c_str());
+	// Let clients revalidate every time instead of caching the response
+	// heuristically with Last-Modified.
+	soup_message_headers_replace(headers, "Cache-Control", "no-cache");
+	if (m_lastModifiedTime) {
+		SoupDate *date = soup_date_new_from_time_t(m_lastModifiedTime);
+		char *dateString = soup_date_to_string(date, SOUP_DATE_HTTP);
+		soup_message_headers_replace(headers, "Last-Modified",
+		                             dateString);
+		g_free(dateString);
+		soup_date_free(date);
+	}
+}
+
+string FaceRest::ResourceHandler::makeResponseCacheKey(void)
+{
+	// The format and the JSONP callback are applied on every reply.
+	map<string, string> params;
+	if (m_query)
+		g_hash_table_foreach(m_query, copyQueryParameter, &params);
+	params.erase("fmt");
+	params.erase("callback");
+
+	string key = m_path + "\n";
+	for (auto &param : params)
+		key += param.first + "=" + param.second + "\n";
+
+	// Users who have the same privilege share the entries.
+	const OperationPrivilege &privilege =
+	  m_dataQueryContextPtr->getOperationPrivilege();
+	key += StringUtils::sprintf("%" PRIx64 "\n", privilege.getFlags());
+	if (privilege.has(OPPRVLG_GET_ALL_SERVER))
+		return key;
+	const ServerHostGrpSetMap &srvHostGrpSetMap =
+	  m_dataQueryContextPtr->getServerHostGrpSetMap();
+	for (auto &srvHostGrpSet : srvHostGrpSetMap) {
+		key += StringUtils::sprintf("%" FMT_SERVER_ID ":",
+		                            srvHostGrpSet.first);
+		for (auto &hostgroupId : srvHostGrpSet.second)
+			key += hostgroupId + ",";
+		key += "\n";
+	}
+	return key;
+}
+
+bool FaceRest::ResourceHandler::replyCachedResponse(
+  const RestResponseCache::Generations &generations)
+{
+	if (!m_faceRest)
+		return false;
+	RestResponseCache &cache = m_faceRest->getResponseCache();
+	if (!cache.getMaxBytes())
+		return false;
+
+	m_responseCacheKey = makeResponseCacheKey();
+	m_responseCacheGenerations = generations;
+	RestResponseCache::Body body =
+	  cache.get(m_responseCacheKey, generations);
+	if (!body)
+		return false;
+	replyJSONBody(body, SOUP_STATUS_OK);
+	return true;
+}
+
+bool FaceRest::ResourceHandler::replyIfUnchanged(
+  const DataGenerationTypeVect &types)
+{
+	if (!httpMethodIs("GET") && !httpMethodIs("HEAD"))
+		return false;
+
+	// All of the following are based on the same generations.
+	const RestResponseCache::Generations generations =
+	  RestResponseCache::getGenerations(types);
+	m_lastModifiedTime = 0;
+	for (auto &type : types) {
+		m_lastModifiedTime = max(m_lastModifiedTime,
+		                         DataGeneration::getLastModifiedTime(type));
+	}
+	m_entityTag = makeEntityTag(types, generations);
+	if (matchIfNoneMatch()) {
+		appendValidatorHeaders();
+		replyHttpStatus(SOUP_STATUS_NOT_MODIFIED);
+		return true;
+	}
+	return replyCachedResponse(generations);
+}
+
 void FaceRest::ResourceHandler::addHatoholError(JSONBuilder &agent,
 						const HatoholError &err)
 {
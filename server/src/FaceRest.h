@@ -32,6 +32,7 @@
 #include "DBTablesMonitoring.h"
 #include "Closure.h"
 #include "Utils.h"
+#include "RestResponseCache.h"
 
 struct FaceRestParam {
 	virtual void setupDoneNotifyFunc(void)
@@ -60,8 +61,16 @@ public:
 	void addResourceHandlerFactory(const char *path,
 				       ResourceHandlerFactory *factory);
 
+	/**
+	 * Get the cache of the JSON bodies shared by the handlers.
+	 *
+	 * @return The cache owned by this instance.
+	 */
+	RestResponseCache &getResponseCache(void);
+
 protected:
 	class Worker;
+	class Reactor;
 
 	// virtual methods
 	gpointer mainThread(HatoholThreadArg *arg);
@@ -71,6 +80,10 @@ protected:
 	void startWorkers(void);
 	void stopWorkers(void);
 
+	// for reactor mode
+	void startReactors(void);
+	void stopReactors(void);
+
 	// generic sub routines
 	SoupServer   *getSoupServer(void);
 	GMainContext *getGMainContext(void);
@@ -23,6 +23,7 @@
 #include "FaceRest.h"
 #include <StringUtils.h>
 #include <UsedCountable.h>
+#include "DataGeneration.h"
 
 static const uint64_t INVALID_ID = -1;
 
@@ -68,6 +69,21 @@ public:
 			const guint &statusCode = SOUP_STATUS_OK);
 	void replyHttpStatus(const guint &statusCode);
 	void replyJSONData(JSONBuilder &agent, const guint &statusCode = SOUP_STATUS_OK);
+
+	/**
+	 * Reply without making the response again if the data it is made
+	 * from haven't been changed. 304 (Not Modified) is replied if the
+	 * client already has the response to the same request. The body in
+	 * the response cache is replied if a request with the same
+	 * parameters and the same privilege has been answered. Otherwise
+	 * ETag and Last-Modified headers are prepared and the body is
+	 * stored in the cache by replyJSONData(). This has to be called
+	 * before the data are read from the DB.
+	 *
+	 * @param types The types of the data the response is made from.
+	 * @return true if the reply is prepared. The caller should return.
+	 */
+	bool replyIfUnchanged(const DataGenerationTypeVect &types);
 	void addServersMap(JSONBuilder &agent,
 			   TriggerBriefMaps *triggerMaps = NULL,
 			   bool lookupTriggerBrief = false);
@@ -83,6 +99,9 @@ public:
 	FaceRest          *m_faceRest;
 
 	// arguments of SoupServerCallback
+	SoupServer        *m_soupServer;
+	// the context of the reactor that got the request
+	GMainContext      *m_gMainContext;
 	SoupMessage       *m_message;
 	std::string        m_path;
 	mlpl::StringVector m_pathElements;
@@ -98,9 +117,23 @@ public:
 	UserIdType  m_userId;
 	bool        m_replyIsPrepared;
 	DataQueryContextPtr m_dataQueryContextPtr;
+	std::string m_entityTag;
+	time_t      m_lastModifiedTime;
+	std::string m_responseCacheKey;
+	RestResponseCache::Generations m_responseCacheGenerations;
 
 protected:
 	bool parseRequest(void);
+	std::string makeEntityTag(
+	  const DataGenerationTypeVect &types,
+	  const RestResponseCache::Generations &generations);
+	bool matchIfNoneMatch(void);
+	void appendValidatorHeaders(void);
+	std::string makeResponseCacheKey(void);
+	bool replyCachedResponse(
+	  const RestResponseCache::Generations &generations);
+	void replyJSONBody(const RestResponseCache::Body &body,
+	                   const guint &statusCode);
 	std::string getJSONPCallbackName(void);
 	bool parseFormatType(void);
 };
@@ -28,6 +28,7 @@
 #include <libsoup/soup.h>
 #include <Reaper.h>
 #include "SelfMonitor.h"
+#include "EventIngestPipeline.h"
 #include <mutex>
 
 using namespace std;
@@ -146,6 +147,7 @@ struct HatoholArmPluginGateHAPI2::Impl
 	SelfMonitorPtr monitorGateInternal;
 	SelfMonitorPtr monitorBrokerConn;
 	SelfMonitorPtr monitorHAP2Conn;
+	EventIngestPipeline m_eventIngestPipeline;
 
 	Impl(const MonitoringServerInfo &_serverInfo,
 	     HatoholArmPluginGateHAPI2 &hapi2)
@@ -173,7 +175,8 @@ struct HatoholArmPluginGateHAPI2::Impl
 	  monitorHAP2Conn(new SelfMonitor(
 	    _serverInfo.id, FAILED_CONNECT_HAP2_TRIGGER_ID,
 	    HatoholError::getMessage(HTERR_FAILED_CONNECT_HAP2),
-	    TRIGGER_SEVERITY_CRITICAL))
+	    TRIGGER_SEVERITY_CRITICAL)),
+	  m_eventIngestPipeline(_serverInfo.id)
 	{
 		ArmPluginInfo::initialize(m_pluginInfo);
 		ThreadLocalDBCache cache;
@@ -1702,9 +1705,9 @@ static bool parseItemParams(JSONParser &parser, ItemInfoList &itemInfoList,
 		size_t num = parser.countElements();
 		names.clear();
 		for (size_t i = 0; i < num; i++) {
-			string name;
+			JSONParser::StringView name;
 			parser.read(i, name);
-			names.push_back(name);
+			names.push_back(name.toString());
 		}
 		parser.endObject();
 		return true;
@@ -2546,7 +2549,7 @@ string HatoholArmPluginGateHAPI2::procedureHandlerPutHostGroupMembership(
 static bool parseTriggerStatus(JSONParser &parser, TriggerStatusType &status,
 			       JSONRPCError &errObj, bool skipValidate)
 {
-	string statusString;
+	JSONParser::StringView statusString;
 	if (skipValidate) {
 		parser.read("status", statusString);
 	} else {
@@ -2561,7 +2564,8 @@ static bool parseTriggerStatus(JSONParser &parser, TriggerStatusType &status,
 	} else if (statusString == "") {
 		status = TRIGGER_STATUS_UNKNOWN;
 	} else {
-		MLPL_WARN("Unknown trigger status: %s\n", statusString.c_str());
+		MLPL_WARN("Unknown trigger status: %s\n",
+			  statusString.toString().c_str());
 		status = TRIGGER_STATUS_UNKNOWN;
 	}
 	return true;
@@ -2571,7 +2575,7 @@ static bool parseTriggerSeverity(JSONParser &parser,
 				 TriggerSeverityType &severity,
 				 JSONRPCError &errObj, bool skipValidate)
 {
-	string severityString;
+	JSONParser::StringView severityString;
 	if (skipValidate) {
 		parser.read("severity", severityString);
 	} else {
@@ -2595,7 +2599,7 @@ static bool parseTriggerSeverity(JSONParser &parser,
 		severity = TRIGGER_SEVERITY_UNKNOWN;
 	} else {
 		MLPL_WARN("Unknown trigger severity: %s\n",
-			  severityString.c_str());
+			  severityString.toString().c_str());
 		severity = TRIGGER_SEVERITY_UNKNOWN;
 	}
 	return true;
@@ -2801,7 +2805,7 @@ string HatoholArmPluginGateHAPI2::procedureHandlerPutTriggers(
 static bool parseEventType(JSONParser &parser, EventInfo &eventInfo,
 			   JSONRPCError &errObj)
 {
-	string eventType;
+	JSONParser::StringView eventType;
 	PARSE_AS_MANDATORY("type", eventType, errObj);
 
 	if (eventType == "GOOD") {
@@ -2813,7 +2817,8 @@ static bool parseEventType(JSONParser &parser, EventInfo &eventInfo,
 	} else if (eventType == "NOTIFICATION") {
 		eventInfo.type = EVENT_TYPE_NOTIFICATION;
 	} else {
-		MLPL_WARN("Invalid event type: %s\n", eventType.c_str());
+		MLPL_WARN("Invalid event type: %s\n",
+			  eventType.toString().c_str());
 		eventInfo.type = EVENT_TYPE_UNKNOWN;
 	}
 	return true;
@@ -2855,12 +2860,8 @@ static bool parseEventsParams(JSONParser &parser, EventInfoList &eventInfoList,
 		PARSE_AS_MANDATORY("eventId",  eventInfo.id, errObj);
 		parseTimeStamp(parser, "time", eventInfo.time, errObj);
 		parseEventType(parser, eventInfo, errObj);
-		TriggerIdType triggerId;
-		if (parser.read("triggerId", triggerId)) {
-			eventInfo.triggerId = triggerId;
-		} else {
+		if (!parser.read("triggerId", eventInfo.triggerId))
 			eventInfo.triggerId = DO_NOT_ASSOCIATE_TRIGGER_ID;
-		}
 		parseTriggerStatus(parser,         eventInfo.status, errObj, true);
 		parseTriggerSeverity(parser,       eventInfo.severity, errObj, true);
 		parser.read("hostId",       eventInfo.hostIdInServer);
@@ -2995,9 +2996,19 @@ string HatoholArmPluginGateHAPI2::procedureHandlerPutEvents(
 		sweepInvalidEventInfoListSequentialIdPair();
 	}
 
+	// Replies of fetchEvents and divided notifications are stored
+	// synchronously after the queued events because the completion is
+	// notified to the requester or depends on the preceding parts.
+	// The message of the other events is acknowledged after they are
+	// stored by the pipeline (see waitDeferredMessage()).
 	if (divided) {
+		m_impl->m_eventIngestPipeline.flush();
 		dataStore->addEventList(collectedEventInfoList, lastInfoUpserter);
+	} else if (fetchId.empty()) {
+		markMessageDeferred(m_impl->m_eventIngestPipeline.push(
+		  eventInfoList, lastInfoUpserter.lastInfo));
 	} else {
+		m_impl->m_eventIngestPipeline.flush();
 		dataStore->addEventList(eventInfoList, lastInfoUpserter);
 	}
 
@@ -3256,3 +3267,8 @@ void HatoholArmPluginGateHAPI2::onConnectFailure(void)
 {
 	updateSelfMonitor(m_impl->monitorBrokerConn, true);
 }
+
+bool HatoholArmPluginGateHAPI2::waitDeferredMessage(const uint64_t &ticket)
+{
+	return m_impl->m_eventIngestPipeline.waitPersisted(ticket);
+}
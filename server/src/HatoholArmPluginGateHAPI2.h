@@ -82,6 +82,7 @@ protected:
 	                                 const HAPI2PluginErrorCode &errorCode);
 	virtual void onConnect(void) override;
 	virtual void onConnectFailure(void) override;
+	virtual bool waitDeferredMessage(const uint64_t &ticket) override;
 	void setPluginAvailableTrigger(const HAPI2PluginCollectType &type,
 				       const TriggerIdType &trrigerId,
 				       const HatoholError &hatoholError);
@@ -369,6 +369,27 @@ bool HostResourceQueryOption::isAllowedServer(
 	       (allowedServersAndHostgroups.find(targetServerId) != endIt);
 }
 
+bool HostResourceQueryOption::getAllowedHostgroupIdSet(
+  HostgroupIdSet &hostgroupIdSet, const ServerIdType &serverId) const
+{
+	if (has(OPPRVLG_GET_ALL_SERVER)) {
+		hostgroupIdSet.insert(ALL_HOST_GROUPS);
+		return true;
+	}
+	const ServerHostGrpSetMap &allowedServersAndHostgroups =
+	  getAllowedServersAndHostgroups();
+	auto endIt = allowedServersAndHostgroups.end();
+	if (allowedServersAndHostgroups.find(ALL_SERVERS) != endIt) {
+		hostgroupIdSet.insert(ALL_HOST_GROUPS);
+		return true;
+	}
+	auto serverIt = allowedServersAndHostgroups.find(serverId);
+	if (serverIt == endIt)
+		return false;
+	hostgroupIdSet.insert(serverIt->second.begin(), serverIt->second.end());
+	return true;
+}
+
 bool HostResourceQueryOption::isAllowedHostgroup(
   const ServerIdType &targetServerId,
   const HostgroupIdType &targetHostgroupId) const
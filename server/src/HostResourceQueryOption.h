@@ -196,6 +196,19 @@ public:
 	 */
 	const bool &getExcludeDefunctServers(void) const;
 
+	/**
+	 * Get hostgroups in a server that the user is allowed to access.
+	 *
+	 * @param hostgroupIdSet
+	 * The allowed hostgroup IDs are inserted in this parameter.
+	 * ALL_HOST_GROUPS is inserted if all hostgroups are allowed.
+	 * @param serverId A target server ID.
+	 *
+	 * @return true if the server is allowed. Otherwise false.
+	 */
+	bool getAllowedHostgroupIdSet(HostgroupIdSet &hostgroupIdSet,
+	                              const ServerIdType &serverId) const;
+
 	std::string getJoinClause(void) const;
 
 protected:
@@ -23,18 +23,25 @@
 #include "ThreadLocalDBCache.h"
 #include "UnifiedDataStore.h"
 #include <mutex>
-#include "SimpleSemaphore.h"
-#include "Reaper.h"
+#include <condition_variable>
+#include <chrono>
+#include "WorkerPool.h"
 #include "AtomicValue.h"
-#include <unistd.h>
 #include <time.h>
-#include <queue>
+#include <algorithm>
+#include <deque>
+#include <map>
 
 using namespace std;
+using namespace std::chrono;
 using namespace mlpl;
 
 static const size_t DEFAULT_RETRY_LIMIT = 3;
 static const unsigned int DEFAULT_RETRY_INTERVAL_MSEC = 5000;
+const size_t IncidentSender::DEFAULT_MAX_IN_FLIGHT_JOBS = 4;
+const size_t IncidentSender::MAX_IN_FLIGHT_JOBS_LIMIT = 16;
+
+typedef pair<ServerIdType, TriggerIdType> TriggerKey;
 
 struct IncidentSender::Job
 {
@@ -45,15 +52,30 @@ struct IncidentSender::Job
 	CreateIncidentCallback createCallback;
 	UpdateIncidentCallback updateCallback;
 	void *userData;
+	size_t numTrials;
+	HatoholError lastResult;
+
+	// Jobs for the events coalesced into this job. This job posts
+	// a comment about them to the incident of the first event.
+	list<Job *> coalescedJobs;
+	bool       coalescable;
+	bool       isCoalescing;
+	TriggerKey triggerKey;
 
 	Job(const EventInfo &_eventInfo,
 	    CreateIncidentCallback _callback = NULL,
 	    void *_userData = NULL,
-	    const UserIdType userId = USER_ID_SYSTEM)
+	    const UserIdType userId = USER_ID_SYSTEM,
+	    const bool _coalescable = false)
 	: userId(userId),
 	  eventInfo(new EventInfo(_eventInfo)), incidentInfo(new IncidentInfo()),
 	  createCallback(_callback), updateCallback(NULL),
-	  userData(_userData)
+	  userData(_userData),
+	  numTrials(0),
+	  lastResult(HTERR_OK),
+	  coalescable(_coalescable),
+	  isCoalescing(false),
+	  triggerKey(_eventInfo.serverId, _eventInfo.triggerId)
 	{
 	}
 
@@ -66,7 +88,12 @@ struct IncidentSender::Job
 	  eventInfo(NULL), incidentInfo(new IncidentInfo(_incidentInfo)),
 	  comment(_comment),
 	  createCallback(NULL), updateCallback(_callback),
-	  userData(_userData)
+	  userData(_userData),
+	  numTrials(0),
+	  lastResult(HTERR_OK),
+	  coalescable(false),
+	  isCoalescing(false),
+	  triggerKey(_incidentInfo.serverId, _incidentInfo.triggerId)
 	{
 	}
 
@@ -74,15 +101,22 @@ struct IncidentSender::Job
 	{
 		delete eventInfo;
 		delete incidentInfo;
+		for (auto job : coalescedJobs)
+			delete job;
 	}
 
 	void notifyStatus(const IncidentSender &sender,
-			  const JobStatus &status) const
+			  const JobStatus &status,
+			  const HatoholError &result = HTERR_OK) const
 	{
 		if (eventInfo && createCallback)
-			createCallback(sender, *eventInfo, status, userData);
+			createCallback(sender, *eventInfo, status, result,
+				       userData);
 		else if (incidentInfo && updateCallback)
-			updateCallback(sender, *incidentInfo, status, userData);
+			updateCallback(sender, *incidentInfo, status, result,
+				       userData);
+		for (auto job : coalescedJobs)
+			job->notifyStatus(sender, status, result);
 	}
 
 	HatoholError send(IncidentSender &sender) const
@@ -93,76 +127,243 @@ struct IncidentSender::Job
 		} else if (incidentInfo) {
 			err = sender.send(*incidentInfo, comment);
 		}
-		sender.setLastResult(err);
-		return sender.getLastResult();
+		return err;
 	}
 };
 
 struct IncidentSender::Impl
 {
+	/**
+	 * The state of the events for a trigger in a coalescing window.
+	 * The first event creates an incident. The following events are
+	 * posted as a comment to it.
+	 */
+	struct Coalescer {
+		steady_clock::time_point deadline;
+		bool                     hasIncident;
+		IncidentInfo             incident;
+
+		// A comment job that hasn't been started.
+		// Coalesced events are added to it.
+		Job                     *commentJob;
+
+		// Events that come before the incident is created.
+		list<Job *>              waitingJobs;
+
+		Coalescer(const steady_clock::time_point &_deadline)
+		: deadline(_deadline),
+		  hasIncident(false),
+		  commentJob(NULL)
+		{
+		}
+	};
+
 	IncidentSender &sender;
 	IncidentTrackerInfo incidentTrackerInfo;
 	std::mutex          queueLock;
-	std::queue<Job*> queue;
-	AtomicValue<Job*> runningJob;
-	SimpleSemaphore jobSemaphore;
+	std::condition_variable jobCond;
+	std::deque<Job*> queue;
+	std::multimap<steady_clock::time_point, Job *> retryQueue;
+	std::map<TriggerKey, Coalescer> coalescerMap;
+	size_t numInFlightJobs;
+	size_t maxInFlightJobs;
 	size_t retryLimit;
 	unsigned int retryIntervalMSec;
+	unsigned int coalescingWindowMSec;
 	AtomicValue<bool> trackerChanged;
 	std::mutex   trackerLock;
-	HatoholError lastResult;
 	bool shouldRecordIncidentHistory;
 
 	Impl(IncidentSender &_sender)
-	: sender(_sender), runningJob(NULL), jobSemaphore(0),
+	: sender(_sender),
+	  numInFlightJobs(0),
+	  maxInFlightJobs(DEFAULT_MAX_IN_FLIGHT_JOBS),
 	  retryLimit(DEFAULT_RETRY_LIMIT),
 	  retryIntervalMSec(DEFAULT_RETRY_INTERVAL_MSEC),
+	  coalescingWindowMSec(0),
 	  shouldRecordIncidentHistory(false)
 	{
 	}
 
 	~Impl()
 	{
-		queueLock.lock();
-		while (!queue.empty()) {
-			Job *job = queue.front();
-			queue.pop();
+		lock_guard<mutex> lock(queueLock);
+		for (auto job : queue)
 			delete job;
+		for (auto &retryPair : retryQueue)
+			delete retryPair.second;
+		for (auto &coalescerPair : coalescerMap) {
+			for (auto job : coalescerPair.second.waitingJobs)
+				delete job;
+		}
+	}
+
+	static bool isCoalescable(const EventInfo &eventInfo)
+	{
+		return eventInfo.triggerId != DO_NOT_ASSOCIATE_TRIGGER_ID &&
+		       eventInfo.triggerId != STATELESS_MONITOR;
+	}
+
+	// The caller must hold 'queueLock'.
+	void enqueue(Job *job)
+	{
+		queue.push_back(job);
+		jobCond.notify_all();
+	}
+
+	// The caller must hold 'queueLock'.
+	bool tryCoalesce(Job *job)
+	{
+		if (!coalescingWindowMSec || !job->coalescable ||
+		    !isCoalescable(*job->eventInfo))
+			return false;
+
+		const steady_clock::time_point now = steady_clock::now();
+		auto it = coalescerMap.find(job->triggerKey);
+		if (it == coalescerMap.end()) {
+			const steady_clock::time_point deadline =
+			  now + milliseconds(coalescingWindowMSec);
+			coalescerMap.insert(
+			  make_pair(job->triggerKey, Coalescer(deadline)));
+			job->isCoalescing = true;
+			return false;
+		}
+
+		Coalescer &coalescer = it->second;
+		if (now >= coalescer.deadline) {
+			if (!isRemovable(coalescer, now))
+				return false;
+			// Start a new window
+			coalescer =
+			  Coalescer(now + milliseconds(coalescingWindowMSec));
+			job->isCoalescing = true;
+			return false;
 		}
-		queueLock.unlock();
+		if (!coalescer.hasIncident) {
+			coalescer.waitingJobs.push_back(job);
+			return true;
+		}
+		if (!coalescer.commentJob) {
+			Job *commentJob = new Job(coalescer.incident, "");
+			commentJob->isCoalescing = true;
+			commentJob->triggerKey = job->triggerKey;
+			coalescer.commentJob = commentJob;
+			enqueue(commentJob);
+		}
+		coalescer.commentJob->coalescedJobs.push_back(job);
+		return true;
 	}
 
 	void pushJob(Job *job)
 	{
-		queueLock.lock();
-		queue.push(job);
+		lock_guard<mutex> lock(queueLock);
 		job->notifyStatus(sender, JOB_QUEUED);
-		jobSemaphore.post();
-		queueLock.unlock();
+		if (job->eventInfo && tryCoalesce(job))
+			return;
+		enqueue(job);
 	}
 
+	// The caller must hold 'queueLock'.
 	Job *popJob(void)
 	{
+		if (numInFlightJobs >= maxInFlightJobs)
+			return NULL;
+
 		Job *job = NULL;
-		queueLock.lock();
-		if (!queue.empty()) {
+		auto retryIt = retryQueue.begin();
+		if (retryIt != retryQueue.end() &&
+		    retryIt->first <= steady_clock::now()) {
+			job = retryIt->second;
+			retryQueue.erase(retryIt);
+		} else if (!queue.empty()) {
 			job = queue.front();
-			queue.pop();
+			queue.pop_front();
+		} else {
+			return NULL;
 		}
-		runningJob = job;
-		if (job)
-			job->notifyStatus(sender, JOB_STARTED);
-		queueLock.unlock();
+
+		if (job->isCoalescing && !job->eventInfo) {
+			// No more events are added to a started comment job.
+			auto it = coalescerMap.find(job->triggerKey);
+			if (it != coalescerMap.end() &&
+			    it->second.commentJob == job)
+				it->second.commentJob = NULL;
+		}
+		numInFlightJobs++;
 		return job;
 	}
 
-	Job *waitNextJob(void)
+	// The caller must hold 'queueLock'.
+	void waitNextJob(unique_lock<mutex> &lock)
 	{
-		jobSemaphore.wait();
-		if (sender.isExitRequested())
-			return NULL;
+		auto retryIt = retryQueue.begin();
+		if (retryIt == retryQueue.end() ||
+		    numInFlightJobs >= maxInFlightJobs)
+			jobCond.wait(lock);
 		else
-			return popJob();
+			jobCond.wait_until(lock, retryIt->first);
+	}
+
+	// The caller must hold 'queueLock'.
+	void onIncidentJobFinished(Job *job, const bool &succeeded)
+	{
+		auto it = coalescerMap.find(job->triggerKey);
+		if (it == coalescerMap.end())
+			return;
+		Coalescer &coalescer = it->second;
+		if (succeeded) {
+			coalescer.hasIncident = true;
+			coalescer.incident = *job->incidentInfo;
+		}
+		if (coalescer.waitingJobs.empty()) {
+			if (!succeeded)
+				coalescerMap.erase(it);
+			return;
+		}
+
+		if (succeeded) {
+			Job *commentJob = new Job(coalescer.incident, "");
+			commentJob->isCoalescing = true;
+			commentJob->triggerKey = job->triggerKey;
+			commentJob->coalescedJobs.swap(coalescer.waitingJobs);
+			coalescer.commentJob = commentJob;
+			enqueue(commentJob);
+		} else {
+			// The next event tries to create the incident.
+			Job *nextJob = coalescer.waitingJobs.front();
+			coalescer.waitingJobs.pop_front();
+			nextJob->isCoalescing = true;
+			enqueue(nextJob);
+		}
+	}
+
+	static bool isRemovable(const Coalescer &coalescer,
+	                        const steady_clock::time_point &now)
+	{
+		return now >= coalescer.deadline && coalescer.hasIncident &&
+		       !coalescer.commentJob && coalescer.waitingJobs.empty();
+	}
+
+	// The caller must hold 'queueLock'.
+	void removeExpiredCoalescers(void)
+	{
+		const steady_clock::time_point now = steady_clock::now();
+		auto it = coalescerMap.begin();
+		while (it != coalescerMap.end()) {
+			if (isRemovable(it->second, now))
+				coalescerMap.erase(it++);
+			else
+				++it;
+		}
+	}
+
+	// The caller must hold 'queueLock'.
+	void finishJob(Job *job, const bool &succeeded)
+	{
+		if (job->isCoalescing && job->eventInfo)
+			onIncidentJobFinished(job, succeeded);
+		removeExpiredCoalescers();
+		delete job;
 	}
 
 	void saveIncidentHistory(const Job &job)
@@ -184,34 +385,79 @@ struct IncidentSender::Impl
 		store->addIncidentHistory(history);
 	}
 
-	HatoholError trySend(const Job &job) {
-		HatoholError result;
-		for (size_t i = 0; i <= retryLimit; i++) {
-			result = job.send(sender);
-			if (result == HTERR_OK)
-				break;
-			if (result != HTERR_FAILED_TO_SEND_INCIDENT)
-				break;
-			if (i == retryLimit)
-				break;
-			if (sender.isExitRequested())
-				break;
-
-			job.notifyStatus(sender, JOB_WAITING_RETRY);
-			usleep(retryIntervalMSec * 1000);
-
-			if (sender.isExitRequested())
-				break;
-			job.notifyStatus(sender, JOB_RETRYING);
+	/**
+	 * The incidents table has only one record for an incident. So the
+	 * incident of the coalesced events is recorded in their histories.
+	 */
+	void saveCoalescedEventsHistory(const Job &job)
+	{
+		SmartTime now(SmartTime::INIT_CURR_TIME);
+		UnifiedDataStore *store = UnifiedDataStore::getInstance();
+		const IncidentInfo &incident = *job.incidentInfo;
+		for (auto coalescedJob : job.coalescedJobs) {
+			IncidentHistory history;
+			history.id = AUTO_INCREMENT_VALUE;
+			history.unifiedEventId =
+			  coalescedJob->eventInfo->unifiedId;
+			history.userId = coalescedJob->userId;
+			history.status = incident.status;
+			history.comment = StringUtils::sprintf(
+			  "Coalesced into the incident %s: %s",
+			  incident.identifier.c_str(),
+			  incident.location.c_str());
+			history.createdAt.tv_sec = now.getAsTimespec().tv_sec;
+			history.createdAt.tv_nsec =
+			  now.getAsTimespec().tv_nsec;
+			store->addIncidentHistory(history);
+		}
+	}
+
+	/**
+	 * Send a job once on a worker of the pool. A failed job is
+	 * scheduled to retry without blocking the worker.
+	 */
+	void runJob(Job *job)
+	{
+		if (job->isCoalescing && !job->eventInfo && !job->numTrials) {
+			EventInfoList eventInfoList;
+			for (auto coalescedJob : job->coalescedJobs)
+				eventInfoList.push_back(*coalescedJob->eventInfo);
+			job->comment =
+			  sender.buildCoalescedEventsComment(eventInfoList);
 		}
-		if (result == HTERR_OK) {
+
+		job->notifyStatus(sender,
+		                  job->numTrials ? JOB_RETRYING : JOB_STARTED,
+		                  job->lastResult);
+		const HatoholError result = job->send(sender);
+		job->lastResult = result;
+		job->numTrials++;
+
+		const bool shouldRetry =
+		  result == HTERR_FAILED_TO_SEND_INCIDENT &&
+		  job->numTrials <= retryLimit && !sender.isExitRequested();
+		if (shouldRetry) {
+			job->notifyStatus(sender, JOB_WAITING_RETRY, result);
+		} else if (result == HTERR_OK) {
 			if (shouldRecordIncidentHistory)
-				saveIncidentHistory(job);
-			job.notifyStatus(sender, JOB_SUCCEEDED);
+				saveIncidentHistory(*job);
+			if (!job->coalescedJobs.empty())
+				saveCoalescedEventsHistory(*job);
+			job->notifyStatus(sender, JOB_SUCCEEDED, result);
+		} else {
+			job->notifyStatus(sender, JOB_FAILED, result);
+		}
+
+		lock_guard<mutex> lock(queueLock);
+		numInFlightJobs--;
+		if (shouldRetry) {
+			const steady_clock::time_point retryTime =
+			  steady_clock::now() + milliseconds(retryIntervalMSec);
+			retryQueue.insert(make_pair(retryTime, job));
 		} else {
-			job.notifyStatus(sender, JOB_FAILED);
+			finishJob(job, result == HTERR_OK);
 		}
-		return result;
+		jobCond.notify_all();
 	}
 };
 
@@ -230,15 +476,18 @@ IncidentSender::~IncidentSender()
 
 void IncidentSender::waitExit(void)
 {
-	m_impl->jobSemaphore.post();
+	m_impl->queueLock.lock();
+	m_impl->jobCond.notify_all();
+	m_impl->queueLock.unlock();
 	HatoholThreadBase::waitExit();
 }
 
 void IncidentSender::queue(const EventInfo &eventInfo,
 			   CreateIncidentCallback callback, void *userData,
-			   const UserIdType userId)
+			   const UserIdType userId, const bool coalescable)
 {
-	Job *job = new Job(eventInfo, callback, userData, userId);
+	Job *job = new Job(eventInfo, callback, userData, userId,
+			   coalescable);
 	m_impl->pushJob(job);
 }
 
@@ -261,12 +510,28 @@ void IncidentSender::setRetryInterval(const unsigned int &msec)
 	m_impl->retryIntervalMSec = msec;
 }
 
+void IncidentSender::setMaxInFlightJobs(const size_t &num)
+{
+	lock_guard<mutex> lock(m_impl->queueLock);
+	m_impl->maxInFlightJobs =
+	  std::max(std::min(num, MAX_IN_FLIGHT_JOBS_LIMIT), (size_t)1);
+	m_impl->jobCond.notify_all();
+}
+
+void IncidentSender::setCoalescingWindow(const unsigned int &msec)
+{
+	lock_guard<mutex> lock(m_impl->queueLock);
+	m_impl->coalescingWindowMSec = msec;
+}
+
 bool IncidentSender::isIdling(void)
 {
 	lock_guard<mutex> lock(m_impl->queueLock);
 	if (!m_impl->queue.empty())
 		return false;
-	return !m_impl->runningJob;
+	if (!m_impl->retryQueue.empty())
+		return false;
+	return !m_impl->numInFlightJobs;
 }
 
 const IncidentTrackerInfo IncidentSender::getIncidentTrackerInfo(void)
@@ -377,27 +642,49 @@ string IncidentSender::buildDescription(const EventInfo &event,
 	return desc;
 }
 
-const HatoholError &IncidentSender::getLastResult(void) const
-{
-	return m_impl->lastResult;
-}
-
-void IncidentSender::setLastResult(const HatoholError &err)
+string IncidentSender::buildCoalescedEventsComment(
+  const EventInfoList &eventInfoList)
 {
-	m_impl->lastResult = err;
+	string comment = StringUtils::sprintf(
+	  "%zd more event(s) occurred for this trigger:\n",
+	  eventInfoList.size());
+	for (const auto &event : eventInfoList) {
+		char timeString[128];
+		struct tm eventTime;
+		localtime_r(&event.time.tv_sec, &eventTime);
+		strftime(timeString, sizeof(timeString),
+			 "%a, %d %b %Y %T %z", &eventTime);
+		comment += StringUtils::sprintf(
+		  "* %s: %s (%s, Event ID: %" FMT_EVENT_ID ")\n",
+		  timeString,
+		  event.brief.c_str(),
+		  LabelUtils::getEventTypeLabel(event.type).c_str(),
+		  event.id.c_str());
+	}
+	return comment;
 }
 
 gpointer IncidentSender::mainThread(HatoholThreadArg *arg)
 {
 	const IncidentTrackerInfo &tracker = m_impl->incidentTrackerInfo;
-	Job *job;
 	MLPL_INFO("Start IncidentSender thread for %" FMT_INCIDENT_TRACKER_ID ":%s\n",
 		  tracker.id, tracker.nickname.c_str());
-	while ((job = m_impl->waitNextJob())) {
-		if (!isExitRequested())
-			m_impl->trySend(*job);
-		m_impl->runningJob = NULL;
-		delete job;
+	{
+		m_impl->queueLock.lock();
+		const size_t numWorkers = m_impl->maxInFlightJobs;
+		m_impl->queueLock.unlock();
+
+		// Jobs being sent are completed on the destruction.
+		WorkerPool workerPool(numWorkers);
+		unique_lock<mutex> lock(m_impl->queueLock);
+		while (!isExitRequested()) {
+			Job *job = m_impl->popJob();
+			if (!job) {
+				m_impl->waitNextJob(lock);
+				continue;
+			}
+			workerPool.post([this, job] { m_impl->runJob(job); });
+		}
 	}
 	MLPL_INFO("Exited IncidentSender thread for %" FMT_INCIDENT_TRACKER_ID ":%s\n",
 		  tracker.id, tracker.nickname.c_str());
@@ -37,15 +37,22 @@ public:
 		JOB_FAILED,
 	} JobStatus;
 
+	// 'result' is the result of the latest trial of the job. It's
+	// HTERR_OK until the job is tried.
 	typedef void (*CreateIncidentCallback)(const IncidentSender &sender,
 					       const EventInfo &info,
 					       const JobStatus &status,
+					       const HatoholError &result,
 					       void *userData);
 	typedef void (*UpdateIncidentCallback)(const IncidentSender &sender,
 					       const IncidentInfo &info,
 					       const JobStatus &status,
+					       const HatoholError &result,
 					       void *userData);
 
+	static const size_t DEFAULT_MAX_IN_FLIGHT_JOBS;
+	static const size_t MAX_IN_FLIGHT_JOBS_LIMIT;
+
 	IncidentSender(const IncidentTrackerInfo &tracker,
 		       bool shouldRecordIncidentHistory);
 	virtual ~IncidentSender();
@@ -106,12 +113,18 @@ public:
 	 * @param userId
 	 * The user ID of the operator.
 	 *
+	 * @param coalescable
+	 * If true, the event may be coalesced into the incident of an
+	 * earlier coalescable event of the same trigger
+	 * (see setCoalescingWindow()).
+	 *
 	 * @return HTERR_OK on succeeded to send. Otherwise an error.
 	 */
 	void queue(const EventInfo &eventInfo,
 		   CreateIncidentCallback callback = NULL,
 		   void *userData = NULL,
-		   const UserIdType userId = USER_ID_SYSTEM);
+		   const UserIdType userId = USER_ID_SYSTEM,
+		   const bool coalescable = false);
 
 	/**
 	 * Queue an IncidentInfo to update existing one. Sending an incident
@@ -161,6 +174,29 @@ public:
 	 */
 	void setRetryInterval(const unsigned int &msec);
 
+	/**
+	 * Set the max number of queued jobs that are sent concurrently.
+	 * A job waiting for a retry doesn't occupy the window.
+	 *
+	 * @param num
+	 * The number of jobs. It's rounded into 1 to
+	 * MAX_IN_FLIGHT_JOBS_LIMIT. The number of the sending threads is
+	 * decided with this value on start().
+	 */
+	void setMaxInFlightJobs(const size_t &num);
+
+	/**
+	 * Set the window to coalesce events of the same trigger.
+	 * A coalescable event queued within the window since the first
+	 * event of the trigger doesn't create a new incident. Such events
+	 * are posted as a comment to the incident of the first event
+	 * instead, and the incident is recorded in their incident histories.
+	 *
+	 * @param msec
+	 * The length of the window [msec]. 0 disables coalescing.
+	 */
+	void setCoalescingWindow(const unsigned int &msec);
+
 	/**
 	 * Check whether all queued sending jobs are finished or not.
 	 *
@@ -172,8 +208,6 @@ public:
 	const IncidentTrackerInfo getIncidentTrackerInfo(void);
 	void setOnChangedIncidentTracker(void);
 
-	const HatoholError &getLastResult(void) const;
-
 protected:
 	bool getServerInfo(const EventInfo &event,
 			   MonitoringServerInfo &server);
@@ -183,7 +217,8 @@ protected:
 	virtual std::string buildDescription(
 	  const EventInfo &event,
 	  const MonitoringServerInfo *server);
-	void setLastResult(const HatoholError &err);
+	virtual std::string buildCoalescedEventsComment(
+	  const EventInfoList &eventInfoList);
 
 	virtual gpointer mainThread(HatoholThreadArg *arg) override;
 
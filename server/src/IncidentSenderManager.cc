@@ -24,6 +24,7 @@
 #include "IncidentSenderRedmine.h"
 #include "IncidentSenderHatohol.h"
 #include "ThreadLocalDBCache.h"
+#include "ConfigManager.h"
 
 using namespace std;
 using namespace mlpl;
@@ -79,6 +80,11 @@ struct IncidentSenderManager::Impl
 				 tracker.type);
 			break;
 		}
+
+		const int numJobs =
+		  ConfigManager::getInstance()->getNumberOfIncidentSenderJobs();
+		if (sender && numJobs > 0)
+			sender->setMaxInFlightJobs(numJobs);
 		return sender;
 	}
 
@@ -126,7 +132,7 @@ IncidentSenderManager &IncidentSenderManager::getInstance(void)
 HatoholError IncidentSenderManager::queue(
   const IncidentTrackerIdType &trackerId, const EventInfo &eventInfo,
   IncidentSender::CreateIncidentCallback callback, void *userData,
-  const UserIdType userId)
+  const UserIdType userId, const bool coalescable)
 {
 	IncidentSender *sender = m_impl->getSender(trackerId);
 	if (!sender) {
@@ -135,7 +141,7 @@ HatoholError IncidentSenderManager::queue(
 			 eventInfo.id.c_str());
 		return HTERR_FAILED_TO_SEND_INCIDENT;
 	}
-	sender->queue(eventInfo, callback, userData, userId);
+	sender->queue(eventInfo, callback, userData, userId, coalescable);
 	return HTERR_OK;
 }
 
@@ -43,6 +43,9 @@ public:
 	 * A data which is passed to the callback function.
 	 * @param userId
 	 * The user ID of the operator.
+	 * @param coalescable
+	 * If true, the event may be coalesced into the incident of an
+	 * earlier event of the same trigger.
 	 *
 	 * @return A HatoholError instance.
 	 */
@@ -50,7 +53,8 @@ public:
 			   const EventInfo &event,
 			   IncidentSender::CreateIncidentCallback callback = NULL,
 			   void *userData = NULL,
-			   const UserIdType userId = USER_ID_SYSTEM);
+			   const UserIdType userId = USER_ID_SYSTEM,
+			   const bool coalescable = false);
 
 	/**
 	 * Queue a job to update an incident.
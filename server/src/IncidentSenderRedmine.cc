@@ -31,6 +31,7 @@ using namespace std;
 using namespace mlpl;
 
 static const guint DEFAULT_TIMEOUT_SECONDS = 60;
+static const unsigned int DEFAULT_COALESCING_WINDOW_MSEC = 60 * 1000;
 static const char *MIME_JSON = "application/json";
 
 struct IncidentSenderRedmine::Impl
@@ -38,8 +39,14 @@ struct IncidentSenderRedmine::Impl
 	Impl(IncidentSenderRedmine &sender)
 	: m_sender(sender), m_session(NULL)
 	{
+		// Workers of the sender share the session. So the
+		// connections are kept alive and reused by them.
+		const int maxConns = IncidentSender::MAX_IN_FLIGHT_JOBS_LIMIT;
 		m_session = soup_session_sync_new_with_options(
-			SOUP_SESSION_TIMEOUT, DEFAULT_TIMEOUT_SECONDS, NULL);
+			SOUP_SESSION_TIMEOUT, DEFAULT_TIMEOUT_SECONDS,
+			SOUP_SESSION_MAX_CONNS, maxConns,
+			SOUP_SESSION_MAX_CONNS_PER_HOST, maxConns,
+			NULL);
 		connectSessionSignals();
 	}
 	virtual ~Impl()
@@ -73,6 +80,7 @@ IncidentSenderRedmine::IncidentSenderRedmine(
 : IncidentSender(tracker, shouldRecordIncidentHistory),
   m_impl(new Impl(*this))
 {
+	setCoalescingWindow(DEFAULT_COALESCING_WINDOW_MSEC);
 }
 
 IncidentSenderRedmine::~IncidentSenderRedmine()
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <mutex>
+#include "LatencyHistogram.h"
+using namespace std;
+using namespace std::chrono;
+
+struct LatencyHistogram::Impl {
+	mutable mutex lock;
+	Snapshot      data;
+
+	Impl(void)
+	{
+		data.buckets.resize(NUM_BUCKETS, 0);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Snapshot
+// ---------------------------------------------------------------------------
+LatencyHistogram::Snapshot::Snapshot(void)
+: count(0),
+  sum(0),
+  min(0),
+  max(0)
+{
+}
+
+uint64_t LatencyHistogram::Snapshot::getValueAtPercentile(
+  const double &percentile) const
+{
+	if (count == 0)
+		return 0;
+	double ratio = percentile / 100.0;
+	if (ratio < 0)
+		ratio = 0;
+	else if (ratio > 1)
+		ratio = 1;
+	uint64_t rank = static_cast<uint64_t>(ratio * count + 0.5);
+	if (rank == 0)
+		rank = 1;
+
+	uint64_t accumulated = 0;
+	for (size_t i = 0; i < buckets.size(); i++) {
+		accumulated += buckets[i];
+		if (accumulated < rank)
+			continue;
+		const uint64_t value = getBucketUpperBound(i);
+		return (value < max) ? value : max;
+	}
+	return max;
+}
+
+double LatencyHistogram::Snapshot::getMean(void) const
+{
+	if (count == 0)
+		return 0;
+	return static_cast<double>(sum) / count;
+}
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram(void)
+: m_impl(new Impl())
+{
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+}
+
+void LatencyHistogram::record(const uint64_t &usec)
+{
+	const size_t index = getBucketIndex(usec);
+	lock_guard<mutex> lock(m_impl->lock);
+	Snapshot &data = m_impl->data;
+	if (data.count == 0 || usec < data.min)
+		data.min = usec;
+	if (usec > data.max)
+		data.max = usec;
+	data.count++;
+	data.sum += usec;
+	data.buckets[index]++;
+}
+
+void LatencyHistogram::recordSince(const steady_clock::time_point &startTime)
+{
+	const steady_clock::duration elapsed = steady_clock::now() - startTime;
+	record(duration_cast<microseconds>(elapsed).count());
+}
+
+void LatencyHistogram::getSnapshot(Snapshot &snapshot) const
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	snapshot = m_impl->data;
+}
+
+void LatencyHistogram::reset(void)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->data = Snapshot();
+	m_impl->data.buckets.resize(NUM_BUCKETS, 0);
+}
+
+size_t LatencyHistogram::getBucketIndex(const uint64_t &value)
+{
+	if (value < SUB_BUCKET_COUNT)
+		return value;
+	const size_t msb = 63 - __builtin_clzll(value);
+	const size_t shift = msb - SUB_BUCKET_BITS;
+	const size_t subIndex = (value >> shift) - SUB_BUCKET_COUNT;
+	return (shift + 1) * SUB_BUCKET_COUNT + subIndex;
+}
+
+uint64_t LatencyHistogram::getBucketLowerBound(const size_t &index)
+{
+	if (index < SUB_BUCKET_COUNT)
+		return index;
+	const size_t shift = index / SUB_BUCKET_COUNT - 1;
+	const uint64_t subIndex = index % SUB_BUCKET_COUNT;
+	return (SUB_BUCKET_COUNT + subIndex) << shift;
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(const size_t &index)
+{
+	if (index < SUB_BUCKET_COUNT)
+		return index;
+	const size_t shift = index / SUB_BUCKET_COUNT - 1;
+	return getBucketLowerBound(index) + ((uint64_t)1 << shift) - 1;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LatencyHistogram_h
+#define LatencyHistogram_h
+
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <stdint.h>
+
+/**
+ * A histogram of latencies in microseconds with log-linear buckets
+ * like HdrHistogram. Values under 2^SUB_BUCKET_BITS have their own
+ * buckets. Each power of two above that is divided into
+ * 2^SUB_BUCKET_BITS buckets, so the relative error of a value is
+ * at most 1/2^SUB_BUCKET_BITS.
+ *
+ * Methods are MT-safe.
+ */
+class LatencyHistogram {
+public:
+	static const size_t SUB_BUCKET_BITS = 4;
+	static const size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+	static const size_t NUM_BUCKETS =
+	  (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+	struct Snapshot {
+		uint64_t count;
+		uint64_t sum;
+		uint64_t min;
+		uint64_t max;
+		std::vector<uint64_t> buckets;
+
+		Snapshot(void);
+
+		/**
+		 * Get the value at the percentile.
+		 *
+		 * @param percentile A percentile from 0 to 100.
+		 *
+		 * @return
+		 * The largest value that is in the same bucket as the value
+		 * at the percentile. It is not greater than 'max'.
+		 * 0 if no value is recorded.
+		 */
+		uint64_t getValueAtPercentile(const double &percentile) const;
+
+		double getMean(void) const;
+	};
+
+	LatencyHistogram(void);
+	virtual ~LatencyHistogram();
+
+	void record(const uint64_t &usec);
+
+	/**
+	 * Record the elapsed time from 'startTime' to now.
+	 *
+	 * @param startTime A start time of the measured interval.
+	 */
+	void recordSince(
+	  const std::chrono::steady_clock::time_point &startTime);
+
+	void getSnapshot(Snapshot &snapshot) const;
+	void reset(void);
+
+	static size_t getBucketIndex(const uint64_t &value);
+	static uint64_t getBucketLowerBound(const size_t &index);
+	static uint64_t getBucketUpperBound(const size_t &index);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // LatencyHistogram_h
@@ -28,6 +28,29 @@ using namespace mlpl;
 
 struct ResidentCommunicator::Impl {
 	SmartBuffer sbuf;
+
+	void addNotifyEventBody(const ActionIdType &actionId,
+	                        const EventInfo &eventInfo,
+	                        const string &sessionId)
+	{
+		// Strings are put after the fixed-length part. Their offsets
+		// are relative to each string header, so the body can be
+		// placed at any position of the packet.
+		size_t bodyIdx =
+		  sbuf.index() + RESIDENT_PROTO_EVENT_BODY_BASE_LEN;
+		sbuf.add32(actionId);
+		sbuf.add32(eventInfo.serverId);
+		bodyIdx = sbuf.insertString(eventInfo.hostIdInServer, bodyIdx);
+		sbuf.add64(eventInfo.time.tv_sec);
+		sbuf.add32(eventInfo.time.tv_nsec);
+		bodyIdx = sbuf.insertString(eventInfo.id, bodyIdx);
+		sbuf.add16(eventInfo.type);
+		bodyIdx = sbuf.insertString(eventInfo.triggerId, bodyIdx);
+		sbuf.add16(eventInfo.status);
+		sbuf.add16(eventInfo.severity);
+		sbuf.add(sessionId.c_str(), HATOHOL_SESSION_ID_LEN);
+		sbuf.setIndex(bodyIdx);
+	}
 };
 
 // This variable is only used for consistency check on the build.
@@ -112,27 +135,9 @@ void ResidentCommunicator::setNotifyEventBody(
   const ActionIdType &actionId, const EventInfo &eventInfo,
   const string &sessionId)
 {
-	const size_t lenNullTerm = 1;
-	const uint32_t bodySize =
-	  RESIDENT_PROTO_EVENT_BODY_BASE_LEN +
-	  eventInfo.hostIdInServer.size() + lenNullTerm +
-	  eventInfo.id.size()             + lenNullTerm +
-	  eventInfo.triggerId.size()      + lenNullTerm;
-	size_t bodyIdx =
-	  RESIDENT_PROTO_HEADER_LEN + RESIDENT_PROTO_EVENT_BODY_BASE_LEN;
-	setHeader(bodySize,
+	setHeader(calcNotifyEventBodySize(eventInfo),
 	          RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT);
-	m_impl->sbuf.add32(actionId);
-	m_impl->sbuf.add32(eventInfo.serverId);
-	bodyIdx = m_impl->sbuf.insertString(eventInfo.hostIdInServer, bodyIdx);
-	m_impl->sbuf.add64(eventInfo.time.tv_sec);
-	m_impl->sbuf.add32(eventInfo.time.tv_nsec);
-	bodyIdx = m_impl->sbuf.insertString(eventInfo.id, bodyIdx);
-	m_impl->sbuf.add16(eventInfo.type);
-	bodyIdx = m_impl->sbuf.insertString(eventInfo.triggerId, bodyIdx);
-	m_impl->sbuf.add16(eventInfo.status);
-	m_impl->sbuf.add16(eventInfo.severity);
-	m_impl->sbuf.add(sessionId.c_str(), HATOHOL_SESSION_ID_LEN);
+	m_impl->addNotifyEventBody(actionId, eventInfo, sessionId);
 }
 
 void ResidentCommunicator::setNotifyEventAck(uint32_t resultCode)
@@ -141,3 +146,43 @@ void ResidentCommunicator::setNotifyEventAck(uint32_t resultCode)
 	          RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_ACK);
 	m_impl->sbuf.add32(resultCode);
 }
+
+size_t ResidentCommunicator::calcNotifyEventBodySize(const EventInfo &eventInfo)
+{
+	const size_t lenNullTerm = 1;
+	return RESIDENT_PROTO_EVENT_BODY_BASE_LEN +
+	       eventInfo.hostIdInServer.size() + lenNullTerm +
+	       eventInfo.id.size()             + lenNullTerm +
+	       eventInfo.triggerId.size()      + lenNullTerm;
+}
+
+void ResidentCommunicator::setNotifyEventBatchHeader(uint32_t bodySize,
+                                                     uint16_t numEvents)
+{
+	setHeader(bodySize, RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH);
+	m_impl->sbuf.add16(numEvents);
+}
+
+void ResidentCommunicator::addNotifyEventBatchItem(
+  uint32_t requestId, const ActionIdType &actionId,
+  const EventInfo &eventInfo, const string &sessionId)
+{
+	m_impl->sbuf.add32(requestId);
+	m_impl->sbuf.add32(calcNotifyEventBodySize(eventInfo));
+	m_impl->addNotifyEventBody(actionId, eventInfo, sessionId);
+}
+
+void ResidentCommunicator::setNotifyEventBatchAckHeader(uint16_t numResults)
+{
+	setHeader(RESIDENT_PROTO_EVENT_BATCH_ACK_NUM_RESULTS_LEN +
+	          RESIDENT_PROTO_EVENT_BATCH_ACK_RESULT_LEN * numResults,
+	          RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH_ACK);
+	m_impl->sbuf.add16(numResults);
+}
+
+void ResidentCommunicator::addNotifyEventBatchAckResult(uint32_t requestId,
+                                                        uint32_t resultCode)
+{
+	m_impl->sbuf.add32(requestId);
+	m_impl->sbuf.add32(resultCode);
+}
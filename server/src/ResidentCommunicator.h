@@ -57,6 +57,36 @@ public:
 	                        const std::string &sessionId);
 	void setNotifyEventAck(uint32_t resuletCode);
 
+	/**
+	 * Calculate the size of a Notify Event body for the event.
+	 *
+	 * @param eventInfo An EventInfo instance to be notified.
+	 * @return The body size in bytes.
+	 */
+	static size_t calcNotifyEventBodySize(const EventInfo &eventInfo);
+
+	/**
+	 * Set the header of a Notify Event Batch packet.
+	 *
+	 * The caller has to add exactly 'numEvents' items with
+	 * addNotifyEventBatchItem() after calling this function.
+	 *
+	 * @param bodySize
+	 * The body size. It is the sum of
+	 * RESIDENT_PROTO_EVENT_BATCH_NUM_EVENTS_LEN and
+	 * RESIDENT_PROTO_EVENT_BATCH_ITEM_HEADER_LEN +
+	 * calcNotifyEventBodySize() for each item.
+	 * @param numEvents The number of items.
+	 */
+	void setNotifyEventBatchHeader(uint32_t bodySize, uint16_t numEvents);
+	void addNotifyEventBatchItem(uint32_t requestId,
+	                             const ActionIdType &actionId,
+	                             const EventInfo &eventInfo,
+	                             const std::string &sessionId);
+	void setNotifyEventBatchAckHeader(uint16_t numResults);
+	void addNotifyEventBatchAckResult(uint32_t requestId,
+	                                  uint32_t resultCode);
+
 private:
 	struct Impl;
 	std::unique_ptr<Impl> m_impl;
@@ -32,6 +32,8 @@ enum
 	RESIDENT_PROTO_PKT_TYPE_PARAMETERS,
 	RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT,
 	RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_ACK,
+	RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH,
+	RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH_ACK,
 };
 
 static const uint16_t HATOHOL_SESSION_ID_LEN = 36;
@@ -145,6 +147,54 @@ static const size_t RESIDENT_PROTO_EVENT_BODY_BASE_LEN =
 
 static const size_t RESIDENT_PROTO_EVENT_ACK_CODE_LEN = 4;
 
+// [Notify Event Batch]
+// Direction: Master -> Slave
+// packet type: RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH
+// <Body>
+// Bytes: Description
+//    2U: The number of events (N).
+//     V: N items with the following structure.
+//
+// <Item>
+//    4U: Request ID. This is echoed back in the Notify Event Batch Ack.
+//    4U: Item body size (not including the request ID and this field)
+//     V: Item body. The layout is the same as the body of Notify Event.
+//        The offsets in the string headers are relative to each header.
+//
+// The master can send the next batch before the ack of the previous one
+// arrives. The slave processes items in the order of arrival, and
+// acknowledges each item as soon as it is processed, because the master
+// applies the action's timeout to every ack.
+
+static const size_t RESIDENT_PROTO_EVENT_BATCH_NUM_EVENTS_LEN = 2;
+static const size_t RESIDENT_PROTO_EVENT_BATCH_REQUEST_ID_LEN = 4;
+static const size_t RESIDENT_PROTO_EVENT_BATCH_ITEM_SIZE_LEN  = 4;
+
+static const size_t RESIDENT_PROTO_EVENT_BATCH_ITEM_HEADER_LEN =
+ RESIDENT_PROTO_EVENT_BATCH_REQUEST_ID_LEN +
+ RESIDENT_PROTO_EVENT_BATCH_ITEM_SIZE_LEN;
+
+static const size_t RESIDENT_PROTO_EVENT_BATCH_MAX_NUM_EVENTS = 64;
+
+// [Notify Event Batch Ack]
+// Direction: Slave -> Master
+// packet type: RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH_ACK
+// <Body>
+// Bytes: Description
+//    2U: The number of results (N).
+//     V: N results with the following structure in the same order as
+//        the items were sent. N can be smaller than the number of the
+//        items of the corresponding Notify Event Batch.
+//
+// <Result>
+//    4U: Request ID.
+//    4U: result code.
+
+static const size_t RESIDENT_PROTO_EVENT_BATCH_ACK_NUM_RESULTS_LEN = 2;
+static const size_t RESIDENT_PROTO_EVENT_BATCH_ACK_RESULT_LEN =
+ RESIDENT_PROTO_EVENT_BATCH_REQUEST_ID_LEN +
+ RESIDENT_PROTO_EVENT_ACK_CODE_LEN;
+
 //
 // Module information
 //
@@ -236,6 +236,7 @@ static HatoholError parseIncidentParameter(
 static void sendIncidentCallback(const IncidentSender &sender,
 				 const UnifiedEventIdType &eventId,
 				 const IncidentSender::JobStatus &status,
+				 const HatoholError &result,
 				 void *userData)
 {
 	RestResourceIncident *job = static_cast<RestResourceIncident *>(userData);
@@ -255,7 +256,7 @@ static void sendIncidentCallback(const IncidentSender &sender,
 		break;
 	}
 	case IncidentSender::JOB_FAILED:
-		job->replyError(sender.getLastResult());
+		job->replyError(result);
 		job->unpauseResponse();
 		job->unref();
 		break;
@@ -267,19 +268,21 @@ static void sendIncidentCallback(const IncidentSender &sender,
 static void createIncidentCallback(const IncidentSender &sender,
 				   const EventInfo &eventInfo,
 				   const IncidentSender::JobStatus &status,
+				   const HatoholError &result,
 				   void *userData)
 {
 	const UnifiedEventIdType &eventId = eventInfo.unifiedId;
-	sendIncidentCallback(sender, eventId, status, userData);
+	sendIncidentCallback(sender, eventId, status, result, userData);
 }
 
 static void updateIncidentCallback(const IncidentSender &sender,
 				   const IncidentInfo &incidentInfo,
 				   const IncidentSender::JobStatus &status,
+				   const HatoholError &result,
 				   void *userData)
 {
 	const UnifiedEventIdType &eventId = incidentInfo.unifiedEventId;
-	sendIncidentCallback(sender, eventId, status, userData);
+	sendIncidentCallback(sender, eventId, status, result, userData);
 }
 
 void RestResourceIncident::createIncidentAsync(
@@ -20,6 +20,8 @@
 #include "RestResourceMonitoring.h"
 #include "RestResourceUtils.h"
 #include "UnifiedDataStore.h"
+#include "TriggerStatisticsCache.h"
+#include "ConfigManager.h"
 #include <string.h>
 
 using namespace std;
@@ -112,6 +114,116 @@ static HatoholError parseItemParameter(ItemsQueryOption &option,
 	return HatoholError(HTERR_OK);
 }
 
+static void makeOverviewTriggersQueryOption(
+  TriggersQueryOption &option, const ServerIdType &serverId)
+{
+	option.setExcludeFlags(EXCLUDE_INVALID_HOST|EXCLUDE_SELF_MONITORING);
+	option.setTargetServerId(serverId);
+}
+
+static void getOverviewServerStatistics(
+  FaceRest::ResourceHandler *job, const ServerIdType &serverId,
+  TriggerStatistics &statistics)
+{
+	TriggersQueryOption option(job->m_dataQueryContextPtr);
+	makeOverviewTriggersQueryOption(option, serverId);
+	if (ConfigManager::getInstance()->isTriggerStatisticsCacheEnabled()) {
+		// Only the privilege is checked here. The counters are kept
+		// in memory.
+		HostgroupIdSet allowedHostgroupIdSet;
+		if (!option.getAllowedHostgroupIdSet(allowedHostgroupIdSet,
+		                                     serverId))
+			return;
+		TriggerStatisticsCache::getInstance().get(
+		  statistics, serverId, allowedHostgroupIdSet);
+		return;
+	}
+
+	UnifiedDataStore *dataStore = UnifiedDataStore::getInstance();
+	statistics.numTriggers = dataStore->getNumberOfTriggers(option);
+	statistics.numBadTriggers =
+	  dataStore->getNumberOfBadTriggers(option, TRIGGER_SEVERITY_ALL);
+	statistics.numBadHosts = dataStore->getNumberOfBadHosts(option);
+}
+
+static void setOverviewHostgroupStatistics(
+  const HostgroupIdType &hostgroupId, const TriggerStatistics &statistics,
+  DBTablesMonitoring::BadTriggerCountMatrix &badTriggerCountMatrix,
+  DBTablesMonitoring::HostStatusCountMap &hostStatusCountMap)
+{
+	DBTablesMonitoring::TriggerSeverityCounts &severityCounts =
+	  badTriggerCountMatrix[hostgroupId];
+	for (int i = 0; i < NUM_TRIGGER_SEVERITY; i++)
+		severityCounts[i] = statistics.numBadTriggersBySeverity[i];
+	DBTablesMonitoring::HostStatusCounts &hostStatusCounts =
+	  hostStatusCountMap[hostgroupId];
+	hostStatusCounts.numGoodHosts = statistics.getNumberOfGoodHosts();
+	hostStatusCounts.numBadHosts = statistics.numBadHosts;
+}
+
+static HatoholError getOverviewHostgroupStatistics(
+  FaceRest::ResourceHandler *job, const ServerIdType &serverId,
+  const HostgroupVect &hostgroups,
+  DBTablesMonitoring::BadTriggerCountMatrix &badTriggerCountMatrix,
+  DBTablesMonitoring::HostStatusCountMap &hostStatusCountMap)
+{
+	TriggersQueryOption option(job->m_dataQueryContextPtr);
+	makeOverviewTriggersQueryOption(option, serverId);
+	HostgroupIdSet allowedHostgroupIdSet;
+	if (!option.getAllowedHostgroupIdSet(allowedHostgroupIdSet, serverId))
+		return HTERR_OK;
+
+	if (ConfigManager::getInstance()->isTriggerStatisticsCacheEnabled()) {
+		TriggerStatisticsCache &statisticsCache =
+		  TriggerStatisticsCache::getInstance();
+		for (const auto &hostgroup : hostgroups) {
+			const HostgroupIdType &hostgroupId =
+			  hostgroup.idInServer;
+			TriggerStatistics statistics;
+			if (hostgroupId == ALL_HOST_GROUPS) {
+				statisticsCache.get(statistics, serverId,
+				                    allowedHostgroupIdSet);
+			} else {
+				statisticsCache.get(statistics, serverId,
+				                    hostgroupId);
+			}
+			setOverviewHostgroupStatistics(
+			  hostgroupId, statistics,
+			  badTriggerCountMatrix, hostStatusCountMap);
+		}
+		return HTERR_OK;
+	}
+
+	UnifiedDataStore *dataStore = UnifiedDataStore::getInstance();
+	HatoholError err =
+	  dataStore->getBadTriggerCountMatrix(badTriggerCountMatrix, option);
+	if (err != HTERR_OK)
+		return err;
+	err = dataStore->getHostStatusCountMap(hostStatusCountMap, option);
+	if (err != HTERR_OK)
+		return err;
+
+	// The pseudo hostgroup for the whole server isn't in the results
+	// grouped by hostgroup.
+	for (const auto &hostgroup : hostgroups) {
+		if (hostgroup.idInServer != ALL_HOST_GROUPS)
+			continue;
+		DBTablesMonitoring::TriggerSeverityCounts &severityCounts =
+		  badTriggerCountMatrix[ALL_HOST_GROUPS];
+		for (int i = 0; i < NUM_TRIGGER_SEVERITY; i++) {
+			severityCounts[i] = dataStore->getNumberOfBadTriggers(
+			  option, (TriggerSeverityType)i);
+		}
+		DBTablesMonitoring::HostStatusCounts &hostStatusCounts =
+		  hostStatusCountMap[ALL_HOST_GROUPS];
+		hostStatusCounts.numGoodHosts =
+		  dataStore->getNumberOfGoodHosts(option);
+		hostStatusCounts.numBadHosts =
+		  dataStore->getNumberOfBadHosts(option);
+	}
+	return HTERR_OK;
+}
+
 static HatoholError addOverviewEachServer(FaceRest::ResourceHandler *job,
 					  JSONBuilder &agent,
 					  MonitoringServerInfo &svInfo,
@@ -143,19 +255,12 @@ static HatoholError addOverviewEachServer(FaceRest::ResourceHandler *job,
 				      fetchItemsSynchronously);
 	agent.add("numberOfItems", numberOfItems);
 
-	TriggerInfoList triggerInfoList;
-	TriggersQueryOption triggersQueryOption(job->m_dataQueryContextPtr);
-	triggersQueryOption.setTargetServerId(svInfo.id);
-	triggersQueryOption.setExcludeFlags(EXCLUDE_INVALID_HOST|EXCLUDE_SELF_MONITORING);
-	agent.add("numberOfTriggers",
-		  dataStore->getNumberOfTriggers(triggersQueryOption));
-	const size_t numBadHosts =
-	  dataStore->getNumberOfBadHosts(triggersQueryOption);
-	agent.add("numberOfBadHosts", numBadHosts);
-	serverIsGoodStatus = (numBadHosts == 0);
-	size_t numBadTriggers = dataStore->getNumberOfBadTriggers(
-				  triggersQueryOption, TRIGGER_SEVERITY_ALL);
-	agent.add("numberOfBadTriggers", numBadTriggers);
+	TriggerStatistics serverStatistics;
+	getOverviewServerStatistics(job, svInfo.id, serverStatistics);
+	agent.add("numberOfTriggers", serverStatistics.numTriggers);
+	agent.add("numberOfBadHosts", serverStatistics.numBadHosts);
+	serverIsGoodStatus = (serverStatistics.numBadHosts == 0);
+	agent.add("numberOfBadTriggers", serverStatistics.numBadTriggers);
 
 	// TODO: These elements should be fixed
 	// after the funtion concerned is added
@@ -188,24 +293,27 @@ static HatoholError addOverviewEachServer(FaceRest::ResourceHandler *job,
 	}
 	agent.endObject();
 
+	// Statistics of each hostgroup
+	DBTablesMonitoring::BadTriggerCountMatrix badTriggerCountMatrix;
+	DBTablesMonitoring::HostStatusCountMap hostStatusCountMap;
+	err = getOverviewHostgroupStatistics(job, svInfo.id, hostgroups,
+	                                     badTriggerCountMatrix,
+	                                     hostStatusCountMap);
+	if (err != HTERR_OK)
+		return err;
+
 	// SystemStatus
 	agent.startArray("systemStatus");
-	HostgroupVectConstIterator hostgrpItr = hostgroups.begin();
-	for (; hostgrpItr != hostgroups.end(); ++ hostgrpItr) {
-		const HostgroupIdType &hostgroupId = hostgrpItr->idInServer;
+	for (const auto &hostgroup : hostgroups) {
+		const HostgroupIdType &hostgroupId = hostgroup.idInServer;
+		const DBTablesMonitoring::TriggerSeverityCounts &severityCounts
+		  = badTriggerCountMatrix[hostgroupId];
 		for (int severity = 0;
 		     severity < NUM_TRIGGER_SEVERITY; severity++) {
-			TriggersQueryOption option(job->m_dataQueryContextPtr);
-			option.setExcludeFlags(EXCLUDE_INVALID_HOST|EXCLUDE_SELF_MONITORING);
-			option.setTargetServerId(svInfo.id);
-			option.setTargetHostgroupId(hostgroupId);
 			agent.startObject();
 			agent.add("hostgroupId", hostgroupId);
 			agent.add("severity", severity);
-			agent.add(
-			  "numberOfTriggers",
-			  dataStore->getNumberOfBadTriggers
-			    (option, (TriggerSeverityType)severity));
+			agent.add("numberOfTriggers", severityCounts[severity]);
 			agent.endObject();
 		}
 	}
@@ -213,19 +321,14 @@ static HatoholError addOverviewEachServer(FaceRest::ResourceHandler *job,
 
 	// HostStatus
 	agent.startArray("hostStatus");
-	hostgrpItr = hostgroups.begin();
-	for (; hostgrpItr != hostgroups.end(); ++ hostgrpItr) {
-		const HostgroupIdType &hostgroupId = hostgrpItr->idInServer;
-		TriggersQueryOption option(job->m_dataQueryContextPtr);
-		option.setExcludeFlags(EXCLUDE_INVALID_HOST|EXCLUDE_SELF_MONITORING);
-		option.setTargetServerId(svInfo.id);
-		option.setTargetHostgroupId(hostgroupId);
-		size_t numBadHosts = dataStore->getNumberOfBadHosts(option);
+	for (const auto &hostgroup : hostgroups) {
+		const HostgroupIdType &hostgroupId = hostgroup.idInServer;
+		const DBTablesMonitoring::HostStatusCounts &hostStatusCounts =
+		  hostStatusCountMap[hostgroupId];
 		agent.startObject();
 		agent.add("hostgroupId", hostgroupId);
-		agent.add("numberOfGoodHosts",
-		          dataStore->getNumberOfGoodHosts(option));
-		agent.add("numberOfBadHosts", numBadHosts);
+		agent.add("numberOfGoodHosts", hostStatusCounts.numGoodHosts);
+		agent.add("numberOfBadHosts", hostStatusCounts.numBadHosts);
 		agent.endObject();
 	}
 	agent.endArray();
@@ -265,6 +368,13 @@ static HatoholError addOverview(FaceRest::ResourceHandler *job, JSONBuilder &age
 
 void RestResourceMonitoring::handlerGetOverview(void)
 {
+	if (replyIfUnchanged({DATA_GENERATION_TRIGGER,
+	                      DATA_GENERATION_ITEM,
+	                      DATA_GENERATION_HOST,
+	                      DATA_GENERATION_CONFIG,
+	                      DATA_GENERATION_USER}))
+		return;
+
 	JSONBuilder agent;
 	HatoholError err;
 	agent.startObject();
@@ -309,6 +419,11 @@ static void addHosts(FaceRest::ResourceHandler *job, JSONBuilder &agent,
 
 void RestResourceMonitoring::handlerGetHost(void)
 {
+	if (replyIfUnchanged({DATA_GENERATION_HOST,
+	                      DATA_GENERATION_CONFIG,
+	                      DATA_GENERATION_USER}))
+		return;
+
 	HostsQueryOption option(m_dataQueryContextPtr);
 	HatoholError err
 	  = RestResourceUtils::parseHostResourceQueryParameter(option, m_query);
@@ -331,6 +446,12 @@ void RestResourceMonitoring::handlerGetHost(void)
 
 void RestResourceMonitoring::handlerGetTrigger(void)
 {
+	if (replyIfUnchanged({DATA_GENERATION_TRIGGER,
+	                      DATA_GENERATION_HOST,
+	                      DATA_GENERATION_CONFIG,
+	                      DATA_GENERATION_USER}))
+		return;
+
 	TriggersQueryOption option(m_dataQueryContextPtr);
 	HatoholError err = RestResourceUtils::parseTriggerParameter(option, m_query);
 	if (err != HTERR_OK) {
@@ -412,9 +533,17 @@ static void addIncident(FaceRest::ResourceHandler *job, JSONBuilder &agent,
 
 void RestResourceMonitoring::handlerGetEvent(void)
 {
+	// The action table decides whether incidents are attached or not.
+	if (replyIfUnchanged({DATA_GENERATION_EVENT,
+	                      DATA_GENERATION_INCIDENT,
+	                      DATA_GENERATION_HOST,
+	                      DATA_GENERATION_CONFIG,
+	                      DATA_GENERATION_USER,
+	                      DATA_GENERATION_ACTION}))
+		return;
+
 	UnifiedDataStore *dataStore = UnifiedDataStore::getInstance();
 
-	EventInfoList eventList;
 	EventsQueryOption option(m_dataQueryContextPtr);
 	bool isCountOnly = false;
 	HatoholError err =
@@ -437,19 +566,6 @@ void RestResourceMonitoring::handlerGetEvent(void)
 	}
 
 	bool addIncidents = dataStore->isIncidentSenderActionEnabled();
-	IncidentInfoVect incidentVect;
-	if (addIncidents) {
-		err = dataStore->getEventList(eventList, option, &incidentVect);
-		HATOHOL_ASSERT(eventList.size() == incidentVect.size(),
-			       "eventList: %zd, incidentVect: %zd\n",
-			       eventList.size(), incidentVect.size());
-	} else {
-		err = dataStore->getEventList(eventList, option);
-	}
-	if (err != HTERR_OK) {
-		replyError(err);
-		return;
-	}
 
 	JSONBuilder agent;
 	agent.startObject();
@@ -460,10 +576,11 @@ void RestResourceMonitoring::handlerGetEvent(void)
 		agent.addTrue("haveIncident");
 	else
 		agent.addFalse("haveIncident");
-	agent.startArray("events");
-	EventInfoListIterator it = eventList.begin();
-	for (size_t i = 0; it != eventList.end(); ++i, ++it) {
-		EventInfo &eventInfo = *it;
+
+	// The events are written as they are read from the DB without
+	// storing the whole list. The handler must not use the DB.
+	size_t numEvents = 0;
+	auto addEvent = [&](EventInfo &eventInfo, IncidentInfo *incident) {
 		agent.startObject();
 		agent.add("unifiedId", eventInfo.unifiedId);
 		agent.add("serverId",  eventInfo.serverId);
@@ -476,12 +593,20 @@ void RestResourceMonitoring::handlerGetEvent(void)
 		agent.add("hostId",    eventInfo.hostIdInServer);
 		agent.add("brief",     eventInfo.brief);
 		agent.add("extendedInfo", eventInfo.extendedInfo);
-		if (addIncidents)
-			addIncident(this, agent, incidentVect[i]);
+		if (incident)
+			addIncident(this, agent, *incident);
 		agent.endObject();
+		numEvents++;
+		return true;
+	};
+	agent.startArray("events");
+	err = dataStore->forEachEvent(option, addEvent, addIncidents);
+	if (err != HTERR_OK) {
+		replyError(err);
+		return;
 	}
 	agent.endArray();
-	agent.add("numberOfEvents", eventList.size());
+	agent.add("numberOfEvents", numEvents);
 	addServersMap(agent, NULL, false);
 	addIncidentTrackersMap(agent);
 	agent.endObject();
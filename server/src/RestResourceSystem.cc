@@ -19,11 +19,16 @@
 
 #include "RestResourceSystem.h"
 #include "UnifiedDataStore.h"
+#include "ActionManager.h"
 
 typedef FaceRestResourceHandlerSimpleFactoryTemplate<RestResourceSystem>
   RestResourceSystemFactory;
 
 const char *RestResourceSystem::pathForSystemInfo = "/system-info";
+const char *RestResourceSystem::pathForActionStatistics =
+  "/system-info/action";
+const char *RestResourceSystem::pathForResponseCacheStatistics =
+  "/system-info/response-cache";
 
 void RestResourceSystem::registerFactories(FaceRest *faceRest)
 {
@@ -31,6 +36,14 @@ void RestResourceSystem::registerFactories(FaceRest *faceRest)
 	  pathForSystemInfo,
 	  new RestResourceSystemFactory(
 	        faceRest, &RestResourceSystem::handlerSystemInfo));
+	faceRest->addResourceHandlerFactory(
+	  pathForActionStatistics,
+	  new RestResourceSystemFactory(
+	        faceRest, &RestResourceSystem::handlerActionStatistics));
+	faceRest->addResourceHandlerFactory(
+	  pathForResponseCacheStatistics,
+	  new RestResourceSystemFactory(
+	        faceRest, &RestResourceSystem::handlerResponseCacheStatistics));
 }
 
 RestResourceSystem::RestResourceSystem(FaceRest *faceRest, HandlerFunc handler)
@@ -85,3 +98,92 @@ void RestResourceSystem::handlerSystemInfo(void)
 	replyJSONData(reply);
 }
 
+static void addLatencyHistogram(JSONBuilder &reply, const char *label,
+                                const LatencyHistogram::Snapshot &snapshot)
+{
+	struct {
+		const char *label;
+		double      percentile;
+	} const percentiles[] = {
+		{"p50",  50.0},
+		{"p90",  90.0},
+		{"p99",  99.0},
+		{"p999", 99.9},
+	};
+
+	reply.startObject(label);
+	reply.add("count", snapshot.count);
+	reply.add("min", snapshot.min);
+	reply.add("max", snapshot.max);
+	reply.add("mean", static_cast<uint64_t>(snapshot.getMean()));
+	for (auto &param : percentiles) {
+		reply.add(param.label,
+		          snapshot.getValueAtPercentile(param.percentile));
+	}
+	reply.endObject(); // label
+}
+
+void RestResourceSystem::handlerActionStatistics(void)
+{
+	if (!httpMethodIs("GET")) {
+		MLPL_ERR("Unknown method: %s\n", m_message->method);
+		replyHttpStatus(SOUP_STATUS_METHOD_NOT_ALLOWED);
+		return;
+	}
+
+	ActionManager::Statistics stats;
+	ActionManager::getStatistics(stats);
+
+	JSONBuilder reply;
+	reply.startObject();
+	reply.add("numDispatchedActions", stats.numDispatchedActions);
+
+	reply.startObject("command");
+	addLatencyHistogram(reply, "launchLatency", stats.commandLaunchLatency);
+	addLatencyHistogram(reply, "runTime", stats.commandRunTime);
+	reply.add("numTimeouts", stats.numCommandTimeouts);
+	reply.add("numOnstageActors", stats.numOnstageCommandActions);
+	reply.add("numWaitingActions", stats.numWaitingCommandActions);
+	reply.add("numPendingSpawnerRequests",
+	          stats.numPendingSpawnerRequests);
+	reply.endObject(); // command
+
+	reply.startObject("resident");
+	addLatencyHistogram(reply, "launchLatency",
+	                    stats.residentLaunchLatency);
+	addLatencyHistogram(reply, "runTime", stats.residentRunTime);
+	reply.add("numTimeouts", stats.numResidentTimeouts);
+	reply.add("numYards", stats.numResidentYards);
+	reply.add("numQueuedEvents", stats.numQueuedResidentEvents);
+	reply.add("numInFlightEvents", stats.numInFlightResidentEvents);
+	reply.endObject(); // resident
+
+	addHatoholError(reply, HatoholError(HTERR_OK));
+	reply.endObject();
+	replyJSONData(reply);
+}
+
+void RestResourceSystem::handlerResponseCacheStatistics(void)
+{
+	if (!httpMethodIs("GET")) {
+		MLPL_ERR("Unknown method: %s\n", m_message->method);
+		replyHttpStatus(SOUP_STATUS_METHOD_NOT_ALLOWED);
+		return;
+	}
+
+	RestResponseCache::Statistics stats;
+	m_faceRest->getResponseCache().getStatistics(stats);
+
+	JSONBuilder reply;
+	reply.startObject();
+	reply.add("numHits", stats.numHits);
+	reply.add("numMisses", stats.numMisses);
+	reply.add("numEvictions", stats.numEvictions);
+	reply.add("numPressureEvictions", stats.numPressureEvictions);
+	reply.add("numEntries", stats.numEntries);
+	reply.add("usedBytes", stats.usedBytes);
+	reply.add("maxBytes", stats.maxBytes);
+	addHatoholError(reply, HatoholError(HTERR_OK));
+	reply.endObject();
+	replyJSONData(reply);
+}
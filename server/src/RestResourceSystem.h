@@ -28,11 +28,15 @@ public:
 	typedef void (RestResourceSystem::*HandlerFunc)(void);
 
 	static const char *pathForSystemInfo;
+	static const char *pathForActionStatistics;
+	static const char *pathForResponseCacheStatistics;
 
 	static void registerFactories(FaceRest *faceRest);
 
 	RestResourceSystem(FaceRest *faceRest, HandlerFunc handler);
 	void handlerSystemInfo(void);
+	void handlerActionStatistics(void);
+	void handlerResponseCacheStatistics(void);
 };
 
 #endif // RestResourceSystem_h
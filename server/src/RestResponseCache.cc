@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <unordered_map>
+#include "RestResponseCache.h"
+
+using namespace std;
+
+const size_t RestResponseCache::DEFAULT_MAX_BYTES = 32 * 1024 * 1024;
+
+static const chrono::seconds MEMORY_PRESSURE_CHECK_INTERVAL(1);
+static const uint64_t MEMORY_PRESSURE_PERCENTAGE = 5;
+
+struct RestResponseCache::Impl {
+	struct Entry {
+		string      key;
+		Generations generations;
+		Body        body;
+		size_t      bytes;
+	};
+	typedef list<Entry> EntryList;
+
+	mutable mutex lock;
+	EntryList     entries; // The most recently used one is the front.
+	unordered_map<string, EntryList::iterator> entryMap;
+	size_t        usedBytes;
+	size_t        maxBytes;
+	Statistics    statistics;
+	MemoryPressureProbe memoryPressureProbe;
+	chrono::steady_clock::time_point lastMemoryPressureCheckTime;
+
+	Impl(const size_t &_maxBytes)
+	: usedBytes(0),
+	  maxBytes(_maxBytes),
+	  memoryPressureProbe(isUnderMemoryPressure)
+	{
+	}
+
+	void erase(EntryList::iterator it)
+	{
+		usedBytes -= it->bytes;
+		entryMap.erase(it->key);
+		entries.erase(it);
+	}
+
+	size_t shrink(const size_t &bytes)
+	{
+		size_t numEvicted = 0;
+		while (usedBytes > bytes && !entries.empty()) {
+			erase(--entries.end());
+			numEvicted++;
+		}
+		return numEvicted;
+	}
+
+	bool checkMemoryPressure(void)
+	{
+		const auto now = chrono::steady_clock::now();
+		if (now - lastMemoryPressureCheckTime <
+		      MEMORY_PRESSURE_CHECK_INTERVAL) {
+			return false;
+		}
+		lastMemoryPressureCheckTime = now;
+		return memoryPressureProbe();
+	}
+};
+
+// ---------------------------------------------------------------------------
+// RestResponseCache::Statistics
+// ---------------------------------------------------------------------------
+RestResponseCache::Statistics::Statistics(void)
+: numHits(0),
+  numMisses(0),
+  numEvictions(0),
+  numPressureEvictions(0),
+  numEntries(0),
+  usedBytes(0),
+  maxBytes(0)
+{
+}
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+RestResponseCache::RestResponseCache(const size_t &maxBytes)
+: m_impl(new Impl(maxBytes))
+{
+}
+
+RestResponseCache::~RestResponseCache()
+{
+}
+
+RestResponseCache::Generations RestResponseCache::getGenerations(
+  const DataGenerationTypeVect &types)
+{
+	Generations generations;
+	generations.reserve(types.size());
+	for (auto &type : types)
+		generations.push_back(DataGeneration::get(type));
+	return generations;
+}
+
+RestResponseCache::Body RestResponseCache::get(
+  const string &key, const Generations &generations)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	auto mapIt = m_impl->entryMap.find(key);
+	if (mapIt == m_impl->entryMap.end()) {
+		m_impl->statistics.numMisses++;
+		return Body();
+	}
+	Impl::EntryList::iterator it = mapIt->second;
+	if (it->generations != generations) {
+		m_impl->erase(it);
+		m_impl->statistics.numMisses++;
+		return Body();
+	}
+	m_impl->entries.splice(m_impl->entries.begin(), m_impl->entries, it);
+	m_impl->statistics.numHits++;
+	return it->body;
+}
+
+void RestResponseCache::put(const string &key, const Generations &generations,
+                            const Body &body)
+{
+	const size_t bytes = sizeof(Impl::Entry) + key.size() + body->size();
+	lock_guard<mutex> lock(m_impl->lock);
+	if (m_impl->checkMemoryPressure()) {
+		m_impl->statistics.numPressureEvictions +=
+		  m_impl->shrink(m_impl->usedBytes / 2);
+		return;
+	}
+	if (bytes > m_impl->maxBytes)
+		return;
+
+	auto mapIt = m_impl->entryMap.find(key);
+	if (mapIt != m_impl->entryMap.end())
+		m_impl->erase(mapIt->second);
+	m_impl->statistics.numEvictions +=
+	  m_impl->shrink(m_impl->maxBytes - bytes);
+
+	m_impl->entries.push_front({key, generations, body, bytes});
+	m_impl->entryMap[key] = m_impl->entries.begin();
+	m_impl->usedBytes += bytes;
+}
+
+void RestResponseCache::shrink(const size_t &maxBytes)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->statistics.numEvictions += m_impl->shrink(maxBytes);
+}
+
+void RestResponseCache::clear(void)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->entries.clear();
+	m_impl->entryMap.clear();
+	m_impl->usedBytes = 0;
+}
+
+size_t RestResponseCache::getMaxBytes(void) const
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	return m_impl->maxBytes;
+}
+
+void RestResponseCache::setMaxBytes(const size_t &maxBytes)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->maxBytes = maxBytes;
+	m_impl->statistics.numEvictions += m_impl->shrink(maxBytes);
+}
+
+void RestResponseCache::setMemoryPressureProbe(
+  const MemoryPressureProbe &probe)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->memoryPressureProbe = probe;
+	m_impl->lastMemoryPressureCheckTime =
+	  chrono::steady_clock::time_point();
+}
+
+void RestResponseCache::getStatistics(Statistics &statistics) const
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	statistics = m_impl->statistics;
+	statistics.numEntries = m_impl->entries.size();
+	statistics.usedBytes = m_impl->usedBytes;
+	statistics.maxBytes = m_impl->maxBytes;
+}
+
+bool RestResponseCache::isUnderMemoryPressure(void)
+{
+	ifstream meminfo("/proc/meminfo");
+	uint64_t memTotal = 0, memAvailable = 0;
+	string line;
+	while (getline(meminfo, line)) {
+		unsigned long long value;
+		if (sscanf(line.c_str(), "MemTotal: %llu", &value) == 1)
+			memTotal = value;
+		else if (sscanf(line.c_str(), "MemAvailable: %llu", &value) == 1)
+			memAvailable = value;
+	}
+	if (!memTotal || !memAvailable)
+		return false;
+	return memAvailable * 100 < memTotal * MEMORY_PRESSURE_PERCENTAGE;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RestResponseCache_h
+#define RestResponseCache_h
+
+#include <string>
+#include <memory>
+#include <functional>
+#include "DataGeneration.h"
+
+/**
+ * An LRU cache of JSON bodies replied by FaceRest.
+ *
+ * An entry is stored with the generations of the data it was made from.
+ * get() discards the entry instead of returning it when one of them has
+ * been bumped since then. So the caller has to take the generations
+ * before it reads the data from the DB.
+ *
+ * The total size of the keys and the bodies is kept under the limit by
+ * evicting the least recently used entries. In addition, the cache is
+ * shrunk to a half when the system runs short of memory.
+ *
+ * Methods are MT-safe.
+ */
+class RestResponseCache {
+public:
+	typedef std::shared_ptr<const std::string> Body;
+	typedef std::vector<uint64_t>             Generations;
+	typedef std::function<bool (void)>         MemoryPressureProbe;
+
+	static const size_t DEFAULT_MAX_BYTES;
+
+	struct Statistics {
+		uint64_t numHits;
+		uint64_t numMisses;
+		// The number of entries discarded by the LRU policy
+		uint64_t numEvictions;
+		// The number of entries discarded due to memory pressure
+		uint64_t numPressureEvictions;
+		size_t   numEntries;
+		size_t   usedBytes;
+		size_t   maxBytes;
+
+		Statistics(void);
+	};
+
+	RestResponseCache(const size_t &maxBytes = DEFAULT_MAX_BYTES);
+	virtual ~RestResponseCache();
+
+	/**
+	 * Get the current generations of the data.
+	 *
+	 * @param types The types of the data.
+	 * @return The generations in the same order as types.
+	 */
+	static Generations getGenerations(const DataGenerationTypeVect &types);
+
+	/**
+	 * Find a body.
+	 *
+	 * @param key A key of the response.
+	 * @param generations The current generations of the data.
+	 * @return The found body or an empty pointer.
+	 */
+	Body get(const std::string &key, const Generations &generations);
+
+	/**
+	 * Store a body.
+	 *
+	 * @param key A key of the response.
+	 * @param generations
+	 * The generations of the data taken before they were read.
+	 * @param body A body.
+	 */
+	void put(const std::string &key, const Generations &generations,
+	         const Body &body);
+
+	/**
+	 * Evict the least recently used entries.
+	 *
+	 * @param maxBytes The size the cache is shrunk to.
+	 */
+	void shrink(const size_t &maxBytes);
+	void clear(void);
+
+	size_t getMaxBytes(void) const;
+
+	/**
+	 * Set the limit of the size. Storing bodies is disabled with 0.
+	 *
+	 * @param maxBytes The limit in bytes.
+	 */
+	void setMaxBytes(const size_t &maxBytes);
+
+	/**
+	 * Replace the function that tells if the system is short of memory.
+	 * It's called at most once a second by put(). The default one
+	 * checks MemAvailable in /proc/meminfo.
+	 *
+	 * @param probe A function that returns true under memory pressure.
+	 */
+	void setMemoryPressureProbe(const MemoryPressureProbe &probe);
+
+	void getStatistics(Statistics &statistics) const;
+
+	/**
+	 * Check if the available memory of the system is less than
+	 * 5% of the total.
+	 *
+	 * @return true if the system is short of memory.
+	 */
+	static bool isUnderMemoryPressure(void);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // RestResponseCache_h
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <list>
+#include <map>
+#include <mutex>
+#include "TriggerInfoCache.h"
+
+using namespace std;
+using namespace mlpl;
+
+typedef pair<ServerIdType, TriggerIdType> TriggerKey;
+// The front is the most recently used one.
+typedef list<TriggerInfo> TriggerLRUList;
+typedef map<TriggerKey, TriggerLRUList::iterator> TriggerKeyMap;
+
+const size_t TriggerInfoCache::DEFAULT_MAX_NUM_TRIGGERS = 50000;
+
+struct TriggerInfoCache::Impl
+{
+	mutable mutex lock;
+	const size_t  maxNumTriggers;
+	TriggerLRUList lruList;
+	TriggerKeyMap  triggerKeyMap;
+	uint64_t      generation;
+
+	Impl(const size_t &_maxNumTriggers)
+	: maxNumTriggers(_maxNumTriggers),
+	  generation(0)
+	{
+	}
+
+	// The caller must hold 'lock'.
+	void put(const TriggerInfo &triggerInfo)
+	{
+		const TriggerKey key(triggerInfo.serverId, triggerInfo.id);
+		auto it = triggerKeyMap.find(key);
+		if (it != triggerKeyMap.end()) {
+			*it->second = triggerInfo;
+			lruList.splice(lruList.begin(), lruList, it->second);
+			return;
+		}
+		lruList.push_front(triggerInfo);
+		triggerKeyMap[key] = lruList.begin();
+
+		if (lruList.size() <= maxNumTriggers)
+			return;
+		const TriggerInfo &oldest = lruList.back();
+		triggerKeyMap.erase(TriggerKey(oldest.serverId, oldest.id));
+		lruList.pop_back();
+	}
+
+	// The caller must hold 'lock'.
+	void erase(TriggerKeyMap::iterator it)
+	{
+		lruList.erase(it->second);
+		triggerKeyMap.erase(it);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+TriggerInfoCache::TriggerInfoCache(const size_t &maxNumTriggers)
+: m_impl(new Impl(maxNumTriggers))
+{
+}
+
+TriggerInfoCache::~TriggerInfoCache()
+{
+}
+
+bool TriggerInfoCache::get(
+  const ServerIdType &serverId, const TriggerIdType &triggerId,
+  TriggerInfo &triggerInfo)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	auto it = m_impl->triggerKeyMap.find(TriggerKey(serverId, triggerId));
+	if (it == m_impl->triggerKeyMap.end())
+		return false;
+	TriggerLRUList &lruList = m_impl->lruList;
+	lruList.splice(lruList.begin(), lruList, it->second);
+	triggerInfo = *it->second;
+	return true;
+}
+
+void TriggerInfoCache::update(const TriggerInfo &triggerInfo)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->generation++;
+	m_impl->put(triggerInfo);
+}
+
+void TriggerInfoCache::update(const TriggerInfoList &triggerInfoList)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->generation++;
+	for (const auto &triggerInfo : triggerInfoList)
+		m_impl->put(triggerInfo);
+}
+
+void TriggerInfoCache::fill(const TriggerInfo &triggerInfo,
+                            const uint64_t &generation)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	if (generation != m_impl->generation)
+		return;
+	m_impl->put(triggerInfo);
+}
+
+void TriggerInfoCache::erase(const ServerIdType &serverId,
+                             const TriggerIdList &idList)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->generation++;
+	for (const auto &triggerId : idList) {
+		auto it = m_impl->triggerKeyMap.find(
+		            TriggerKey(serverId, triggerId));
+		if (it != m_impl->triggerKeyMap.end())
+			m_impl->erase(it);
+	}
+}
+
+void TriggerInfoCache::erase(const ServerIdType &serverId)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->generation++;
+	TriggerKeyMap &triggerKeyMap = m_impl->triggerKeyMap;
+	auto it = triggerKeyMap.lower_bound(TriggerKey(serverId, ""));
+	while (it != triggerKeyMap.end() && it->first.first == serverId)
+		m_impl->erase(it++);
+}
+
+void TriggerInfoCache::clear(void)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->generation++;
+	m_impl->triggerKeyMap.clear();
+	m_impl->lruList.clear();
+}
+
+uint64_t TriggerInfoCache::getGeneration(void) const
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	return m_impl->generation;
+}
+
+size_t TriggerInfoCache::getNumberOfTriggers(void) const
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	return m_impl->lruList.size();
+}
+
+TriggerInfoCache &TriggerInfoCache::getInstance(void)
+{
+	static TriggerInfoCache instance;
+	return instance;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TriggerInfoCache_h
+#define TriggerInfoCache_h
+
+#include <memory>
+#include "Monitoring.h"
+
+/**
+ * A bounded cache of triggers keyed by the server ID and the trigger ID.
+ *
+ * DBTablesMonitoring updates it when it writes triggers and looks it up
+ * before it selects a trigger from the DB. When the number of triggers
+ * exceeds the limit, the least recently used one is evicted.
+ *
+ * Methods are MT-safe.
+ */
+class TriggerInfoCache {
+public:
+	static const size_t DEFAULT_MAX_NUM_TRIGGERS;
+
+	TriggerInfoCache(const size_t &maxNumTriggers = DEFAULT_MAX_NUM_TRIGGERS);
+	virtual ~TriggerInfoCache();
+
+	/**
+	 * Get a cached trigger.
+	 *
+	 * @param serverId A server ID of the trigger.
+	 * @param triggerId A trigger ID of the trigger.
+	 * @param triggerInfo The found trigger is stored in this parameter.
+	 *
+	 * @return true if the trigger is found, or false.
+	 */
+	bool get(const ServerIdType &serverId, const TriggerIdType &triggerId,
+	         TriggerInfo &triggerInfo);
+
+	/**
+	 * Store triggers that have been written to the DB.
+	 *
+	 * @param triggerInfo A written trigger.
+	 */
+	void update(const TriggerInfo &triggerInfo);
+	void update(const TriggerInfoList &triggerInfoList);
+
+	/**
+	 * Store a trigger that has been read from the DB.
+	 *
+	 * The trigger is discarded if the cache has been changed since
+	 * getGeneration() returned 'generation', because the read trigger
+	 * may be older than the one stored by update().
+	 *
+	 * @param triggerInfo A read trigger.
+	 * @param generation
+	 * A return value of getGeneration() called before the DB is read.
+	 */
+	void fill(const TriggerInfo &triggerInfo, const uint64_t &generation);
+
+	void erase(const ServerIdType &serverId, const TriggerIdList &idList);
+	void erase(const ServerIdType &serverId);
+	void clear(void);
+
+	uint64_t getGeneration(void) const;
+	size_t getNumberOfTriggers(void) const;
+
+	/**
+	 * Get the cache shared in the process.
+	 *
+	 * @return The shared instance.
+	 */
+	static TriggerInfoCache &getInstance(void);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // TriggerInfoCache_h
@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <mutex>
+#include <functional>
+#include "TriggerStatisticsCache.h"
+#include "ThreadLocalDBCache.h"
+#include "UnifiedDataStore.h"
+
+using namespace std;
+using namespace mlpl;
+
+struct HostCounter {
+	size_t numTriggers;
+	size_t numBadTriggers;
+	size_t numBadTriggersBySeverity[NUM_TRIGGER_SEVERITY];
+
+	HostCounter(void)
+	: numTriggers(0),
+	  numBadTriggers(0),
+	  numBadTriggersBySeverity()
+	{
+	}
+};
+
+struct TriggerState {
+	LocalHostIdType     hostIdInServer;
+	TriggerStatusType   status;
+	TriggerSeverityType severity;
+};
+
+static bool isCounted(const TriggerInfo &triggerInfo)
+{
+	return triggerInfo.validity != TRIGGER_INVALID &&
+	       triggerInfo.validity != TRIGGER_VALID_SELF_MONITORING;
+}
+
+static bool isValidSeverity(const TriggerSeverityType &severity)
+{
+	return severity >= 0 && severity < NUM_TRIGGER_SEVERITY;
+}
+
+static void accumulate(TriggerStatistics &statistics,
+                       const HostCounter &counter, const bool &add)
+{
+	if (counter.numTriggers == 0)
+		return;
+	auto apply = [&](size_t &dest, const size_t &value) {
+		if (add)
+			dest += value;
+		else
+			dest -= value;
+	};
+	apply(statistics.numTriggers, counter.numTriggers);
+	apply(statistics.numBadTriggers, counter.numBadTriggers);
+	for (int i = 0; i < NUM_TRIGGER_SEVERITY; i++) {
+		apply(statistics.numBadTriggersBySeverity[i],
+		      counter.numBadTriggersBySeverity[i]);
+	}
+	apply(statistics.numHosts, 1);
+	if (counter.numBadTriggers > 0)
+		apply(statistics.numBadHosts, 1);
+}
+
+struct ServerEntry {
+	map<TriggerIdType, TriggerState>      triggers;
+	map<LocalHostIdType, HostCounter>     hostCounters;
+	map<LocalHostIdType, HostgroupIdSet>  hostgroupMap;
+	map<HostgroupIdType, TriggerStatistics> hostgroupStatistics;
+	TriggerStatistics                     serverStatistics;
+
+	void setHostgroupMembers(const HostgroupMemberVect &hostgroupMembers)
+	{
+		for (const auto &member : hostgroupMembers) {
+			hostgroupMap[member.hostIdInServer].insert(
+			  member.hostgroupIdInServer);
+		}
+	}
+
+	// The contribution of the host is removed from the statistics
+	// before 'modify' is called, and added again after that.
+	void changeHost(const LocalHostIdType &hostIdInServer,
+	                const function<void (HostCounter &)> &modify)
+	{
+		HostCounter &counter = hostCounters[hostIdInServer];
+		auto groupIt = hostgroupMap.find(hostIdInServer);
+		auto accumulateAll = [&](const bool &add) {
+			accumulate(serverStatistics, counter, add);
+			if (groupIt == hostgroupMap.end())
+				return;
+			for (const auto &hostgroupId : groupIt->second) {
+				accumulate(hostgroupStatistics[hostgroupId],
+				           counter, add);
+			}
+		};
+		accumulateAll(false);
+		modify(counter);
+		accumulateAll(true);
+		if (counter.numTriggers == 0)
+			hostCounters.erase(hostIdInServer);
+	}
+
+	void count(const TriggerState &state, const bool &add)
+	{
+		changeHost(state.hostIdInServer, [&](HostCounter &counter) {
+			auto apply = [&](size_t &dest) {
+				if (add)
+					dest++;
+				else
+					dest--;
+			};
+			apply(counter.numTriggers);
+			if (state.status != TRIGGER_STATUS_PROBLEM)
+				return;
+			apply(counter.numBadTriggers);
+			if (isValidSeverity(state.severity)) {
+				apply(counter.numBadTriggersBySeverity[
+				        state.severity]);
+			}
+		});
+	}
+
+	void erase(const TriggerIdType &triggerId)
+	{
+		auto it = triggers.find(triggerId);
+		if (it == triggers.end())
+			return;
+		count(it->second, false);
+		triggers.erase(it);
+	}
+
+	void put(const TriggerInfo &triggerInfo)
+	{
+		erase(triggerInfo.id);
+		if (!isCounted(triggerInfo))
+			return;
+		TriggerState &state = triggers[triggerInfo.id];
+		state.hostIdInServer = triggerInfo.hostIdInServer;
+		state.status         = triggerInfo.status;
+		state.severity       = triggerInfo.severity;
+		count(state, true);
+	}
+
+	void get(TriggerStatistics &statistics,
+	         const HostgroupIdType &hostgroupId) const
+	{
+		if (hostgroupId == ALL_HOST_GROUPS) {
+			statistics = serverStatistics;
+			return;
+		}
+		auto it = hostgroupStatistics.find(hostgroupId);
+		statistics = (it != hostgroupStatistics.end()) ?
+		               it->second : TriggerStatistics();
+	}
+
+	void get(TriggerStatistics &statistics,
+	         const HostgroupIdSet &hostgroupIdSet) const
+	{
+		if (hostgroupIdSet.count(ALL_HOST_GROUPS)) {
+			statistics = serverStatistics;
+			return;
+		}
+		statistics = TriggerStatistics();
+		for (const auto &hostPair : hostCounters) {
+			auto groupIt = hostgroupMap.find(hostPair.first);
+			if (groupIt == hostgroupMap.end())
+				continue;
+			for (const auto &hostgroupId : groupIt->second) {
+				if (!hostgroupIdSet.count(hostgroupId))
+					continue;
+				accumulate(statistics, hostPair.second, true);
+				break;
+			}
+		}
+	}
+};
+
+struct TriggerStatisticsCache::Impl
+{
+	mutable mutex lock;
+	map<ServerIdType, unique_ptr<ServerEntry>> serverEntries;
+	// Incremented when the triggers or the hostgroup members of
+	// a server are changed. It is used to discard the counters loaded
+	// during the change.
+	map<ServerIdType, uint64_t> generations;
+
+	static unique_ptr<ServerEntry> load(const ServerIdType &serverId)
+	{
+		unique_ptr<ServerEntry> entry(new ServerEntry());
+
+		HostgroupMemberVect hostgroupMembers;
+		HostgroupMembersQueryOption memberOption(USER_ID_SYSTEM);
+		memberOption.setTargetServerId(serverId);
+		UnifiedDataStore::getInstance()->getHostgroupMembers(
+		  hostgroupMembers, memberOption);
+		entry->setHostgroupMembers(hostgroupMembers);
+
+		TriggerInfoList triggerInfoList;
+		TriggersQueryOption triggerOption(USER_ID_SYSTEM);
+		triggerOption.setTargetServerId(serverId);
+		triggerOption.setExcludeDefunctServers(false);
+		ThreadLocalDBCache cache;
+		cache.getMonitoring().getTriggerInfoList(triggerInfoList,
+		                                         triggerOption);
+		for (const auto &triggerInfo : triggerInfoList)
+			entry->put(triggerInfo);
+		return entry;
+	}
+
+	template <typename T>
+	void get(TriggerStatistics &statistics, const ServerIdType &serverId,
+	         const T &target)
+	{
+		uint64_t generation;
+		{
+			lock_guard<mutex> _lock(lock);
+			auto it = serverEntries.find(serverId);
+			if (it != serverEntries.end()) {
+				it->second->get(statistics, target);
+				return;
+			}
+			generation = generations[serverId];
+		}
+
+		// The DB is read without the lock not to block writers.
+		unique_ptr<ServerEntry> entry = load(serverId);
+		entry->get(statistics, target);
+
+		lock_guard<mutex> _lock(lock);
+		if (generations[serverId] != generation)
+			return;
+		if (serverEntries.find(serverId) != serverEntries.end())
+			return;
+		serverEntries[serverId] = move(entry);
+	}
+
+	// The caller must hold 'lock'.
+	ServerEntry *touch(const ServerIdType &serverId)
+	{
+		generations[serverId]++;
+		auto it = serverEntries.find(serverId);
+		if (it == serverEntries.end())
+			return NULL;
+		return it->second.get();
+	}
+};
+
+// ---------------------------------------------------------------------------
+// TriggerStatistics
+// ---------------------------------------------------------------------------
+TriggerStatistics::TriggerStatistics(void)
+: numTriggers(0),
+  numBadTriggers(0),
+  numBadTriggersBySeverity(),
+  numHosts(0),
+  numBadHosts(0)
+{
+}
+
+size_t TriggerStatistics::getNumberOfBadTriggers(
+  const TriggerSeverityType &severity) const
+{
+	if (severity == TRIGGER_SEVERITY_ALL)
+		return numBadTriggers;
+	if (!isValidSeverity(severity))
+		return 0;
+	return numBadTriggersBySeverity[severity];
+}
+
+size_t TriggerStatistics::getNumberOfGoodHosts(void) const
+{
+	return numHosts - numBadHosts;
+}
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+TriggerStatisticsCache::TriggerStatisticsCache(void)
+: m_impl(new Impl())
+{
+}
+
+TriggerStatisticsCache::~TriggerStatisticsCache()
+{
+}
+
+void TriggerStatisticsCache::update(const TriggerInfo &triggerInfo)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	ServerEntry *entry = m_impl->touch(triggerInfo.serverId);
+	if (entry)
+		entry->put(triggerInfo);
+}
+
+void TriggerStatisticsCache::update(const TriggerInfoList &triggerInfoList)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	for (const auto &triggerInfo : triggerInfoList) {
+		ServerEntry *entry = m_impl->touch(triggerInfo.serverId);
+		if (entry)
+			entry->put(triggerInfo);
+	}
+}
+
+void TriggerStatisticsCache::erase(const ServerIdType &serverId,
+                                   const TriggerIdList &idList)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	ServerEntry *entry = m_impl->touch(serverId);
+	if (!entry)
+		return;
+	for (const auto &triggerId : idList)
+		entry->erase(triggerId);
+}
+
+void TriggerStatisticsCache::erase(const ServerIdType &serverId)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	m_impl->generations[serverId]++;
+	m_impl->serverEntries.erase(serverId);
+}
+
+void TriggerStatisticsCache::clear(void)
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	// The generations are kept so that a load running now is discarded.
+	for (auto &generationPair : m_impl->generations)
+		generationPair.second++;
+	m_impl->serverEntries.clear();
+}
+
+void TriggerStatisticsCache::get(
+  TriggerStatistics &statistics, const ServerIdType &serverId,
+  const HostgroupIdType &hostgroupId)
+{
+	m_impl->get(statistics, serverId, hostgroupId);
+}
+
+void TriggerStatisticsCache::get(
+  TriggerStatistics &statistics, const ServerIdType &serverId,
+  const HostgroupIdSet &hostgroupIdSet)
+{
+	m_impl->get(statistics, serverId, hostgroupIdSet);
+}
+
+size_t TriggerStatisticsCache::getNumberOfServers(void) const
+{
+	lock_guard<mutex> lock(m_impl->lock);
+	return m_impl->serverEntries.size();
+}
+
+TriggerStatisticsCache &TriggerStatisticsCache::getInstance(void)
+{
+	static TriggerStatisticsCache instance;
+	return instance;
+}
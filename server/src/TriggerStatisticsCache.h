@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TriggerStatisticsCache_h
+#define TriggerStatisticsCache_h
+
+#include <memory>
+#include "Monitoring.h"
+
+struct TriggerStatistics {
+	size_t numTriggers;
+	// The number of triggers whose status is TRIGGER_STATUS_PROBLEM
+	size_t numBadTriggers;
+	size_t numBadTriggersBySeverity[NUM_TRIGGER_SEVERITY];
+	size_t numHosts;
+	// The number of hosts that have at least one bad trigger
+	size_t numBadHosts;
+
+	TriggerStatistics(void);
+	size_t getNumberOfBadTriggers(const TriggerSeverityType &severity) const;
+	size_t getNumberOfGoodHosts(void) const;
+};
+
+/**
+ * Counters of triggers per server and hostgroup for the overview.
+ *
+ * The counters of a server are loaded from the DB on the first get() for
+ * it. After that DBTablesMonitoring keeps them up to date by passing the
+ * written and the deleted triggers. Hostgroup members aren't tracked
+ * incrementally: DBTablesHost calls erase() for the server when they are
+ * changed so that the counters are loaded again.
+ *
+ * Only triggers that aren't filtered out by EXCLUDE_INVALID_HOST and
+ * EXCLUDE_SELF_MONITORING are counted. The privilege of a user isn't
+ * taken into account. The caller has to pass the allowed hostgroups.
+ *
+ * Methods are MT-safe.
+ */
+class TriggerStatisticsCache {
+public:
+	TriggerStatisticsCache(void);
+	virtual ~TriggerStatisticsCache();
+
+	/**
+	 * Reflect triggers that have been written to the DB.
+	 *
+	 * @param triggerInfo A written trigger.
+	 */
+	void update(const TriggerInfo &triggerInfo);
+	void update(const TriggerInfoList &triggerInfoList);
+
+	/**
+	 * Reflect triggers that have been deleted from the DB.
+	 *
+	 * @param serverId A server ID of the triggers.
+	 * @param idList IDs of the deleted triggers.
+	 */
+	void erase(const ServerIdType &serverId, const TriggerIdList &idList);
+
+	/**
+	 * Discard the counters of a server. They are loaded from the DB
+	 * again on the next get().
+	 *
+	 * @param serverId A target server ID.
+	 */
+	void erase(const ServerIdType &serverId);
+	void clear(void);
+
+	/**
+	 * Get the statistics of a hostgroup.
+	 *
+	 * @param statistics The statistics are stored in this parameter.
+	 * @param serverId A target server ID.
+	 * @param hostgroupId
+	 * A target hostgroup ID. The whole server is counted with
+	 * ALL_HOST_GROUPS.
+	 */
+	void get(TriggerStatistics &statistics, const ServerIdType &serverId,
+	         const HostgroupIdType &hostgroupId = ALL_HOST_GROUPS);
+
+	/**
+	 * Get the statistics of hosts that belong to at least one of
+	 * the given hostgroups.
+	 *
+	 * @param statistics The statistics are stored in this parameter.
+	 * @param serverId A target server ID.
+	 * @param hostgroupIdSet
+	 * Target hostgroup IDs. The whole server is counted if it has
+	 * ALL_HOST_GROUPS.
+	 */
+	void get(TriggerStatistics &statistics, const ServerIdType &serverId,
+	         const HostgroupIdSet &hostgroupIdSet);
+
+	/**
+	 * Get the number of servers whose counters are kept in memory.
+	 *
+	 * @return The number of servers.
+	 */
+	size_t getNumberOfServers(void) const;
+
+	/**
+	 * Get the cache shared in the process.
+	 *
+	 * @return The shared instance.
+	 */
+	static TriggerStatisticsCache &getInstance(void);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif // TriggerStatisticsCache_h
@@ -439,6 +439,17 @@ HatoholError UnifiedDataStore::getEventList(EventInfoList &eventList,
 	return dbMonitoring.getEventInfoList(eventList, option, incidentVect);
 }
 
+HatoholError UnifiedDataStore::forEachEvent(
+  const EventsQueryOption &option,
+  const DBTablesMonitoring::EventInfoHandler &handler,
+  const bool &withIncidentInfo)
+{
+	ThreadLocalDBCache cache;
+	DBTablesMonitoring &dbMonitoring = cache.getMonitoring();
+	return dbMonitoring.forEachEventInfo(option, handler,
+	                                     withIncidentInfo);
+}
+
 void UnifiedDataStore::getItemList(ItemInfoList &itemList,
 				   const ItemsQueryOption &option,
 				   bool fetchItemsSynchronously)
@@ -657,6 +668,22 @@ size_t UnifiedDataStore::getNumberOfBadHosts(const TriggersQueryOption &option)
 	return cache.getMonitoring().getNumberOfBadHosts(option);
 }
 
+HatoholError UnifiedDataStore::getBadTriggerCountMatrix(
+  DBTablesMonitoring::BadTriggerCountMatrix &matrix,
+  const TriggersQueryOption &option)
+{
+	ThreadLocalDBCache cache;
+	return cache.getMonitoring().getBadTriggerCountMatrix(matrix, option);
+}
+
+HatoholError UnifiedDataStore::getHostStatusCountMap(
+  DBTablesMonitoring::HostStatusCountMap &countMap,
+  const TriggersQueryOption &option)
+{
+	ThreadLocalDBCache cache;
+	return cache.getMonitoring().getHostStatusCountMap(countMap, option);
+}
+
 size_t UnifiedDataStore::getNumberOfItems(const ItemsQueryOption &option,
 					  bool fetchItemsSynchronously)
 {
@@ -96,6 +96,15 @@ public:
 	HatoholError getEventList(EventInfoList &eventList,
 	                          EventsQueryOption &option,
 				  IncidentInfoVect *incidentVect = NULL);
+
+	/**
+	 * Get events one by one without storing the whole result.
+	 * See DBTablesMonitoring::forEachEventInfo() for the details.
+	 */
+	HatoholError forEachEvent(
+	  const EventsQueryOption &option,
+	  const DBTablesMonitoring::EventInfoHandler &handler,
+	  const bool &withIncidentInfo = false);
 	void getItemList(ItemInfoList &itemList,
 	                 const ItemsQueryOption &option,
 	                 bool fetchItemsSynchronously = false);
@@ -212,6 +221,12 @@ public:
 	                          DBAgent::TransactionHooks *hooks = NULL);
 	size_t getNumberOfGoodHosts(const TriggersQueryOption &option);
 	size_t getNumberOfBadHosts(const TriggersQueryOption &option);
+	HatoholError getBadTriggerCountMatrix(
+	  DBTablesMonitoring::BadTriggerCountMatrix &matrix,
+	  const TriggersQueryOption &option);
+	HatoholError getHostStatusCountMap(
+	  DBTablesMonitoring::HostStatusCountMap &countMap,
+	  const TriggersQueryOption &option);
 	size_t getNumberOfItems(const ItemsQueryOption &option,
 				bool fetchItemsSynchronously = false);
 	HatoholError getNumberOfMonitoredItemsPerSecond(const DataQueryOption &option,
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <glib.h>
+#include <glib-object.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <Logger.h>
+#include <SmartBuffer.h>
+#include "Hatohol.h"
+#include "HatoholException.h"
+#include "NamedPipe.h"
+#include "ActionSpawnerProtocol.h"
+#include "ResidentCommunicator.h"
+using namespace std;
+using namespace std::chrono;
+using namespace mlpl;
+
+// hatohol-action-spawner is a small helper process that creates command
+// actions on behalf of Hatohol. Because the address space of this process
+// is much smaller than that of Hatohol, posix_spawn() here is cheaper than
+// fork() in Hatohol. A spawned process is a child of this process, so its
+// exit and time-out are handled here and reported to Hatohol.
+
+struct Impl : public ResidentPullHelper<Impl> {
+	GMainLoop *loop;
+	NamedPipe pipeRd;
+	NamedPipe pipeWr;
+	int exitCode;
+
+	Impl(void)
+	: loop(NULL),
+	  pipeRd(NamedPipe::END_TYPE_SLAVE_READ),
+	  pipeWr(NamedPipe::END_TYPE_SLAVE_WRITE),
+	  exitCode(EXIT_SUCCESS)
+	{
+		initResidentPullHelper(&pipeRd, this);
+	}
+
+	virtual ~Impl()
+	{
+		if (loop)
+			g_main_loop_unref(loop);
+	}
+};
+
+struct ActorContext {
+	Impl     *impl;
+	uint64_t  requestId;
+	pid_t     pid;
+	guint     timerTag;
+	bool      killedByTimeout;
+	steady_clock::time_point spawnedTime;
+
+	ActorContext(Impl *_impl, const uint64_t &_requestId)
+	: impl(_impl),
+	  requestId(_requestId),
+	  pid(0),
+	  timerTag(0),
+	  killedByTimeout(false)
+	{
+	}
+};
+
+static void requestQuit(Impl *impl, int exitCode = EXIT_FAILURE)
+{
+	impl->exitCode = exitCode;
+	g_main_loop_quit(impl->loop);
+}
+
+static uint64_t getElapsedUsec(const steady_clock::time_point &since)
+{
+	return duration_cast<microseconds>(steady_clock::now() - since).count();
+}
+
+static gboolean readPipeCb
+  (GIOChannel *source, GIOCondition condition, gpointer data)
+{
+	Impl *impl = static_cast<Impl *>(data);
+	MLPL_ERR("Error: condition: %x\n", condition);
+	requestQuit(impl);
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean writePipeCb
+  (GIOChannel *source, GIOCondition condition, gpointer data)
+{
+	Impl *impl = static_cast<Impl *>(data);
+	MLPL_ERR("Error: condition: %x\n", condition);
+	requestQuit(impl);
+	return G_SOURCE_REMOVE;
+}
+
+static void sendLaunched(Impl *impl)
+{
+	ResidentCommunicator comm;
+	comm.setHeader(0, ACTION_SPAWNER_PKT_TYPE_LAUNCHED);
+	comm.push(impl->pipeWr);
+}
+
+static void sendSpawned(Impl *impl, const uint64_t &requestId,
+                        const int &errorNumber, const pid_t &pid,
+                        const uint64_t &spawnUsec)
+{
+	ResidentCommunicator comm;
+	comm.setHeader(ACTION_SPAWNER_SPAWNED_BODY_LEN,
+	               ACTION_SPAWNER_PKT_TYPE_SPAWNED);
+	SmartBuffer &sbuf = comm.getBuffer();
+	sbuf.add64(requestId);
+	sbuf.add32(errorNumber);
+	sbuf.add32(pid);
+	sbuf.add64(spawnUsec);
+	comm.push(impl->pipeWr);
+}
+
+static void sendExited(ActorContext *actorCtx, const int &code,
+                       const int &status)
+{
+	ResidentCommunicator comm;
+	comm.setHeader(ACTION_SPAWNER_EXITED_BODY_LEN,
+	               ACTION_SPAWNER_PKT_TYPE_EXITED);
+	SmartBuffer &sbuf = comm.getBuffer();
+	sbuf.add64(actorCtx->requestId);
+	sbuf.add32(code);
+	sbuf.add32(status);
+	sbuf.add8(actorCtx->killedByTimeout ? 1 : 0);
+	sbuf.add64(getElapsedUsec(actorCtx->spawnedTime));
+	comm.push(actorCtx->impl->pipeWr);
+}
+
+static gboolean actorTimeoutCb(gpointer data)
+{
+	ActorContext *actorCtx = static_cast<ActorContext *>(data);
+	actorCtx->timerTag = 0;
+	actorCtx->killedByTimeout = true;
+	if (kill(actorCtx->pid, SIGKILL) == -1) {
+		MLPL_ERR("Failed to kill. pid: %d, %s\n",
+		         actorCtx->pid, g_strerror(errno));
+	}
+	return G_SOURCE_REMOVE;
+}
+
+static void actorExitedCb(GPid pid, gint waitStatus, gpointer data)
+{
+	ActorContext *actorCtx = static_cast<ActorContext *>(data);
+	if (actorCtx->timerTag)
+		g_source_remove(actorCtx->timerTag);
+	g_spawn_close_pid(pid);
+
+	int code;
+	int status;
+	if (WIFEXITED(waitStatus)) {
+		code = CLD_EXITED;
+		status = WEXITSTATUS(waitStatus);
+	} else if (WIFSIGNALED(waitStatus)) {
+		code = WCOREDUMP(waitStatus) ? CLD_DUMPED : CLD_KILLED;
+		status = WTERMSIG(waitStatus);
+	} else {
+		MLPL_BUG("Unexpected wait status: %d (%x)\n", pid, waitStatus);
+		code = CLD_KILLED;
+		status = 0;
+	}
+	sendExited(actorCtx, code, status);
+	delete actorCtx;
+}
+
+static int spawnActor(pid_t &pid, const string &workingDir,
+                      const StringVector &args, const StringVector &envs)
+{
+	// We can change the current directory temporarily, because
+	// this process handles requests one by one on a single thread.
+	int savedDirFd = -1;
+	if (!workingDir.empty()) {
+		savedDirFd = open(".", O_RDONLY | O_CLOEXEC);
+		if (savedDirFd == -1)
+			return errno;
+		if (chdir(workingDir.c_str()) == -1) {
+			int err = errno;
+			close(savedDirFd);
+			return err;
+		}
+	}
+
+	const char *argv[args.size() + 1];
+	for (size_t i = 0; i < args.size(); i++)
+		argv[i] = args[i].c_str();
+	argv[args.size()] = NULL;
+
+	const char *envp[envs.size() + 1];
+	for (size_t i = 0; i < envs.size(); i++)
+		envp[i] = envs[i].c_str();
+	envp[envs.size()] = NULL;
+
+	int err = posix_spawn(&pid, argv[0], NULL, NULL, (char **)argv,
+	                      envs.empty() ? environ : (char **)envp);
+
+	if (savedDirFd != -1) {
+		if (fchdir(savedDirFd) == -1) {
+			MLPL_ERR("Failed to restore the current directory: "
+			         "%s\n", g_strerror(errno));
+		}
+		close(savedDirFd);
+	}
+	return err;
+}
+
+static void requestCb(GIOStatus stat, SmartBuffer &sbuf, size_t size,
+                      Impl *impl);
+
+static void gotSpawnBodyCb(GIOStatus stat, SmartBuffer &sbuf, size_t size,
+                           Impl *impl)
+{
+	if (stat != G_IO_STATUS_NORMAL) {
+		MLPL_ERR("Error: status: %x\n", stat);
+		requestQuit(impl);
+		return;
+	}
+
+	const uint64_t requestId = sbuf.getValueAndIncIndex<uint64_t>();
+	const uint32_t timeout   = sbuf.getValueAndIncIndex<uint32_t>();
+	const string workingDir  = sbuf.getStringAndIncIndex<uint32_t>();
+	StringVector args;
+	const uint16_t numArgs = sbuf.getValueAndIncIndex<uint16_t>();
+	for (uint16_t i = 0; i < numArgs; i++)
+		args.push_back(sbuf.getStringAndIncIndex<uint32_t>());
+	StringVector envs;
+	const uint16_t numEnvs = sbuf.getValueAndIncIndex<uint16_t>();
+	for (uint16_t i = 0; i < numEnvs; i++)
+		envs.push_back(sbuf.getStringAndIncIndex<uint32_t>());
+
+	pid_t pid = 0;
+	int err = EINVAL;
+	const steady_clock::time_point startTime = steady_clock::now();
+	if (!args.empty())
+		err = spawnActor(pid, workingDir, args, envs);
+	const uint64_t spawnUsec = getElapsedUsec(startTime);
+	sendSpawned(impl, requestId, err, err ? 0 : pid, spawnUsec);
+
+	if (err == 0) {
+		ActorContext *actorCtx = new ActorContext(impl, requestId);
+		actorCtx->pid = pid;
+		actorCtx->spawnedTime = steady_clock::now();
+		if (timeout > 0) {
+			actorCtx->timerTag =
+			  g_timeout_add(timeout, actorTimeoutCb, actorCtx);
+		}
+		g_child_watch_add(pid, actorExitedCb, actorCtx);
+	} else {
+		MLPL_ERR("Failed to spawn: %s, %s\n",
+		         args.empty() ? "(no arguments)" : args[0].c_str(),
+		         g_strerror(err));
+	}
+
+	// request to get the next request
+	impl->pullHeader(requestCb);
+}
+
+static void requestCb(GIOStatus stat, SmartBuffer &sbuf, size_t size,
+                      Impl *impl)
+{
+	if (stat != G_IO_STATUS_NORMAL) {
+		MLPL_ERR("Error: status: %x\n", stat);
+		requestQuit(impl);
+		return;
+	}
+
+	int pktType = ResidentCommunicator::getPacketType(sbuf);
+	if (pktType == ACTION_SPAWNER_PKT_TYPE_SPAWN) {
+		// request to get the body
+		impl->pullData(ResidentCommunicator::getBodySize(sbuf),
+		               gotSpawnBodyCb);
+	} else {
+		MLPL_ERR("Unexpected packet: %d\n", pktType);
+		requestQuit(impl);
+		return;
+	}
+}
+
+int mainRoutine(int argc, char *argv[])
+{
+#ifndef GLIB_VERSION_2_36
+	g_type_init();
+#endif // GLIB_VERSION_2_36
+#ifndef GLIB_VERSION_2_32
+	g_thread_init(NULL);
+#endif // GLIB_VERSION_2_32 
+
+	hatoholInit();
+	Impl impl;
+	MLPL_INFO("started hatohol-action-spawner: ver. %s\n", PACKAGE_VERSION);
+
+	// open pipes
+	if (argc < 2) {
+		MLPL_ERR("The pipe name is not given. (%d)\n", argc);
+		return EXIT_FAILURE;
+	}
+	const char *pipeName = argv[1];
+	MLPL_INFO("PIPE name: %s\n", pipeName);
+	if (!impl.pipeRd.init(pipeName, readPipeCb, &impl))
+		return EXIT_FAILURE;
+	if (!impl.pipeWr.init(pipeName, writePipeCb, &impl))
+		return EXIT_FAILURE;
+
+	sendLaunched(&impl);
+	impl.pullHeader(requestCb);
+
+	// main loop of GLIB
+	impl.loop = g_main_loop_new(NULL, FALSE);
+	g_main_loop_run(impl.loop);
+
+	return impl.exitCode;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = EXIT_FAILURE;
+	try {
+		ret = mainRoutine(argc, argv);
+	} catch (const HatoholException &e){
+		MLPL_ERR("Got exception: %s", e.getFancyMessage().c_str());
+	} catch (const exception &e) {
+		MLPL_ERR("Got exception: %s", e.what());
+	}
+	return ret;
+}
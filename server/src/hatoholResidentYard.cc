@@ -94,8 +94,7 @@ static gboolean writePipeCb
 static void eventCb(GIOStatus stat, SmartBuffer &sbuf, size_t size,
                     Impl *impl);
 
-static void gotNotifyEventBodyCb(GIOStatus stat, mlpl::SmartBuffer &sbuf,
-                                 size_t size, Impl *impl)
+static uint32_t notifyEvent(Impl *impl, SmartBuffer &sbuf)
 {
 	ResidentNotifyEventArg arg;
 	arg.actionId        = *sbuf.getPointerAndIncIndex<uint32_t>();
@@ -116,7 +115,13 @@ static void gotNotifyEventBodyCb(GIOStatus stat, mlpl::SmartBuffer &sbuf,
 	sbuf.incIndex(HATOHOL_SESSION_ID_LEN);
 
 	// call a user action
-	uint32_t resultCode = (*impl->module->notifyEvent)(&arg);
+	return (*impl->module->notifyEvent)(&arg);
+}
+
+static void gotNotifyEventBodyCb(GIOStatus stat, mlpl::SmartBuffer &sbuf,
+                                 size_t size, Impl *impl)
+{
+	uint32_t resultCode = notifyEvent(impl, sbuf);
 	ResidentCommunicator comm;
 	comm.setNotifyEventAck(resultCode);
 	comm.push(impl->pipeWr);
@@ -125,6 +130,51 @@ static void gotNotifyEventBodyCb(GIOStatus stat, mlpl::SmartBuffer &sbuf,
 	impl->pullHeader(eventCb);
 }
 
+static void gotNotifyEventBatchBodyCb(GIOStatus stat, mlpl::SmartBuffer &sbuf,
+                                      size_t size, Impl *impl)
+{
+	if (size < RESIDENT_PROTO_EVENT_BATCH_NUM_EVENTS_LEN) {
+		MLPL_ERR("Too small batch: %zd\n", size);
+		requestQuit(impl);
+		return;
+	}
+	const size_t bodyTail = sbuf.index() + size;
+	const uint16_t numEvents = *sbuf.getPointerAndIncIndex<uint16_t>();
+
+	// Each item is acknowledged as soon as it is processed, because
+	// the master applies the action's timeout to every ack. The master
+	// doesn't wait for the acks before sending the next batch.
+	for (uint16_t i = 0; i < numEvents; i++) {
+		if (sbuf.index() + RESIDENT_PROTO_EVENT_BATCH_ITEM_HEADER_LEN
+		    > bodyTail) {
+			MLPL_ERR("Broken batch: item: %" PRIu16 "/%" PRIu16
+			         "\n", i, numEvents);
+			requestQuit(impl);
+			return;
+		}
+		const uint32_t requestId =
+		  *sbuf.getPointerAndIncIndex<uint32_t>();
+		const uint32_t itemSize =
+		  *sbuf.getPointerAndIncIndex<uint32_t>();
+		const size_t itemTail = sbuf.index() + itemSize;
+		if (itemSize < RESIDENT_PROTO_EVENT_BODY_BASE_LEN ||
+		    itemTail > bodyTail) {
+			MLPL_ERR("Invalid item size: %" PRIu32 "\n", itemSize);
+			requestQuit(impl);
+			return;
+		}
+		uint32_t resultCode = notifyEvent(impl, sbuf);
+		ResidentCommunicator comm;
+		comm.setNotifyEventBatchAckHeader(1);
+		comm.addNotifyEventBatchAckResult(requestId, resultCode);
+		comm.push(impl->pipeWr);
+		sbuf.setIndex(itemTail);
+	}
+
+	// request to get the envet
+	impl->pullHeader(eventCb);
+}
+
 static void eventCb(GIOStatus stat, SmartBuffer &sbuf, size_t size,
                     Impl *impl)
 {
@@ -139,6 +189,9 @@ static void eventCb(GIOStatus stat, SmartBuffer &sbuf, size_t size,
 		// request to get the body
 		impl->pullData(ResidentCommunicator::getBodySize(sbuf),
 		               gotNotifyEventBodyCb);
+	} else if (pktType == RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH) {
+		impl->pullData(ResidentCommunicator::getBodySize(sbuf),
+		               gotNotifyEventBatchBodyCb);
 	} else {
 		MLPL_ERR("Unexpected packet: %d\n", pktType);
 		requestQuit(impl);
@@ -20,6 +20,7 @@
 #include <gcutter.h>
 #include "DBAgentTest.h"
 #include "SQLUtils.h"
+#include "ColumnarTableStream.h"
 #include "Helpers.h"
 using namespace std;
 using namespace mlpl;
@@ -716,6 +717,82 @@ void dbAgentTestSelectExWithCondAllColumns(DBAgent &dbAgent)
 	assertItemData(double,   itemGroup, HEIGHT[targetRow], idx);
 }
 
+void dbAgentTestSelectExWithColumnarTable(DBAgent &dbAgent)
+{
+	const ColumnDef &columnDefId = COLUMN_DEF_TEST[IDX_TEST_TABLE_ID];
+	size_t targetRow = 1;
+
+	DBAgentChecker::createTable(dbAgent);
+	DBAgentChecker::makeTestData(dbAgent);
+
+	DBAgent::SelectExArg arg(tableProfileTest);
+	for (size_t i = 0; i < NUM_COLUMNS_TEST; i++)
+		arg.add(i);
+	arg.condition = StringUtils::sprintf(
+	  "%s=%" PRIu64, columnDefId.columnName, ID[targetRow]);
+	arg.useColumnarTable = true;
+	dbAgent.select(arg);
+
+	const ColumnarTable &table = *arg.columnarTable;
+	cppcut_assert_equal((size_t)1, table.getNumberOfRows());
+	cppcut_assert_equal(NUM_COLUMNS_TEST, table.getNumberOfColumns());
+
+	ColumnarTableStream stream(table);
+	cppcut_assert_equal(true, stream.next());
+	cppcut_assert_equal(ID[targetRow], stream.read<uint64_t>());
+	cppcut_assert_equal(AGE[targetRow], stream.read<int>());
+	cppcut_assert_equal(string(NAME[targetRow]), stream.read<string>());
+	cppcut_assert_equal(HEIGHT[targetRow], stream.read<double>());
+	cppcut_assert_equal(false, stream.next());
+}
+
+void dbAgentTestSelectEach(DBAgent &dbAgent)
+{
+	DBAgentChecker::createTable(dbAgent);
+	DBAgentChecker::makeTestData(dbAgent);
+
+	DBAgent::SelectExArg arg(tableProfileTest);
+	arg.add(IDX_TEST_TABLE_ID);
+	arg.add(IDX_TEST_TABLE_NAME);
+
+	size_t numRows = 0;
+	map<uint64_t, string> actual;
+	dbAgent.selectEach(arg, [&](ColumnarTableStream &stream) {
+		const uint64_t id = stream.read<uint64_t>();
+		actual[id] = stream.read<string>();
+		numRows++;
+		return true;
+	});
+	cppcut_assert_equal(NUM_TEST_DATA, numRows);
+	cppcut_assert_equal(NUM_TEST_DATA, actual.size());
+	for (size_t i = 0; i < NUM_TEST_DATA; i++)
+		cppcut_assert_equal(string(NAME[i]), actual[ID[i]]);
+}
+
+void dbAgentTestSelectEachStop(DBAgent &dbAgent)
+{
+	DBAgentChecker::createTable(dbAgent);
+	DBAgentChecker::makeTestData(dbAgent);
+
+	DBAgent::SelectExArg arg(tableProfileTest);
+	arg.add(IDX_TEST_TABLE_ID);
+	size_t numRows = 0;
+	dbAgent.selectEach(arg, [&](ColumnarTableStream &stream) {
+		numRows++;
+		return false;
+	});
+	cppcut_assert_equal((size_t)1, numRows);
+
+	// The connection can be used after the iteration is stopped.
+	DBAgent::SelectExArg countArg(tableProfileTest);
+	countArg.add("count(*)", SQL_COLUMN_TYPE_INT);
+	dbAgent.select(countArg);
+	const ItemGroupList &itemList = countArg.dataTable->getItemGroupList();
+	cppcut_assert_equal((size_t)1, itemList.size());
+	int idx = 0;
+	assertItemData(int, *itemList.begin(), (int)NUM_TEST_DATA, idx);
+}
+
 void dbAgentTestSelectHeightOrder
   (DBAgent &dbAgent, size_t limit, size_t offset, size_t forceExpectedRows)
 {
@@ -888,6 +965,35 @@ static void deleteRowFromTestTableAutoInc(DBAgent &dbAgent,
 	dbAgent.deleteRows(arg);
 }
 
+void dbAgentTestBulkInsert(DBAgent &dbAgent, DBAgentChecker &checker)
+{
+	createTestTableAutoInc(dbAgent, checker);
+
+	static const size_t NUM_ROWS = 3;
+	DBAgent::BulkInsertArg bulkArg(tableProfileTestAutoInc);
+	string expected;
+	for (size_t i = 0; i < NUM_ROWS; i++) {
+		const int val = i * 10;
+		const string name = StringUtils::sprintf("name%zd", i);
+		DBAgent::InsertArg arg(tableProfileTestAutoInc);
+		arg.row->addNewItem(AUTO_INCREMENT_VALUE, ITEM_DATA_NULL);
+		arg.row->addNewItem(val);
+		arg.row->addNewItem(name);
+		bulkArg.add(arg);
+		if (!expected.empty())
+			expected += "\n";
+		expected += StringUtils::sprintf("%zd|%d|%s",
+		                                 i + 1, val, name.c_str());
+	}
+	dbAgent.bulkInsert(bulkArg);
+
+	cppcut_assert_equal(NUM_ROWS, bulkArg.insertIds.size());
+	for (size_t i = 0; i < NUM_ROWS; i++)
+		cppcut_assert_equal((uint64_t)(i + 1), bulkArg.insertIds[i]);
+	assertDBContent(&dbAgent, "select * from test_table_auto_inc",
+	                expected);
+}
+
 void dbAgentTestAutoIncrement(DBAgent &dbAgent, DBAgentChecker &checker)
 {
 	createTestTableAutoInc(dbAgent, checker);
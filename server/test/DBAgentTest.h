@@ -108,6 +108,7 @@ void dbAgentTestInsertUint64
   (DBAgent &dbAgent, DBAgentChecker &checker, uint64_t id);
 void dbAgentTestInsertNull(DBAgent &dbAgent, DBAgentChecker &checker);
 void dbAgentTestUpsert(DBAgent &dbAgent, DBAgentChecker &checker);
+void dbAgentTestBulkInsert(DBAgent &dbAgent, DBAgentChecker &checker);
 void dbAgentTestUpsertWithPrimaryKeyAutoInc(
   DBAgent &dbAgent, DBAgentChecker &checker);
 void dbAgentTestUpdate(DBAgent &dbAgent, DBAgentChecker &checker);
@@ -117,6 +118,9 @@ void dbAgentTestSelect(DBAgent &dbAgent);
 void dbAgentTestSelectEx(DBAgent &dbAgent);
 void dbAgentTestSelectExWithCond(DBAgent &dbAgent);
 void dbAgentTestSelectExWithCondAllColumns(DBAgent &dbAgent);
+void dbAgentTestSelectExWithColumnarTable(DBAgent &dbAgent);
+void dbAgentTestSelectEach(DBAgent &dbAgent);
+void dbAgentTestSelectEachStop(DBAgent &dbAgent);
 void dbAgentTestSelectHeightOrder
  (DBAgent &dbAgent, size_t limit = 0, size_t offset = 0,
   size_t forceExpectedRows = (size_t)-1);
@@ -22,6 +22,7 @@
 #include "Helpers.h"
 #include "DBTablesTest.h"
 #include <ThreadLocalDBCache.h>
+#include "TriggerInfoCache.h"
 using namespace std;
 using namespace mlpl;
 
@@ -2362,6 +2363,8 @@ void setupTestDB(void)
 	                              TEST_DB_USER, TEST_DB_PASSWORD);
 	const bool dbRecreate = true;
 	makeTestMySQLDBIfNeeded(TEST_DB_NAME, dbRecreate);
+	// The cached triggers are no longer in the recreated DB.
+	TriggerInfoCache::getInstance().clear();
 
 	// Only when we use SQLite3 for DBTablesHatoho,
 	// the following line should be enabled.
@@ -125,6 +125,11 @@ void HttpServerStub::reset(void)
 // ---------------------------------------------------------------------------
 // Protected methods
 // ---------------------------------------------------------------------------
+GMainContext *HttpServerStub::getGMainContext(void)
+{
+	return m_ctx->gMainCtx;
+}
+
 gpointer HttpServerStub::_mainThread(gpointer data)
 {
 	HttpServerStub *obj = static_cast<HttpServerStub *>(data);
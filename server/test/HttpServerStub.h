@@ -35,6 +35,7 @@ public:
 	virtual void reset(void);
 
 protected:
+	GMainContext *getGMainContext(void);
 	virtual gpointer mainThread(void);
 	virtual void setSoupHandlers(SoupServer *server);
 
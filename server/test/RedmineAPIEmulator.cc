@@ -22,12 +22,20 @@
 #include <map>
 #include <set>
 #include <queue>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <time.h>
+#include <cstring>
 #include "RedmineAPIEmulator.h"
 #include "JSONParser.h"
 #include "JSONBuilder.h"
 #include "Helpers.h"
 
 using namespace std;
+using namespace mlpl;
 
 const guint EMULATOR_PORT = 44444;
 RedmineAPIEmulator g_redmineEmulator;
@@ -105,6 +113,15 @@ string RedmineIssue::toJSON(void) const
 	JSONBuilder agent;
 	agent.startObject();
 	agent.startObject("issue");
+	addMembers(agent);
+	agent.endObject();
+	agent.endObject();
+
+	return agent.generate();
+}
+
+void RedmineIssue::addMembers(JSONBuilder &agent) const
+{
 	agent.add("id", id);
 
 	agent.startObject("project");
@@ -146,11 +163,6 @@ string RedmineIssue::toJSON(void) const
 	agent.add("spent_hours", ":0.0,");
 	agent.add("created_on", getCreatedOn());
 	agent.add("updated_on", getUpdatedOn());
-
-	agent.endObject();
-	agent.endObject();
-
-	return agent.generate();
 }
 
 struct Response {
@@ -158,9 +170,30 @@ struct Response {
 	string body;
 };
 
+static const size_t DEFAULT_ISSUES_LIMIT = 25;
+static const size_t MAX_ISSUES_LIMIT = 100;
+
+RedmineAPIEmulator::LoadProfile::LoadProfile(void)
+: latencyMSec(0),
+  latencyJitterMSec(0),
+  errorRate(0.0),
+  errorStatus(SOUP_STATUS_SERVICE_UNAVAILABLE),
+  randomSeed(0)
+{
+}
+
 struct RedmineAPIEmulator::PrivateContext {
+	struct DelayedMessage {
+		SoupServer  *server;
+		SoupMessage *msg;
+	};
+
 	PrivateContext(void)
-	: m_issueId(0)
+	: m_issueId(0),
+	  m_useIssueStore(false),
+	  m_touchPosition(0),
+	  m_numRequests(0),
+	  m_numInjectedErrors(0)
 	{
 	}
 	virtual ~PrivateContext()
@@ -183,7 +216,13 @@ struct RedmineAPIEmulator::PrivateContext {
 				  const char *path, GHashTable *query,
 				  SoupClientContext *client);
 	string buildResponse(RedmineIssue &issue);
+	bool injectError(SoupMessage *msg);
+	void delayResponse(SoupServer *server, SoupMessage *msg,
+			   GMainContext *context);
+	static gboolean resumeMessageCb(gpointer data);
+	static void deleteDelayedMessage(gpointer data);
 	void replyGetIssue(SoupMessage *msg);
+	void replyGetStoredIssues(SoupMessage *msg, GHashTable *query);
 	void replyPostIssue(SoupMessage *msg);
 	void replyPutIssue(SoupMessage *msg);
 	int getTrackerId(const string &trackerId);
@@ -198,6 +237,17 @@ struct RedmineAPIEmulator::PrivateContext {
 	string m_lastResponseBody;
 	RedmineIssue m_lastIssue;
 	queue<Response> m_dummyResponseQueue;
+
+	// Members for the load generation. They are accessed from both
+	// the server thread and the caller thread.
+	mutable mutex m_loadMutex;
+	LoadProfile m_loadProfile;
+	std::mt19937 m_random;
+	bool m_useIssueStore;
+	vector<RedmineIssue> m_issues;
+	size_t m_touchPosition;
+	atomic<size_t> m_numRequests;
+	atomic<size_t> m_numInjectedErrors;
 };
 
 RedmineAPIEmulator::RedmineAPIEmulator(void)
@@ -224,6 +274,15 @@ void RedmineAPIEmulator::reset(void)
 	m_ctx->m_lastIssue = RedmineIssue();
 	queue<Response> empty;
 	std::swap(m_ctx->m_dummyResponseQueue, empty);
+
+	lock_guard<mutex> lock(m_ctx->m_loadMutex);
+	m_ctx->m_loadProfile = LoadProfile();
+	m_ctx->m_random.seed(m_ctx->m_loadProfile.randomSeed);
+	m_ctx->m_useIssueStore = false;
+	m_ctx->m_issues.clear();
+	m_ctx->m_touchPosition = 0;
+	m_ctx->m_numRequests = 0;
+	m_ctx->m_numInjectedErrors = 0;
 }
 
 void RedmineAPIEmulator::addUser(const std::string &userName,
@@ -271,6 +330,71 @@ void RedmineAPIEmulator::queueDummyResponse(const guint &soupStatus,
 	m_ctx->m_dummyResponseQueue.push(res);
 }
 
+void RedmineAPIEmulator::setLoadProfile(const LoadProfile &profile)
+{
+	lock_guard<mutex> lock(m_ctx->m_loadMutex);
+	m_ctx->m_loadProfile = profile;
+	m_ctx->m_random.seed(profile.randomSeed);
+}
+
+RedmineAPIEmulator::LoadProfile RedmineAPIEmulator::getLoadProfile(void) const
+{
+	lock_guard<mutex> lock(m_ctx->m_loadMutex);
+	return m_ctx->m_loadProfile;
+}
+
+void RedmineAPIEmulator::generateIssues(const size_t &numIssues,
+					const time_t &updatedOn)
+{
+	lock_guard<mutex> lock(m_ctx->m_loadMutex);
+	m_ctx->m_useIssueStore = true;
+	m_ctx->m_issues.clear();
+	m_ctx->m_issues.reserve(numIssues);
+	for (size_t i = 0; i < numIssues; i++) {
+		const size_t id = i + 1;
+		RedmineIssue issue(id,
+				   StringUtils::sprintf("Issue %zd", id),
+				   "Generated by RedmineAPIEmulator",
+				   "hatohol");
+		issue.startDate = updatedOn;
+		issue.createdOn = updatedOn;
+		issue.updatedOn = updatedOn;
+		m_ctx->m_issues.push_back(issue);
+	}
+	m_ctx->m_issueId = numIssues;
+	m_ctx->m_touchPosition = 0;
+}
+
+void RedmineAPIEmulator::touchIssues(const size_t &numIssues,
+				     const time_t &updatedOn)
+{
+	lock_guard<mutex> lock(m_ctx->m_loadMutex);
+	vector<RedmineIssue> &issues = m_ctx->m_issues;
+	if (issues.empty())
+		return;
+	for (size_t i = 0; i < numIssues; i++) {
+		size_t &position = m_ctx->m_touchPosition;
+		issues[position].updatedOn = updatedOn;
+		position = (position + 1) % issues.size();
+	}
+}
+
+size_t RedmineAPIEmulator::getNumberOfIssues(void) const
+{
+	lock_guard<mutex> lock(m_ctx->m_loadMutex);
+	return m_ctx->m_issues.size();
+}
+
+size_t RedmineAPIEmulator::getNumberOfRequests(void) const
+{
+	return m_ctx->m_numRequests;
+}
+
+size_t RedmineAPIEmulator::getNumberOfInjectedErrors(void) const
+{
+	return m_ctx->m_numInjectedErrors;
+}
+
 gboolean RedmineAPIEmulator::PrivateContext::authCallback
   (SoupAuthDomain *domain, SoupMessage *msg, const char *username,
    const char *password, gpointer user_data)
@@ -358,6 +482,87 @@ void RedmineAPIEmulator::PrivateContext::replyGetIssue(SoupMessage *msg)
 	g_free(contents);
 }
 
+static const char *lookupQuery(GHashTable *query, const char *key)
+{
+	if (!query)
+		return NULL;
+	return static_cast<const char *>(g_hash_table_lookup(query, key));
+}
+
+static time_t parseDate(const char *date)
+{
+	// ArmRedmine sends the date in the local time
+	struct tm tm;
+	memset(&tm, 0, sizeof(tm));
+	if (!strptime(date, "%Y-%m-%d", &tm))
+		return 0;
+	tm.tm_isdst = -1;
+	return mktime(&tm);
+}
+
+void RedmineAPIEmulator::PrivateContext::replyGetStoredIssues(
+  SoupMessage *msg, GHashTable *query)
+{
+	size_t limit = DEFAULT_ISSUES_LIMIT;
+	const char *value = lookupQuery(query, "limit");
+	if (value && atoi(value) > 0)
+		limit = min(static_cast<size_t>(atoi(value)), MAX_ISSUES_LIMIT);
+
+	size_t offset = 0;
+	if ((value = lookupQuery(query, "offset")))
+		offset = atoi(value);
+	else if ((value = lookupQuery(query, "page")) && atoi(value) > 1)
+		offset = (atoi(value) - 1) * limit;
+
+	time_t updatedOnMin = 0;
+	const char *op = lookupQuery(query, "op[updated_on]");
+	value = lookupQuery(query, "v[updated_on][]");
+	if (op && value && string(op) == ">=")
+		updatedOnMin = parseDate(value);
+
+	string sortOrder;
+	if ((value = lookupQuery(query, "sort")))
+		sortOrder = value;
+
+	JSONBuilder agent;
+	agent.startObject();
+	agent.startArray("issues");
+
+	lock_guard<mutex> lock(m_loadMutex);
+	vector<const RedmineIssue *> matched;
+	matched.reserve(m_issues.size());
+	for (const auto &issue : m_issues) {
+		if (issue.updatedOn >= updatedOnMin)
+			matched.push_back(&issue);
+	}
+	// Redmine sorts issues by ID in descending order by default
+	auto compare = [&](const RedmineIssue *a, const RedmineIssue *b) {
+		if (sortOrder == "updated_on:desc" && a->updatedOn != b->updatedOn)
+			return a->updatedOn > b->updatedOn;
+		if (sortOrder == "updated_on" && a->updatedOn != b->updatedOn)
+			return a->updatedOn < b->updatedOn;
+		return a->id > b->id;
+	};
+	std::sort(matched.begin(), matched.end(), compare);
+
+	for (size_t i = offset; i < matched.size() && i < offset + limit; i++) {
+		agent.startObject();
+		matched[i]->addMembers(agent);
+		agent.endObject();
+	}
+	agent.endArray();
+	agent.add("total_count", static_cast<gint64>(matched.size()));
+	agent.add("offset", static_cast<gint64>(offset));
+	agent.add("limit", static_cast<gint64>(limit));
+	agent.endObject();
+
+	m_lastResponseBody = agent.generate();
+	soup_message_set_status(msg, SOUP_STATUS_OK);
+	soup_message_body_append(msg->response_body, SOUP_MEMORY_COPY,
+				 m_lastResponseBody.c_str(),
+				 m_lastResponseBody.size());
+}
+
 void RedmineAPIEmulator::PrivateContext::replyPostIssue(SoupMessage *msg)
 {
 	m_lastRequestBody.assign(msg->request_body->data,
@@ -405,6 +610,9 @@ void RedmineAPIEmulator::PrivateContext::replyPostIssue(SoupMessage *msg)
 				   m_currentUser, trackerId);
 		m_lastResponseBody = issue.toJSON();
 		m_lastIssue = issue;
+		lock_guard<mutex> lock(m_loadMutex);
+		if (m_useIssueStore)
+			m_issues.push_back(issue);
 		soup_message_body_append(msg->response_body, SOUP_MEMORY_COPY,
 					 m_lastResponseBody.c_str(),
 					 m_lastResponseBody.size());
@@ -450,6 +658,61 @@ bool RedmineAPIEmulator::PrivateContext::handlerDummyResponse
 	return true;
 }
 
+bool RedmineAPIEmulator::PrivateContext::injectError(SoupMessage *msg)
+{
+	m_numRequests++;
+
+	lock_guard<mutex> lock(m_loadMutex);
+	if (m_loadProfile.errorRate <= 0.0)
+		return false;
+	uniform_real_distribution<double> distribution(0.0, 1.0);
+	if (distribution(m_random) >= m_loadProfile.errorRate)
+		return false;
+	soup_message_set_status(msg, m_loadProfile.errorStatus);
+	m_numInjectedErrors++;
+	return true;
+}
+
+void RedmineAPIEmulator::PrivateContext::delayResponse(
+  SoupServer *server, SoupMessage *msg, GMainContext *context)
+{
+	size_t delayMSec;
+	{
+		lock_guard<mutex> lock(m_loadMutex);
+		delayMSec = m_loadProfile.latencyMSec;
+		if (m_loadProfile.latencyJitterMSec > 0) {
+			uniform_int_distribution<size_t> distribution(
+			  0, m_loadProfile.latencyJitterMSec);
+			delayMSec += distribution(m_random);
+		}
+	}
+	if (delayMSec == 0)
+		return;
+
+	// Don't block the server thread to serve concurrent requests
+	soup_server_pause_message(server, msg);
+	DelayedMessage *delayed = new DelayedMessage();
+	delayed->server = server;
+	delayed->msg = msg;
+	GSource *source = g_timeout_source_new(delayMSec);
+	g_source_set_callback(source, resumeMessageCb, delayed,
+			      deleteDelayedMessage);
+	g_source_attach(source, context);
+	g_source_unref(source);
+}
+
+gboolean RedmineAPIEmulator::PrivateContext::resumeMessageCb(gpointer data)
+{
+	DelayedMessage *delayed = static_cast<DelayedMessage *>(data);
+	soup_server_unpause_message(delayed->server, delayed->msg);
+	return FALSE;
+}
+
+void RedmineAPIEmulator::PrivateContext::deleteDelayedMessage(gpointer data)
+{
+	delete static_cast<DelayedMessage *>(data);
+}
+
 void RedmineAPIEmulator::PrivateContext::handlerIssuesJSON
   (SoupServer *server, SoupMessage *msg, const char *path, GHashTable *query,
    SoupClientContext *client, gpointer user_data)
@@ -470,7 +733,20 @@ void RedmineAPIEmulator::PrivateContext::handlerIssuesJSON
 	if (priv->handlerDummyResponse(msg, path ,query, client))
 		return;
 
-	if (method == "GET") {
+	if (priv->injectError(msg)) {
+		priv->delayResponse(server, msg, emulator->getGMainContext());
+		return;
+	}
+
+	bool useIssueStore;
+	{
+		lock_guard<mutex> lock(priv->m_loadMutex);
+		useIssueStore = priv->m_useIssueStore;
+	}
+
+	if (method == "GET" && useIssueStore) {
+		priv->replyGetStoredIssues(msg, query);
+	} else if (method == "GET") {
 		priv->replyGetIssue(msg);
 	} else if (method == "PUT") {
 		soup_message_set_status(msg, SOUP_STATUS_NOT_FOUND);
@@ -482,6 +758,7 @@ void RedmineAPIEmulator::PrivateContext::handlerIssuesJSON
 	} else {
 		soup_message_set_status(msg, SOUP_STATUS_METHOD_NOT_ALLOWED);
 	}
+	priv->delayResponse(server, msg, emulator->getGMainContext());
 }
 
 void RedmineAPIEmulator::PrivateContext::handlerIssueJSON
@@ -504,6 +781,11 @@ void RedmineAPIEmulator::PrivateContext::handlerIssueJSON
 	if (priv->handlerDummyResponse(msg, path ,query, client))
 		return;
 
+	if (priv->injectError(msg)) {
+		priv->delayResponse(server, msg, emulator->getGMainContext());
+		return;
+	}
+
 	if (method == "GET") {
 		soup_message_set_status(msg, SOUP_STATUS_NOT_IMPLEMENTED);
 	} else if (method == "PUT") {
@@ -515,4 +797,5 @@ void RedmineAPIEmulator::PrivateContext::handlerIssueJSON
 	} else {
 		soup_message_set_status(msg, SOUP_STATUS_METHOD_NOT_ALLOWED);
 	}
+	priv->delayResponse(server, msg, emulator->getGMainContext());
 }
@@ -22,6 +22,8 @@
 
 #include "HttpServerStub.h"
 
+class JSONBuilder;
+
 struct RedmineIssue {
 	size_t id;
 	std::string subject;
@@ -55,6 +57,7 @@ struct RedmineIssue {
 	std::string getCreatedOn(void) const;
 	std::string getUpdatedOn(void) const;
 	std::string toJSON(void) const;
+	void addMembers(JSONBuilder &agent) const;
 
 	static std::string getDateString(time_t time);
 	static std::string getTimeString(time_t time);
@@ -62,6 +65,24 @@ struct RedmineIssue {
 
 class RedmineAPIEmulator : public HttpServerStub {
 public:
+	/**
+	 * Load injected into the responses to emulate a busy or flaky
+	 * Redmine. Requests answered by queueDummyResponse() aren't
+	 * affected.
+	 */
+	struct LoadProfile {
+		// A delay added to every response
+		size_t       latencyMSec;
+		// A random delay up to this value is added to latencyMSec
+		size_t       latencyJitterMSec;
+		// A ratio (0.0 - 1.0) of requests answered with errorStatus
+		double       errorRate;
+		guint        errorStatus;
+		unsigned int randomSeed;
+
+		LoadProfile(void);
+	};
+
 	RedmineAPIEmulator(void);
 	virtual ~RedmineAPIEmulator();
 	virtual void reset(void);
@@ -75,6 +96,33 @@ public:
 	void queueDummyResponse(const guint &soupStatus,
 				const std::string &body = "");
 
+	void setLoadProfile(const LoadProfile &profile);
+	LoadProfile getLoadProfile(void) const;
+
+	/**
+	 * Generate issues returned by GET /issues.json instead of the
+	 * fixture. limit, offset, page, sort by updated_on and the
+	 * updated_on filter are emulated for them. Other filters are
+	 * ignored. Issues posted after calling this method are also added.
+	 *
+	 * @param numIssues The number of issues to generate.
+	 * @param updatedOn created_on and updated_on of the issues.
+	 */
+	void generateIssues(const size_t &numIssues, const time_t &updatedOn);
+
+	/**
+	 * Change updated_on of the generated issues to emulate updates on
+	 * Redmine. Issues are chosen in round-robin order.
+	 *
+	 * @param numIssues The number of issues to update.
+	 * @param updatedOn A new updated_on.
+	 */
+	void touchIssues(const size_t &numIssues, const time_t &updatedOn);
+
+	size_t getNumberOfIssues(void) const;
+	size_t getNumberOfRequests(void) const;
+	size_t getNumberOfInjectedErrors(void) const;
+
 protected:
 	virtual void setSoupHandlers(SoupServer *soupServer);
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A standalone Redmine stand-in for load tests. It serves the REST API
+ * emulated by RedmineAPIEmulator with injected latency, errors and
+ * a large number of issues.
+ *
+ * Example:
+ *   RedmineEmulatorServer --port 44444 --issues 50000 \
+ *                         --latency 50 --jitter 100 --error-rate 0.01
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <glib.h>
+#include <Logger.h>
+#include "RedmineAPIEmulator.h"
+
+using namespace std;
+using namespace mlpl;
+
+struct Options {
+	gint     port;
+	gint     numIssues;
+	gint     latencyMSec;
+	gint     latencyJitterMSec;
+	gdouble  errorRate;
+	gint     errorStatus;
+	gint     randomSeed;
+	gint     statsIntervalSec;
+	gchar   *userName;
+	gchar   *password;
+
+	Options(void)
+	: port(EMULATOR_PORT),
+	  numIssues(0),
+	  latencyMSec(0),
+	  latencyJitterMSec(0),
+	  errorRate(0.0),
+	  errorStatus(SOUP_STATUS_SERVICE_UNAVAILABLE),
+	  randomSeed(0),
+	  statsIntervalSec(10),
+	  userName(NULL),
+	  password(NULL)
+	{
+	}
+
+	~Options()
+	{
+		g_free(userName);
+		g_free(password);
+	}
+};
+
+static bool parseCommandLine(gint *argc, gchar ***argv, Options &options)
+{
+	GOptionEntry entries[] = {
+		{"port",
+		 'p', 0, G_OPTION_ARG_INT, &options.port,
+		 "Port to listen", NULL},
+		{"issues",
+		 'n', 0, G_OPTION_ARG_INT, &options.numIssues,
+		 "Number of generated issues "
+		 "(0: the fixture is returned)", NULL},
+		{"latency",
+		 'l', 0, G_OPTION_ARG_INT, &options.latencyMSec,
+		 "Latency of each response in milliseconds", NULL},
+		{"jitter",
+		 'j', 0, G_OPTION_ARG_INT, &options.latencyJitterMSec,
+		 "Maximum random latency added to --latency", NULL},
+		{"error-rate",
+		 'e', 0, G_OPTION_ARG_DOUBLE, &options.errorRate,
+		 "Ratio of requests answered with an error (0.0 - 1.0)", NULL},
+		{"error-status",
+		 's', 0, G_OPTION_ARG_INT, &options.errorStatus,
+		 "HTTP status code of the injected errors", NULL},
+		{"seed",
+		 'r', 0, G_OPTION_ARG_INT, &options.randomSeed,
+		 "Seed of the random number generator", NULL},
+		{"stats-interval",
+		 'i', 0, G_OPTION_ARG_INT, &options.statsIntervalSec,
+		 "Interval to print statistics in seconds", NULL},
+		{"user",
+		 'u', 0, G_OPTION_ARG_STRING, &options.userName,
+		 "User name of the basic authentication", NULL},
+		{"password",
+		 'w', 0, G_OPTION_ARG_STRING, &options.password,
+		 "Password of the basic authentication", NULL},
+		{ NULL }
+	};
+
+	GOptionContext *optCtx = g_option_context_new(NULL);
+	g_option_context_add_main_entries(optCtx, entries, NULL);
+	GError *error = NULL;
+	bool succeeded = g_option_context_parse(optCtx, argc, argv, &error);
+	if (!succeeded) {
+		MLPL_ERR("Failed to parse command line argment. (%s)\n",
+		         error ? error->message : "Unknown reason");
+		g_error_free(error);
+	}
+	g_option_context_free(optCtx);
+	return succeeded;
+}
+
+int main(int argc, char *argv[])
+{
+	Options options;
+	if (!parseCommandLine(&argc, &argv, options))
+		return EXIT_FAILURE;
+	if (options.statsIntervalSec <= 0)
+		options.statsIntervalSec = 10;
+
+	RedmineAPIEmulator &emulator = g_redmineEmulator;
+	emulator.addUser(options.userName ? options.userName : "hatohol",
+			 options.password ? options.password : "hatohol");
+
+	RedmineAPIEmulator::LoadProfile profile;
+	profile.latencyMSec       = options.latencyMSec;
+	profile.latencyJitterMSec = options.latencyJitterMSec;
+	profile.errorRate         = options.errorRate;
+	profile.errorStatus       = options.errorStatus;
+	profile.randomSeed        = options.randomSeed;
+	emulator.setLoadProfile(profile);
+	if (options.numIssues > 0)
+		emulator.generateIssues(options.numIssues, time(NULL));
+
+	emulator.start(options.port);
+	MLPL_INFO("Listening on port %d with %zd issues\n",
+		  options.port, emulator.getNumberOfIssues());
+
+	// The process runs until it's killed (e.g. by Ctrl-C).
+	size_t prevNumRequests = 0;
+	while (true) {
+		sleep(options.statsIntervalSec);
+		const size_t numRequests = emulator.getNumberOfRequests();
+		printf("requests: %zd (%.1f/s), injected errors: %zd, "
+		       "issues: %zd\n",
+		       numRequests,
+		       (double)(numRequests - prevNumRequests)
+		         / options.statsIntervalSec,
+		       emulator.getNumberOfInjectedErrors(),
+		       emulator.getNumberOfIssues());
+		fflush(stdout);
+		prevNumRequests = numRequests;
+	}
+	return EXIT_SUCCESS;
+}
@@ -20,11 +20,13 @@
 #include <gcutter.h>
 #include <cppcutter.h>
 #include <atomic>
+#include <set>
 
 #include <Reaper.h>
 #include <AMQPConnection.h>
 #include <AMQPConsumer.h>
 #include <AMQPPublisher.h>
+#include <AMQPPipelinedPublisher.h>
 #include <AMQPMessageHandler.h>
 
 using namespace std;
@@ -53,6 +55,39 @@ namespace testAMQPConnection {
 		AMQPMessage m_message;
 	};
 
+	class TestBatchMessageHandler : public AMQPMessageHandler {
+	public:
+		TestBatchMessageHandler()
+		: m_numMessages(0)
+		{
+		}
+
+		virtual bool handle(AMQPConsumer &consumer,
+				    const AMQPMessage &message) override
+		{
+			return true;
+		}
+
+		virtual void handleMessages(
+		  AMQPConsumer &consumer,
+		  const AMQPMessageVect &messages,
+		  vector<bool> &handled) override
+		{
+			for (size_t i = 0; i < messages.size(); i++) {
+				const string &body = messages[i].body;
+				m_bodies.push_back(body);
+				if (m_rejectOnce.erase(body) > 0)
+					handled[i] = false;
+			}
+			m_numMessages += messages.size();
+		}
+
+		atomic<size_t> m_numMessages;
+		vector<string> m_bodies;
+		// Messages that aren't handled when they arrive first
+		set<string> m_rejectOnce;
+	};
+
 	AMQPConnectionInfo &getConnectionInfo(void)
 	{
 		if (!connectionInfo)
@@ -109,6 +144,34 @@ namespace testAMQPConnection {
 		cppcut_assert_equal(false, connection->consume(message));
 	}
 
+	void test_consumeIfReadyWithoutConnection(void)
+	{
+		AMQPMessage message;
+		connection = getConnection();
+		cppcut_assert_equal(false, connection->consumeIfReady(message));
+	}
+
+	void test_ackWithoutConnection(void)
+	{
+		connection = getConnection();
+		cppcut_assert_equal(false, connection->ack(1));
+	}
+
+	void test_enableConfirmWithoutConnection(void)
+	{
+		connection = getConnection();
+		cppcut_assert_equal(false, connection->enableConfirm());
+	}
+
+	void test_waitConfirmationWithoutConnection(void)
+	{
+		AMQPConfirmation confirmation;
+		struct timeval timeout = {0, 0};
+		connection = getConnection();
+		cppcut_assert_equal(
+		  false, connection->waitConfirmation(confirmation, &timeout));
+	}
+
 	void test_publishWithoutConnection(void)
 	{
 		AMQPMessage message;
@@ -142,4 +205,126 @@ namespace testAMQPConnection {
 		cppcut_assert_equal(message.body,
 				    handler.m_message.body);
 	}
+
+	void test_transferMessagesInBatchWithManualAck(void)
+	{
+		const size_t numMessages = 3;
+		AMQPPublisher publisher(getConnectionInfo());
+		vector<string> expected;
+		for (size_t i = 0; i < numMessages; i++) {
+			AMQPJSONMessage message;
+			message.body = StringUtils::sprintf("{\"id\":%zd}", i);
+			publisher.setMessage(message);
+			cppcut_assert_equal(true, publisher.publish());
+			expected.push_back(message.body);
+		}
+
+		connectionInfo->setPrefetchCount(10);
+		connectionInfo->setManualAckEnabled(true);
+		TestBatchMessageHandler handler;
+		AMQPConsumer consumer(*connectionInfo, &handler);
+		consumer.setMaxBatchSize(numMessages);
+		consumer.start();
+		gdouble timeout = 2.0, elapsed = 0.0;
+		GTimer *timer = startTimer();
+		while (handler.m_numMessages < numMessages &&
+		       elapsed < timeout) {
+			g_usleep(0.1 * G_USEC_PER_SEC);
+			elapsed = g_timer_elapsed(timer, NULL);
+		}
+		consumer.exitSync();
+
+		cut_assert_true(elapsed < timeout);
+		cppcut_assert_equal(numMessages, handler.m_bodies.size());
+		for (size_t i = 0; i < numMessages; i++)
+			cppcut_assert_equal(expected[i], handler.m_bodies[i]);
+	}
+
+	void test_redeliverOnlyUnhandledMessagesInBatch(void)
+	{
+		const size_t numMessages = 3;
+		AMQPPublisher publisher(getConnectionInfo());
+		vector<string> expected;
+		for (size_t i = 0; i < numMessages; i++) {
+			AMQPJSONMessage message;
+			message.body = StringUtils::sprintf("{\"id\":%zd}", i);
+			publisher.setMessage(message);
+			cppcut_assert_equal(true, publisher.publish());
+			expected.push_back(message.body);
+		}
+
+		connectionInfo->setPrefetchCount(10);
+		connectionInfo->setManualAckEnabled(true);
+		TestBatchMessageHandler handler;
+		handler.m_rejectOnce.insert(expected[1]);
+		AMQPConsumer consumer(*connectionInfo, &handler);
+		consumer.setMaxBatchSize(numMessages);
+		consumer.start();
+		gdouble timeout = 2.0, elapsed = 0.0;
+		GTimer *timer = startTimer();
+		while (handler.m_numMessages < numMessages + 1 &&
+		       elapsed < timeout) {
+			g_usleep(0.1 * G_USEC_PER_SEC);
+			elapsed = g_timer_elapsed(timer, NULL);
+		}
+		// Wait for an unexpected redelivery
+		g_usleep(0.2 * G_USEC_PER_SEC);
+		consumer.exitSync();
+
+		cut_assert_true(elapsed < timeout);
+		cppcut_assert_equal(numMessages + 1, handler.m_bodies.size());
+		cppcut_assert_equal(expected[1], handler.m_bodies.back());
+	}
+
+	void test_pipelinedPublisher(void)
+	{
+		const size_t numMessages = 10;
+		AMQPPipelinedPublisher publisher(getConnectionInfo());
+		publisher.setMaxUnconfirmed(3);
+		publisher.start();
+		vector<string> expected;
+		for (size_t i = 0; i < numMessages; i++) {
+			AMQPJSONMessage message;
+			message.body = StringUtils::sprintf("{\"id\":%zd}", i);
+			publisher.push(message);
+			expected.push_back(message.body);
+		}
+
+		TestBatchMessageHandler handler;
+		AMQPConsumer consumer(*connectionInfo, &handler);
+		consumer.start();
+		gdouble timeout = 5.0, elapsed = 0.0;
+		GTimer *timer = startTimer();
+		while (handler.m_numMessages < numMessages &&
+		       elapsed < timeout) {
+			g_usleep(0.1 * G_USEC_PER_SEC);
+			elapsed = g_timer_elapsed(timer, NULL);
+		}
+		consumer.exitSync();
+
+		cut_assert_true(elapsed < timeout);
+		cppcut_assert_equal((size_t)0,
+		                    publisher.getNumberOfPendingMessages());
+		cppcut_assert_equal(numMessages, handler.m_bodies.size());
+		for (size_t i = 0; i < numMessages; i++)
+			cppcut_assert_equal(expected[i], handler.m_bodies[i]);
+	}
+
+	void test_stopPipelinedPublisherWithoutBroker(void)
+	{
+		// Nothing listens on the port.
+		AMQPConnectionInfo info;
+		info.setURL("amqp://localhost:1/");
+		info.setPublisherQueueName("test.1");
+		GTimer *timer = startTimer();
+		{
+			AMQPPipelinedPublisher publisher(info);
+			publisher.setFlushTimeout(100);
+			publisher.start();
+			AMQPJSONMessage message;
+			message.body = "{}";
+			publisher.push(message);
+		}
+		cut_assert_true(g_timer_elapsed(timer, NULL) < 2.0);
+	}
 } // namespace testAMQPConnection
@@ -88,6 +88,16 @@ namespace defaultValue {
 	{
 		cppcut_assert_equal(string(""), info->getPublisherQueueName());
 	}
+
+	void test_prefetchCount(void)
+	{
+		cppcut_assert_equal((uint16_t)0, info->getPrefetchCount());
+	}
+
+	void test_manualAckEnabled(void)
+	{
+		cppcut_assert_equal(false, info->isManualAckEnabled());
+	}
 }
 
 namespace setter {
@@ -106,6 +116,30 @@ namespace setter {
 		info.setPublisherQueueName(queueName);
 		cppcut_assert_equal(queueName, info.getPublisherQueueName());
 	}
+
+	void test_prefetchCount(void)
+	{
+		AMQPConnectionInfo info;
+		info.setPrefetchCount(100);
+		cppcut_assert_equal((uint16_t)100, info.getPrefetchCount());
+	}
+
+	void test_manualAckEnabled(void)
+	{
+		AMQPConnectionInfo info;
+		info.setManualAckEnabled(true);
+		cppcut_assert_equal(true, info.isManualAckEnabled());
+	}
+
+	void test_copy(void)
+	{
+		AMQPConnectionInfo info;
+		info.setPrefetchCount(10);
+		info.setManualAckEnabled(true);
+		AMQPConnectionInfo copied(info);
+		cppcut_assert_equal((uint16_t)10, copied.getPrefetchCount());
+		cppcut_assert_equal(true, copied.isManualAckEnabled());
+	}
 }
 
 } // namespace testAMQPConnectionInfo
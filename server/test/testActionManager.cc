@@ -1018,6 +1018,55 @@ void test_execCommandActionTimeoutNotExpired(void)
 	cppcut_assert_equal(FALSE, g_source_remove(ctx->actorInfo.timerTag));
 }
 
+void test_execCommandActionBySpawner(void)
+{
+	ConfigManager::getInstance()->setNumberOfActionSpawners(2);
+	g_execCommandCtx = new ExecCommandContext();
+	ExecCommandContext *ctx = g_execCommandCtx; // just an alias
+
+	string pipeName = "test-command-action";
+	ctx->initPipes(pipeName);
+
+	ctx->eventInfo = testEventInfo[0];
+	ExecActionArg arg(2343242, ACTION_COMMAND);
+	assertExecAction(ctx, arg);
+	assertActionLogJustAfterExec(ctx);
+	sendQuit(ctx);
+	assertActionLogAfterEnding(ctx);
+}
+
+void test_execCommandActionBySpawnerWithWrongPath(void)
+{
+	ConfigManager::getInstance()->setNumberOfActionSpawners(1);
+	g_execCommandCtx = new ExecCommandContext();
+	ExecCommandContext *ctx = g_execCommandCtx; // just an alias
+
+	ExecActionArg arg(7869, ACTION_COMMAND);
+	arg.usePipe = false;
+	arg.command = "wrong-command-dayo";
+	assertExecAction(ctx, arg);
+	assertWaitForChangeActionLogStatus(ctx, ACTLOG_STAT_STARTED);
+	assertActionLogForFailure(ctx, ACTLOG_EXECFAIL_ENTRY_NOT_FOUND);
+}
+
+void test_execCommandActionBySpawnerTimeout(void)
+{
+	ConfigManager::getInstance()->setNumberOfActionSpawners(1);
+	g_execCommandCtx = new ExecCommandContext();
+	ExecCommandContext *ctx = g_execCommandCtx; // just an alias
+
+	string pipeName = "test-command-action";
+	ctx->initPipes(pipeName);
+
+	ExecActionArg arg(2343242, ACTION_COMMAND);
+	arg.option = OPTION_STALL;
+	arg.timeout = 10;
+	assertExecAction(ctx, arg);
+	assertWaitForChangeActionLogStatus(ctx, ACTLOG_STAT_STARTED);
+	assertActionLogForFailure(ctx, ACTLOG_EXECFAIL_KILLED_TIMEOUT,
+	                          ACTLOG_FLAG_QUEUING_TIME);
+}
+
 void test_execResidentAction(void)
 {
 	g_execCommandCtx = new ExecCommandContext();
@@ -1148,13 +1197,13 @@ void test_execResidentActionManyEvents(void)
 	}
 }
 
-void test_execResidentActionManyEventsGenThenCheckLog(void)
+static void _assertExecResidentActionManyEventsGenThenCheckLog(
+  const size_t &numEvents)
 {
 	g_execCommandCtx = new ExecCommandContext();
 	ExecCommandContext *ctx = g_execCommandCtx; // just an alias
 
 	vector<ActorInfo> actorVect;
-	size_t numEvents = 10;
 	for (size_t i = 0; i < numEvents; i++) {
 		ExecActionArg arg(0x4ab3fd32, ACTION_RESIDENT);
 		assertExecAction(ctx, arg);
@@ -1170,6 +1219,33 @@ void test_execResidentActionManyEventsGenThenCheckLog(void)
 		assertActionLogAfterExecResident(logarg);
 	}
 }
+#define assertExecResidentActionManyEventsGenThenCheckLog(N) \
+cut_trace(_assertExecResidentActionManyEventsGenThenCheckLog(N))
+
+void test_execResidentActionManyEventsGenThenCheckLog(void)
+{
+	assertExecResidentActionManyEventsGenThenCheckLog(10);
+}
+
+void test_execResidentActionManyEventsOverWindow(void)
+{
+	// Some events are queued until acks of the in-flight events come.
+	assertExecResidentActionManyEventsGenThenCheckLog(100);
+}
+
+void test_getStatisticsAfterResidentActions(void)
+{
+	const size_t numEvents = 10;
+	assertExecResidentActionManyEventsGenThenCheckLog(numEvents);
+
+	ActionManager::Statistics stats;
+	ActionManager::getStatistics(stats);
+	cppcut_assert_equal((uint64_t)numEvents, stats.numDispatchedActions);
+	cppcut_assert_equal((uint64_t)numEvents,
+	                    stats.residentLaunchLatency.count);
+	cppcut_assert_equal((uint64_t)0, stats.numResidentTimeouts);
+	cppcut_assert_equal((uint64_t)0, stats.commandLaunchLatency.count);
+}
 
 void test_execResidentActionCheckArg(void)
 {
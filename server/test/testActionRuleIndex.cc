@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <cppcutter.h>
+#include <cutter.h>
+#include "Hatohol.h"
+#include "ActionRuleIndex.h"
+#include "DBTablesTest.h"
+#include "Helpers.h"
+#include "ThreadLocalDBCache.h"
+using namespace std;
+using namespace mlpl;
+
+namespace testActionRuleIndex {
+
+static ActionDef makeActionDef(const ActionIdType &id,
+                               const ActionCondition &condition)
+{
+	ActionDef actionDef;
+	actionDef.id = id;
+	actionDef.condition = condition;
+	actionDef.type = ACTION_COMMAND;
+	actionDef.command = "/bin/true";
+	actionDef.timeout = 0;
+	actionDef.ownerUserId = USER_ID_SYSTEM;
+	return actionDef;
+}
+
+static EventInfo makeEventInfo(void)
+{
+	EventInfo eventInfo;
+	initEventInfo(eventInfo);
+	eventInfo.serverId = 1;
+	eventInfo.id = "100";
+	eventInfo.triggerId = "10";
+	eventInfo.status = TRIGGER_STATUS_PROBLEM;
+	eventInfo.severity = TRIGGER_SEVERITY_WARNING;
+	eventInfo.hostIdInServer = "235012";
+	return eventInfo;
+}
+
+static string makeIdString(const ActionDefList &actionDefList)
+{
+	string s;
+	for (auto &actionDef : actionDefList)
+		s += StringUtils::sprintf("%" FMT_ACTION_ID ",", actionDef.id);
+	return s;
+}
+
+static string match(const ActionRuleIndex &index, const EventInfo &eventInfo)
+{
+	ActionDefList actionDefList;
+	index.match(actionDefList, eventInfo);
+	return makeIdString(actionDefList);
+}
+
+void cut_setup(void)
+{
+	hatoholInit();
+}
+
+// ---------------------------------------------------------------------------
+// Test cases
+// ---------------------------------------------------------------------------
+void test_matchEachCondition(void)
+{
+	ActionCondition noCond;
+	ActionCondition serverCond = noCond;
+	serverCond.enable(ACTCOND_SERVER_ID);
+	serverCond.serverId = 1;
+	ActionCondition otherServerCond = serverCond;
+	otherServerCond.serverId = 2;
+	ActionCondition hostCond = noCond;
+	hostCond.enable(ACTCOND_HOST_ID);
+	hostCond.hostIdInServer = "235012";
+	ActionCondition triggerCond = noCond;
+	triggerCond.enable(ACTCOND_TRIGGER_ID);
+	triggerCond.triggerId = "10";
+	ActionCondition statusCond = noCond;
+	statusCond.enable(ACTCOND_TRIGGER_STATUS);
+	statusCond.triggerStatus = TRIGGER_STATUS_OK;
+
+	ActionDefList actionDefList = {
+		makeActionDef(6, statusCond),
+		makeActionDef(5, triggerCond),
+		makeActionDef(4, hostCond),
+		makeActionDef(3, otherServerCond),
+		makeActionDef(2, serverCond),
+		makeActionDef(1, noCond),
+	};
+	HostgroupMemberVect hostgroupMembers;
+	ActionRuleIndex index(actionDefList, hostgroupMembers);
+	cppcut_assert_equal((size_t)6, index.getNumberOfActions());
+	cppcut_assert_equal(string("1,2,4,5,"),
+	                    match(index, makeEventInfo()));
+}
+
+void test_matchHostgroup(void)
+{
+	ActionCondition cond;
+	cond.enable(ACTCOND_HOST_GROUP_ID);
+	cond.hostgroupId = "G1";
+	ActionDefList actionDefList = {makeActionDef(1, cond)};
+	HostgroupMemberVect hostgroupMembers = {
+		{1, 1, "235012", "G1", 10},
+		{2, 1, "235013", "G2", 11},
+	};
+	ActionRuleIndex index(actionDefList, hostgroupMembers);
+
+	EventInfo eventInfo = makeEventInfo();
+	cppcut_assert_equal(string("1,"), match(index, eventInfo));
+	eventInfo.hostIdInServer = "235013";
+	cppcut_assert_equal(string(""), match(index, eventInfo));
+	eventInfo.serverId = 2;
+	eventInfo.hostIdInServer = "235012";
+	cppcut_assert_equal(string(""), match(index, eventInfo));
+}
+
+void test_matchSeverity(void)
+{
+	ActionCondition eqCond;
+	eqCond.enable(ACTCOND_TRIGGER_SEVERITY);
+	eqCond.triggerSeverity = TRIGGER_SEVERITY_WARNING;
+	eqCond.triggerSeverityCompType = CMP_EQ;
+	ActionCondition eqGtCond = eqCond;
+	eqGtCond.triggerSeverity = TRIGGER_SEVERITY_INFO;
+	eqGtCond.triggerSeverityCompType = CMP_EQ_GT;
+	ActionCondition higherCond = eqGtCond;
+	higherCond.triggerSeverity = TRIGGER_SEVERITY_CRITICAL;
+
+	ActionDefList actionDefList = {
+		makeActionDef(1, eqCond),
+		makeActionDef(2, eqGtCond),
+		makeActionDef(3, higherCond),
+	};
+	HostgroupMemberVect hostgroupMembers;
+	ActionRuleIndex index(actionDefList, hostgroupMembers);
+	cppcut_assert_equal(string("1,2,"), match(index, makeEventInfo()));
+}
+
+void test_sharedIndexIsSameAsQuery(void)
+{
+	setupTestDB();
+	loadTestDBTablesConfig();
+	loadTestDBTablesUser();
+	loadTestDBAction();
+	loadTestDBHostgroupMember();
+
+	ThreadLocalDBCache cache;
+	DBTablesAction &dbAction = cache.getAction();
+	shared_ptr<const ActionRuleIndex> index = ActionRuleIndex::getShared();
+	for (size_t i = 0; i < NumTestEventInfo; i++) {
+		const EventInfo &eventInfo = testEventInfo[i];
+		ActionDefList expected;
+		ActionsQueryOption option(USER_ID_SYSTEM);
+		option.setActionType(ACTION_ALL);
+		option.setTargetEventInfo(&eventInfo);
+		dbAction.getActionList(expected, option);
+		expected.sort([](const ActionDef &lhs, const ActionDef &rhs) {
+			return lhs.id < rhs.id;
+		});
+		cppcut_assert_equal(makeIdString(expected),
+		                    match(*index, eventInfo));
+	}
+}
+
+void test_invalidateByAddAction(void)
+{
+	setupTestDB();
+	loadTestDBTablesConfig();
+	loadTestDBTablesUser();
+	shared_ptr<const ActionRuleIndex> prev = ActionRuleIndex::getShared();
+	cppcut_assert_equal(true, prev == ActionRuleIndex::getShared());
+
+	loadTestDBAction();
+	shared_ptr<const ActionRuleIndex> curr = ActionRuleIndex::getShared();
+	cppcut_assert_equal(true, prev != curr);
+	cppcut_assert_equal((size_t)0, prev->getNumberOfActions());
+	cppcut_assert_equal(true, curr->getNumberOfActions() > 0);
+}
+
+} // namespace testActionRuleIndex
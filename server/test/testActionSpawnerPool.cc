@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppcutter.h>
+#include <gcutter.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include "Hatohol.h"
+#include "ActionSpawnerPool.h"
+#include "Helpers.h"
+
+using namespace std;
+using namespace mlpl;
+
+namespace testActionSpawnerPool {
+
+struct CompletionWaiter {
+	bool completed;
+	ActionSpawnerPool::Result result;
+
+	CompletionWaiter(void)
+	: completed(false)
+	{
+	}
+
+	ActionSpawnerPool::CompletedCallback getCallback(void)
+	{
+		return [this](const ActionSpawnerPool::Result &_result) {
+			completed = true;
+			result = _result;
+		};
+	}
+
+	void wait(void)
+	{
+		while (!completed)
+			g_main_context_iteration(NULL, TRUE);
+	}
+};
+
+static string getSpawnerPath(void)
+{
+	return cut_build_path(getBaseDir().c_str(), "..", "src", ".libs",
+	                      ActionSpawnerPool::SPAWNER_NAME, NULL);
+}
+
+static ActionSpawnerPool::Request makeRequest(const string &command)
+{
+	ActionSpawnerPool::Request request;
+	request.args.push_back(command);
+	return request;
+}
+
+void cut_setup(void)
+{
+	hatoholInit();
+	acquireDefaultContext();
+}
+
+// ---------------------------------------------------------------------------
+// Test cases
+// ---------------------------------------------------------------------------
+void test_getNumberOfSpawners(void)
+{
+	ActionSpawnerPool pool(3, getSpawnerPath());
+	cppcut_assert_equal((size_t)3, pool.getNumberOfSpawners());
+}
+
+void test_exited(void)
+{
+	ActionSpawnerPool pool(1, getSpawnerPath());
+	CompletionWaiter waiter;
+	pool.submit(makeRequest("/bin/true"), waiter.getCallback());
+	waiter.wait();
+	cppcut_assert_equal(0, waiter.result.errorNumber);
+	cppcut_assert_equal(false, waiter.result.lostSpawner);
+	cppcut_assert_equal(true, waiter.result.pid > 0);
+	cppcut_assert_equal(CLD_EXITED, waiter.result.code);
+	cppcut_assert_equal(EXIT_SUCCESS, waiter.result.status);
+	cppcut_assert_equal((size_t)0, pool.getNumberOfPendingRequests());
+
+	ActionSpawnerPool::Statistics stats = pool.getStatistics();
+	cppcut_assert_equal((uint64_t)1, stats.numSpawned);
+	cppcut_assert_equal((uint64_t)0, stats.numSpawnFailures);
+	cppcut_assert_equal(waiter.result.spawnUsec, stats.maxSpawnUsec);
+}
+
+void test_exitStatus(void)
+{
+	ActionSpawnerPool pool(1, getSpawnerPath());
+	CompletionWaiter waiter;
+	pool.submit(makeRequest("/bin/false"), waiter.getCallback());
+	waiter.wait();
+	cppcut_assert_equal(0, waiter.result.errorNumber);
+	cppcut_assert_equal(CLD_EXITED, waiter.result.code);
+	cppcut_assert_equal(EXIT_FAILURE, waiter.result.status);
+}
+
+void test_notFound(void)
+{
+	ActionSpawnerPool pool(1, getSpawnerPath());
+	CompletionWaiter waiter;
+	pool.submit(makeRequest("/non-existing-command-dayo"),
+	            waiter.getCallback());
+	waiter.wait();
+	cppcut_assert_equal(ENOENT, waiter.result.errorNumber);
+	cppcut_assert_equal((uint64_t)1,
+	                    pool.getStatistics().numSpawnFailures);
+}
+
+void test_timeout(void)
+{
+	ActionSpawnerPool pool(1, getSpawnerPath());
+	ActionSpawnerPool::Request request = makeRequest("/bin/sleep");
+	request.args.push_back("10");
+	request.timeout = 10;
+	CompletionWaiter waiter;
+	pool.submit(request, waiter.getCallback());
+	waiter.wait();
+	cppcut_assert_equal(0, waiter.result.errorNumber);
+	cppcut_assert_equal(true, waiter.result.killedByTimeout);
+	cppcut_assert_equal(CLD_KILLED, waiter.result.code);
+	cppcut_assert_equal(SIGKILL, waiter.result.status);
+}
+
+void test_workingDirectory(void)
+{
+	ActionSpawnerPool pool(1, getSpawnerPath());
+	ActionSpawnerPool::Request request = makeRequest("/bin/sh");
+	request.args.push_back("-c");
+	request.args.push_back("test `pwd` = /");
+	request.workingDirectory = "/";
+	CompletionWaiter waiter;
+	pool.submit(request, waiter.getCallback());
+	waiter.wait();
+	cppcut_assert_equal(CLD_EXITED, waiter.result.code);
+	cppcut_assert_equal(EXIT_SUCCESS, waiter.result.status);
+}
+
+void test_manyRequests(void)
+{
+	const size_t numRequests = 20;
+	ActionSpawnerPool pool(2, getSpawnerPath());
+	vector<CompletionWaiter> waiters(numRequests);
+	for (auto &waiter : waiters)
+		pool.submit(makeRequest("/bin/true"), waiter.getCallback());
+	for (auto &waiter : waiters) {
+		waiter.wait();
+		cppcut_assert_equal(CLD_EXITED, waiter.result.code);
+	}
+	cppcut_assert_equal((uint64_t)numRequests,
+	                    pool.getStatistics().numSpawned);
+}
+
+void test_spawnerNotFound(void)
+{
+	ActionSpawnerPool pool(1, "/non-existing-spawner-dayo");
+	CompletionWaiter waiter;
+	pool.submit(makeRequest("/bin/true"), waiter.getCallback());
+	waiter.wait();
+	cppcut_assert_equal(ECHILD, waiter.result.errorNumber);
+}
+
+} // namespace testActionSpawnerPool
@@ -25,6 +25,7 @@
 #include "RedmineAPIEmulator.h"
 #include "ThreadLocalDBCache.h"
 #include "DBTablesTest.h"
+#include "DBTablesLastInfo.h"
 
 using namespace std;
 using namespace mlpl;
@@ -151,4 +152,111 @@ void test_oneProcWihNoUpdatedIssues(void)
 	assertQuery(expected, g_redmineEmulator.getLastRequestQuery());
 }
 
+static time_t getStoredLastUpdateTime(const IncidentTrackerIdType &trackerId)
+{
+	ThreadLocalDBCache cache;
+	LastInfoQueryOption option(USER_ID_SYSTEM);
+	option.setLastInfoType(LAST_INFO_INCIDENT);
+	option.setTargetServerId(trackerId);
+	LastInfoDefList lastInfoList;
+	cache.getLastInfo().getLastInfoList(lastInfoList, option);
+	if (lastInfoList.empty())
+		return 0;
+	return atoll(lastInfoList.begin()->value.c_str());
+}
+
+void test_oneProcAdvancesLastUpdateTime(void)
+{
+	loadTestDBIncidents();
+	const IncidentTrackerInfo &tracker = testIncidentTrackerInfo[2];
+	g_redmineEmulator.addUser(tracker.userName, tracker.password);
+
+	// 2014-08-26T00:00:00Z: Older than all issues in the fixture
+	const time_t lastUpdateTime = 1409011200;
+	ThreadLocalDBCache cache;
+	OperationPrivilege privilege(USER_ID_SYSTEM);
+	LastInfoDef lastInfoDef;
+	lastInfoDef.id = AUTO_INCREMENT_VALUE;
+	lastInfoDef.dataType = LAST_INFO_INCIDENT;
+	lastInfoDef.value = StringUtils::toString(
+	                      static_cast<uint64_t>(lastUpdateTime));
+	lastInfoDef.serverId = tracker.id;
+	cache.getLastInfo().upsertLastInfo(lastInfoDef, privilege);
+
+	// An incident tied with the issue #2086 in the fixture
+	IncidentInfo incident = testIncidentInfo[0];
+	incident.identifier = "2086";
+	cache.getMonitoring().addIncidentInfo(&incident);
+
+	ArmRedmineTestee arm(tracker);
+	cppcut_assert_equal(true, arm.callOneProc());
+
+	// The query should start from the stored high-water mark
+	struct tm localTime;
+	localtime_r(&lastUpdateTime, &localTime);
+	char date[16];
+	strftime(date, sizeof(date), "%Y-%m-%d", &localTime);
+	string query = g_redmineEmulator.getLastRequestQuery();
+	cppcut_assert_equal(true,
+	  StringUtils::hasSuffix(query, string("=") + date));
+
+	// 2014-08-29T03:25:00Z: The latest updated_on in the fixture
+	const time_t expectedLastUpdateTime = 1409282700;
+	cppcut_assert_equal(expectedLastUpdateTime,
+			    getStoredLastUpdateTime(tracker.id));
+
+	IncidentInfoVect incidents;
+	IncidentsQueryOption option(USER_ID_SYSTEM);
+	cache.getMonitoring().getIncidentInfoVect(incidents, option);
+	bool found = false;
+	for (const auto &actual : incidents) {
+		if (actual.identifier != "2086")
+			continue;
+		found = true;
+		cppcut_assert_equal(expectedLastUpdateTime,
+				    actual.updatedAt.tv_sec);
+		cppcut_assert_equal(20, actual.doneRatio);
+		cppcut_assert_equal(incident.serverId, actual.serverId);
+	}
+	cppcut_assert_equal(true, found);
+}
+
+void test_oneProcWithMultiplePages(void)
+{
+	loadTestDBIncidents();
+	const IncidentTrackerInfo &tracker = testIncidentTrackerInfo[2];
+	g_redmineEmulator.addUser(tracker.userName, tracker.password);
+
+	// Newer than testIncidentInfo
+	const time_t updatedOn = 1420070400; // 2015-01-01T00:00:00Z
+	const size_t numIssues = 250;
+	g_redmineEmulator.generateIssues(numIssues, updatedOn);
+
+	ThreadLocalDBCache cache;
+	IncidentInfo incident = testIncidentInfo[0];
+	incident.identifier = "150"; // On the 2nd page
+	cache.getMonitoring().addIncidentInfo(&incident);
+
+	ArmRedmineTestee arm(tracker);
+	cppcut_assert_equal(true, arm.callOneProc());
+
+	// All of 3 pages should be fetched
+	cppcut_assert_equal((size_t)3,
+			    g_redmineEmulator.getNumberOfRequests());
+	cppcut_assert_equal(updatedOn, getStoredLastUpdateTime(tracker.id));
+
+	IncidentInfoVect incidents;
+	IncidentsQueryOption option(USER_ID_SYSTEM);
+	cache.getMonitoring().getIncidentInfoVect(incidents, option);
+	bool found = false;
+	for (const auto &actual : incidents) {
+		if (actual.identifier != "150")
+			continue;
+		found = true;
+		cppcut_assert_equal(updatedOn, actual.updatedAt.tv_sec);
+		cppcut_assert_equal(string("New"), actual.status);
+	}
+	cppcut_assert_equal(true, found);
+}
+
 }
@@ -297,5 +297,92 @@ void test_ignore_sigstop(void)
 	cppcut_assert_equal(true, (bool)ctx->calledFinalized);
 }
 
+void test_collectManyChildren(void)
+{
+	struct Ctx : public ChildProcessManager::EventCallback {
+		const size_t numChildren;
+		AtomicValue<size_t> numCollected;
+		AtomicValue<size_t> numFinalized;
+		GMainLoopAgent mainLoop;
+
+		Ctx(const size_t &_numChildren)
+		: numChildren(_numChildren),
+		  numCollected(0),
+		  numFinalized(0)
+		{
+		}
+
+		virtual void onCollected(const siginfo_t *siginfo) override
+		{
+			numCollected.add(1);
+		}
+
+		virtual void onFinalized(void) override
+		{
+			if (numFinalized.add(1) == numChildren)
+				mainLoop.quit();
+		}
+	};
+	const size_t numChildren = 20;
+	Ctx *ctx = new Ctx(numChildren);
+	Reaper<UsedCountable> ctxUnref(ctx, UsedCountable::unref);
+
+	vector<pid_t> pids;
+	for (size_t i = 0; i < numChildren; i++) {
+		ChildProcessManager::CreateArg arg;
+		ctx->ref(); // unref() is called in the destructor of arg.
+		arg.eventCb = ctx;
+		assertCreate(arg);
+		pids.push_back(arg.pid);
+	}
+	for (size_t i = 0; i < numChildren; i++)
+		cppcut_assert_equal(0, kill(pids[i], SIGKILL));
+	ctx->mainLoop.run();
+	cppcut_assert_equal(numChildren, (size_t)ctx->numCollected);
+	cppcut_assert_equal(numChildren, (size_t)ctx->numFinalized);
+}
+
+void test_createInCollectedCb(void)
+{
+	struct Ctx : public ChildProcessManager::EventCallback {
+		GMainLoopAgent &mainLoop;
+		bool createNext;
+		HatoholError err;
+
+		Ctx(GMainLoopAgent &_mainLoop, const bool &_createNext)
+		: mainLoop(_mainLoop),
+		  createNext(_createNext)
+		{
+		}
+
+		virtual void onCollected(const siginfo_t *siginfo) override
+		{
+			if (!createNext)
+				return;
+			ChildProcessManager::CreateArg arg;
+			arg.args.push_back("/bin/true");
+			arg.eventCb = new Ctx(mainLoop, false);
+			err = ChildProcessManager::getInstance()->create(arg);
+		}
+
+		virtual void onFinalized(void) override
+		{
+			if (!createNext || err != HTERR_OK)
+				mainLoop.quit();
+		}
+	};
+	GMainLoopAgent mainLoop;
+	Ctx *ctx = new Ctx(mainLoop, true);
+	Reaper<UsedCountable> ctxUnref(ctx, UsedCountable::unref);
+
+	ChildProcessManager::CreateArg arg;
+	ctx->ref(); // unref() is called in the destructor of arg.
+	arg.eventCb = ctx;
+	assertCreate(arg);
+	cppcut_assert_equal(0, kill(arg.pid, SIGKILL));
+	mainLoop.run();
+	assertHatoholError(HTERR_OK, ctx->err);
+}
+
 
 } // namespace testChildProcessManager
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <gcutter.h>
+#include <cppcutter.h>
+#include "Helpers.h"
+#include "ColumnarTable.h"
+#include "ColumnarTableStream.h"
+using namespace std;
+using namespace mlpl;
+
+namespace testColumnarTable {
+
+static void makeTestTable(ColumnarTable &table)
+{
+	vector<SQLColumnType> columnTypes;
+	columnTypes.push_back(SQL_COLUMN_TYPE_INT);
+	columnTypes.push_back(SQL_COLUMN_TYPE_BIGUINT);
+	columnTypes.push_back(SQL_COLUMN_TYPE_VARCHAR);
+	columnTypes.push_back(SQL_COLUMN_TYPE_DOUBLE);
+	table.setColumnTypes(columnTypes);
+}
+
+// ---------------------------------------------------------------------------
+// Test cases
+// ---------------------------------------------------------------------------
+void test_addAndGet(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	table.addInt(-5);
+	table.addUint64(0xfedcba9876543210);
+	table.addString("dog", 3);
+	table.addDouble(1.5);
+	table.addInt(8);
+	table.addUint64(3);
+	table.addString("", 0);
+	table.addDouble(-0.25);
+
+	cppcut_assert_equal((size_t)4, table.getNumberOfColumns());
+	cppcut_assert_equal((size_t)2, table.getNumberOfRows());
+	cppcut_assert_equal(-5, table.getInt(0, 0));
+	cppcut_assert_equal((uint64_t)0xfedcba9876543210,
+	                    table.getUint64(0, 1));
+	cppcut_assert_equal(string("dog"), table.getString(0, 2));
+	cppcut_assert_equal(1.5, table.getDouble(0, 3));
+	cppcut_assert_equal(8, table.getInt(1, 0));
+	cppcut_assert_equal((uint64_t)3, table.getUint64(1, 1));
+	cppcut_assert_equal(string(""), table.getString(1, 2));
+	cppcut_assert_equal(-0.25, table.getDouble(1, 3));
+}
+
+void test_numberOfRowsWithPartialRow(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	table.addInt(1);
+	table.addUint64(2);
+	cppcut_assert_equal((size_t)0, table.getNumberOfRows());
+}
+
+void test_addNull(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	for (size_t i = 0; i < table.getNumberOfColumns(); i++)
+		table.addNull();
+	cppcut_assert_equal((size_t)1, table.getNumberOfRows());
+	for (size_t i = 0; i < table.getNumberOfColumns(); i++)
+		cppcut_assert_equal(true, table.isNull(0, i));
+	cppcut_assert_equal(0, table.getInt(0, 0));
+	cppcut_assert_equal(string(""), table.getString(0, 2));
+}
+
+void test_addFromString(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	table.addFromString("-3", 2);
+	table.addFromString("18446744073709551615", 20);
+	table.addFromString("cat", 3);
+	table.addFromString(NULL, 0);
+
+	cppcut_assert_equal(-3, table.getInt(0, 0));
+	cppcut_assert_equal((uint64_t)18446744073709551615ULL,
+	                    table.getUint64(0, 1));
+	cppcut_assert_equal(string("cat"), table.getString(0, 2));
+	cppcut_assert_equal(false, table.isNull(0, 2));
+	cppcut_assert_equal(true, table.isNull(0, 3));
+}
+
+void test_addWithUnexpectedType(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	bool gotException = false;
+	try {
+		table.addDouble(1.0);
+	} catch (const HatoholException &e) {
+		gotException = true;
+	}
+	cppcut_assert_equal(true, gotException);
+	cppcut_assert_equal((size_t)0, table.getNumberOfRows());
+}
+
+void test_stream(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	const size_t numRows = 3;
+	for (size_t i = 0; i < numRows; i++) {
+		const string name = StringUtils::sprintf("name%zd", i);
+		table.addInt(i);
+		table.addUint64(i * 100);
+		table.addString(name.c_str(), name.size());
+		table.addDouble(i * 0.5);
+	}
+
+	ColumnarTableStream stream(table);
+	size_t row = 0;
+	while (stream.next()) {
+		int intVal;
+		uint64_t uint64Val;
+		string str;
+		double doubleVal;
+		stream >> intVal;
+		stream >> uint64Val;
+		stream >> str;
+		stream >> doubleVal;
+		cppcut_assert_equal(row, stream.getRow());
+		cppcut_assert_equal((int)row, intVal);
+		cppcut_assert_equal((uint64_t)(row * 100), uint64Val);
+		cppcut_assert_equal(StringUtils::sprintf("name%zd", row), str);
+		cppcut_assert_equal(row * 0.5, doubleVal);
+		row++;
+	}
+	cppcut_assert_equal(numRows, row);
+}
+
+void test_streamReadIntAsUint64(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	table.addInt(7);
+	table.addUint64(0);
+	table.addString("", 0);
+	table.addDouble(0);
+
+	ColumnarTableStream stream(table);
+	cppcut_assert_equal(true, stream.next());
+	cppcut_assert_equal((uint64_t)7, stream.read<uint64_t>());
+	cppcut_assert_equal(string("0"), (stream.read<uint64_t, string>()));
+}
+
+void test_streamSkipAndIsNull(void)
+{
+	ColumnarTable table;
+	makeTestTable(table);
+	table.addInt(1);
+	table.addNull();
+	table.addString("x", 1);
+	table.addDouble(2.0);
+
+	ColumnarTableStream stream(table);
+	cppcut_assert_equal(true, stream.next());
+	cppcut_assert_equal(false, stream.isNull());
+	stream.skip();
+	cppcut_assert_equal(true, stream.isNull());
+	stream.skip();
+	cppcut_assert_equal(string("x"), stream.read<string>());
+}
+
+} // namespace testColumnarTable
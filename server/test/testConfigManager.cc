@@ -23,6 +23,7 @@
 #include <errno.h>
 #include "config.h"
 #include "ConfigManager.h"
+#include "RestResponseCache.h"
 #include "Hatohol.h"
 #include "Helpers.h"
 using namespace std;
@@ -286,4 +287,153 @@ void test_getFaceRestNumWorkers(void)
 	cppcut_assert_equal(expect, actual);
 }
 
+void test_getNumberOfActionSpawnersDefault(void)
+{
+	cppcut_assert_equal(
+	  0, ConfigManager::getInstance()->getNumberOfActionSpawners());
+}
+
+void data_parseNumActionSpawners(void)
+{
+	int expect = ConfigManager::getInstance()->getNumberOfActionSpawners();
+	gcut_add_datum("Negative",
+		       "data", G_TYPE_INT, -1,
+		       "expect", G_TYPE_INT, expect,
+		       NULL);
+	gcut_add_datum("Zero",
+		       "data", G_TYPE_INT, 0,
+		       "expect", G_TYPE_INT, 0,
+		       NULL);
+	gcut_add_datum("Two",
+		       "data", G_TYPE_INT, 2,
+		       "expect", G_TYPE_INT, 2,
+		       NULL);
+}
+
+void test_parseNumActionSpawners(gconstpointer data)
+{
+	int val = gcut_data_get_int(data, "data");
+	string str = StringUtils::sprintf("%d", val);
+	int expect = gcut_data_get_int(data, "expect");
+
+	CommandArgHelper cmds;
+	cmds << "--action-spawners";
+	cmds << str.c_str();
+	cmds.activate();
+
+	cppcut_assert_equal(
+	  expect, ConfigManager::getInstance()->getNumberOfActionSpawners());
+}
+
+void test_setNumberOfActionSpawners(void)
+{
+	const int numSpawners = 3;
+	ConfigManager *mng = ConfigManager::getInstance();
+	mng->setNumberOfActionSpawners(numSpawners);
+	cppcut_assert_equal(numSpawners, mng->getNumberOfActionSpawners());
+}
+
+void test_getNumberOfIncidentSenderJobsDefault(void)
+{
+	cppcut_assert_equal(
+	  0, ConfigManager::getInstance()->getNumberOfIncidentSenderJobs());
+}
+
+void data_parseNumIncidentSenderJobs(void)
+{
+	int expect =
+	  ConfigManager::getInstance()->getNumberOfIncidentSenderJobs();
+	gcut_add_datum("Zero",
+		       "data", G_TYPE_INT, 0,
+		       "expect", G_TYPE_INT, expect,
+		       NULL);
+	gcut_add_datum("Eight",
+		       "data", G_TYPE_INT, 8,
+		       "expect", G_TYPE_INT, 8,
+		       NULL);
+}
+
+void test_parseNumIncidentSenderJobs(gconstpointer data)
+{
+	int val = gcut_data_get_int(data, "data");
+	string str = StringUtils::sprintf("%d", val);
+	int expect = gcut_data_get_int(data, "expect");
+
+	CommandArgHelper cmds;
+	cmds << "--incident-sender-jobs";
+	cmds << str.c_str();
+	cmds.activate();
+
+	cppcut_assert_equal(
+	  expect,
+	  ConfigManager::getInstance()->getNumberOfIncidentSenderJobs());
+}
+
+void test_isTriggerStatisticsCacheEnabledDefault(void)
+{
+	cppcut_assert_equal(
+	  true,
+	  ConfigManager::getInstance()->isTriggerStatisticsCacheEnabled());
+}
+
+void test_parseDisableTriggerStatisticsCache(void)
+{
+	CommandArgHelper cmds;
+	cmds << "--disable-trigger-statistics-cache";
+	cmds.activate();
+	cppcut_assert_equal(
+	  false,
+	  ConfigManager::getInstance()->isTriggerStatisticsCacheEnabled());
+}
+
+void test_getRestResponseCacheSizeDefault(void)
+{
+	cppcut_assert_equal(
+	  RestResponseCache::DEFAULT_MAX_BYTES,
+	  ConfigManager::getInstance()->getRestResponseCacheSize());
+}
+
+void data_parseRestResponseCacheSize(void)
+{
+	gcut_add_datum("Disabled", "value", G_TYPE_INT, 0, NULL);
+	gcut_add_datum("Set", "value", G_TYPE_INT, 8, NULL);
+}
+
+void test_parseRestResponseCacheSize(gconstpointer data)
+{
+	const int size = gcut_data_get_int(data, "value");
+	CommandArgHelper cmds;
+	cmds << "--rest-response-cache-size";
+	cmds << StringUtils::toString(size).c_str();
+	cmds.activate();
+	cppcut_assert_equal(
+	  static_cast<size_t>(size * 1024 * 1024),
+	  ConfigManager::getInstance()->getRestResponseCacheSize());
+}
+
+void test_getFaceRestNumReactorsDefault(void)
+{
+	cppcut_assert_equal(
+	  static_cast<size_t>(1),
+	  ConfigManager::getInstance()->getFaceRestNumReactors());
+}
+
+void data_parseFaceRestNumReactors(void)
+{
+	gcut_add_datum("PerCPU", "value", G_TYPE_INT, 0, NULL);
+	gcut_add_datum("Set", "value", G_TYPE_INT, 4, NULL);
+}
+
+void test_parseFaceRestNumReactors(gconstpointer data)
+{
+	const int num = gcut_data_get_int(data, "value");
+	CommandArgHelper cmds;
+	cmds << "--face-rest-reactors";
+	cmds << StringUtils::toString(num).c_str();
+	cmds.activate();
+	cppcut_assert_equal(
+	  static_cast<size_t>(num),
+	  ConfigManager::getInstance()->getFaceRestNumReactors());
+}
+
 } // namespace testConfigManager
@@ -556,6 +556,12 @@ void test_upsertWithPrimaryKeyAutoInc(void)
 	dbAgentTestUpsertWithPrimaryKeyAutoInc(dbAgent, dbAgentChecker);
 }
 
+void test_bulkInsert(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgentTestBulkInsert(dbAgent, dbAgentChecker);
+}
+
 void test_update(void)
 {
 	DBAgentMySQL dbAgent(TEST_DB_NAME);
@@ -580,6 +586,34 @@ void test_select(void)
 	dbAgentTestSelect(dbAgent);
 }
 
+void test_insertWithPreparedStatement(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgent.setPreparedStatementEnabled(true);
+	dbAgentTestInsert(dbAgent, dbAgentChecker);
+}
+
+void test_insertNullWithPreparedStatement(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgent.setPreparedStatementEnabled(true);
+	dbAgentTestInsertNull(dbAgent, dbAgentChecker);
+}
+
+void test_upsertWithPreparedStatement(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgent.setPreparedStatementEnabled(true);
+	dbAgentTestUpsert(dbAgent, dbAgentChecker);
+}
+
+void test_selectWithPreparedStatement(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgent.setPreparedStatementEnabled(true);
+	dbAgentTestSelect(dbAgent);
+}
+
 void test_selectEx(void)
 {
 	DBAgentMySQL dbAgent(TEST_DB_NAME);
@@ -598,6 +632,24 @@ void test_selectExWithCondAllColumns(void)
 	dbAgentTestSelectExWithCondAllColumns(dbAgent);
 }
 
+void test_selectExWithColumnarTable(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgentTestSelectExWithColumnarTable(dbAgent);
+}
+
+void test_selectEach(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgentTestSelectEach(dbAgent);
+}
+
+void test_selectEachStop(void)
+{
+	DBAgentMySQL dbAgent(TEST_DB_NAME);
+	dbAgentTestSelectEachStop(dbAgent);
+}
+
 void test_selectExWithOrderBy(void)
 {
 	DBAgentMySQL dbAgent(TEST_DB_NAME);
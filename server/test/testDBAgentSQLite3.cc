@@ -487,6 +487,103 @@ void test_upsertWithPrimaryKeyAutoInc(void)
 	dbAgentTestUpsertWithPrimaryKeyAutoInc(dbAgent, dbAgentChecker);
 }
 
+void test_bulkInsert(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestBulkInsert(dbAgent, dbAgentChecker);
+}
+
+void test_insertReusesCachedStatement(void)
+{
+	DBAgentSQLite3 dbAgent;
+	// The rows are inserted one by one with the same statement.
+	dbAgentTestBulkInsert(dbAgent, dbAgentChecker);
+	cppcut_assert_equal((size_t)1, dbAgent.getNumberOfCachedStatements());
+}
+
+void test_selectReusesCachedStatement(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestBulkInsert(dbAgent, dbAgentChecker);
+
+	DBAgent::SelectArg arg(tableProfileTestAutoInc);
+	arg.columnIndexes.push_back(0);
+	for (size_t i = 0; i < 2; i++) {
+		dbAgent.select(arg);
+		cppcut_assert_equal((size_t)3,
+		                    arg.dataTable->getNumberOfRows());
+	}
+	// One for the insert and one for the select
+	cppcut_assert_equal((size_t)2, dbAgent.getNumberOfCachedStatements());
+}
+
+void test_selectWithConditionReusesCachedStatement(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestBulkInsert(dbAgent, dbAgentChecker);
+
+	// The values in the conditions are bound to the same statement.
+	for (size_t i = 0; i < 3; i++) {
+		DBAgent::SelectExArg arg(tableProfileTestAutoInc);
+		arg.add(0);
+		arg.condition = StringUtils::sprintf(
+		  "id=%zd AND name='name%zd'", i + 1, i);
+		dbAgent.select(arg);
+		cppcut_assert_equal((size_t)1,
+		                    arg.dataTable->getNumberOfRows());
+	}
+	// One for the insert and one for the select
+	cppcut_assert_equal((size_t)2, dbAgent.getNumberOfCachedStatements());
+}
+
+void test_updateAndDeleteReuseCachedStatement(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestBulkInsert(dbAgent, dbAgentChecker);
+
+	for (size_t i = 0; i < 2; i++) {
+		DBAgent::UpdateArg arg(tableProfileTestAutoInc);
+		arg.add(2, StringUtils::sprintf("it's %zd", i));
+		arg.condition = StringUtils::sprintf("id=%zd", i + 1);
+		dbAgent.update(arg);
+	}
+	DBAgent::DeleteArg deleteArg(tableProfileTestAutoInc);
+	for (size_t i = 0; i < 2; i++) {
+		deleteArg.condition = StringUtils::sprintf("val=%zd", i * 10);
+		dbAgent.deleteRows(deleteArg);
+	}
+	assertDBContent(&dbAgent, "select * from test_table_auto_inc",
+	                "3|20|name2");
+
+	// One each for the insert, the update and the delete
+	cppcut_assert_equal((size_t)3, dbAgent.getNumberOfCachedStatements());
+}
+
+void test_selectWithLongInListIsNotCached(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestBulkInsert(dbAgent, dbAgentChecker);
+
+	// The values of a long list are kept inline. So the statement
+	// differs for each list and isn't cached.
+	for (size_t numIds = 20; numIds < 22; numIds++) {
+		DBAgent::SelectExArg arg(tableProfileTestAutoInc);
+		arg.add(0);
+		string ids;
+		for (size_t id = 1; id <= numIds; id++) {
+			if (!ids.empty())
+				ids += ",";
+			ids += StringUtils::toString(id);
+		}
+		arg.condition = "id IN (" + ids + ")";
+		dbAgent.select(arg);
+		cppcut_assert_equal((size_t)3,
+		                    arg.dataTable->getNumberOfRows());
+	}
+	// Only for the insert
+	cppcut_assert_equal((size_t)1, dbAgent.getNumberOfCachedStatements());
+}
+
 void test_update(void)
 {
 	DBAgentSQLite3 dbAgent;
@@ -523,6 +620,24 @@ void test_selectExWithCondAllColumns(void)
 	dbAgentTestSelectExWithCondAllColumns(dbAgent);
 }
 
+void test_selectExWithColumnarTable(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestSelectExWithColumnarTable(dbAgent);
+}
+
+void test_selectEach(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestSelectEach(dbAgent);
+}
+
+void test_selectEachStop(void)
+{
+	DBAgentSQLite3 dbAgent;
+	dbAgentTestSelectEachStop(dbAgent);
+}
+
 void test_selectExWithOrderBy(void)
 {
 	DBAgentSQLite3 dbAgent;
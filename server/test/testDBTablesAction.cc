@@ -693,6 +693,39 @@ void test_endExecAction(void)
 	assertDBContent(&dbAction.getDBAgent(), statement, expect);
 }
 
+void data_getLoggedEvents(void)
+{
+	gcut_add_datum("Recent", "clearRecent", G_TYPE_BOOLEAN, FALSE, NULL);
+	gcut_add_datum("FromDB", "clearRecent", G_TYPE_BOOLEAN, TRUE, NULL);
+}
+
+void test_getLoggedEvents(gconstpointer data)
+{
+	const ActionDef &actDef = testActionDef[0];
+	ServerEventIdPairSet expected;
+	EventInfoList eventInfoList;
+	{
+		DECLARE_DBTABLES_ACTION(dbAction);
+		for (size_t i = 0; i < NumTestEventInfo; i++) {
+			const EventInfo &eventInfo = testEventInfo[i];
+			eventInfoList.push_back(eventInfo);
+			if (i % 2 == 0)
+				continue;
+			dbAction.createActionLog(actDef, eventInfo);
+			expected.insert(ServerEventIdPair(eventInfo.serverId,
+			                                  eventInfo.id));
+		}
+	}
+	if (gcut_data_get_boolean(data, "clearRecent"))
+		DBTablesAction::reset();
+
+	DECLARE_DBTABLES_ACTION(dbAction);
+	ServerEventIdPairSet actual;
+	dbAction.getLoggedEvents(actual, eventInfoList);
+	cppcut_assert_equal(expected.size(), actual.size());
+	cppcut_assert_equal(true, expected == actual);
+}
+
 void test_getTriggerActionList(void)
 {
 	loadTestDBAction();
@@ -26,6 +26,7 @@
 #include "DBTablesTest.h"
 #include "Params.h"
 #include "ThreadLocalDBCache.h"
+#include "TriggerInfoCache.h"
 #include "testDBTablesMonitoring.h"
 #include <algorithm>
 #include "TestHostResourceQueryOption.h"
@@ -808,6 +809,47 @@ void test_getTriggerInfoNotFound(void)
 	                    dbMonitoring.getTriggerInfo(triggerInfo, option));
 }
 
+void test_getTriggerInfoWithIds(void)
+{
+	loadTestDBTriggers();
+	// Make the DB be read
+	TriggerInfoCache::getInstance().clear();
+
+	const TriggerInfo &targetTriggerInfo = testTriggerInfo[2];
+	TriggerInfo triggerInfo;
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+	cppcut_assert_equal(true,
+	   dbMonitoring.getTriggerInfo(triggerInfo, targetTriggerInfo.serverId,
+	                               targetTriggerInfo.id));
+	assertTriggerInfo(targetTriggerInfo, triggerInfo);
+
+	TriggerInfo cachedTriggerInfo;
+	cppcut_assert_equal(true, TriggerInfoCache::getInstance().get(
+	  targetTriggerInfo.serverId, targetTriggerInfo.id,
+	  cachedTriggerInfo));
+	assertTriggerInfo(targetTriggerInfo, cachedTriggerInfo);
+}
+
+void test_getTriggerInfoWithIdsAfterDelete(void)
+{
+	loadTestDBTriggers();
+
+	const TriggerInfo &targetTriggerInfo = testTriggerInfo[2];
+	TriggerInfo triggerInfo;
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+	cppcut_assert_equal(true,
+	   dbMonitoring.getTriggerInfo(triggerInfo, targetTriggerInfo.serverId,
+	                               targetTriggerInfo.id));
+
+	TriggerIdList triggerIdList = { targetTriggerInfo.id };
+	assertHatoholError(
+	  HTERR_OK, dbMonitoring.deleteTriggerInfo(triggerIdList,
+	                                           targetTriggerInfo.serverId));
+	cppcut_assert_equal(false,
+	   dbMonitoring.getTriggerInfo(triggerInfo, targetTriggerInfo.serverId,
+	                               targetTriggerInfo.id));
+}
+
 void data_getTriggerInfoList(void)
 {
 	prepareTestDataExcludeDefunctServers();
@@ -1297,6 +1339,39 @@ void test_addEventInfoUnifiedId(void)
 			"select * from events", expected);
 }
 
+void test_addEventInfoListWithTriggerInfo(void)
+{
+	loadTestDBTriggers();
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+
+	// Events without host and brief. They are filled with the triggers.
+	EventInfoList eventInfoList;
+	for (size_t i = 0; i < 2; i++) {
+		const TriggerInfo &trigInfo = testTriggerInfo[i];
+		EventInfo eventInfo;
+		initEventInfo(eventInfo);
+		eventInfo.serverId  = trigInfo.serverId;
+		eventInfo.id        = StringUtils::sprintf("%zd", i + 1);
+		eventInfo.triggerId = trigInfo.id;
+		eventInfoList.push_back(eventInfo);
+	}
+	dbMonitoring.addEventInfoList(eventInfoList);
+
+	size_t idx = 0;
+	for (const auto &eventInfo : eventInfoList) {
+		const TriggerInfo &trigInfo = testTriggerInfo[idx++];
+		cppcut_assert_equal((UnifiedEventIdType)idx,
+		                    eventInfo.unifiedId);
+		cppcut_assert_equal(trigInfo.severity, eventInfo.severity);
+		cppcut_assert_equal(trigInfo.globalHostId,
+		                    eventInfo.globalHostId);
+		cppcut_assert_equal(trigInfo.hostIdInServer,
+		                    eventInfo.hostIdInServer);
+		cppcut_assert_equal(trigInfo.hostName, eventInfo.hostName);
+		cppcut_assert_equal(trigInfo.brief, eventInfo.brief);
+	}
+}
+
 void data_addDupEventInfoList(void)
 {
 	prepareTestDataExcludeDefunctServers();
@@ -1494,6 +1569,71 @@ void test_getNumberOfTriggersBySeverityWithoutPriviledge(void)
 	}
 }
 
+void test_getBadTriggerCountMatrix(void)
+{
+	loadTestDBTriggers();
+	loadTestDBHostgroupMember();
+
+	const ServerIdType targetServerId = testTriggerInfo[0].serverId;
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+	TriggersQueryOption option(USER_ID_SYSTEM);
+	option.setTargetServerId(targetServerId);
+	DBTablesMonitoring::BadTriggerCountMatrix matrix;
+	assertHatoholError(HTERR_OK,
+	  dbMonitoring.getBadTriggerCountMatrix(matrix, option));
+
+	for (const auto &hostgroupId : getTestHostgroupIdSet()) {
+		TriggersQueryOption hostgroupOption(option);
+		hostgroupOption.setTargetHostgroupId(hostgroupId);
+		for (int i = 0; i < NUM_TRIGGER_SEVERITY; i++) {
+			const TriggerSeverityType severity =
+			  static_cast<TriggerSeverityType>(i);
+			cppcut_assert_equal(
+			  dbMonitoring.getNumberOfBadTriggers(hostgroupOption,
+			                                      severity),
+			  matrix[hostgroupId][i],
+			  cut_message("hostgroup: %" FMT_HOST_GROUP_ID ", "
+			              "severity: %d", hostgroupId.c_str(), i));
+		}
+	}
+}
+
+void test_getHostStatusCountMap(void)
+{
+	loadTestDBTriggers();
+	loadTestDBHostgroupMember();
+
+	const ServerIdType targetServerId = testTriggerInfo[0].serverId;
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+	TriggersQueryOption option(USER_ID_SYSTEM);
+	option.setTargetServerId(targetServerId);
+	DBTablesMonitoring::HostStatusCountMap countMap;
+	assertHatoholError(HTERR_OK,
+	  dbMonitoring.getHostStatusCountMap(countMap, option));
+
+	for (const auto &hostgroupId : getTestHostgroupIdSet()) {
+		TriggersQueryOption hostgroupOption(option);
+		hostgroupOption.setTargetHostgroupId(hostgroupId);
+		const DBTablesMonitoring::HostStatusCounts &counts =
+		  countMap[hostgroupId];
+		cppcut_assert_equal(
+		  dbMonitoring.getNumberOfGoodHosts(hostgroupOption),
+		  counts.numGoodHosts);
+		cppcut_assert_equal(
+		  dbMonitoring.getNumberOfBadHosts(hostgroupOption),
+		  counts.numBadHosts);
+	}
+}
+
+void test_getBadTriggerCountMatrixWithoutTargetServer(void)
+{
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+	TriggersQueryOption option(USER_ID_SYSTEM);
+	DBTablesMonitoring::BadTriggerCountMatrix matrix;
+	assertHatoholError(HTERR_INVALID_PARAMETER,
+	  dbMonitoring.getBadTriggerCountMatrix(matrix, option));
+}
+
 void test_getLastChangeTimeOfTriggerWithNoTrigger(void)
 {
 	DECLARE_DBTABLES_MONITORING(dbMonitoring);
@@ -1924,6 +2064,47 @@ void test_updateNonExistentIncidentInfo(void)
 	assertDBContent(&dbAgent, statement, expect);
 }
 
+void test_updateIncidentInfoVect(void)
+{
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+	DBAgent &dbAgent = dbMonitoring.getDBAgent();
+
+	IncidentInfo incidentInfo0 = testIncidentInfo[0];
+	IncidentInfo incidentInfo1 = testIncidentInfo[1];
+	dbMonitoring.addIncidentInfo(&incidentInfo0);
+	dbMonitoring.addIncidentInfo(&incidentInfo1);
+
+	IncidentInfoVect incidentInfoVect;
+	incidentInfoVect.push_back(incidentInfo0);
+	incidentInfoVect.push_back(incidentInfo1);
+	incidentInfoVect.push_back(incidentInfo1);
+	for (auto &incidentInfo : incidentInfoVect) {
+		incidentInfo.status = "Assigned";
+		incidentInfo.assignee = "hikeshi";
+		incidentInfo.updatedAt.tv_sec = time(NULL);
+		incidentInfo.updatedAt.tv_nsec = 0;
+		// They are ignored and the stored values are kept
+		incidentInfo.serverId = 12345;
+		incidentInfo.eventId = "12345";
+	}
+	// Non existent identifier should be skipped
+	incidentInfoVect.back().identifier = "8888";
+
+	size_t numUpdated
+	  = dbMonitoring.updateIncidentInfoVect(incidentInfoVect);
+
+	cppcut_assert_equal((size_t)2, numUpdated);
+	incidentInfo0.status = incidentInfo1.status = "Assigned";
+	incidentInfo0.assignee = incidentInfo1.assignee = "hikeshi";
+	incidentInfo0.updatedAt = incidentInfoVect[0].updatedAt;
+	incidentInfo1.updatedAt = incidentInfoVect[1].updatedAt;
+	string statement("select * from incidents order by identifier asc;");
+	string expect;
+	expect += makeIncidentOutput(incidentInfo0);
+	expect += makeIncidentOutput(incidentInfo1);
+	assertDBContent(&dbAgent, statement, expect);
+}
+
 void test_getIncidentInfo(void)
 {
 	DECLARE_DBTABLES_MONITORING(dbMonitoring);
@@ -2023,6 +2204,40 @@ void test_getEventsSelectByHosts(void)
 	cppcut_assert_equal(expected, actual);
 }
 
+void test_forEachEventInfo(void)
+{
+	loadTestDBEvents();
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+
+	EventsQueryOption option(USER_ID_SYSTEM);
+	EventInfoList expected;
+	dbMonitoring.getEventInfoList(expected, option);
+
+	EventInfoList actual;
+	dbMonitoring.forEachEventInfo(option,
+	  [&](EventInfo &eventInfo, IncidentInfo *incidentInfo) {
+		cppcut_assert_null(incidentInfo);
+		actual.push_back(eventInfo);
+		return true;
+	});
+	cppcut_assert_equal(sortedJoin(expected), sortedJoin(actual));
+}
+
+void test_forEachEventInfoStop(void)
+{
+	loadTestDBEvents();
+	DECLARE_DBTABLES_MONITORING(dbMonitoring);
+
+	EventsQueryOption option(USER_ID_SYSTEM);
+	size_t count = 0;
+	dbMonitoring.forEachEventInfo(option,
+	  [&](EventInfo &eventInfo, IncidentInfo *incidentInfo) {
+		count++;
+		return false;
+	});
+	cppcut_assert_equal((size_t)1, count);
+}
+
 void test_getEventsExcludeByHosts(void)
 {
 	loadTestDBEvents();
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppcutter.h>
+#include <gcutter.h>
+#include "Hatohol.h"
+#include "Helpers.h"
+#include "DBTablesTest.h"
+#include "ThreadLocalDBCache.h"
+#include "DataGeneration.h"
+using namespace std;
+using namespace mlpl;
+
+namespace testDataGeneration {
+
+void cut_setup(void)
+{
+	hatoholInit();
+	setupTestDB();
+}
+
+// ---------------------------------------------------------------------------
+// Test cases
+// ---------------------------------------------------------------------------
+void test_bump(void)
+{
+	const uint64_t trigger = DataGeneration::get(DATA_GENERATION_TRIGGER);
+	const uint64_t event = DataGeneration::get(DATA_GENERATION_EVENT);
+	DataGeneration::bump(DATA_GENERATION_TRIGGER);
+	cppcut_assert_equal(trigger + 1,
+	                    DataGeneration::get(DATA_GENERATION_TRIGGER));
+	cppcut_assert_equal(event, DataGeneration::get(DATA_GENERATION_EVENT));
+}
+
+void test_bumper(void)
+{
+	const uint64_t host = DataGeneration::get(DATA_GENERATION_HOST);
+	{
+		DataGeneration::Bumper bumper(DATA_GENERATION_HOST);
+		cppcut_assert_equal(host,
+		                    DataGeneration::get(DATA_GENERATION_HOST));
+	}
+	cppcut_assert_equal(host + 1, DataGeneration::get(DATA_GENERATION_HOST));
+}
+
+void test_getLastModifiedTime(void)
+{
+	const time_t before = time(NULL);
+	DataGeneration::bump(DATA_GENERATION_ITEM);
+	const time_t lastModifiedTime =
+	  DataGeneration::getLastModifiedTime(DATA_GENERATION_ITEM);
+	cppcut_assert_equal(true, lastModifiedTime >= before);
+	cppcut_assert_equal(true, lastModifiedTime <= time(NULL));
+}
+
+void test_getEpoch(void)
+{
+	cppcut_assert_not_equal((uint64_t)0, DataGeneration::getEpoch());
+	cppcut_assert_equal(DataGeneration::getEpoch(),
+	                    DataGeneration::getEpoch());
+}
+
+void test_addTriggerInfoBumpsTrigger(void)
+{
+	const uint64_t trigger = DataGeneration::get(DATA_GENERATION_TRIGGER);
+	ThreadLocalDBCache cache;
+	cache.getMonitoring().addTriggerInfo(&testTriggerInfo[0]);
+	cppcut_assert_equal(trigger + 1,
+	                    DataGeneration::get(DATA_GENERATION_TRIGGER));
+}
+
+void test_upsertHostgroupMemberBumpsHost(void)
+{
+	const uint64_t host = DataGeneration::get(DATA_GENERATION_HOST);
+	ThreadLocalDBCache cache;
+	cache.getHost().upsertHostgroupMember(testHostgroupMember[0]);
+	cppcut_assert_equal(true,
+	                    DataGeneration::get(DATA_GENERATION_HOST) > host);
+}
+
+void test_addTargetServerBumpsConfig(void)
+{
+	const uint64_t config = DataGeneration::get(DATA_GENERATION_CONFIG);
+	loadTestDBServer();
+	cppcut_assert_equal(true,
+	                    DataGeneration::get(DATA_GENERATION_CONFIG) > config);
+}
+
+} // namespace testDataGeneration
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <cppcutter.h>
+#include <SimpleSemaphore.h>
+#include <mutex>
+#include <StringUtils.h>
+#include "EventIngestPipeline.h"
+#include "HatoholException.h"
+
+using namespace std;
+using namespace mlpl;
+
+namespace testEventIngestPipeline {
+
+static const ServerIdType TEST_SERVER_ID = 3;
+static const size_t TIMEOUT_MSEC = 5000;
+
+class TestPipeline : public EventIngestPipeline {
+public:
+	mutex m_mutex;
+	vector<size_t> m_persistedBatchSizes;
+	vector<string> m_persistedEventIds;
+	vector<string> m_lastInfos;
+	vector<string> m_dispatchedEventIds;
+	SimpleSemaphore *m_persistGate;
+	size_t m_numPersistFailures;
+
+	TestPipeline(WorkerPool &pool, const size_t &capacity
+	               = DEFAULT_QUEUE_CAPACITY)
+	: EventIngestPipeline(TEST_SERVER_ID, pool, capacity),
+	  m_persistGate(NULL),
+	  m_numPersistFailures(0)
+	{
+	}
+
+	virtual ~TestPipeline()
+	{
+		flush();
+	}
+
+protected:
+	virtual void persist(EventInfoList &eventInfoList,
+	                     const string &lastInfo) override
+	{
+		if (m_persistGate)
+			m_persistGate->wait();
+		lock_guard<mutex> lock(m_mutex);
+		if (m_numPersistFailures > 0) {
+			m_numPersistFailures--;
+			THROW_HATOHOL_EXCEPTION("Test failure");
+		}
+		m_persistedBatchSizes.push_back(eventInfoList.size());
+		for (auto &eventInfo : eventInfoList)
+			m_persistedEventIds.push_back(eventInfo.id);
+		m_lastInfos.push_back(lastInfo);
+	}
+
+	virtual void dispatchActions(
+	  const EventInfoList &eventInfoList) override
+	{
+		lock_guard<mutex> lock(m_mutex);
+		for (auto &eventInfo : eventInfoList)
+			m_dispatchedEventIds.push_back(eventInfo.id);
+	}
+};
+
+static EventInfoList makeEventInfoList(const size_t &first,
+                                       const size_t &num)
+{
+	EventInfoList eventInfoList;
+	for (size_t i = first; i < first + num; i++) {
+		EventInfo eventInfo;
+		initEventInfo(eventInfo);
+		eventInfo.serverId = TEST_SERVER_ID;
+		eventInfo.id = StringUtils::toString(i);
+		eventInfoList.push_back(eventInfo);
+	}
+	return eventInfoList;
+}
+
+static vector<string> makeIds(const size_t &num)
+{
+	vector<string> ids;
+	for (size_t i = 0; i < num; i++)
+		ids.push_back(StringUtils::toString(i));
+	return ids;
+}
+
+template<typename T>
+static void assertEqualVector(const vector<T> &expected,
+                              const vector<T> &actual)
+{
+	cppcut_assert_equal(expected.size(), actual.size());
+	for (size_t i = 0; i < expected.size(); i++)
+		cppcut_assert_equal(expected[i], actual[i]);
+}
+
+static void waitQueueDepth(EventIngestPipeline &pipeline,
+                           const EventIngestPipeline::Stage &stage,
+                           const size_t &depth)
+{
+	GTimer *timer = g_timer_new();
+	cut_take(timer, (CutDestroyFunction)g_timer_destroy);
+	g_timer_start(timer);
+	while (pipeline.getQueueDepth(stage) != depth) {
+		cut_assert_true(
+		  g_timer_elapsed(timer, NULL) * 1000 < TIMEOUT_MSEC);
+		g_usleep(0.01 * G_USEC_PER_SEC);
+	}
+}
+
+void test_pushAndFlush(void)
+{
+	WorkerPool pool(2);
+	TestPipeline pipeline(pool);
+	for (size_t i = 0; i < 3; i++) {
+		EventInfoList eventInfoList = makeEventInfoList(i * 2, 2);
+		pipeline.push(eventInfoList,
+		              StringUtils::sprintf("lastInfo%zd", i));
+		cppcut_assert_equal(true, eventInfoList.empty());
+	}
+	pipeline.flush();
+
+	assertEqualVector(makeIds(6), pipeline.m_persistedEventIds);
+	assertEqualVector(makeIds(6), pipeline.m_dispatchedEventIds);
+	cppcut_assert_equal(string("lastInfo2"), pipeline.m_lastInfos.back());
+	for (int i = 0; i < EventIngestPipeline::NUM_STAGES; i++) {
+		EventIngestPipeline::Stage stage =
+		  static_cast<EventIngestPipeline::Stage>(i);
+		cppcut_assert_equal((size_t)0, pipeline.getQueueDepth(stage));
+	}
+}
+
+void test_coalesceWhilePersistIsBusy(void)
+{
+	WorkerPool pool(2);
+	SimpleSemaphore persistGate(0);
+	TestPipeline pipeline(pool);
+	pipeline.m_persistGate = &persistGate;
+
+	EventInfoList eventInfoList = makeEventInfoList(0, 1);
+	pipeline.push(eventInfoList, "");
+	waitQueueDepth(pipeline, EventIngestPipeline::STAGE_PERSIST, 0);
+	for (size_t i = 1; i < 4; i++) {
+		eventInfoList = makeEventInfoList(i, 1);
+		pipeline.push(eventInfoList, "");
+	}
+	waitQueueDepth(pipeline, EventIngestPipeline::STAGE_COALESCE, 0);
+	cppcut_assert_equal((size_t)1, pipeline.getQueueDepth(
+	  EventIngestPipeline::STAGE_PERSIST));
+
+	persistGate.post();
+	persistGate.post();
+	pipeline.flush();
+
+	vector<size_t> expectedSizes = {1, 3};
+	assertEqualVector(expectedSizes, pipeline.m_persistedBatchSizes);
+	assertEqualVector(makeIds(4), pipeline.m_dispatchedEventIds);
+}
+
+void test_retryPersistAfterFailure(void)
+{
+	WorkerPool pool(1);
+	TestPipeline pipeline(pool);
+	pipeline.m_numPersistFailures = 2;
+	EventInfoList eventInfoList = makeEventInfoList(0, 2);
+	const EventIngestPipeline::Ticket ticket =
+	  pipeline.push(eventInfoList, "lastInfo");
+	cppcut_assert_equal(true, pipeline.waitPersisted(ticket));
+
+	cppcut_assert_equal((size_t)0, pipeline.m_numPersistFailures);
+	assertEqualVector(makeIds(2), pipeline.m_persistedEventIds);
+	pipeline.flush();
+	assertEqualVector(makeIds(2), pipeline.m_dispatchedEventIds);
+	cppcut_assert_equal(string("lastInfo"), pipeline.m_lastInfos.back());
+}
+
+void test_giveUpPersistAfterMaxTrials(void)
+{
+	WorkerPool pool(1);
+	TestPipeline pipeline(pool);
+	pipeline.m_numPersistFailures = EventIngestPipeline::MAX_PERSIST_TRIALS;
+	EventInfoList eventInfoList = makeEventInfoList(0, 2);
+	const EventIngestPipeline::Ticket failedTicket =
+	  pipeline.push(eventInfoList, "");
+	cppcut_assert_equal(false, pipeline.waitPersisted(failedTicket));
+
+	eventInfoList = makeEventInfoList(2, 1);
+	const EventIngestPipeline::Ticket ticket =
+	  pipeline.push(eventInfoList, "");
+	cppcut_assert_equal(true, pipeline.waitPersisted(ticket));
+	pipeline.flush();
+
+	vector<string> expectedIds = {"2"};
+	assertEqualVector(expectedIds, pipeline.m_persistedEventIds);
+	assertEqualVector(expectedIds, pipeline.m_dispatchedEventIds);
+}
+
+void test_getStageName(void)
+{
+	cppcut_assert_equal(string("persist"), string(
+	  EventIngestPipeline::getStageName(
+	    EventIngestPipeline::STAGE_PERSIST)));
+}
+
+} // namespace testEventIngestPipeline
@@ -22,6 +22,7 @@
 #include "FaceRest.h"
 #include "FaceRestTestUtils.h"
 #include "Helpers.h"
+#include "ConfigManager.h"
 using namespace std;
 using namespace mlpl;
 
@@ -67,4 +68,30 @@ void test_testError(void)
 	assertErrorCode(parserPtr.get(), HTERR_ERROR_TEST);
 }
 
+void test_multipleReactors(void)
+{
+	// The connections are distributed among the reactors by the kernel.
+	ConfigManager::getInstance()->setFaceRestNumReactors(4);
+	startFaceRest();
+	for (size_t i = 0; i < 16; i++) {
+		RequestArg arg("/test");
+		unique_ptr<JSONParser> parserPtr(getResponseAsJSONParser(arg));
+		assertErrorCode(parserPtr.get());
+	}
+}
+
+void test_keepAliveWithMultipleReactors(void)
+{
+	ConfigManager::getInstance()->setFaceRestNumReactors(2);
+	startFaceRest();
+	// curl reuses the connection for the second request if it is kept.
+	const string url = StringUtils::sprintf(
+	  "http://localhost:%d/hello.html",
+	  ConfigManager::getInstance()->getFaceRestPort());
+	const string cmd = StringUtils::sprintf(
+	  "curl -s -o /dev/null -w \"%%{num_connects} \" %s %s",
+	  url.c_str(), url.c_str());
+	cppcut_assert_equal(string("1 0 "), executeCommand(cmd));
+}
+
 } // namespace testFaceRest
@@ -26,6 +26,7 @@
 #include "testDBTablesMonitoring.h"
 #include "FaceRestTestUtils.h"
 #include "ThreadLocalDBCache.h"
+#include "ConfigManager.h"
 using namespace std;
 using namespace mlpl;
 
@@ -718,7 +719,7 @@ void test_itemsJSONWithQuery(void)
 	assertItems("/item?serverId=3&hostId=5&itemId=1", "", 1);
 }
 
-void test_overview(void)
+static void _assertOverview(void)
 {
 	startFaceRest();
 	loadTestDBTriggers();
@@ -736,6 +737,172 @@ void test_overview(void)
 	assertErrorCode(parser);
 	assertOverviewInParser(parser, arg);
 }
+#define assertOverview() cut_trace(_assertOverview())
+
+void test_overview(void)
+{
+	assertOverview();
+}
+
+void test_overviewWithoutTriggerStatisticsCache(void)
+{
+	ConfigManager::getInstance()->setTriggerStatisticsCacheEnabled(false);
+	assertOverview();
+}
+
+static string findResponseHeader(const RequestArg &arg, const string &name)
+{
+	const string prefix = name + ": ";
+	for (const auto &header : arg.responseHeaders) {
+		if (StringUtils::hasPrefix(header, prefix, false))
+			return header.substr(prefix.size());
+	}
+	return "";
+}
+
+static string makeIfNoneMatchHeader(const string &entityTag)
+{
+	// Double quotes are escaped for the shell that runs curl.
+	string header = "If-None-Match: ";
+	for (const auto &c : entityTag) {
+		if (c == '"')
+			header += '\\';
+		header += c;
+	}
+	return header;
+}
+
+static string getEntityTag(const string &path,
+                           const StringMap &parameters = StringMap())
+{
+	RequestArg arg(path);
+	arg.parameters = parameters;
+	arg.userId = findUserWith(OPPRVLG_GET_ALL_SERVER);
+	getServerResponse(arg);
+	cppcut_assert_equal(static_cast<int>(SOUP_STATUS_OK),
+	                    arg.httpStatusCode);
+	cppcut_assert_equal(false,
+	                    findResponseHeader(arg, "Last-Modified").empty());
+	cppcut_assert_equal(string("no-cache"),
+	                    findResponseHeader(arg, "Cache-Control"));
+	const string entityTag = findResponseHeader(arg, "ETag");
+	cppcut_assert_equal(false, entityTag.empty());
+	return entityTag;
+}
+
+static int getStatusCodeWithEntityTag(
+  const string &path, const string &entityTag,
+  const StringMap &parameters = StringMap())
+{
+	RequestArg arg(path);
+	arg.parameters = parameters;
+	arg.userId = findUserWith(OPPRVLG_GET_ALL_SERVER);
+	arg.headers.push_back(makeIfNoneMatchHeader(entityTag));
+	getServerResponse(arg);
+	if (arg.httpStatusCode == SOUP_STATUS_NOT_MODIFIED) {
+		cppcut_assert_equal(string(), arg.response);
+		cppcut_assert_equal(entityTag, findResponseHeader(arg, "ETag"));
+	}
+	return arg.httpStatusCode;
+}
+
+void data_notModified(void)
+{
+	gcut_add_datum("overview", "path", G_TYPE_STRING, "/overview", NULL);
+	gcut_add_datum("host", "path", G_TYPE_STRING, "/host", NULL);
+	gcut_add_datum("trigger", "path", G_TYPE_STRING, "/trigger", NULL);
+	gcut_add_datum("event", "path", G_TYPE_STRING, "/event", NULL);
+}
+
+void test_notModified(gconstpointer data)
+{
+	loadTestDBTriggers();
+	loadTestDBEvents();
+	loadTestDBServerHostDef();
+	startFaceRest();
+
+	const string path = gcut_data_get_string(data, "path");
+	const string entityTag = getEntityTag(path);
+	cppcut_assert_equal(static_cast<int>(SOUP_STATUS_NOT_MODIFIED),
+	                    getStatusCodeWithEntityTag(path, entityTag));
+}
+
+void test_notModifiedWithWeakEntityTag(void)
+{
+	loadTestDBTriggers();
+	startFaceRest();
+
+	const string entityTag = getEntityTag("/trigger");
+	cppcut_assert_equal(static_cast<int>(SOUP_STATUS_NOT_MODIFIED),
+	                    getStatusCodeWithEntityTag("/trigger",
+	                                               "W/" + entityTag));
+}
+
+void test_modifiedAfterTriggerIsChanged(void)
+{
+	loadTestDBTriggers();
+	startFaceRest();
+
+	const string entityTag = getEntityTag("/trigger");
+	TriggerInfo triggerInfo = testTriggerInfo[0];
+	triggerInfo.status = (triggerInfo.status == TRIGGER_STATUS_OK) ?
+	  TRIGGER_STATUS_PROBLEM : TRIGGER_STATUS_OK;
+	ThreadLocalDBCache cache;
+	cache.getMonitoring().addTriggerInfo(&triggerInfo);
+	cppcut_assert_equal(static_cast<int>(SOUP_STATUS_OK),
+	                    getStatusCodeWithEntityTag("/trigger", entityTag));
+	cppcut_assert_not_equal(entityTag, getEntityTag("/trigger"));
+}
+
+void test_notModifiedAfterUnrelatedDataIsChanged(void)
+{
+	loadTestDBTriggers();
+	startFaceRest();
+
+	const string entityTag = getEntityTag("/trigger");
+	loadTestDBEvents();
+	cppcut_assert_equal(static_cast<int>(SOUP_STATUS_NOT_MODIFIED),
+	                    getStatusCodeWithEntityTag("/trigger", entityTag));
+}
+
+void test_modifiedWithOtherParameters(void)
+{
+	loadTestDBTriggers();
+	startFaceRest();
+
+	const string entityTag = getEntityTag("/trigger");
+	StringMap parameters;
+	parameters["serverId"] = StringUtils::toString(
+	                           testTriggerInfo[0].serverId);
+	cppcut_assert_equal(static_cast<int>(SOUP_STATUS_OK),
+	                    getStatusCodeWithEntityTag("/trigger", entityTag,
+	                                               parameters));
+}
+
+static string getTriggerResponse(void)
+{
+	RequestArg arg("/trigger");
+	arg.userId = findUserWith(OPPRVLG_GET_ALL_SERVER);
+	getServerResponse(arg);
+	cppcut_assert_equal(static_cast<int>(SOUP_STATUS_OK),
+	                    arg.httpStatusCode);
+	return arg.response;
+}
+
+void test_cachedResponse(void)
+{
+	loadTestDBTriggers();
+	startFaceRest();
+
+	const string response = getTriggerResponse();
+	cppcut_assert_equal(response, getTriggerResponse());
+
+	TriggerInfo triggerInfo = testTriggerInfo[0];
+	triggerInfo.brief = "Changed trigger";
+	ThreadLocalDBCache cache;
+	cache.getMonitoring().addTriggerInfo(&triggerInfo);
+	cppcut_assert_not_equal(response, getTriggerResponse());
+}
 
 void test_getHistoryWithoutParameter(void)
 {
@@ -76,4 +76,79 @@ void test_systemInfo(void)
 	}
 }
 
+void test_actionStatistics(void)
+{
+	startFaceRest();
+	RequestArg arg("/system-info/action");
+	arg.userId = findUserWith(OPPRVLG_GET_SYSTEM_INFO);
+	unique_ptr<JSONParser> parserPtr(getResponseAsJSONParser(arg));
+	JSONParser *parser = parserPtr.get();
+	assertErrorCode(parser);
+
+	auto assertNumber = [&](const char *label) {
+		int64_t n;
+		cppcut_assert_equal(true, parser->read(label, n),
+		                    cut_message("label: %s", label));
+		cppcut_assert_equal(true, n >= 0);
+	};
+
+	auto assertLatencyHistogram = [&](const char *label) {
+		assertStartObject(parser, label);
+		for (auto label : {"count", "min", "max", "mean",
+		                   "p50", "p90", "p99", "p999"})
+			assertNumber(label);
+		parser->endObject();
+	};
+
+	assertNumber("numDispatchedActions");
+
+	assertStartObject(parser, "command");
+	for (auto label : {"launchLatency", "runTime"})
+		assertLatencyHistogram(label);
+	for (auto label : {"numTimeouts", "numOnstageActors",
+	                   "numWaitingActions", "numPendingSpawnerRequests"})
+		assertNumber(label);
+	parser->endObject();
+
+	assertStartObject(parser, "resident");
+	for (auto label : {"launchLatency", "runTime"})
+		assertLatencyHistogram(label);
+	for (auto label : {"numTimeouts", "numYards",
+	                   "numQueuedEvents", "numInFlightEvents"})
+		assertNumber(label);
+	parser->endObject();
+}
+
+void test_responseCacheStatistics(void)
+{
+	loadTestDBTriggers();
+	startFaceRest();
+	for (int i = 0; i < 2; i++) {
+		RequestArg arg("/trigger");
+		arg.userId = findUserWith(OPPRVLG_GET_ALL_SERVER);
+		unique_ptr<JSONParser> parserPtr(getResponseAsJSONParser(arg));
+		assertErrorCode(parserPtr.get());
+	}
+
+	RequestArg arg("/system-info/response-cache");
+	arg.userId = findUserWith(OPPRVLG_GET_SYSTEM_INFO);
+	unique_ptr<JSONParser> parserPtr(getResponseAsJSONParser(arg));
+	JSONParser *parser = parserPtr.get();
+	assertErrorCode(parser);
+
+	auto assertNumber = [&](const char *label, const int64_t &expected) {
+		int64_t n;
+		cppcut_assert_equal(true, parser->read(label, n),
+		                    cut_message("label: %s", label));
+		cppcut_assert_equal(expected, n,
+		                    cut_message("label: %s", label));
+	};
+	assertNumber("numHits", 1);
+	assertNumber("numMisses", 1);
+	assertNumber("numEvictions", 0);
+	assertNumber("numPressureEvictions", 0);
+	assertNumber("numEntries", 1);
+	assertNumber("maxBytes", RestResponseCache::DEFAULT_MAX_BYTES);
+}
+
 } // namespace testFaceRestSystem
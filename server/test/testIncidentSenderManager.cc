@@ -68,6 +68,7 @@ void test_instanceIsSingleton(void)
 static void statusCallback(const IncidentSender &sender,
 			   const EventInfo &info,
 			   const IncidentSender::JobStatus &status,
+			   const HatoholError &result,
 			   void *userData)
 {
 	bool *succeeded = static_cast<bool*>(userData);
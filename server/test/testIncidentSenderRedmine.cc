@@ -377,9 +377,10 @@ struct CallbackData
 	size_t errorsCount;
 	bool   succeeded;
 	bool   failed;
+	HatoholError result;
 
 	CallbackData()
-	: errorsCount(0), succeeded(false), failed(false)
+	: errorsCount(0), succeeded(false), failed(false), result(HTERR_OK)
 	{
 	}
 };
@@ -387,6 +388,7 @@ struct CallbackData
 static void statusCallback(const IncidentSender &sender,
 			   const EventInfo &info,
 			   const IncidentSender::JobStatus &status,
+			   const HatoholError &result,
 			   void *userData)
 {
 	CallbackData *data = static_cast<CallbackData*>(userData);
@@ -403,6 +405,7 @@ static void statusCallback(const IncidentSender &sender,
 	default:
 		break;
 	}
+	data->result = result;
 }
 
 void _assertThread(size_t numErrors, bool shouldSuccess = true)
@@ -428,6 +431,9 @@ void _assertThread(size_t numErrors, bool shouldSuccess = true)
 	cppcut_assert_equal(expectedErrorsCount, cbData.errorsCount);
 	cppcut_assert_equal(shouldSuccess, cbData.succeeded);
 	cppcut_assert_equal(!shouldSuccess, cbData.failed);
+	const HatoholErrorCode expectedResult =
+	  shouldSuccess ? HTERR_OK : HTERR_FAILED_TO_SEND_INCIDENT;
+	cppcut_assert_equal(expectedResult, cbData.result.getCode());
 
 	// check the posted issue
 	string expect;
@@ -463,4 +469,118 @@ void test_threadWithLimitOverErrors(void)
 	assertThread(retryLimit + 1, !shouldSuccessSending);
 }
 
+void test_threadWithCoalescedEvents(void)
+{
+	loadTestDBTablesConfig();
+	const IncidentTrackerInfo tracker = testIncidentTrackerInfo[2];
+	TestRedmineSender sender(tracker);
+	sender.setRetryInterval(10);
+	g_redmineEmulator.addUser(tracker.userName, tracker.password);
+
+	// Events of the same trigger
+	const size_t numEvents = 3;
+	CallbackData cbData[numEvents];
+	sender.start();
+	for (size_t i = 0; i < numEvents; i++) {
+		EventInfo event = testEventInfo[0];
+		event.id = StringUtils::sprintf("%zd", 100 + i);
+		event.unifiedId = 100 + i;
+		const bool coalescable = true;
+		sender.queue(event, statusCallback, (void*)&cbData[i],
+			     USER_ID_SYSTEM, coalescable);
+	}
+	while (!sender.isIdling())
+		usleep(100 * 1000);
+	sender.exitSync();
+
+	for (size_t i = 0; i < numEvents; i++) {
+		cppcut_assert_equal(true, cbData[i].succeeded);
+		cppcut_assert_equal(false, cbData[i].failed);
+	}
+
+	// The following events are posted as a comment to the first issue.
+	cppcut_assert_equal(string("PUT"),
+	                    g_redmineEmulator.getLastRequestMethod());
+	JSONParser parser(g_redmineEmulator.getLastRequestBody());
+	cppcut_assert_equal(true, parser.startObject("issue"));
+	string notes;
+	cppcut_assert_equal(true, parser.read("notes", notes));
+	cppcut_assert_equal(true,
+	  notes.find("Event ID: 101") != string::npos);
+	cppcut_assert_equal(true,
+	  notes.find("Event ID: 102") != string::npos);
+
+	ThreadLocalDBCache cache;
+	DBAgent &dbAgent = cache.getMonitoring().getDBAgent();
+	assertDBContent(&dbAgent, "select count(*) from incidents;", "1");
+
+	// The coalesced events are linked to the issue by their histories.
+	assertDBContent(&dbAgent,
+	                "select unified_event_id from incident_histories"
+	                " order by unified_event_id;",
+	                "101\n102");
+}
+
+void test_threadWithoutCoalescableEvents(void)
+{
+	loadTestDBTablesConfig();
+	const IncidentTrackerInfo tracker = testIncidentTrackerInfo[2];
+	TestRedmineSender sender(tracker);
+	sender.setRetryInterval(10);
+	g_redmineEmulator.addUser(tracker.userName, tracker.password);
+
+	// Events of the same trigger queued without the coalescable flag
+	// (e.g. by POST /incident) create their own incidents.
+	const size_t numEvents = 3;
+	CallbackData cbData[numEvents];
+	sender.start();
+	for (size_t i = 0; i < numEvents; i++) {
+		EventInfo event = testEventInfo[0];
+		event.id = StringUtils::sprintf("%zd", 100 + i);
+		event.unifiedId = 100 + i;
+		sender.queue(event, statusCallback, (void*)&cbData[i]);
+	}
+	while (!sender.isIdling())
+		usleep(100 * 1000);
+	sender.exitSync();
+
+	for (size_t i = 0; i < numEvents; i++)
+		cppcut_assert_equal(true, cbData[i].succeeded);
+	ThreadLocalDBCache cache;
+	DBAgent &dbAgent = cache.getMonitoring().getDBAgent();
+	assertDBContent(&dbAgent, "select count(*) from incidents;",
+	                StringUtils::sprintf("%zd", numEvents));
+}
+
+void test_threadWithConcurrentJobs(void)
+{
+	loadTestDBTablesConfig();
+	const IncidentTrackerInfo tracker = testIncidentTrackerInfo[2];
+	TestRedmineSender sender(tracker);
+	sender.setRetryInterval(10);
+	sender.setMaxInFlightJobs(4);
+	g_redmineEmulator.addUser(tracker.userName, tracker.password);
+
+	// Events of different triggers aren't coalesced.
+	const size_t numEvents = 8;
+	CallbackData cbData[numEvents];
+	sender.start();
+	for (size_t i = 0; i < numEvents; i++) {
+		EventInfo event = testEventInfo[0];
+		event.id = StringUtils::sprintf("%zd", 100 + i);
+		event.triggerId = StringUtils::sprintf("%zd", 200 + i);
+		sender.queue(event, statusCallback, (void*)&cbData[i]);
+	}
+	while (!sender.isIdling())
+		usleep(100 * 1000);
+	sender.exitSync();
+
+	for (size_t i = 0; i < numEvents; i++)
+		cppcut_assert_equal(true, cbData[i].succeeded);
+	ThreadLocalDBCache cache;
+	DBAgent &dbAgent = cache.getMonitoring().getDBAgent();
+	assertDBContent(&dbAgent, "select count(*) from incidents;",
+	                StringUtils::sprintf("%zd", numEvents));
+}
+
 }
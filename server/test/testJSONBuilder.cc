@@ -20,6 +20,7 @@
 #include <cppcutter.h>
 #include <StringUtils.h>
 #include "JSONBuilder.h"
+#include "HatoholException.h"
 using namespace std;
 using namespace mlpl;
 
@@ -61,6 +62,111 @@ void test_array(void)
 	cppcut_assert_equal(expected, agent.generate());
 }
 
+void test_nestedObjectsInArray(void)
+{
+	JSONBuilder agent;
+	agent.startObject();
+	agent.startArray("items");
+	for (int i = 0; i < 2; i++) {
+		agent.startObject();
+		agent.add("id", i);
+		agent.add("name", StringUtils::sprintf("item%d", i));
+		agent.endObject();
+	}
+	agent.endArray();
+	agent.add("count", 2);
+	agent.endObject();
+	string expected =
+	  "{\"items\":[{\"id\":0,\"name\":\"item0\"},"
+	  "{\"id\":1,\"name\":\"item1\"}],\"count\":2}";
+	cppcut_assert_equal(expected, agent.generate());
+}
+
+void test_boolAndNull(void)
+{
+	JSONBuilder agent;
+	agent.startObject();
+	agent.addTrue("t");
+	agent.addFalse("f");
+	agent.addNull("n");
+	agent.endObject();
+	string expected = "{\"t\":true,\"f\":false,\"n\":null}";
+	cppcut_assert_equal(expected, agent.generate());
+}
+
+void test_escapeString(void)
+{
+	JSONBuilder agent;
+	agent.startObject();
+	agent.add("a\"b", "q\"b\\s/\b\f\n\r\t\x01 \xe3\x81\x82");
+	agent.endObject();
+	string expected =
+	  "{\"a\\\"b\":\"q\\\"b\\\\s/\\b\\f\\n\\r\\t\\u0001 \xe3\x81\x82\"}";
+	cppcut_assert_equal(expected, agent.generate());
+}
+
+void test_int64(void)
+{
+	JSONBuilder agent;
+	agent.startObject();
+	agent.add("max", G_MAXINT64);
+	agent.add("min", G_MININT64);
+	agent.endObject();
+	string expected =
+	  "{\"max\":9223372036854775807,\"min\":-9223372036854775808}";
+	cppcut_assert_equal(expected, agent.generate());
+}
+
+void test_chunkSink(void)
+{
+	string received;
+	size_t numChunks = 0;
+	const size_t chunkSize = 16;
+	auto sink = [&](const char *data, const size_t &size) {
+		received.append(data, size);
+		numChunks++;
+	};
+	JSONBuilder agent(sink, chunkSize);
+	agent.startObject();
+	agent.startArray("values");
+	string expected = "{\"values\":[";
+	for (int i = 0; i < 20; i++) {
+		agent.add(i);
+		expected += StringUtils::sprintf(i ? ",%d" : "%d", i);
+	}
+	agent.endArray();
+	agent.endObject();
+	expected += "]}";
+	cppcut_assert_equal(string(), agent.generate());
+	cppcut_assert_equal(expected, received);
+	cppcut_assert_equal(true, numChunks > 1);
+}
+
+void test_moveTo(void)
+{
+	JSONBuilder agent;
+	agent.startObject();
+	agent.add("foo", "bar");
+	agent.endObject();
+	string dest = "garbage";
+	agent.moveTo(dest);
+	cppcut_assert_equal(string("{\"foo\":\"bar\"}"), dest);
+	cppcut_assert_equal(string(), agent.generate());
+}
+
+void test_endObjectWithoutStart(void)
+{
+	bool gotException = false;
+	JSONBuilder agent;
+	agent.startArray("foo");
+	try {
+		agent.endObject();
+	} catch (const HatoholException &e) {
+		gotException = true;
+	}
+	cppcut_assert_equal(true, gotException);
+}
+
 } //namespace testJSONBuilder
 
 
@@ -23,6 +23,7 @@
 #include "JSONParser.h"
 #include "Helpers.h"
 using namespace std;
+using namespace mlpl;
 
 namespace testJSONParser {
 
@@ -61,6 +62,12 @@ assertReadFile(JSON_MATERIAL, _json); \
 JSONParser parser(_json); \
 cppcut_assert_equal(false, PARSER.hasError());
 
+#define DEFINE_IN_SITU_PARSER_AND_READ(PARSER, JSON_MATERIAL) \
+string _json; \
+assertReadFile(JSON_MATERIAL, _json); \
+JSONParser parser(_json, JSONParser::BACKEND_IN_SITU); \
+cppcut_assert_equal(false, PARSER.hasError());
+
 void cut_setup(void)
 {
 	cut_set_fixture_data_dir(getFixturesDir().c_str(), NULL);
@@ -281,4 +288,146 @@ void test_getMemberNames(void)
 	assertEqual(expect, names);
 }
 
+void test_parseStringInObjectInArrayInSitu(void)
+{
+	const char *path = cut_build_fixture_path("testJSON04.json", NULL);
+	DEFINE_IN_SITU_PARSER_AND_READ(parser, path);
+
+	cppcut_assert_equal(true, parser.startObject("array0"));
+	cppcut_assert_equal(2u, parser.countElements());
+
+	cppcut_assert_equal(true, parser.startElement(0));
+	assertReadWord(string, parser, "key0", "value0");
+	assertReadWord(string, parser, "key1", "value1");
+	parser.endElement();
+
+	cppcut_assert_equal(true, parser.startElement(1));
+	assertReadWord(string, parser, "key0X", "value0Y");
+	assertReadWord(string, parser, "key1X", "value1Y");
+	parser.endElement();
+
+	cppcut_assert_equal(false, parser.startElement(2));
+	parser.endObject(); // array0;
+}
+
+void test_checkParseSuccessInSitu(void)
+{
+	const char *path = cut_build_fixture_path("testJSON05.json", NULL);
+	DEFINE_IN_SITU_PARSER_AND_READ(parser, path);
+
+	assertReadWord(bool, parser, "valid", true);
+	assertReadWord(int64_t, parser, "id", 1);
+	assertReadWord(string, parser, "name", "Hatohol");
+
+	cppcut_assert_equal(true, parser.startObject("object"));
+	assertReadWord(bool, parser, "home", true);
+	assertReadWord(string, parser, "city", "Tokyo");
+	assertReadWord(int64_t, parser, "code", 124);
+	parser.endObject();
+}
+
+void data_valueTypeInSitu(void)
+{
+	data_valueType();
+}
+
+void test_valueTypeInSitu(gconstpointer data)
+{
+	JSONParser parser(gcut_data_get_string(data, "json"),
+	                  JSONParser::BACKEND_IN_SITU);
+	JSONParser::ValueType expected =
+	  static_cast<JSONParser::ValueType>(
+	    gcut_data_get_int(data, "expected"));
+	cppcut_assert_equal(expected, parser.getValueType("value"));
+}
+
+void test_getMemberNamesInSitu(void)
+{
+	JSONParser parser("{\"foo\":1, \"dog\":\"cat\", \"book\":[1,2,3]}",
+	                  JSONParser::BACKEND_IN_SITU);
+	set<string> names;
+	parser.getMemberNames(names);
+
+	const set<string> expect = {"foo", "dog", "book"};
+	assertEqual(expect, names);
+}
+
+void test_readEscapedStringInSitu(void)
+{
+	JSONParser parser(
+	  "{\"a\\\"b\":\"q\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\ud83d\\ude00\"}",
+	  JSONParser::BACKEND_IN_SITU);
+	cppcut_assert_equal(false, parser.hasError());
+	assertReadWord(string, parser, "a\"b",
+	               "q\"\\/\b\f\n\r\t\xc3\xa9\xf0\x9f\x98\x80");
+}
+
+void test_readStringViewInSitu(void)
+{
+	const string json = "{\"foo\":\"bar\",\"num\":5}";
+	JSONParser parser(json, JSONParser::BACKEND_IN_SITU);
+	JSONParser::StringView view;
+	cppcut_assert_equal(true, parser.read("foo", view));
+	cppcut_assert_equal(string("bar"), view.toString());
+	cppcut_assert_equal(true, view == "bar");
+	cppcut_assert_equal(false, view == "ba");
+
+	// A non-string value is read as an empty string.
+	cppcut_assert_equal(true, parser.read("num", view));
+	cppcut_assert_equal((size_t)0, view.size);
+}
+
+void test_readManyElementsInSitu(void)
+{
+	const int numElements = 1000;
+	string json = "[";
+	for (int i = 0; i < numElements; i++) {
+		if (i > 0)
+			json += ",";
+		json += StringUtils::sprintf("{\"id\":%d}", i);
+	}
+	json += "]";
+
+	JSONParser parser(json, JSONParser::BACKEND_IN_SITU);
+	cppcut_assert_equal(false, parser.hasError());
+	cppcut_assert_equal((unsigned int)numElements,
+	                    parser.countElements());
+	for (int i = numElements - 1; i >= 0; i -= 7) {
+		cppcut_assert_equal(true, parser.startElement(i));
+		assertReadWord(int64_t, parser, "id", i);
+		parser.endElement();
+	}
+	for (int i = 0; i < numElements; i++) {
+		cppcut_assert_equal(true, parser.startElement(i));
+		assertReadWord(int64_t, parser, "id", i);
+		parser.endElement();
+	}
+}
+
+void data_parseErrorInSitu(void)
+{
+	gcut_add_datum("empty", "json", G_TYPE_STRING, "", NULL);
+	gcut_add_datum("unquoted name",
+		       "json", G_TYPE_STRING, "{hoge:123}", NULL);
+	gcut_add_datum("trailing comma",
+		       "json", G_TYPE_STRING, "{\"a\":1,}", NULL);
+	gcut_add_datum("missing comma", "json", G_TYPE_STRING, "[1 2]", NULL);
+	gcut_add_datum("unterminated string",
+		       "json", G_TYPE_STRING, "{\"a\":\"abc}", NULL);
+	gcut_add_datum("invalid literal", "json", G_TYPE_STRING, "tru", NULL);
+	gcut_add_datum("trailing data", "json", G_TYPE_STRING, "{} x", NULL);
+	gcut_add_datum("invalid number", "json", G_TYPE_STRING, "1.", NULL);
+	gcut_add_datum("invalid escape",
+		       "json", G_TYPE_STRING, "\"\\x\"", NULL);
+}
+
+void test_parseErrorInSitu(gconstpointer data)
+{
+	JSONParser parser(gcut_data_get_string(data, "json"),
+	                  JSONParser::BACKEND_IN_SITU);
+	cppcut_assert_equal(true, parser.hasError());
+	cppcut_assert_equal(JSONParser::VALUE_TYPE_UNKNOWN,
+	                    parser.getValueType("a"));
+}
+
 } //namespace testJSONParser
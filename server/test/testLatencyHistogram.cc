@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppcutter.h>
+#include "LatencyHistogram.h"
+using namespace std;
+
+namespace testLatencyHistogram {
+
+void test_initialSnapshot(void)
+{
+	LatencyHistogram histogram;
+	LatencyHistogram::Snapshot snapshot;
+	histogram.getSnapshot(snapshot);
+	cppcut_assert_equal((uint64_t)0, snapshot.count);
+	cppcut_assert_equal((uint64_t)0, snapshot.getValueAtPercentile(50));
+	cppcut_assert_equal(0.0, snapshot.getMean());
+	cppcut_assert_equal(LatencyHistogram::NUM_BUCKETS,
+	                    snapshot.buckets.size());
+}
+
+void data_getBucketIndex(void)
+{
+	gcut_add_datum("Zero",
+	               "value", G_TYPE_UINT64, (guint64)0, NULL);
+	gcut_add_datum("Linear range",
+	               "value", G_TYPE_UINT64, (guint64)15, NULL);
+	gcut_add_datum("Lower bound of a log bucket",
+	               "value", G_TYPE_UINT64, (guint64)32, NULL);
+	gcut_add_datum("Upper bound of a log bucket",
+	               "value", G_TYPE_UINT64, (guint64)33, NULL);
+	gcut_add_datum("One second",
+	               "value", G_TYPE_UINT64, (guint64)1000000, NULL);
+	gcut_add_datum("Max",
+	               "value", G_TYPE_UINT64, (guint64)UINT64_MAX, NULL);
+}
+
+void test_getBucketIndex(gconstpointer data)
+{
+	const uint64_t value = gcut_data_get_uint64(data, "value");
+	const size_t index = LatencyHistogram::getBucketIndex(value);
+	cppcut_assert_equal(true, index < LatencyHistogram::NUM_BUCKETS);
+	cppcut_assert_equal(true,
+	  LatencyHistogram::getBucketLowerBound(index) <= value);
+	cppcut_assert_equal(true,
+	  value <= LatencyHistogram::getBucketUpperBound(index));
+
+	// The relative error is bounded by the number of sub buckets.
+	const uint64_t width = LatencyHistogram::getBucketUpperBound(index)
+	                       - LatencyHistogram::getBucketLowerBound(index);
+	cppcut_assert_equal(true,
+	  width <= value / LatencyHistogram::SUB_BUCKET_COUNT);
+}
+
+void test_record(void)
+{
+	LatencyHistogram histogram;
+	for (uint64_t i = 1; i <= 1000; i++)
+		histogram.record(i);
+	LatencyHistogram::Snapshot snapshot;
+	histogram.getSnapshot(snapshot);
+	cppcut_assert_equal((uint64_t)1000, snapshot.count);
+	cppcut_assert_equal((uint64_t)1, snapshot.min);
+	cppcut_assert_equal((uint64_t)1000, snapshot.max);
+	cppcut_assert_equal((uint64_t)500500, snapshot.sum);
+	cppcut_assert_equal(500.5, snapshot.getMean());
+	cppcut_assert_equal((uint64_t)1000,
+	                    snapshot.getValueAtPercentile(100));
+}
+
+void data_getValueAtPercentile(void)
+{
+	gcut_add_datum("p50",
+	               "percentile", G_TYPE_DOUBLE, 50.0,
+	               "expect", G_TYPE_UINT64, (guint64)500, NULL);
+	gcut_add_datum("p90",
+	               "percentile", G_TYPE_DOUBLE, 90.0,
+	               "expect", G_TYPE_UINT64, (guint64)900, NULL);
+	gcut_add_datum("p99",
+	               "percentile", G_TYPE_DOUBLE, 99.0,
+	               "expect", G_TYPE_UINT64, (guint64)990, NULL);
+}
+
+void test_getValueAtPercentile(gconstpointer data)
+{
+	LatencyHistogram histogram;
+	for (uint64_t i = 1; i <= 1000; i++)
+		histogram.record(i);
+	LatencyHistogram::Snapshot snapshot;
+	histogram.getSnapshot(snapshot);
+
+	const double percentile = gcut_data_get_double(data, "percentile");
+	const uint64_t expect = gcut_data_get_uint64(data, "expect");
+	const uint64_t actual = snapshot.getValueAtPercentile(percentile);
+	const uint64_t tolerance = expect / LatencyHistogram::SUB_BUCKET_COUNT;
+	cppcut_assert_equal(true, actual >= expect,
+	  cut_message("actual: %" PRIu64, actual));
+	cppcut_assert_equal(true, actual <= expect + tolerance,
+	  cut_message("actual: %" PRIu64, actual));
+}
+
+void test_reset(void)
+{
+	LatencyHistogram histogram;
+	histogram.record(100);
+	histogram.reset();
+	LatencyHistogram::Snapshot snapshot;
+	histogram.getSnapshot(snapshot);
+	cppcut_assert_equal((uint64_t)0, snapshot.count);
+	cppcut_assert_equal((uint64_t)0, snapshot.max);
+	cppcut_assert_equal((uint64_t)0, snapshot.buckets[100]);
+}
+
+} // namespace testLatencyHistogram
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppcutter.h>
+#include <cutter.h>
+#include "Hatohol.h"
+#include "ResidentCommunicator.h"
+using namespace std;
+using namespace mlpl;
+
+namespace testResidentCommunicator {
+
+static const char *TEST_SESSION_ID = "0123456789abcdef0123456789abcdef0123";
+
+static EventInfo makeEventInfo(const size_t &idx)
+{
+	EventInfo eventInfo;
+	initEventInfo(eventInfo);
+	eventInfo.serverId = 10 + idx;
+	eventInfo.hostIdInServer = StringUtils::sprintf("host-%zd", idx);
+	eventInfo.time.tv_sec = 1450000000 + idx;
+	eventInfo.time.tv_nsec = 12345 + idx;
+	eventInfo.id = StringUtils::sprintf("event-%zd", idx * 1000);
+	eventInfo.type = EVENT_TYPE_BAD;
+	eventInfo.triggerId = StringUtils::sprintf("trig-%zd", idx);
+	eventInfo.status = TRIGGER_STATUS_PROBLEM;
+	eventInfo.severity = TRIGGER_SEVERITY_WARNING;
+	return eventInfo;
+}
+
+static void _assertNotifyEventBody(SmartBuffer &sbuf,
+                                   const ActionIdType &actionId,
+                                   const EventInfo &eventInfo)
+{
+	cppcut_assert_equal(actionId,
+	                    (ActionIdType)sbuf.getValueAndIncIndex<uint32_t>());
+	cppcut_assert_equal(eventInfo.serverId,
+	                    (ServerIdType)sbuf.getValueAndIncIndex<uint32_t>());
+	cppcut_assert_equal(eventInfo.hostIdInServer,
+	                    sbuf.extractStringAndIncIndex());
+	cppcut_assert_equal((uint64_t)eventInfo.time.tv_sec,
+	                    sbuf.getValueAndIncIndex<uint64_t>());
+	cppcut_assert_equal((uint32_t)eventInfo.time.tv_nsec,
+	                    sbuf.getValueAndIncIndex<uint32_t>());
+	cppcut_assert_equal(eventInfo.id, sbuf.extractStringAndIncIndex());
+	cppcut_assert_equal((uint16_t)eventInfo.type,
+	                    sbuf.getValueAndIncIndex<uint16_t>());
+	cppcut_assert_equal(eventInfo.triggerId,
+	                    sbuf.extractStringAndIncIndex());
+	cppcut_assert_equal((uint16_t)eventInfo.status,
+	                    sbuf.getValueAndIncIndex<uint16_t>());
+	cppcut_assert_equal((uint16_t)eventInfo.severity,
+	                    sbuf.getValueAndIncIndex<uint16_t>());
+	cppcut_assert_equal(string(TEST_SESSION_ID),
+	                    string(sbuf.getPointer<char>(),
+	                           HATOHOL_SESSION_ID_LEN));
+	sbuf.incIndex(HATOHOL_SESSION_ID_LEN);
+}
+#define assertNotifyEventBody(S,A,E) \
+cut_trace(_assertNotifyEventBody(S,A,E))
+
+void cut_setup(void)
+{
+	hatoholInit();
+}
+
+// ---------------------------------------------------------------------------
+// Test cases
+// ---------------------------------------------------------------------------
+void test_setNotifyEventBody(void)
+{
+	const ActionIdType actionId = 5;
+	const EventInfo eventInfo = makeEventInfo(0);
+	ResidentCommunicator comm;
+	comm.setNotifyEventBody(actionId, eventInfo, TEST_SESSION_ID);
+
+	SmartBuffer &sbuf = comm.getBuffer();
+	const size_t bodySize =
+	  ResidentCommunicator::calcNotifyEventBodySize(eventInfo);
+	cppcut_assert_equal(RESIDENT_PROTO_HEADER_LEN + bodySize,
+	                    sbuf.watermark());
+	cppcut_assert_equal(bodySize,
+	                    ResidentCommunicator::getBodySize(sbuf));
+	cppcut_assert_equal((int)RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT,
+	                    ResidentCommunicator::getPacketType(sbuf));
+	sbuf.setIndex(RESIDENT_PROTO_HEADER_LEN);
+	assertNotifyEventBody(sbuf, actionId, eventInfo);
+}
+
+void test_notifyEventBatch(void)
+{
+	const ActionIdType actionId = 7;
+	const size_t numEvents = 3;
+	const uint32_t firstRequestId = 0xfffffffe; // includes wrap around
+	vector<EventInfo> eventInfoVect;
+	size_t bodySize = RESIDENT_PROTO_EVENT_BATCH_NUM_EVENTS_LEN;
+	for (size_t i = 0; i < numEvents; i++) {
+		eventInfoVect.push_back(makeEventInfo(i));
+		bodySize += RESIDENT_PROTO_EVENT_BATCH_ITEM_HEADER_LEN;
+		bodySize += ResidentCommunicator::calcNotifyEventBodySize(
+		              eventInfoVect[i]);
+	}
+
+	ResidentCommunicator comm;
+	comm.setNotifyEventBatchHeader(bodySize, numEvents);
+	for (size_t i = 0; i < numEvents; i++) {
+		comm.addNotifyEventBatchItem(firstRequestId + i, actionId,
+		                             eventInfoVect[i], TEST_SESSION_ID);
+	}
+
+	SmartBuffer &sbuf = comm.getBuffer();
+	cppcut_assert_equal(RESIDENT_PROTO_HEADER_LEN + bodySize,
+	                    sbuf.watermark());
+	cppcut_assert_equal(bodySize,
+	                    ResidentCommunicator::getBodySize(sbuf));
+	cppcut_assert_equal((int)RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH,
+	                    ResidentCommunicator::getPacketType(sbuf));
+	sbuf.setIndex(RESIDENT_PROTO_HEADER_LEN);
+	cppcut_assert_equal((uint16_t)numEvents,
+	                    sbuf.getValueAndIncIndex<uint16_t>());
+	for (size_t i = 0; i < numEvents; i++) {
+		cppcut_assert_equal((uint32_t)(firstRequestId + i),
+		                    sbuf.getValueAndIncIndex<uint32_t>());
+		const uint32_t itemSize = sbuf.getValueAndIncIndex<uint32_t>();
+		cppcut_assert_equal(
+		  ResidentCommunicator::calcNotifyEventBodySize(
+		    eventInfoVect[i]),
+		  (size_t)itemSize);
+		const size_t itemTail = sbuf.index() + itemSize;
+		assertNotifyEventBody(sbuf, actionId, eventInfoVect[i]);
+		sbuf.setIndex(itemTail);
+	}
+	cppcut_assert_equal(sbuf.watermark(), sbuf.index());
+}
+
+void test_notifyEventBatchAck(void)
+{
+	const size_t numResults = 4;
+	ResidentCommunicator comm;
+	comm.setNotifyEventBatchAckHeader(numResults);
+	for (size_t i = 0; i < numResults; i++)
+		comm.addNotifyEventBatchAckResult(100 + i, i * 3);
+
+	SmartBuffer &sbuf = comm.getBuffer();
+	const size_t bodySize =
+	  RESIDENT_PROTO_EVENT_BATCH_ACK_NUM_RESULTS_LEN +
+	  RESIDENT_PROTO_EVENT_BATCH_ACK_RESULT_LEN * numResults;
+	cppcut_assert_equal(RESIDENT_PROTO_HEADER_LEN + bodySize,
+	                    sbuf.watermark());
+	cppcut_assert_equal(bodySize,
+	                    ResidentCommunicator::getBodySize(sbuf));
+	cppcut_assert_equal(
+	  (int)RESIDENT_PROTO_PKT_TYPE_NOTIFY_EVENT_BATCH_ACK,
+	  ResidentCommunicator::getPacketType(sbuf));
+	sbuf.setIndex(RESIDENT_PROTO_HEADER_LEN);
+	cppcut_assert_equal((uint16_t)numResults,
+	                    sbuf.getValueAndIncIndex<uint16_t>());
+	for (size_t i = 0; i < numResults; i++) {
+		cppcut_assert_equal((uint32_t)(100 + i),
+		                    sbuf.getValueAndIncIndex<uint32_t>());
+		cppcut_assert_equal((uint32_t)(i * 3),
+		                    sbuf.getValueAndIncIndex<uint32_t>());
+	}
+}
+
+} // namespace testResidentCommunicator
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppcutter.h>
+#include "RestResponseCache.h"
+using namespace std;
+
+namespace testRestResponseCache {
+
+static RestResponseCache::Body makeBody(const string &json)
+{
+	return RestResponseCache::Body(new string(json));
+}
+
+static size_t getNumberOfEntries(RestResponseCache &cache)
+{
+	RestResponseCache::Statistics stats;
+	cache.getStatistics(stats);
+	return stats.numEntries;
+}
+
+// ---------------------------------------------------------------------------
+// Test cases
+// ---------------------------------------------------------------------------
+void test_get(void)
+{
+	RestResponseCache cache;
+	RestResponseCache::Body body = makeBody("{\"a\":1}");
+	cache.put("key", {1, 2}, body);
+	RestResponseCache::Body found = cache.get("key", {1, 2});
+	cppcut_assert_equal(body.get(), found.get());
+
+	RestResponseCache::Statistics stats;
+	cache.getStatistics(stats);
+	cppcut_assert_equal((uint64_t)1, stats.numHits);
+	cppcut_assert_equal((uint64_t)0, stats.numMisses);
+}
+
+void test_getUnknownKey(void)
+{
+	RestResponseCache cache;
+	cache.put("key", {1}, makeBody("{}"));
+	cppcut_assert_equal(false, static_cast<bool>(cache.get("foo", {1})));
+
+	RestResponseCache::Statistics stats;
+	cache.getStatistics(stats);
+	cppcut_assert_equal((uint64_t)0, stats.numHits);
+	cppcut_assert_equal((uint64_t)1, stats.numMisses);
+}
+
+void test_getWithNewGenerations(void)
+{
+	RestResponseCache cache;
+	cache.put("key", {1, 2}, makeBody("{}"));
+	cppcut_assert_equal(false,
+	                    static_cast<bool>(cache.get("key", {1, 3})));
+	cppcut_assert_equal((size_t)0, getNumberOfEntries(cache));
+}
+
+void test_getGenerations(void)
+{
+	const DataGenerationTypeVect types = {
+	  DATA_GENERATION_TRIGGER, DATA_GENERATION_HOST};
+	const RestResponseCache::Generations generations =
+	  RestResponseCache::getGenerations(types);
+	DataGeneration::bump(DATA_GENERATION_HOST);
+	const RestResponseCache::Generations expected = {
+	  generations[0], generations[1] + 1};
+	cppcut_assert_equal(true,
+	                    expected == RestResponseCache::getGenerations(types));
+}
+
+void test_evictLeastRecentlyUsed(void)
+{
+	const string json(100, 'a');
+	RestResponseCache cache;
+	cache.put("key0", {1}, makeBody(json));
+	RestResponseCache::Statistics stats;
+	cache.getStatistics(stats);
+	const size_t entryBytes = stats.usedBytes;
+	cache.setMaxBytes(entryBytes * 2);
+
+	cache.put("key1", {1}, makeBody(json));
+	cache.get("key0", {1});
+	cache.put("key2", {1}, makeBody(json));
+
+	cppcut_assert_equal(true, static_cast<bool>(cache.get("key0", {1})));
+	cppcut_assert_equal(false, static_cast<bool>(cache.get("key1", {1})));
+	cppcut_assert_equal(true, static_cast<bool>(cache.get("key2", {1})));
+	cache.getStatistics(stats);
+	cppcut_assert_equal((uint64_t)1, stats.numEvictions);
+	cppcut_assert_equal(entryBytes * 2, stats.usedBytes);
+}
+
+void test_disabled(void)
+{
+	RestResponseCache cache(0);
+	cache.put("key", {1}, makeBody("{}"));
+	cppcut_assert_equal((size_t)0, getNumberOfEntries(cache));
+}
+
+void test_shrinkUnderMemoryPressure(void)
+{
+	// The probe is called at most once a second. Setting it again makes
+	// the next put() call it.
+	bool pressure = false;
+	auto probe = [&]() { return pressure; };
+	RestResponseCache cache;
+	for (int i = 0; i < 4; i++) {
+		cache.setMemoryPressureProbe(probe);
+		cache.put(to_string(i), {1}, makeBody("{}"));
+	}
+	pressure = true;
+	cache.setMemoryPressureProbe(probe);
+	cache.put("4", {1}, makeBody("{}"));
+
+	RestResponseCache::Statistics stats;
+	cache.getStatistics(stats);
+	cppcut_assert_equal((size_t)2, stats.numEntries);
+	cppcut_assert_equal((uint64_t)2, stats.numPressureEvictions);
+	cppcut_assert_equal((uint64_t)0, stats.numEvictions);
+	cppcut_assert_equal(false, static_cast<bool>(cache.get("4", {1})));
+}
+
+void test_clear(void)
+{
+	RestResponseCache cache;
+	cache.put("key", {1}, makeBody("{}"));
+	cache.clear();
+	RestResponseCache::Statistics stats;
+	cache.getStatistics(stats);
+	cppcut_assert_equal((size_t)0, stats.numEntries);
+	cppcut_assert_equal((size_t)0, stats.usedBytes);
+}
+
+} // namespace testRestResponseCache
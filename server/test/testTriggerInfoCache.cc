@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppcutter.h>
+#include "TriggerInfoCache.h"
+using namespace std;
+
+namespace testTriggerInfoCache {
+
+static TriggerInfo makeTriggerInfo(const ServerIdType &serverId,
+                                   const TriggerIdType &triggerId,
+                                   const string &brief = "")
+{
+	TriggerInfo triggerInfo;
+	triggerInfo.serverId = serverId;
+	triggerInfo.id = triggerId;
+	triggerInfo.brief = brief;
+	return triggerInfo;
+}
+
+static void _assertCached(TriggerInfoCache &cache,
+                          const ServerIdType &serverId,
+                          const TriggerIdType &triggerId,
+                          const string &brief)
+{
+	TriggerInfo triggerInfo;
+	cppcut_assert_equal(true, cache.get(serverId, triggerId, triggerInfo));
+	cppcut_assert_equal(serverId, triggerInfo.serverId);
+	cppcut_assert_equal(triggerId, triggerInfo.id);
+	cppcut_assert_equal(brief, triggerInfo.brief);
+}
+#define assertCached(C,S,T,B) cut_trace(_assertCached(C,S,T,B))
+
+static void _assertNotCached(TriggerInfoCache &cache,
+                             const ServerIdType &serverId,
+                             const TriggerIdType &triggerId)
+{
+	TriggerInfo triggerInfo;
+	cppcut_assert_equal(false, cache.get(serverId, triggerId, triggerInfo));
+}
+#define assertNotCached(C,S,T) cut_trace(_assertNotCached(C,S,T))
+
+void test_getNotFound(void)
+{
+	TriggerInfoCache cache;
+	assertNotCached(cache, 1, "1");
+	cppcut_assert_equal((size_t)0, cache.getNumberOfTriggers());
+}
+
+void test_update(void)
+{
+	TriggerInfoCache cache;
+	cache.update(makeTriggerInfo(1, "1", "foo"));
+	cache.update(makeTriggerInfo(2, "1", "bar"));
+	assertCached(cache, 1, "1", "foo");
+	assertCached(cache, 2, "1", "bar");
+
+	cache.update(makeTriggerInfo(1, "1", "goo"));
+	assertCached(cache, 1, "1", "goo");
+	cppcut_assert_equal((size_t)2, cache.getNumberOfTriggers());
+}
+
+void test_evictLeastRecentlyUsed(void)
+{
+	TriggerInfoCache cache(2);
+	cache.update(makeTriggerInfo(1, "1", "foo"));
+	cache.update(makeTriggerInfo(1, "2", "bar"));
+	assertCached(cache, 1, "1", "foo");
+
+	cache.update(makeTriggerInfo(1, "3", "goo"));
+	cppcut_assert_equal((size_t)2, cache.getNumberOfTriggers());
+	assertNotCached(cache, 1, "2");
+	assertCached(cache, 1, "1", "foo");
+	assertCached(cache, 1, "3", "goo");
+}
+
+void test_fill(void)
+{
+	TriggerInfoCache cache;
+	const uint64_t generation = cache.getGeneration();
+	cache.fill(makeTriggerInfo(1, "1", "foo"), generation);
+	assertCached(cache, 1, "1", "foo");
+}
+
+void test_fillAfterUpdate(void)
+{
+	TriggerInfoCache cache;
+	const uint64_t generation = cache.getGeneration();
+	cache.update(makeTriggerInfo(1, "1", "new"));
+	cache.fill(makeTriggerInfo(1, "1", "old"), generation);
+	assertCached(cache, 1, "1", "new");
+}
+
+void test_erase(void)
+{
+	TriggerInfoCache cache;
+	cache.update(makeTriggerInfo(1, "1", "foo"));
+	cache.update(makeTriggerInfo(1, "2", "bar"));
+	cache.update(makeTriggerInfo(2, "1", "goo"));
+	cache.erase(1, TriggerIdList{"1", "3"});
+	assertNotCached(cache, 1, "1");
+	assertCached(cache, 1, "2", "bar");
+	assertCached(cache, 2, "1", "goo");
+}
+
+void test_eraseServer(void)
+{
+	TriggerInfoCache cache;
+	cache.update(makeTriggerInfo(1, "1", "foo"));
+	cache.update(makeTriggerInfo(2, "1", "bar"));
+	cache.update(makeTriggerInfo(2, "2", "goo"));
+	cache.update(makeTriggerInfo(3, "1", "hoo"));
+	cache.erase(2);
+	assertCached(cache, 1, "1", "foo");
+	assertNotCached(cache, 2, "1");
+	assertNotCached(cache, 2, "2");
+	assertCached(cache, 3, "1", "hoo");
+}
+
+void test_clear(void)
+{
+	TriggerInfoCache cache;
+	cache.update(makeTriggerInfo(1, "1", "foo"));
+	cache.clear();
+	assertNotCached(cache, 1, "1");
+	cppcut_assert_equal((size_t)0, cache.getNumberOfTriggers());
+}
+
+} // namespace testTriggerInfoCache
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppcutter.h>
+#include <gcutter.h>
+#include "Hatohol.h"
+#include "Helpers.h"
+#include "DBTablesTest.h"
+#include "ThreadLocalDBCache.h"
+#include "TriggerStatisticsCache.h"
+using namespace std;
+using namespace mlpl;
+
+namespace testTriggerStatisticsCache {
+
+static void _assertStatistics(const ServerIdType &serverId,
+                              const HostgroupIdType &hostgroupId)
+{
+	TriggerStatistics statistics;
+	TriggerStatisticsCache::getInstance().get(statistics, serverId,
+	                                          hostgroupId);
+
+	ThreadLocalDBCache cache;
+	DBTablesMonitoring &dbMonitoring = cache.getMonitoring();
+	TriggersQueryOption option(USER_ID_SYSTEM);
+	option.setTargetServerId(serverId);
+	option.setTargetHostgroupId(hostgroupId);
+	option.setExcludeFlags(EXCLUDE_INVALID_HOST|EXCLUDE_SELF_MONITORING);
+	cppcut_assert_equal(dbMonitoring.getNumberOfTriggers(option),
+	                    statistics.numTriggers);
+	cppcut_assert_equal(
+	  dbMonitoring.getNumberOfBadTriggers(option, TRIGGER_SEVERITY_ALL),
+	  statistics.getNumberOfBadTriggers(TRIGGER_SEVERITY_ALL));
+	for (int i = 0; i < NUM_TRIGGER_SEVERITY; i++) {
+		const TriggerSeverityType severity =
+		  static_cast<TriggerSeverityType>(i);
+		cppcut_assert_equal(
+		  dbMonitoring.getNumberOfBadTriggers(option, severity),
+		  statistics.getNumberOfBadTriggers(severity),
+		  cut_message("severity: %d", i));
+	}
+	cppcut_assert_equal(dbMonitoring.getNumberOfGoodHosts(option),
+	                    statistics.getNumberOfGoodHosts());
+	cppcut_assert_equal(dbMonitoring.getNumberOfBadHosts(option),
+	                    statistics.numBadHosts);
+}
+#define assertStatistics(S,H) cut_trace(_assertStatistics(S,H))
+
+static void _assertAllHostgroups(const ServerIdType &serverId)
+{
+	assertStatistics(serverId, ALL_HOST_GROUPS);
+	for (const auto &hostgroupId : getTestHostgroupIdSet())
+		assertStatistics(serverId, hostgroupId);
+}
+#define assertAllHostgroups(S) cut_trace(_assertAllHostgroups(S))
+
+static const TriggerInfo &findTestTrigger(const ServerIdType &serverId,
+                                          const TriggerStatusType &status)
+{
+	for (size_t i = 0; i < NumTestTriggerInfo; i++) {
+		const TriggerInfo &triggerInfo = testTriggerInfo[i];
+		if (triggerInfo.serverId != serverId)
+			continue;
+		if (triggerInfo.status != status)
+			continue;
+		if (triggerInfo.validity != TRIGGER_VALID)
+			continue;
+		return triggerInfo;
+	}
+	cut_fail("Not found: server: %" FMT_SERVER_ID ", status: %d",
+	         serverId, status);
+	return testTriggerInfo[0];
+}
+
+void cut_setup(void)
+{
+	hatoholInit();
+	setupTestDB();
+	loadTestDBTablesConfig();
+	loadTestDBTriggers();
+	loadTestDBHostgroupMember();
+}
+
+// ---------------------------------------------------------------------------
+// Test cases
+// ---------------------------------------------------------------------------
+void data_get(void)
+{
+	ServerIdSet serverIdSet;
+	for (size_t i = 0; i < NumTestTriggerInfo; i++)
+		serverIdSet.insert(testTriggerInfo[i].serverId);
+	for (const auto &serverId : serverIdSet) {
+		const string label =
+		  StringUtils::sprintf("server: %" FMT_SERVER_ID, serverId);
+		gcut_add_datum(label.c_str(),
+		               "serverId", G_TYPE_INT, serverId, NULL);
+	}
+}
+
+void test_get(gconstpointer data)
+{
+	const ServerIdType serverId = gcut_data_get_int(data, "serverId");
+	assertAllHostgroups(serverId);
+	cppcut_assert_equal((size_t)1,
+	  TriggerStatisticsCache::getInstance().getNumberOfServers());
+}
+
+void test_getWithHostgroupIdSet(void)
+{
+	const ServerIdType serverId = testTriggerInfo[0].serverId;
+	TriggerStatisticsCache &statisticsCache =
+	  TriggerStatisticsCache::getInstance();
+	for (const auto &hostgroupId : getTestHostgroupIdSet()) {
+		TriggerStatistics expected, actual;
+		statisticsCache.get(expected, serverId, hostgroupId);
+		statisticsCache.get(actual, serverId,
+		                    HostgroupIdSet{hostgroupId});
+		cppcut_assert_equal(expected.numTriggers, actual.numTriggers);
+		cppcut_assert_equal(expected.numBadTriggers,
+		                    actual.numBadTriggers);
+		cppcut_assert_equal(expected.numHosts, actual.numHosts);
+		cppcut_assert_equal(expected.numBadHosts, actual.numBadHosts);
+	}
+}
+
+void test_updateAfterLoad(void)
+{
+	const ServerIdType serverId = testTriggerInfo[0].serverId;
+	assertAllHostgroups(serverId);
+
+	TriggerInfo triggerInfo = findTestTrigger(serverId, TRIGGER_STATUS_OK);
+	triggerInfo.status = TRIGGER_STATUS_PROBLEM;
+	triggerInfo.severity = TRIGGER_SEVERITY_CRITICAL;
+	ThreadLocalDBCache cache;
+	cache.getMonitoring().addTriggerInfoList({triggerInfo});
+
+	assertAllHostgroups(serverId);
+	cppcut_assert_equal((size_t)1,
+	  TriggerStatisticsCache::getInstance().getNumberOfServers());
+}
+
+void test_invalidateAfterLoad(void)
+{
+	const ServerIdType serverId = testTriggerInfo[0].serverId;
+	assertAllHostgroups(serverId);
+
+	TriggerInfo triggerInfo =
+	  findTestTrigger(serverId, TRIGGER_STATUS_PROBLEM);
+	triggerInfo.validity = TRIGGER_INVALID;
+	ThreadLocalDBCache cache;
+	cache.getMonitoring().addTriggerInfoList({triggerInfo});
+
+	assertAllHostgroups(serverId);
+}
+
+void test_deleteAfterLoad(void)
+{
+	const ServerIdType serverId = testTriggerInfo[0].serverId;
+	assertAllHostgroups(serverId);
+
+	const TriggerInfo &triggerInfo =
+	  findTestTrigger(serverId, TRIGGER_STATUS_PROBLEM);
+	ThreadLocalDBCache cache;
+	assertHatoholError(HTERR_OK,
+	  cache.getMonitoring().deleteTriggerInfo({triggerInfo.id},
+	                                          serverId));
+
+	assertAllHostgroups(serverId);
+}
+
+void test_changeHostgroupMembers(void)
+{
+	const ServerIdType serverId = testTriggerInfo[0].serverId;
+	assertAllHostgroups(serverId);
+
+	const TriggerInfo &triggerInfo =
+	  findTestTrigger(serverId, TRIGGER_STATUS_PROBLEM);
+	HostgroupMember hostgroupMember;
+	hostgroupMember.id = AUTO_INCREMENT_VALUE;
+	hostgroupMember.serverId = serverId;
+	hostgroupMember.hostIdInServer = triggerInfo.hostIdInServer;
+	hostgroupMember.hostgroupIdInServer = "NewGroup";
+	hostgroupMember.hostId = triggerInfo.globalHostId;
+	ThreadLocalDBCache cache;
+	cache.getHost().upsertHostgroupMembers({hostgroupMember});
+
+	TriggerStatisticsCache &statisticsCache =
+	  TriggerStatisticsCache::getInstance();
+	cppcut_assert_equal((size_t)0, statisticsCache.getNumberOfServers());
+	assertAllHostgroups(serverId);
+	assertStatistics(serverId, "NewGroup");
+}
+
+} // namespace testTriggerStatisticsCache
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2016 Project Hatohol
+ *
+ * This file is part of Hatohol.
+ *
+ * Hatohol is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License, version 3
+ * as published by the Free Software Foundation.
+ *
+ * Hatohol is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Hatohol. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include <cppcutter.h>
+#include <atomic>
+#include "WorkerPool.h"
+#include "HatoholException.h"
+
+using namespace std;
+
+namespace testWorkerPool {
+
+void test_numberOfWorkers(void)
+{
+	WorkerPool pool(3);
+	cppcut_assert_equal((size_t)3, pool.getNumberOfWorkers());
+}
+
+void test_defaultNumberOfWorkers(void)
+{
+	WorkerPool pool;
+	cppcut_assert_equal(true, pool.getNumberOfWorkers() > 0);
+}
+
+void test_runAllPostedTasks(void)
+{
+	const size_t numTasks = 100;
+	atomic<size_t> count(0);
+	{
+		WorkerPool pool(4);
+		for (size_t i = 0; i < numTasks; i++)
+			pool.post([&] { count++; });
+	}
+	cppcut_assert_equal(numTasks, count.load());
+}
+
+void test_continueAfterException(void)
+{
+	atomic<size_t> count(0);
+	{
+		WorkerPool pool(1);
+		pool.post([] { THROW_HATOHOL_EXCEPTION("Test exception"); });
+		pool.post([&] { count++; });
+	}
+	cppcut_assert_equal((size_t)1, count.load());
+}
+
+void test_getShared(void)
+{
+	WorkerPool &pool = WorkerPool::getShared();
+	cppcut_assert_equal(&pool, &WorkerPool::getShared());
+	cppcut_assert_equal(true, pool.getNumberOfWorkers() > 0);
+}
+
+} // namespace testWorkerPool